@@ -85,14 +85,26 @@ QGraphicsItem* ArrowElement::getItem() const
 	return m_graphicsItem;
 }
 
+void ArrowElement::paintContent(QPainter* painter) const
+{
+	if (m_graphicsItem) {
+		m_graphicsItem->paintContent(painter);
+	}
+}
+
 void ArrowElement::addToScene(QGraphicsScene *scene)
 {
 	if (!scene) return;
+	scene->addItem(ensureItem());
+}
+
+QGraphicsItem* ArrowElement::ensureItem()
+{
 	if (!m_graphicsItem) {
 		m_graphicsItem = createGraphicsItem();
 		syncToItem();
 	}
-	scene->addItem(m_graphicsItem);
+	return m_graphicsItem;
 }
 
 void ArrowElement::setPen(const QPen &pen)
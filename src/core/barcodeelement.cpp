@@ -28,6 +28,12 @@ QGraphicsItem* BarcodeElement::getItem() const {
     return m_item;
 }
 
+void BarcodeElement::paintContent(QPainter* painter) const {
+    if (m_item) {
+        m_item->paintContent(painter);
+    }
+}
+
 QString BarcodeElement::getType() const {
     return "barcode";
 }
@@ -209,9 +215,24 @@ void BarcodeElement::restoreOriginalData()
     m_hasOriginalData = false;
 }
 
+SymbolMatrixKey BarcodeElement::symbolMatrixKeyForRecord(int index, int deviceDpiX, int deviceDpiY) const
+{
+    auto source = dataSource();
+    if (!m_item || !isDataSourceEnabled() || !source || index < 0 || index >= source->count()) {
+        return SymbolMatrixKey();
+    }
+
+    // 与 applyDataSourceRecord 相同的取值规则
+    return m_item->symbolMatrixKey(source->at(index).trimmed(), deviceDpiX, deviceDpiY);
+}
+
 void BarcodeElement::addToScene(QGraphicsScene* scene) {
     if (!scene) return;
 
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* BarcodeElement::ensureItem() {
     // 如果 item 还不存在，创建一个新的
     if (!m_item) {
         m_item = new BarcodeItem(m_data, m_format);
@@ -222,5 +243,5 @@ void BarcodeElement::addToScene(QGraphicsScene* scene) {
         m_item->setHumanReadableTextFont(m_humanReadableTextFont);
     }
 
-    scene->addItem(m_item);
+    return m_item;
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ public:
 
     // 实现基类的虚函数
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     QString getType() const override;
     QJsonObject getData() const override;
     void setData(const QJsonObject& data) override;
@@ -52,9 +53,12 @@ public:
     // 数据源相关
     bool applyDataSourceRecord(int index);
     void restoreOriginalData();
+    // 第 index 条记录绘制到给定 DPI 设备时的编码参数（不修改当前数据），供批量预编码使用
+    SymbolMatrixKey symbolMatrixKeyForRecord(int index, int deviceDpiX, int deviceDpiY) const;
 
     // 创建 BarcodeItem 并添加到场景
     void addToScene(QGraphicsScene* scene);
+    QGraphicsItem* ensureItem() override;
 
 private:
     BarcodeItem* m_item = nullptr;
@@ -0,0 +1,350 @@
+#include "documentjournal.h"
+
+#include "documentwriter.h"
+
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QLockFile>
+#include <QObject>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+const QByteArray kJournalMagic("SLJ1");
+
+// 超过任一上限时重新写快照，日志不会无限增长
+constexpr int kMaxAppendedRecords = 1000;
+constexpr qint64 kMinCompactionBytes = 1024 * 1024;
+
+const QString kOp = QStringLiteral("op");
+
+QByteArray frame(const QCborMap &record)
+{
+    const QByteArray payload = QCborValue(record).toCbor();
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::BigEndian);
+    out << quint32(payload.size());
+    out.writeRawData(payload.constData(), payload.size());
+    return data;
+}
+
+QCborArray idArray(const QVector<quint64> &ids)
+{
+    QCborArray array;
+    for (quint64 id : ids) {
+        array.append(qint64(id));
+    }
+    return array;
+}
+
+} // namespace
+
+DocumentJournal::DocumentJournal(DocumentWriter *writer)
+    : m_writer(writer)
+{
+}
+
+DocumentJournal::~DocumentJournal() = default;
+
+QString DocumentJournal::journalDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("journal");
+}
+
+void DocumentJournal::update(const QString &documentPath,
+                             const QJsonObject &document,
+                             const QVector<Entry> &items,
+                             const ImageStore &images)
+{
+    if (!m_writer) {
+        return;
+    }
+    if (needsSnapshot(documentPath)) {
+        writeSnapshot(documentPath, document, items, images);
+        return;
+    }
+
+    if (document != m_document) {
+        QCborMap record;
+        record.insert(kOp, QStringLiteral("document"));
+        record.insert(QStringLiteral("document"), QCborMap::fromJsonObject(document));
+        appendRecord(frame(record));
+        m_document = document;
+    }
+
+    // 新增的图像先于引用它的元素写出
+    QCborMap newImages;
+    for (const QString &ref : images.refs()) {
+        if (!m_imageRefs.contains(ref)) {
+            newImages.insert(ref, images.data(ref));
+            m_imageRefs.insert(ref);
+        }
+    }
+    if (!newImages.isEmpty()) {
+        QCborMap record;
+        record.insert(kOp, QStringLiteral("images"));
+        record.insert(QStringLiteral("images"), newImages);
+        appendRecord(frame(record));
+    }
+
+    QVector<quint64> order;
+    order.reserve(items.size());
+    QSet<quint64> present;
+    for (const Entry &entry : items) {
+        order.append(entry.id);
+        present.insert(entry.id);
+        const auto it = m_items.constFind(entry.id);
+        if (it != m_items.constEnd() && (!entry.changed || it.value() == entry.item)) {
+            continue;
+        }
+        QCborMap record;
+        record.insert(kOp, QStringLiteral("item"));
+        record.insert(QStringLiteral("id"), qint64(entry.id));
+        record.insert(QStringLiteral("item"), QCborMap::fromJsonObject(entry.item));
+        appendRecord(frame(record));
+        m_items.insert(entry.id, entry.item);
+    }
+
+    for (auto it = m_items.begin(); it != m_items.end();) {
+        if (present.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        QCborMap record;
+        record.insert(kOp, QStringLiteral("remove"));
+        record.insert(QStringLiteral("id"), qint64(it.key()));
+        appendRecord(frame(record));
+        it = m_items.erase(it);
+    }
+
+    if (order != m_order) {
+        QCborMap record;
+        record.insert(kOp, QStringLiteral("order"));
+        record.insert(QStringLiteral("ids"), idArray(order));
+        appendRecord(frame(record));
+        m_order = order;
+    }
+}
+
+bool DocumentJournal::needsSnapshot(const QString &documentPath) const
+{
+    const bool compact = m_appendedRecords > kMaxAppendedRecords
+                         || m_appendedBytes > std::max(m_snapshotBytes, kMinCompactionBytes);
+    return !m_started || compact || documentPath != m_documentPath;
+}
+
+void DocumentJournal::writeSnapshot(const QString &documentPath,
+                                    const QJsonObject &document,
+                                    const QVector<Entry> &items,
+                                    const ImageStore &images)
+{
+    if (m_path.isEmpty()) {
+        const QDir dir(journalDirectory());
+        if (!QDir().mkpath(dir.absolutePath())) {
+            return;
+        }
+        m_path = dir.filePath(QStringLiteral("%1-%2.journal")
+                                  .arg(QCoreApplication::applicationPid())
+                                  .arg(QDateTime::currentMSecsSinceEpoch()));
+        // 会话期间一直持有锁，其他实例据此判断日志不是崩溃遗留
+        m_lock = std::make_unique<QLockFile>(m_path + QStringLiteral(".lock"));
+        m_lock->setStaleLockTime(0);
+        if (!m_lock->tryLock(0)) {
+            m_lock.reset();
+            m_path.clear();
+            return;
+        }
+    }
+
+    m_documentPath = documentPath;
+    m_document = document;
+    m_items.clear();
+    m_order.clear();
+    m_imageRefs.clear();
+
+    QCborArray itemArray;
+    for (const Entry &entry : items) {
+        QCborMap item;
+        item.insert(QStringLiteral("id"), qint64(entry.id));
+        item.insert(QStringLiteral("item"), QCborMap::fromJsonObject(entry.item));
+        itemArray.append(item);
+        m_items.insert(entry.id, entry.item);
+        m_order.append(entry.id);
+    }
+    for (const QString &ref : images.refs()) {
+        m_imageRefs.insert(ref);
+    }
+
+    QCborMap record;
+    record.insert(kOp, QStringLiteral("snapshot"));
+    record.insert(QStringLiteral("path"), documentPath);
+    record.insert(QStringLiteral("document"), QCborMap::fromJsonObject(document));
+    record.insert(QStringLiteral("items"), itemArray);
+    record.insert(QStringLiteral("images"), images.toCbor(false));
+
+    const QByteArray data = kJournalMagic + frame(record);
+    // 快照（含压缩）写临时文件后替换：写入中途崩溃时旧日志仍可恢复
+    m_writer->replace(m_path, data);
+    m_started = true;
+    m_snapshotBytes = data.size();
+    m_appendedBytes = 0;
+    m_appendedRecords = 0;
+}
+
+void DocumentJournal::appendRecord(const QByteArray &record)
+{
+    m_writer->append(m_path, record);
+    m_appendedBytes += record.size();
+    ++m_appendedRecords;
+}
+
+void DocumentJournal::discard()
+{
+    if (m_started && m_writer) {
+        m_writer->remove(m_path);
+    }
+    m_started = false;
+    m_documentPath.clear();
+    m_document = QJsonObject();
+    m_items.clear();
+    m_order.clear();
+    m_imageRefs.clear();
+}
+
+QStringList DocumentJournal::pendingJournals()
+{
+    QStringList journals;
+    const QDir dir(journalDirectory());
+    const QFileInfoList files = dir.entryInfoList({ QStringLiteral("*.journal") }, QDir::Files, QDir::Time);
+    for (const QFileInfo &info : files) {
+        // 能取得锁说明所属进程已不在运行
+        QLockFile lock(info.absoluteFilePath() + QStringLiteral(".lock"));
+        lock.setStaleLockTime(0);
+        if (lock.tryLock(0)) {
+            journals.append(info.absoluteFilePath());
+        }
+    }
+    return journals;
+}
+
+void DocumentJournal::removeJournal(const QString &journalPath)
+{
+    QFile::remove(journalPath);
+    QFile::remove(journalPath + QStringLiteral(".lock"));
+}
+
+bool DocumentJournal::recover(const QString &journalPath,
+                              QString *documentPath,
+                              QJsonObject *root,
+                              ImageStore *images,
+                              QString *errorMessage)
+{
+    QFile file(journalPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    if (!data.startsWith(kJournalMagic)) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("恢复日志已损坏");
+        }
+        return false;
+    }
+
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::BigEndian);
+    in.skipRawData(kJournalMagic.size());
+
+    bool hasSnapshot = false;
+    QJsonObject document;
+    QHash<quint64, QJsonObject> items;
+    QVector<quint64> order;
+    while (!in.atEnd()) {
+        quint32 length = 0;
+        in >> length;
+        // 崩溃时最后一条记录可能只写了一半，到此为止
+        if (in.status() != QDataStream::Ok || length > in.device()->bytesAvailable()) {
+            break;
+        }
+        QByteArray payload(static_cast<int>(length), Qt::Uninitialized);
+        in.readRawData(payload.data(), payload.size());
+        QCborParserError parseError;
+        const QCborMap record = QCborValue::fromCbor(payload, &parseError).toMap();
+        if (parseError.error != QCborError::NoError) {
+            break;
+        }
+
+        const QString op = record.value(kOp).toString();
+        if (op == QLatin1String("snapshot")) {
+            hasSnapshot = true;
+            *documentPath = record.value(QStringLiteral("path")).toString();
+            document = record.value(QStringLiteral("document")).toMap().toJsonObject();
+            items.clear();
+            order.clear();
+            for (const QCborValue &value : record.value(QStringLiteral("items")).toArray()) {
+                const QCborMap entry = value.toMap();
+                const quint64 id = quint64(entry.value(QStringLiteral("id")).toInteger());
+                items.insert(id, entry.value(QStringLiteral("item")).toMap().toJsonObject());
+                order.append(id);
+            }
+            if (images) {
+                images->readCbor(record.value(QStringLiteral("images")).toMap());
+            }
+        } else if (!hasSnapshot) {
+            break;
+        } else if (op == QLatin1String("document")) {
+            document = record.value(QStringLiteral("document")).toMap().toJsonObject();
+        } else if (op == QLatin1String("images")) {
+            if (images) {
+                images->readCbor(record.value(QStringLiteral("images")).toMap());
+            }
+        } else if (op == QLatin1String("item")) {
+            const quint64 id = quint64(record.value(QStringLiteral("id")).toInteger());
+            if (!items.contains(id)) {
+                order.append(id);
+            }
+            items.insert(id, record.value(QStringLiteral("item")).toMap().toJsonObject());
+        } else if (op == QLatin1String("remove")) {
+            const quint64 id = quint64(record.value(QStringLiteral("id")).toInteger());
+            items.remove(id);
+            order.removeAll(id);
+        } else if (op == QLatin1String("order")) {
+            order.clear();
+            for (const QCborValue &value : record.value(QStringLiteral("ids")).toArray()) {
+                order.append(quint64(value.toInteger()));
+            }
+        }
+    }
+
+    if (!hasSnapshot) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("恢复日志已损坏");
+        }
+        return false;
+    }
+
+    QJsonArray itemArray;
+    for (quint64 id : std::as_const(order)) {
+        const auto it = items.constFind(id);
+        if (it != items.constEnd()) {
+            itemArray.append(it.value());
+        }
+    }
+    *root = document;
+    (*root)["items"] = itemArray;
+    return true;
+}
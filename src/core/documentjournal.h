@@ -0,0 +1,86 @@
+#ifndef DOCUMENTJOURNAL_H
+#define DOCUMENTJOURNAL_H
+
+#include "imagestore.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+class DocumentWriter;
+class QLockFile;
+
+/**
+ * @brief 崩溃恢复日志
+ *
+ * 文档有未保存的修改时定期调用 update()：第一次写入完整快照，之后只追加与上次相比
+ * 变化的部分（文档属性、单个元素、删除、顺序、新增图像），自动保存的开销与修改量
+ * 成正比，而不是与文档大小成正比。记录数或体积超过快照时重新写快照。
+ * 日志位于应用数据目录，会话期间持有同名锁文件；程序启动时，锁已失效（所属进程
+ * 不在运行）的日志即为崩溃遗留，可用 recover() 重放。正常保存或关闭时丢弃日志。
+ */
+class DocumentJournal
+{
+public:
+    struct Entry {
+        quint64 id = 0;         // 会话内稳定的元素标识
+        QJsonObject item;       // 与 .lbl "items" 中相同的 JSON
+        bool changed = true;    // false：调用方确认与上次 update() 相同，不再比较
+    };
+
+    explicit DocumentJournal(DocumentWriter *writer);
+    ~DocumentJournal();
+
+    DocumentJournal(const DocumentJournal &) = delete;
+    DocumentJournal &operator=(const DocumentJournal &) = delete;
+
+    // document 为不含 "items"、"images" 的根对象；items 按绘制顺序
+    void update(const QString &documentPath,
+                const QJsonObject &document,
+                const QVector<Entry> &items,
+                const ImageStore &images);
+    // 下次 update() 会写完整快照，此时 items 与 images 须完整
+    bool needsSnapshot(const QString &documentPath) const;
+    // 文档已保存或放弃修改
+    void discard();
+
+    // 崩溃遗留、可以恢复的日志
+    static QStringList pendingJournals();
+    // 重放日志；root 与 LabelDocumentFile::read() 的结果格式相同
+    static bool recover(const QString &journalPath,
+                        QString *documentPath,
+                        QJsonObject *root,
+                        ImageStore *images,
+                        QString *errorMessage = nullptr);
+    static void removeJournal(const QString &journalPath);
+
+private:
+    static QString journalDirectory();
+    void writeSnapshot(const QString &documentPath,
+                       const QJsonObject &document,
+                       const QVector<Entry> &items,
+                       const ImageStore &images);
+    void appendRecord(const QByteArray &record);
+
+    DocumentWriter *m_writer = nullptr;
+    QString m_path;
+    std::unique_ptr<QLockFile> m_lock;
+
+    // 日志中已记录的状态，下次只写出差异
+    bool m_started = false;
+    QString m_documentPath;
+    QJsonObject m_document;
+    QHash<quint64, QJsonObject> m_items;
+    QVector<quint64> m_order;
+    QSet<QString> m_imageRefs;
+    qint64 m_snapshotBytes = 0;
+    qint64 m_appendedBytes = 0;
+    int m_appendedRecords = 0;
+};
+
+#endif // DOCUMENTJOURNAL_H
@@ -0,0 +1,109 @@
+#include "documentloader.h"
+
+#include "imageelement.h"
+#include "labeldocumentfile.h"
+#include "../graphics/imagemipchain.h"
+
+#include <QJsonArray>
+#include <QMetaObject>
+#include <QPointer>
+#include <QSet>
+
+#include <utility>
+
+DocumentLoader::DocumentLoader(QObject *parent)
+    : QObject(parent)
+{
+    // 一次只读一个文档；图像解码另用临时线程池并行
+    m_pool.setMaxThreadCount(1);
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void DocumentLoader::load(const QString &fileName)
+{
+    const int generation = ++m_generation;
+    m_pool.clear();
+
+    QPointer<DocumentLoader> guard(this);
+    m_pool.start([this, guard, generation, fileName]() {
+        if (generation != m_generation) {
+            return;
+        }
+        auto document = std::make_shared<Document>();
+        QString errorMessage;
+        if (!read(fileName, document.get(), &errorMessage)) {
+            document.reset();
+        }
+        // 析构时等待线程池，此处 this 仍然有效；结果排队交给界面线程
+        QMetaObject::invokeMethod(this, [this, guard, generation, fileName, document, errorMessage]() {
+            if (guard && generation == m_generation) {
+                emit loadFinished(fileName, document, errorMessage);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DocumentLoader::cancel()
+{
+    ++m_generation;
+    m_pool.clear();
+}
+
+bool DocumentLoader::read(const QString &fileName, Document *document, QString *errorMessage)
+{
+    QJsonObject root;
+    if (!LabelDocumentFile::read(fileName, &root, &document->images, errorMessage)) {
+        return false;
+    }
+    build(root, document);
+    return true;
+}
+
+void DocumentLoader::build(const QJsonObject &root, Document *document)
+{
+    const QJsonArray items = root.value(QStringLiteral("items")).toArray();
+    document->root = root;
+    document->root.remove(QStringLiteral("items"));
+    document->root.remove(QStringLiteral("images"));
+
+    // 图像在临时线程池中并行解码，同时在本线程继续创建其余元素。
+    // 解码结果按内容哈希进入进程级缓存，界面线程创建 ImageItem 时直接命中
+    QThreadPool decodePool;
+    QSet<QString> scheduled;
+
+    document->elements.clear();
+    document->elements.reserve(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        const QJsonObject itemObject = items.at(i).toObject();
+        auto element = labelelement::createFromJson(itemObject, &document->images);
+        if (!element) {
+            continue;
+        }
+
+        if (auto *imageElement = dynamic_cast<ImageElement*>(element.get())) {
+            // 同一引用只解码一次；旧文档的内嵌图像没有引用，逐个解码
+            const QString ref = itemObject.value(QStringLiteral("imageRef")).toString();
+            const QString key = ref.isEmpty() ? QStringLiteral("#%1").arg(i) : ref;
+            const QByteArray encoded = imageElement->getImageData();
+            if (!encoded.isEmpty() && !scheduled.contains(key)) {
+                scheduled.insert(key);
+                decodePool.start([encoded]() {
+                    ImageMipChain::fromEncoded(encoded);
+                });
+            }
+        }
+
+        Element entry;
+        entry.pos = QPointF(itemObject.value(QStringLiteral("x")).toDouble(),
+                            itemObject.value(QStringLiteral("y")).toDouble());
+        entry.element = std::move(element);
+        document->elements.push_back(std::move(entry));
+    }
+
+    decodePool.waitForDone();
+}
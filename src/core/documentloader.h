@@ -0,0 +1,65 @@
+#ifndef DOCUMENTLOADER_H
+#define DOCUMENTLOADER_H
+
+#include "imagestore.h"
+#include "labelelement.h"
+
+#include <QJsonObject>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 后台文档读取
+ *
+ * 打开文档分为两个阶段。后台阶段读取并解析文件、并行解码其中的图像（结果进入
+ * ImageMipChain 的进程级缓存）、由 JSON 创建元素模型；界面线程只剩创建图形项并
+ * 一次性加入场景（见 LabelScene::addLabelItems），元素较多的模板不再逐项阻塞界面。
+ * 新的 load() 使尚未完成的读取作废。
+ */
+class DocumentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Element {
+        std::unique_ptr<labelelement> element;
+        QPointF pos;
+    };
+
+    struct Document {
+        QJsonObject root;                   // 不含 "items"、"images"
+        ImageStore images;                  // 元素持有其地址，须与元素同生命周期
+        std::vector<Element> elements;      // 按绘制顺序
+    };
+
+    explicit DocumentLoader(QObject *parent = nullptr);
+    ~DocumentLoader() override;
+
+    // 在后台读取；完成后发出 loadFinished
+    void load(const QString &fileName);
+    // 放弃尚未完成的读取（不再发出 loadFinished）
+    void cancel();
+
+    // 在当前线程完成后台阶段
+    static bool read(const QString &fileName, Document *document, QString *errorMessage = nullptr);
+    // root 含 "items"；元素引用的图像须已在 document->images 中
+    static void build(const QJsonObject &root, Document *document);
+
+signals:
+    // 失败时 document 为空
+    void loadFinished(const QString &fileName,
+                      std::shared_ptr<DocumentLoader::Document> document,
+                      const QString &errorMessage);
+
+private:
+    QThreadPool m_pool;
+    std::atomic<int> m_generation{0};
+};
+
+#endif // DOCUMENTLOADER_H
@@ -0,0 +1,82 @@
+#include "documentwriter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QSaveFile>
+
+DocumentWriter::DocumentWriter(QObject *parent)
+    : QObject(parent)
+{
+    // 单线程：同一文件的保存、日志追加按提交顺序完成
+    m_pool.setMaxThreadCount(1);
+}
+
+DocumentWriter::~DocumentWriter()
+{
+    m_pool.waitForDone();
+}
+
+void DocumentWriter::save(const QString &fileName,
+                          const QJsonObject &root,
+                          const ImageStore &images,
+                          const LabelDocumentFile::WriteOptions &options)
+{
+    QPointer<DocumentWriter> guard(this);
+    m_pool.start([this, guard, fileName, root, images, options]() {
+        QString errorMessage;
+        const bool ok = LabelDocumentFile::write(fileName, root, images, options, &errorMessage);
+        if (!ok) {
+            QMutexLocker locker(&m_mutex);
+            m_saveFailed = true;
+        }
+        // 析构时等待线程池，此处 this 仍然有效；结果排队交给界面线程
+        QMetaObject::invokeMethod(this, [guard, fileName, ok, errorMessage]() {
+            if (guard) {
+                emit guard->saveFinished(fileName, ok, errorMessage);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DocumentWriter::append(const QString &fileName, const QByteArray &data)
+{
+    m_pool.start([fileName, data]() {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            file.write(data);
+            file.flush();
+        }
+    });
+}
+
+void DocumentWriter::replace(const QString &fileName, const QByteArray &data)
+{
+    m_pool.start([fileName, data]() {
+        QSaveFile file(fileName);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+            file.commit();
+        }
+    });
+}
+
+void DocumentWriter::remove(const QString &fileName)
+{
+    m_pool.start([fileName]() {
+        if (QFileInfo::exists(fileName)) {
+            QFile::remove(fileName);
+        }
+    });
+}
+
+bool DocumentWriter::waitForDone()
+{
+    m_pool.waitForDone();
+    QMutexLocker locker(&m_mutex);
+    const bool ok = !m_saveFailed;
+    m_saveFailed = false;
+    return ok;
+}
@@ -0,0 +1,53 @@
+#ifndef DOCUMENTWRITER_H
+#define DOCUMENTWRITER_H
+
+#include "imagestore.h"
+#include "labeldocumentfile.h"
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * @brief 后台文档写入
+ *
+ * 保存时界面线程只生成文档快照（根对象与图像表，均为隐式共享的值），
+ * 序列化、压缩与写盘在单线程池中按提交顺序进行，经 QSaveFile 替换原文件，
+ * 写入中途崩溃不会留下半个文件。恢复日志的追加、删除也在同一队列中，
+ * 因此与保存的先后关系保持不变。
+ */
+class DocumentWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentWriter(QObject *parent = nullptr);
+    ~DocumentWriter() override;
+
+    // 在后台保存；完成后发出 saveFinished
+    void save(const QString &fileName,
+              const QJsonObject &root,
+              const ImageStore &images,
+              const LabelDocumentFile::WriteOptions &options);
+
+    // 追加到文件末尾
+    void append(const QString &fileName, const QByteArray &data);
+    // 经 QSaveFile 整体替换文件内容，提交前原文件保持完整
+    void replace(const QString &fileName, const QByteArray &data);
+    void remove(const QString &fileName);
+
+    // 等待队列中的任务完成；自上次调用以来有保存失败时返回 false
+    bool waitForDone();
+
+signals:
+    void saveFinished(const QString &fileName, bool ok, const QString &errorMessage);
+
+private:
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    bool m_saveFailed = false;
+};
+
+#endif // DOCUMENTWRITER_H
@@ -0,0 +1,117 @@
+#include "elementregistry.h"
+
+#include "arrowelement.h"
+#include "barcodeelement.h"
+#include "circleelement.h"
+#include "imageelement.h"
+#include "lineelement.h"
+#include "polygonelement.h"
+#include "qrcodeelement.h"
+#include "rectangleelement.h"
+#include "starelement.h"
+#include "tableelement.h"
+#include "textelement.h"
+#include "../graphics/arrowitem.h"
+#include "../graphics/barcodeitem.h"
+#include "../graphics/circleitem.h"
+#include "../graphics/imageitem.h"
+#include "../graphics/lineitem.h"
+#include "../graphics/polygonitem.h"
+#include "../graphics/qrcodeitem.h"
+#include "../graphics/rectangleitem.h"
+#include "../graphics/staritem.h"
+#include "../graphics/tableitem.h"
+#include "../graphics/textitem.h"
+
+namespace {
+
+// 元素类有默认构造函数与以图形项为参数的构造函数时的登记项
+template <typename Element, typename Item>
+ElementRegistry::Entry makeEntry(const QStringList &typeNames)
+{
+    ElementRegistry::Entry entry;
+    entry.itemType = Item::Type;
+    entry.typeNames = typeNames;
+    entry.create = [](const QString &) -> std::unique_ptr<labelelement> {
+        return std::make_unique<Element>();
+    };
+    entry.wrap = [](QGraphicsItem *item) -> std::unique_ptr<labelelement> {
+        return std::make_unique<Element>(static_cast<Item*>(item));
+    };
+    return entry;
+}
+
+} // namespace
+
+ElementRegistry &ElementRegistry::instance()
+{
+    static ElementRegistry registry;
+    return registry;
+}
+
+ElementRegistry::ElementRegistry()
+{
+    registerBuiltinTypes();
+}
+
+void ElementRegistry::registerBuiltinTypes()
+{
+    registerType(makeEntry<QRCodeElement, QRCodeItem>({ QStringLiteral("qrcode") }));
+    registerType(makeEntry<BarcodeElement, BarcodeItem>({ QStringLiteral("barcode") }));
+    registerType(makeEntry<TextElement, TextItem>({ QStringLiteral("text") }));
+    registerType(makeEntry<ImageElement, ImageItem>({ QStringLiteral("image") }));
+    registerType(makeEntry<LineElement, LineItem>({ QStringLiteral("line") }));
+    registerType(makeEntry<RectangleElement, RectangleItem>({ QStringLiteral("rectangle") }));
+    registerType(makeEntry<StarElement, StarItem>({ QStringLiteral("star") }));
+    registerType(makeEntry<ArrowElement, ArrowItem>({ QStringLiteral("arrow") }));
+    registerType(makeEntry<PolygonElement, PolygonItem>({ QStringLiteral("polygon") }));
+    registerType(makeEntry<TableElement, TableItem>({ QStringLiteral("table") }));
+
+    // 圆与椭圆共用 CircleItem，由类型名区分
+    Entry circle = makeEntry<CircleElement, CircleItem>({ QStringLiteral("circle"), QStringLiteral("ellipse") });
+    circle.create = [](const QString &typeName) -> std::unique_ptr<labelelement> {
+        auto element = std::make_unique<CircleElement>();
+        if (typeName.compare(QLatin1String("ellipse"), Qt::CaseInsensitive) == 0) {
+            element->setIsCircle(false);
+        }
+        return element;
+    };
+    registerType(circle);
+}
+
+void ElementRegistry::registerType(const Entry &entry)
+{
+    m_entries.insert(entry.itemType, entry);
+    for (const QString &name : entry.typeNames) {
+        m_typesByName.insert(name.toLower(), entry.itemType);
+    }
+}
+
+const ElementRegistry::Entry *ElementRegistry::entryForItem(const QGraphicsItem *item) const
+{
+    if (!item) {
+        return nullptr;
+    }
+    const auto it = m_entries.constFind(item->type());
+    return it != m_entries.constEnd() ? &it.value() : nullptr;
+}
+
+std::unique_ptr<labelelement> ElementRegistry::create(const QString &typeName) const
+{
+    const QString normalized = typeName.trimmed();
+    const auto type = m_typesByName.constFind(normalized.toLower());
+    if (type == m_typesByName.constEnd()) {
+        return nullptr;
+    }
+    const auto entry = m_entries.constFind(type.value());
+    if (entry == m_entries.constEnd() || !entry->create) {
+        return nullptr;
+    }
+    return entry->create(normalized);
+}
+
+std::unique_ptr<labelelement> ElementRegistry::wrap(QGraphicsItem *item) const
+{
+    const Entry *entry = entryForItem(item);
+    return entry && entry->wrap ? entry->wrap(item) : nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef ELEMENTREGISTRY_H
+#define ELEMENTREGISTRY_H
+
+#include "labelelement.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief 元素类型注册表
+ *
+ * 按图形项类型标识（QGraphicsItem::type()，见 LabelItemType）与 JSON "itemType"
+ * 登记每种元素的工厂：create 创建空元素（读取文档时再 setData），wrap 包装场景中
+ * 已有的图形项（保存、打印、导出时经其 toJson()/paintContent() 使用）。
+ * 整个文档的操作对每个图形项只查一次表，不再逐个 dynamic_cast；
+ * 新的元素类型在此登记即可被读写、打印，无需改动 MainWindow。
+ * 内置类型在首次使用时登记；其他类型应在启动阶段（界面线程）登记，
+ * 之后注册表只读，可在工作线程中使用。
+ */
+class ElementRegistry
+{
+public:
+    struct Entry {
+        int itemType = 0;           // 图形项的 type()
+        QStringList typeNames;      // JSON "itemType"（不区分大小写）
+        // 创建空元素；typeName 为文档中的类型名（同一元素可对应多个名称）
+        std::function<std::unique_ptr<labelelement>(const QString &typeName)> create;
+        // 包装已有图形项，item->type() 与 itemType 相同
+        std::function<std::unique_ptr<labelelement>(QGraphicsItem *item)> wrap;
+    };
+
+    static ElementRegistry &instance();
+
+    void registerType(const Entry &entry);
+
+    const Entry *entryForItem(const QGraphicsItem *item) const;
+    // 是否为已登记的元素图形项（背景、选择框、编辑器等返回 false）
+    bool isElementItem(const QGraphicsItem *item) const { return entryForItem(item) != nullptr; }
+
+    std::unique_ptr<labelelement> create(const QString &typeName) const;
+    std::unique_ptr<labelelement> wrap(QGraphicsItem *item) const;
+
+private:
+    ElementRegistry();
+    void registerBuiltinTypes();
+
+    QHash<int, Entry> m_entries;            // 图形项类型 -> 登记项
+    QHash<QString, int> m_typesByName;      // 小写类型名 -> 图形项类型
+};
+
+#endif // ELEMENTREGISTRY_H
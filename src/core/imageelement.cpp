@@ -1,5 +1,9 @@
 #include "imageelement.h"
+#include "imagestore.h"
+#include "datasource.h"
+#include "../graphics/recordimageprovider.h"
 #include <QGraphicsScene>
+#include <QStringList>
 
 ImageElement::ImageElement(ImageItem* item) : m_item(item) {
     if (item) {
@@ -36,16 +40,35 @@ QGraphicsItem* ImageElement::getItem() const {
     return m_item;
 }
 
+void ImageElement::paintContent(QPainter* painter) const {
+    if (m_item) {
+        m_item->paintContent(painter);
+    }
+}
+
 QString ImageElement::getType() const {
     return "image";
 }
 
 QJsonObject ImageElement::getData() const {
     QJsonObject data;
-    
-    // 将图像数据编码为Base64字符串
-    data["imageData"] = QString::fromLatin1(m_imageData.toBase64());
+
+    // 按内容哈希引用图像；图形项的缩放链已算过哈希，直接沿用
+    if (!m_imageData.isEmpty()) {
+        const QByteArray hash = m_item ? m_item->imageHash() : QByteArray();
+        if (m_imageStore) {
+            data["imageRef"] = m_imageStore->add(m_imageData, hash);
+        } else {
+            data["imageRef"] = hash.isEmpty() ? ImageStore::refOf(m_imageData)
+                                              : QString::fromLatin1(hash.toHex());
+            // 没有文档表时（单独序列化元素）仍内嵌Base64数据
+            data["imageData"] = QString::fromLatin1(m_imageData.toBase64());
+        }
+    }
     data["imagePath"] = m_imagePath;
+    if (!m_recordImageDirectory.isEmpty()) {
+        data["recordImageDir"] = m_recordImageDirectory;
+    }
     data["width"] = m_size.width();
     data["height"] = m_size.height();
     data["keepAspectRatio"] = m_keepAspectRatio;
@@ -55,11 +78,19 @@ QJsonObject ImageElement::getData() const {
 }
 
 void ImageElement::setData(const QJsonObject& data) {
-    // 从Base64字符串解码图像数据
-    QString base64Data = data["imageData"].toString();
-    m_imageData = QByteArray::fromBase64(base64Data.toLatin1());
+    // 优先按引用从文档图像表、共享素材目录取数据；旧文档为内嵌的Base64字符串
+    m_imageData.clear();
+    const QString ref = data["imageRef"].toString();
+    if (!ref.isEmpty()) {
+        m_imageData = m_imageStore ? m_imageStore->data(ref) : ImageStore::assetData(ref);
+    }
+    if (m_imageData.isEmpty()) {
+        QString base64Data = data["imageData"].toString();
+        m_imageData = QByteArray::fromBase64(base64Data.toLatin1());
+    }
     
     m_imagePath = data["imagePath"].toString();
+    m_recordImageDirectory = data["recordImageDir"].toString();
     m_size = QSizeF(data["width"].toDouble(), data["height"].toDouble());
     m_keepAspectRatio = data["keepAspectRatio"].toBool(true);
     m_opacity = data["opacity"].toDouble(1.0);
@@ -141,9 +172,59 @@ void ImageElement::setOpacity(qreal opacity) {
     }
 }
 
+QString ImageElement::getRecordImageDirectory() const {
+    return m_recordImageDirectory;
+}
+
+void ImageElement::setRecordImageDirectory(const QString& directory) {
+    m_recordImageDirectory = directory;
+    if (m_item) {
+        m_item->setRecordImageDirectory(directory);
+    }
+}
+
+QString ImageElement::recordImagePath(int index) const {
+    auto source = dataSource();
+    if (!isDataSourceEnabled() || !source || index < 0 || index >= source->count()) {
+        return QString();
+    }
+
+    // 先查元素指定的目录，再查共享素材目录（取值也可以是素材引用）
+    QStringList directories;
+    if (!m_recordImageDirectory.isEmpty()) {
+        directories << m_recordImageDirectory;
+    }
+    directories << ImageStore::assetDirectory();
+    return RecordImageProvider::instance().resolve(source->at(index), directories);
+}
+
+bool ImageElement::applyDataSourceRecord(int index) {
+    auto source = dataSource();
+    if (!isDataSourceEnabled() || !source || !m_item) {
+        return false;
+    }
+    if (index < 0 || index >= source->count()) {
+        return false;
+    }
+
+    // 找不到图像文件的记录不绘制图像，不中断整个批量任务
+    m_item->setRecordImagePath(recordImagePath(index));
+    return true;
+}
+
+void ImageElement::restoreOriginalData() {
+    if (m_item) {
+        m_item->clearRecordImage();
+    }
+}
+
 void ImageElement::addToScene(QGraphicsScene* scene) {
     if (!scene) return;
 
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* ImageElement::ensureItem() {
     // 如果 item 还不存在，创建一个新的
     if (!m_item) {
         if (!m_imageData.isEmpty()) {
@@ -158,9 +239,10 @@ void ImageElement::addToScene(QGraphicsScene* scene) {
         m_item->setSize(m_size);
         m_item->setKeepAspectRatio(m_keepAspectRatio);
         m_item->setOpacity(m_opacity);
+        m_item->setRecordImageDirectory(m_recordImageDirectory);
     }
 
-    scene->addItem(m_item);
+    return m_item;
 }
 
 void ImageElement::syncFromItem() {
@@ -171,6 +253,7 @@ void ImageElement::syncFromItem() {
     m_size = m_item->size();
     m_keepAspectRatio = m_item->keepAspectRatio();
     m_opacity = m_item->opacity();
+    m_recordImageDirectory = m_item->recordImageDirectory();
 }
 
 void ImageElement::syncToItem() {
@@ -185,4 +268,5 @@ void ImageElement::syncToItem() {
     m_item->setSize(m_size);
     m_item->setKeepAspectRatio(m_keepAspectRatio);
     m_item->setOpacity(m_opacity);
+    m_item->setRecordImageDirectory(m_recordImageDirectory);
 }
@@ -9,6 +9,8 @@
 #include <QByteArray>
 #include <memory>
 
+class ImageStore;
+
 class ImageElement : public labelelement {
 public:
     // 构造函数
@@ -25,6 +27,7 @@ public:
 
     // 实现基类的虚函数
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     QString getType() const override;
     QJsonObject getData() const override;
     void setData(const QJsonObject& data) override;
@@ -47,8 +50,23 @@ public:
     qreal getOpacity() const;
     void setOpacity(qreal opacity);
 
+    // 按记录取图的目录（数据源取值为相对路径或键名时使用），空为共享素材目录
+    QString getRecordImageDirectory() const;
+    void setRecordImageDirectory(const QString& directory);
+
+    // 数据源绑定：取值为图像文件路径或键名
+    bool applyDataSourceRecord(int index);
+    void restoreOriginalData();
+    // 第 index 条记录的图像文件（不修改当前状态），供批量预取使用；无法解析时为空
+    QString recordImagePath(int index) const;
+
+    // 文档级图像表：设置后 getData 只写 "imageRef"，编码数据登记到表中；
+    // setData 按 "imageRef" 从表（及共享素材目录）取数据。未设置时 JSON 自带完整数据
+    void setImageStore(ImageStore* store) override { m_imageStore = store; }
+
     // 创建 ImageItem 并添加到场景
     void addToScene(QGraphicsScene* scene) override;
+    QGraphicsItem* ensureItem() override;
 
 private:
     ImageItem* m_item = nullptr;
@@ -57,6 +75,8 @@ private:
     QSizeF m_size;
     bool m_keepAspectRatio = true;
     qreal m_opacity = 1.0;
+    QString m_recordImageDirectory;
+    ImageStore* m_imageStore = nullptr;
 
     // 私有辅助方法
     void syncFromItem();
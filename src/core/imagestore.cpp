@@ -0,0 +1,182 @@
+#include "imagestore.h"
+
+#include "../graphics/imagemipchain.h"
+
+#include <QCborValue>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+
+namespace {
+
+// 引用同时用作素材文件名，只接受 64 位十六进制，避免路径穿越
+bool isValidRef(const QString &ref)
+{
+    if (ref.size() != 64) {
+        return false;
+    }
+    for (const QChar ch : ref) {
+        const ushort c = ch.unicode();
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString templatesDirectory()
+{
+    return QDir(QCoreApplication::applicationDirPath()).filePath("templates");
+}
+
+} // namespace
+
+QString ImageStore::add(const QByteArray &encoded, const QByteArray &contentHash)
+{
+    if (encoded.isEmpty()) {
+        return QString();
+    }
+    const QString ref = contentHash.isEmpty() ? refOf(encoded)
+                                              : QString::fromLatin1(contentHash.toHex());
+    m_images.insert(ref, encoded);
+    return ref;
+}
+
+QByteArray ImageStore::data(const QString &ref) const
+{
+    const auto it = m_images.constFind(ref);
+    if (it != m_images.constEnd()) {
+        return it.value();
+    }
+    return assetData(ref);
+}
+
+void ImageStore::readJson(const QJsonObject &table)
+{
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        if (!isValidRef(it.key())) {
+            continue;
+        }
+        const QByteArray encoded = QByteArray::fromBase64(it.value().toString().toLatin1());
+        if (!encoded.isEmpty()) {
+            m_images.insert(it.key(), encoded);
+        }
+    }
+}
+
+QJsonObject ImageStore::toJson(bool useSharedAssets) const
+{
+    QJsonObject table;
+    const QHash<QString, QByteArray> images = embeddedImages(useSharedAssets);
+    for (auto it = images.constBegin(); it != images.constEnd(); ++it) {
+        table[it.key()] = QString::fromLatin1(it.value().toBase64());
+    }
+    return table;
+}
+
+void ImageStore::readCbor(const QCborMap &table)
+{
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        const QString ref = it.key().toString();
+        const QByteArray encoded = it.value().toByteArray();
+        if (isValidRef(ref) && !encoded.isEmpty()) {
+            m_images.insert(ref, encoded);
+        }
+    }
+}
+
+QCborMap ImageStore::toCbor(bool useSharedAssets) const
+{
+    QCborMap table;
+    const QHash<QString, QByteArray> images = embeddedImages(useSharedAssets);
+    for (auto it = images.constBegin(); it != images.constEnd(); ++it) {
+        table.insert(it.key(), it.value());
+    }
+    return table;
+}
+
+QHash<QString, QByteArray> ImageStore::embeddedImages(bool useSharedAssets) const
+{
+    if (!useSharedAssets) {
+        return m_images;
+    }
+    QHash<QString, QByteArray> images;
+    for (auto it = m_images.constBegin(); it != m_images.constEnd(); ++it) {
+        // 素材目录写入失败时退回内嵌，文档仍然完整
+        if (!publishAsset(it.key(), it.value())) {
+            images.insert(it.key(), it.value());
+        }
+    }
+    return images;
+}
+
+QString ImageStore::refOf(const QByteArray &encoded)
+{
+    return QString::fromLatin1(ImageMipChain::hashOf(encoded).toHex());
+}
+
+QString ImageStore::assetDirectory()
+{
+    return QDir(templatesDirectory()).filePath("assets");
+}
+
+bool ImageStore::usesSharedAssets(const QString &documentPath)
+{
+    if (documentPath.isEmpty()) {
+        return false;
+    }
+    const QString base = QDir::cleanPath(QFileInfo(templatesDirectory()).absoluteFilePath()) + QLatin1Char('/');
+    const QString path = QDir::cleanPath(QFileInfo(documentPath).absoluteFilePath());
+    return path.startsWith(base, Qt::CaseInsensitive);
+}
+
+QByteArray ImageStore::assetData(const QString &ref)
+{
+    if (!isValidRef(ref)) {
+        return QByteArray();
+    }
+    QFile file(QDir(assetDirectory()).filePath(ref));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    const QByteArray encoded = file.readAll();
+    // 文件名即内容哈希，损坏或被替换的素材按缺失处理
+    return refOf(encoded) == ref ? encoded : QByteArray();
+}
+
+bool ImageStore::publishAsset(const QString &ref, const QByteArray &encoded, QString *errorMessage)
+{
+    if (!isValidRef(ref) || encoded.isEmpty()) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无效的图像引用");
+        }
+        return false;
+    }
+
+    const QDir dir(assetDirectory());
+    const QString filePath = dir.filePath(ref);
+    const QFileInfo info(filePath);
+    // 长度一致时仍需校验哈希：截断后补齐或被替换的文件按损坏处理并重写
+    if (info.exists() && info.size() == encoded.size() && !assetData(ref).isEmpty()) {
+        return true;
+    }
+    if (!QDir().mkpath(dir.absolutePath())) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无法创建素材目录 %1").arg(QDir::toNativeSeparators(dir.absolutePath()));
+        }
+        return false;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(encoded) != encoded.size() || !file.commit()) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无法写入素材文件 %1:\n%2")
+                                .arg(QDir::toNativeSeparators(filePath), file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef IMAGESTORE_H
+#define IMAGESTORE_H
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief 文档级图像表
+ *
+ * .lbl 中的图像元素只保存 "imageRef"（编码数据 SHA-256 的十六进制串），编码数据按哈希
+ * 在文档根对象的 "images" 表中各存一份，多个元素使用同一图像时不再重复。
+ * 模板目录下另有共享素材目录（templates/assets/<哈希>），保存到模板目录中的文档
+ * 把图像放入素材目录后只写引用，多个模板共用同一份文件。
+ * 解析引用时先查文档表，再查共享素材目录。
+ */
+class ImageStore
+{
+public:
+    // 登记编码数据并返回引用；contentHash 为已知的原始 SHA-256（可省去重复计算）
+    QString add(const QByteArray &encoded, const QByteArray &contentHash = QByteArray());
+    // 按引用取编码数据：文档表、共享素材目录，均无时返回空
+    QByteArray data(const QString &ref) const;
+
+    bool isEmpty() const { return m_images.isEmpty(); }
+    // 文档表中的全部引用（不含只在共享素材目录中的）
+    QList<QString> refs() const { return m_images.keys(); }
+
+    // 读取文档根对象的 "images" 表
+    void readJson(const QJsonObject &table);
+    // 生成 "images" 表；useSharedAssets 为 true 时图像写入共享素材目录，表中不再保存
+    QJsonObject toJson(bool useSharedAssets) const;
+    // 二进制文档中的图像表：引用 -> 原生字节串
+    void readCbor(const QCborMap &table);
+    QCborMap toCbor(bool useSharedAssets) const;
+
+    // 编码数据对应的引用（SHA-256 十六进制）
+    static QString refOf(const QByteArray &encoded);
+
+    // 共享素材目录
+    static QString assetDirectory();
+    // documentPath 位于模板目录中时，保存时使用共享素材目录
+    static bool usesSharedAssets(const QString &documentPath);
+    static QByteArray assetData(const QString &ref);
+    // 放入共享素材目录（内容相同的文件已存在时直接成功）
+    static bool publishAsset(const QString &ref, const QByteArray &encoded, QString *errorMessage = nullptr);
+
+private:
+    // 需要内嵌到文档中的图像（共享素材目录写入失败的也在其中）
+    QHash<QString, QByteArray> embeddedImages(bool useSharedAssets) const;
+
+    QHash<QString, QByteArray> m_images;
+};
+
+#endif // IMAGESTORE_H
@@ -0,0 +1,396 @@
+#include "labeldocumentfile.h"
+
+#include "imagestore.h"
+
+#include <QBuffer>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QList>
+#include <QObject>
+#include <QSaveFile>
+
+namespace {
+
+// 与 PNG 相同的构造：文本方式传输造成的换行转换、截断可被发现
+const QByteArray kMagic("SLBL\r\n\x1a\n", 8);
+constexpr quint16 kContainerVersion = 1;
+
+constexpr quint32 kSectionCompressed = 0x1;
+
+const QByteArray kHeaderTag("HEAD");
+const QByteArray kItemsTag("ITEM");
+const QByteArray kImagesTag("IMGS");
+
+struct Section {
+    QByteArray tag;
+    quint32 flags = 0;
+    QByteArray payload;
+};
+
+void setError(QString *errorMessage, const QString &message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+QVector<LabelDocumentFile::ElementSummary> summarize(const QJsonArray &items)
+{
+    QVector<LabelDocumentFile::ElementSummary> elements;
+    elements.reserve(items.size());
+    for (const QJsonValue &value : items) {
+        const QJsonObject item = value.toObject();
+        elements.append({ item["itemType"].toString(),
+                          QPointF(item["x"].toDouble(), item["y"].toDouble()) });
+    }
+    return elements;
+}
+
+// 根对象中除元素与图像之外的部分（版本、时间、标签尺寸等）
+void fillHeader(const QJsonObject &document, LabelDocumentFile::Header *header)
+{
+    const QJsonObject labelInfo = document["labelInfo"].toObject();
+    header->version = document["version"].toString();
+    header->labelSizeMM = QSizeF(labelInfo["width"].toDouble(), labelInfo["height"].toDouble());
+    header->created = QDateTime::fromString(document["createTime"].toString(), Qt::ISODate);
+    header->modified = QDateTime::fromString(document["lastModified"].toString(), Qt::ISODate);
+}
+
+bool readPreamble(QDataStream &in, quint16 *sectionCount, QString *errorMessage)
+{
+    QByteArray magic(kMagic.size(), Qt::Uninitialized);
+    quint16 version = 0;
+    if (in.readRawData(magic.data(), magic.size()) != magic.size() || magic != kMagic) {
+        setError(errorMessage, QObject::tr("不是有效的标签文件"));
+        return false;
+    }
+    in >> version >> *sectionCount;
+    if (in.status() != QDataStream::Ok) {
+        setError(errorMessage, QObject::tr("标签文件已损坏"));
+        return false;
+    }
+    if (version > kContainerVersion) {
+        setError(errorMessage, QObject::tr("标签文件由更新版本的程序创建，无法读取"));
+        return false;
+    }
+    return true;
+}
+
+// 只读取 wanted 中各节的内容，其余节跳过，只返回标签
+bool readSection(QDataStream &in, const QList<QByteArray> &wanted, Section *section, QString *errorMessage)
+{
+    section->tag = QByteArray(4, Qt::Uninitialized);
+    quint32 length = 0;
+    if (in.readRawData(section->tag.data(), 4) != 4) {
+        setError(errorMessage, QObject::tr("标签文件已损坏"));
+        return false;
+    }
+    in >> section->flags >> length;
+    // 先核对长度，损坏的文件不会导致巨大的分配
+    if (in.status() != QDataStream::Ok || length > in.device()->bytesAvailable()) {
+        setError(errorMessage, QObject::tr("标签文件已损坏"));
+        return false;
+    }
+    if (!wanted.contains(section->tag)) {
+        section->payload.clear();
+        return in.skipRawData(static_cast<int>(length)) == static_cast<int>(length);
+    }
+    section->payload = QByteArray(static_cast<int>(length), Qt::Uninitialized);
+    if (in.readRawData(section->payload.data(), static_cast<int>(length)) != static_cast<int>(length)) {
+        setError(errorMessage, QObject::tr("标签文件已损坏"));
+        return false;
+    }
+    return true;
+}
+
+bool decodeSection(const Section &section, QCborValue *value, QString *errorMessage)
+{
+    QByteArray payload = section.payload;
+    if (section.flags & kSectionCompressed) {
+        payload = qUncompress(payload);
+        if (payload.isEmpty() && !section.payload.isEmpty()) {
+            setError(errorMessage, QObject::tr("标签文件已损坏"));
+            return false;
+        }
+    }
+    QCborParserError error;
+    *value = QCborValue::fromCbor(payload, &error);
+    if (error.error != QCborError::NoError) {
+        setError(errorMessage, QObject::tr("标签文件已损坏：%1").arg(error.errorString()));
+        return false;
+    }
+    return true;
+}
+
+bool decodeHeader(const QCborMap &map, QJsonObject *document, LabelDocumentFile::Header *header)
+{
+    *document = map.value(QStringLiteral("document")).toMap().toJsonObject();
+    if (!header) {
+        return true;
+    }
+    fillHeader(*document, header);
+    header->format = LabelDocumentFile::Format::Binary;
+    header->thumbnail = QImage::fromData(map.value(QStringLiteral("thumbnail")).toByteArray(), "PNG");
+    header->elements.clear();
+    const QCborArray elements = map.value(QStringLiteral("elements")).toArray();
+    header->elements.reserve(static_cast<int>(elements.size()));
+    for (const QCborValue &value : elements) {
+        const QCborMap element = value.toMap();
+        header->elements.append({ element.value(QStringLiteral("itemType")).toString(),
+                                  QPointF(element.value(QStringLiteral("x")).toDouble(),
+                                          element.value(QStringLiteral("y")).toDouble()) });
+    }
+    return true;
+}
+
+bool readJsonDocument(const QByteArray &data, QJsonObject *root, QString *errorMessage)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        setError(errorMessage, QObject::tr("文件格式无效：%1").arg(error.errorString()));
+        return false;
+    }
+    *root = document.object();
+    return true;
+}
+
+QByteArray encodePng(const QImage &image)
+{
+    if (image.isNull()) {
+        return QByteArray();
+    }
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes;
+}
+
+void writeSection(QDataStream &out, const QByteArray &tag, const QByteArray &payload, bool compress)
+{
+    const QByteArray data = compress ? qCompress(payload) : payload;
+    out.writeRawData(tag.constData(), 4);
+    out << quint32(compress ? kSectionCompressed : 0) << quint32(data.size());
+    out.writeRawData(data.constData(), data.size());
+}
+
+} // namespace
+
+bool LabelDocumentFile::isBinary(const QByteArray &data)
+{
+    return data.startsWith(kMagic);
+}
+
+LabelDocumentFile::Format LabelDocumentFile::formatForFileName(const QString &fileName)
+{
+    return QFileInfo(fileName).suffix().compare(QLatin1String("json"), Qt::CaseInsensitive) == 0
+               ? Format::Json
+               : Format::Binary;
+}
+
+bool LabelDocumentFile::readHeader(const QString &fileName, Header *header, QString *errorMessage)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+
+    if (!isBinary(file.peek(kMagic.size()))) {
+        // 旧版 JSON 文档只能整体解析
+        QJsonObject root;
+        if (!readJsonDocument(file.readAll(), &root, errorMessage)) {
+            return false;
+        }
+        *header = Header();
+        header->format = Format::Json;
+        fillHeader(root, header);
+        header->elements = summarize(root["items"].toArray());
+        return true;
+    }
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::BigEndian);
+    quint16 sectionCount = 0;
+    if (!readPreamble(in, &sectionCount, errorMessage)) {
+        return false;
+    }
+    for (quint16 i = 0; i < sectionCount; ++i) {
+        Section section;
+        // 文档头在第一节，正文只跳过不读
+        if (!readSection(in, { kHeaderTag }, &section, errorMessage)) {
+            return false;
+        }
+        if (section.tag != kHeaderTag) {
+            continue;
+        }
+        QCborValue value;
+        QJsonObject document;
+        if (!decodeSection(section, &value, errorMessage)) {
+            return false;
+        }
+        *header = Header();
+        return decodeHeader(value.toMap(), &document, header);
+    }
+    setError(errorMessage, QObject::tr("标签文件缺少文档头"));
+    return false;
+}
+
+bool LabelDocumentFile::read(const QString &fileName,
+                             QJsonObject *root,
+                             ImageStore *images,
+                             QString *errorMessage,
+                             Header *header)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+    return readData(file.readAll(), root, images, errorMessage, header);
+}
+
+bool LabelDocumentFile::readData(const QByteArray &data,
+                                 QJsonObject *root,
+                                 ImageStore *images,
+                                 QString *errorMessage,
+                                 Header *header)
+{
+    if (!isBinary(data)) {
+        if (!readJsonDocument(data, root, errorMessage)) {
+            return false;
+        }
+        if (images) {
+            images->readJson((*root)["images"].toObject());
+        }
+        root->remove(QStringLiteral("images"));
+        if (header) {
+            *header = Header();
+            header->format = Format::Json;
+            fillHeader(*root, header);
+            header->elements = summarize((*root)["items"].toArray());
+        }
+        return true;
+    }
+
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::BigEndian);
+    quint16 sectionCount = 0;
+    if (!readPreamble(in, &sectionCount, errorMessage)) {
+        return false;
+    }
+
+    // 未知的节来自更新的程序，跳过
+    QList<QByteArray> wanted { kHeaderTag, kItemsTag };
+    if (images) {
+        wanted.append(kImagesTag);
+    }
+
+    bool hasHeader = false;
+    QJsonObject document;
+    QJsonArray items;
+    for (quint16 i = 0; i < sectionCount; ++i) {
+        Section section;
+        if (!readSection(in, wanted, &section, errorMessage)) {
+            return false;
+        }
+        if (!wanted.contains(section.tag)) {
+            continue;
+        }
+        QCborValue value;
+        if (!decodeSection(section, &value, errorMessage)) {
+            return false;
+        }
+        if (section.tag == kHeaderTag) {
+            if (header) {
+                *header = Header();
+            }
+            hasHeader = decodeHeader(value.toMap(), &document, header);
+        } else if (section.tag == kItemsTag) {
+            items = value.toArray().toJsonArray();
+        } else {
+            images->readCbor(value.toMap());
+        }
+    }
+    if (!hasHeader) {
+        setError(errorMessage, QObject::tr("标签文件缺少文档头"));
+        return false;
+    }
+
+    *root = document;
+    (*root)["items"] = items;
+    return true;
+}
+
+QByteArray LabelDocumentFile::serialize(const QJsonObject &root, const ImageStore &images, const WriteOptions &options)
+{
+    if (options.format == Format::Json) {
+        QJsonObject document = root;
+        document.remove(QStringLiteral("images"));
+        if (!images.isEmpty()) {
+            document["images"] = images.toJson(options.useSharedAssets);
+        }
+        return QJsonDocument(document).toJson(QJsonDocument::Indented);
+    }
+
+    const QJsonArray items = root["items"].toArray();
+    QJsonObject document = root;
+    document.remove(QStringLiteral("items"));
+    document.remove(QStringLiteral("images"));
+
+    // 元素索引：不解析正文即可知道文档中有哪些元素及其位置
+    QCborArray elements;
+    for (const ElementSummary &element : summarize(items)) {
+        QCborMap entry;
+        entry.insert(QStringLiteral("itemType"), element.type);
+        entry.insert(QStringLiteral("x"), element.pos.x());
+        entry.insert(QStringLiteral("y"), element.pos.y());
+        elements.append(entry);
+    }
+
+    QCborMap headerMap;
+    headerMap.insert(QStringLiteral("document"), QCborMap::fromJsonObject(document));
+    headerMap.insert(QStringLiteral("elements"), elements);
+    const QByteArray thumbnail = encodePng(options.thumbnail);
+    if (!thumbnail.isEmpty()) {
+        headerMap.insert(QStringLiteral("thumbnail"), thumbnail);
+    }
+
+    const QCborMap imageTable = images.toCbor(options.useSharedAssets);
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::BigEndian);
+    out.writeRawData(kMagic.constData(), kMagic.size());
+    out << kContainerVersion << quint16(imageTable.isEmpty() ? 2 : 3);
+    writeSection(out, kHeaderTag, QCborValue(headerMap).toCbor(), false);
+    writeSection(out, kItemsTag, QCborArray::fromJsonArray(items).toCborValue().toCbor(), options.compress);
+    if (!imageTable.isEmpty()) {
+        writeSection(out, kImagesTag, QCborValue(imageTable).toCbor(), false);
+    }
+    return data;
+}
+
+bool LabelDocumentFile::write(const QString &fileName,
+                              const QJsonObject &root,
+                              const ImageStore &images,
+                              const WriteOptions &options,
+                              QString *errorMessage)
+{
+    const QByteArray data = serialize(root, images, options);
+
+    // 写入临时文件后替换，写入中途失败不会破坏原文件
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef LABELDOCUMENTFILE_H
+#define LABELDOCUMENTFILE_H
+
+#include <QDateTime>
+#include <QImage>
+#include <QJsonObject>
+#include <QPointF>
+#include <QSizeF>
+#include <QString>
+#include <QVector>
+
+class ImageStore;
+
+/**
+ * @brief .lbl 文档的读写
+ *
+ * 默认写为分节的二进制容器：8 字节魔数、容器版本与节数，随后每节为
+ * 4 字节标签 + 标志 + 长度 + 内容，内容为 CBOR：
+ *  - HEAD：标签尺寸、时间、缩略图（PNG 字节串）与元素索引（类型、位置），总在第一节，
+ *          模板列表、索引等只需读这一节；
+ *  - ITEM：元素数组，与 JSON 格式中的 "items" 相同，可选 zlib 压缩；
+ *  - IMGS：文档图像表，哈希 -> 原生字节串（不再经过 Base64）。
+ * 读取时按标签查找，未知的节跳过，便于以后增加。
+ * 旧版 JSON 文档仍可读取；文件名以 .json 结尾时按 JSON 写出，供导出与交换。
+ * 读取结果统一为 JSON 格式的根对象（不含 "images"）加上 ImageStore。
+ */
+class LabelDocumentFile
+{
+public:
+    enum class Format {
+        Binary,
+        Json
+    };
+
+    struct ElementSummary {
+        QString type;
+        QPointF pos;
+    };
+
+    struct Header {
+        Format format = Format::Binary;
+        QString version;            // 文档版本（根对象的 "version"）
+        QSizeF labelSizeMM;
+        QDateTime created;
+        QDateTime modified;
+        QImage thumbnail;           // JSON 文档没有缩略图
+        QVector<ElementSummary> elements;
+    };
+
+    struct WriteOptions {
+        Format format = Format::Binary;
+        bool compress = true;       // 压缩元素节（图像本身已是压缩格式，不再压缩）
+        bool useSharedAssets = false;
+        QImage thumbnail;
+    };
+
+    // 只读取文档头；二进制文档不读取正文
+    static bool readHeader(const QString &fileName, Header *header, QString *errorMessage = nullptr);
+
+    // 读取完整文档：root 为 JSON 格式的根对象，images 为文档图像表（可为 nullptr）
+    static bool read(const QString &fileName,
+                     QJsonObject *root,
+                     ImageStore *images,
+                     QString *errorMessage = nullptr,
+                     Header *header = nullptr);
+    // 从内存读取（fileName 仅用于错误信息）
+    static bool readData(const QByteArray &data,
+                         QJsonObject *root,
+                         ImageStore *images,
+                         QString *errorMessage = nullptr,
+                         Header *header = nullptr);
+
+    // root 为 JSON 格式的根对象，其中的 "images" 被忽略，以 images 为准
+    static QByteArray serialize(const QJsonObject &root, const ImageStore &images, const WriteOptions &options);
+    static bool write(const QString &fileName,
+                      const QJsonObject &root,
+                      const ImageStore &images,
+                      const WriteOptions &options,
+                      QString *errorMessage = nullptr);
+
+    // 按文件名选择格式：*.json 为 JSON，其余为二进制
+    static Format formatForFileName(const QString &fileName);
+    static bool isBinary(const QByteArray &data);
+};
+
+#endif // LABELDOCUMENTFILE_H
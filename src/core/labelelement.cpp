@@ -1,76 +1,21 @@
 #include "labelelement.h"
 
-#include "qrcodeelement.h"
-#include "barcodeelement.h"
-#include "textelement.h"
-#include "imageelement.h"
-#include "lineelement.h"
-#include "rectangleelement.h"
-#include "circleelement.h"
-#include "starelement.h"
-#include "arrowelement.h"
-#include "polygonelement.h"
-#include "tableelement.h"
+#include "elementregistry.h"
 #include "datasource.h"
 
-// 由于 labelelement 是一个抽象类，主要包含纯虚函数，
-// 实现文件可以添加一些辅助函数或默认实现
-
-// 可以添加一些静态工厂方法来创建不同类型的元素
+// 类型名到元素的对应关系见 ElementRegistry
 std::unique_ptr<labelelement> labelelement::createFromType(const QString& type) {
-    // 支持二维码和条形码
-    const QString normalized = type.trimmed();
-    const QString lower = normalized.toLower();
-
-    if (lower == "qrcode") {
-        return std::make_unique<QRCodeElement>();
-    }
-    if (lower == "barcode") {
-        return std::make_unique<BarcodeElement>();
-    }
-    if (lower == "text") {
-        return std::make_unique<TextElement>();
-    }
-    if (lower == "image") {
-        return std::make_unique<ImageElement>();
-    }
-    if (lower == "line") {
-        return std::make_unique<LineElement>();
-    }
-    if (lower == "rectangle") {
-        return std::make_unique<RectangleElement>();
-    }
-    if (lower == "circle") {
-        return std::make_unique<CircleElement>();
-    }
-    if (lower == "ellipse") {
-        auto element = std::make_unique<CircleElement>();
-        element->setIsCircle(false);
-        return element;
-    }
-    if (lower == "star") {
-        return std::make_unique<StarElement>();
-    }
-    if (lower == "arrow") {
-        return std::make_unique<ArrowElement>();
-    }
-    if (lower == "polygon") {
-        return std::make_unique<PolygonElement>();
-    }
-    if (lower == "table") {
-        return std::make_unique<TableElement>();
-    }
-
-    // 如果类型未识别，返回nullptr
-    return nullptr;
+    return ElementRegistry::instance().create(type);
 }
 
 // 从JSON对象创建元素
-std::unique_ptr<labelelement> labelelement::createFromJson(const QJsonObject& json) {
+std::unique_ptr<labelelement> labelelement::createFromJson(const QJsonObject& json,
+                                                           ImageStore* images) {
     QString type = json["itemType"].toString();
     auto element = createFromType(type);
 
     if (element) {
+        element->setImageStore(images);
         element->setData(json);
 
         if (json.contains("dataSource") && json["dataSource"].isObject()) {
@@ -142,3 +87,30 @@ void labelelement::setDataSourceEnabled(bool enabled)
     }
     m_useDataSource = enabled;
 }
+
+QTransform labelelement::renderTransform() const
+{
+    if (const QGraphicsItem* item = getItem()) {
+        return item->sceneTransform();
+    }
+    const QPointF pos = getPos();
+    return QTransform::fromTranslate(pos.x(), pos.y());
+}
+
+qreal labelelement::renderZValue() const
+{
+    const QGraphicsItem* item = getItem();
+    return item ? item->zValue() : 0.0;
+}
+
+bool labelelement::isRenderVisible() const
+{
+    const QGraphicsItem* item = getItem();
+    return item && item->isVisible();
+}
+
+qreal labelelement::renderOpacity() const
+{
+    const QGraphicsItem* item = getItem();
+    return item ? item->effectiveOpacity() : 1.0;
+}
@@ -2,10 +2,13 @@
 #define LABELELEMENT_H
 #include <QGraphicsItem>
 #include <QJsonObject>
+#include <QTransform>
 #include <memory>
 
+class QPainter;
 class QRCodeElement;
 class DataSource;
+class ImageStore;
 
 class labelelement {
 public:
@@ -33,13 +36,34 @@ public:
     // 序列化整个元素到JSON对象（包括位置和类型信息）
     QJsonObject toJson() const;
 
+    // 文档级图像表（只有图像元素使用）：设置后 getData 只写引用，setData 按引用取数据
+    virtual void setImageStore(ImageStore* store) { Q_UNUSED(store); }
+
     virtual void addToScene(QGraphicsScene* scene) = 0;
 
+    // 创建图形项但不加入场景（已存在时直接返回），用于离屏绘制；
+    // 未加入场景的图形项由调用方释放
+    virtual QGraphicsItem* ensureItem() = 0;
+
+    // 输出渲染：在元素局部坐标系中绘制内容，不含选择框、手柄、对齐线等编辑装饰，
+    // 不经过 QGraphicsScene。内容读自元素的图形项，场景中的元素只能在 GUI 线程绘制；
+    // 调用方自行创建且未加入场景的元素（ensureItem）可在创建它的线程中绘制
+    virtual void paintContent(QPainter* painter) const = 0;
+
+    // 元素局部坐标到标签坐标的变换（位置、旋转与自定义变换）；
+    // 以下均读自图形项，线程要求同 paintContent
+    QTransform renderTransform() const;
+    // 绘制顺序与可见性、不透明度
+    qreal renderZValue() const;
+    bool isRenderVisible() const;
+    qreal renderOpacity() const;
+
     // 工厂方法：根据类型创建元素
     static std::unique_ptr<labelelement> createFromType(const QString& type);
 
-    // 工厂方法：从JSON创建元素
-    static std::unique_ptr<labelelement> createFromJson(const QJsonObject& json);
+    // 工厂方法：从JSON创建元素；images 为文档级图像表，用于解析图像元素的 "imageRef"
+    static std::unique_ptr<labelelement> createFromJson(const QJsonObject& json,
+                                                        ImageStore* images = nullptr);
 
     // 数据源绑定
     void setDataSource(const std::shared_ptr<DataSource>& source);
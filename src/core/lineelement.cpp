@@ -110,18 +110,29 @@ QGraphicsItem* LineElement::getItem() const
     return m_graphicsItem;
 }
 
+void LineElement::paintContent(QPainter* painter) const
+{
+    if (m_graphicsItem) {
+        m_graphicsItem->paintContent(painter);
+    }
+}
+
 void LineElement::addToScene(QGraphicsScene* scene)
 {
     if (!scene) {
         return;
     }
 
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* LineElement::ensureItem()
+{
     if (!m_graphicsItem) {
         m_graphicsItem = new LineItem(m_startPoint, m_endPoint);
         syncToItem();
     }
-
-    scene->addItem(m_graphicsItem);
+    return m_graphicsItem;
 }
 
 void LineElement::setLine(const QPointF &startPoint, const QPointF &endPoint)
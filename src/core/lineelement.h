@@ -22,7 +22,9 @@ public:
     void setPos(const QPointF &pos) override;
     QPointF getPos() const override;
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     void addToScene(QGraphicsScene* scene) override;
+    QGraphicsItem* ensureItem() override;
 
     // 画笔属性
     QPen pen() const { return m_pen; }
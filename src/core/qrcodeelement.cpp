@@ -8,6 +8,8 @@ QRCodeElement::QRCodeElement(QRCodeItem* item) : m_item(item) {
         m_size = item->size();
         m_foregroundColor = item->foregroundColor();
         m_backgroundColor = item->backgroundColor();
+        m_qrVersion = item->qrVersion();
+        m_qrMask = item->qrMask();
     }
 }
 
@@ -21,6 +23,12 @@ QGraphicsItem* QRCodeElement::getItem() const {
     return m_item;
 }
 
+void QRCodeElement::paintContent(QPainter* painter) const {
+    if (m_item) {
+        m_item->paintContent(painter);
+    }
+}
+
 QString QRCodeElement::getType() const {
     return "qrcode";
 }
@@ -32,6 +40,12 @@ QJsonObject QRCodeElement::getData() const {
     data["height"] = m_size.height();
     data["foregroundColor"] = m_foregroundColor.name();
     data["backgroundColor"] = m_backgroundColor.name();
+    if (m_qrVersion > 0) {
+        data["qrVersion"] = m_qrVersion;
+    }
+    if (m_qrMask >= 0) {
+        data["qrMask"] = m_qrMask;
+    }
     return data;
 }
 
@@ -40,6 +54,8 @@ void QRCodeElement::setData(const QJsonObject& data) {
     m_size = QSizeF(data["width"].toDouble(), data["height"].toDouble());
     m_foregroundColor = QColor(data["foregroundColor"].toString());
     m_backgroundColor = QColor(data["backgroundColor"].toString());
+    m_qrVersion = qBound(0, data["qrVersion"].toInt(0), 40);
+    m_qrMask = qBound(-1, data["qrMask"].toInt(-1), 7);
 
     // 如果已有 item，则更新其属性
     if (m_item) {
@@ -47,6 +63,8 @@ void QRCodeElement::setData(const QJsonObject& data) {
         m_item->setSize(m_size);
         m_item->setForegroundColor(m_foregroundColor);
         m_item->setBackgroundColor(m_backgroundColor);
+        m_item->setQrVersion(m_qrVersion);
+        m_item->setQrMask(m_qrMask);
     }
 }
 
@@ -107,18 +125,45 @@ void QRCodeElement::setBackgroundColor(const QColor& color) {
     }
 }
 
+int QRCodeElement::getQrVersion() const {
+    return m_qrVersion;
+}
+
+void QRCodeElement::setQrVersion(int version) {
+    m_qrVersion = qBound(0, version, 40);
+    if (m_item) {
+        m_item->setQrVersion(m_qrVersion);
+    }
+}
+
+int QRCodeElement::getQrMask() const {
+    return m_qrMask;
+}
+
+void QRCodeElement::setQrMask(int mask) {
+    m_qrMask = qBound(-1, mask, 7);
+    if (m_item) {
+        m_item->setQrMask(m_qrMask);
+    }
+}
+
 void QRCodeElement::addToScene(QGraphicsScene* scene) {
     if (!scene) return;
 
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* QRCodeElement::ensureItem() {
     // 如果 item 还不存在，创建一个新的
     if (!m_item) {
         m_item = new QRCodeItem(m_text);
         m_item->setSize(m_size);
         m_item->setForegroundColor(m_foregroundColor);
         m_item->setBackgroundColor(m_backgroundColor);
+        m_item->setQrVersion(m_qrVersion);
+        m_item->setQrMask(m_qrMask);
     }
-
-    scene->addItem(m_item);
+    return m_item;
 }
 
 bool QRCodeElement::applyDataSourceRecord(int index)
@@ -168,4 +213,15 @@ void QRCodeElement::restoreOriginalData()
     }
 
     m_hasOriginalData = false;
+}
+
+SymbolMatrixKey QRCodeElement::symbolMatrixKeyForRecord(int index) const
+{
+    auto source = dataSource();
+    if (!m_item || !isDataSourceEnabled() || !source || index < 0 || index >= source->count()) {
+        return SymbolMatrixKey();
+    }
+
+    // 与 applyDataSourceRecord 相同的取值规则
+    return m_item->symbolMatrixKey(source->at(index).trimmed());
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ public:
 
     // 实现基类的虚函数
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     QString getType() const override;
     QJsonObject getData() const override;
     void setData(const QJsonObject& data) override;
@@ -35,11 +36,20 @@ public:
     QColor getBackgroundColor() const;
     void setBackgroundColor(const QColor& color);
 
+    // 固定 QR 版本/掩码，0 与 -1 表示自动（缺省不写入模板）
+    int getQrVersion() const;
+    void setQrVersion(int version);
+    int getQrMask() const;
+    void setQrMask(int mask);
+
     // 创建 QRCodeItem 并添加到场景
     void addToScene(QGraphicsScene* scene);
+    QGraphicsItem* ensureItem() override;
 
     bool applyDataSourceRecord(int index);
     void restoreOriginalData();
+    // 第 index 条记录的编码参数（不修改当前数据），供批量预编码使用
+    SymbolMatrixKey symbolMatrixKeyForRecord(int index) const;
 
 private:
     QRCodeItem* m_item = nullptr;
@@ -47,6 +57,8 @@ private:
     QSizeF m_size;
     QColor m_foregroundColor = Qt::black;
     QColor m_backgroundColor = Qt::white;
+    int m_qrVersion = 0;
+    int m_qrMask = -1;
     QString m_originalData;
     bool m_hasOriginalData = false;
 };
@@ -142,20 +142,31 @@ QGraphicsItem* ShapeElement::getItem() const
     return m_graphicsItem;
 }
 
+void ShapeElement::paintContent(QPainter* painter) const
+{
+    if (m_graphicsItem) {
+        m_graphicsItem->paintContent(painter);
+    }
+}
+
 void ShapeElement::addToScene(QGraphicsScene* scene)
 {
     if (!scene) {
         return;
     }
 
+    if (QGraphicsItem* item = ensureItem()) {
+        scene->addItem(item);
+    }
+}
+
+QGraphicsItem* ShapeElement::ensureItem()
+{
     if (!m_graphicsItem) {
         m_graphicsItem = createGraphicsItem();
         syncToItem();
     }
-
-    if (m_graphicsItem) {
-        scene->addItem(m_graphicsItem);
-    }
+    return m_graphicsItem;
 }
 
 QString ShapeElement::shapeTypeToString() const
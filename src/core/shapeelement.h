@@ -29,7 +29,9 @@ public:
     void setPos(const QPointF &pos) override;
     QPointF getPos() const override;
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     void addToScene(QGraphicsScene* scene) override;
+    QGraphicsItem* ensureItem() override;
 
     // 形状类型
     ShapeType shapeType() const { return m_shapeType; }
@@ -4,15 +4,37 @@
 #include <QJsonObject>
 #include <QJsonArray>
 
-TableElement::TableElement() : m_item(new TableItem(3,3,50,30)) {}
+namespace {
+
+void applyTableData(TableItem* item, const QJsonObject& data)
+{
+    int rows = data.value("rows").toInt(2);
+    int cols = data.value("cols").toInt(2);
+    item->setGrid(rows, cols);
+    if (data.contains("colWidths") && data.value("colWidths").isArray()) {
+        QVector<qreal> cw; for (auto v : data.value("colWidths").toArray()) cw.append(v.toDouble());
+        if (cw.size() == cols) item->setColumnWidths(cw);
+    }
+    if (data.contains("rowHeights") && data.value("rowHeights").isArray()) {
+        QVector<qreal> rh; for (auto v : data.value("rowHeights").toArray()) rh.append(v.toDouble());
+        if (rh.size() == rows) item->setRowHeights(rh);
+    }
+}
+
+} // namespace
+
+// 与其他元素一致，图形项延迟到 ensureItem 时创建：未加入场景就被丢弃的元素不会遗留图形项
+TableElement::TableElement() = default;
 TableElement::TableElement(TableItem* item) : m_item(item) {}
 
 QGraphicsItem* TableElement::getItem() const { return m_item; }
 
+void TableElement::paintContent(QPainter* painter) const { if (m_item) m_item->paintContent(painter); }
+
 QJsonObject TableElement::getData() const
 {
     QJsonObject json;
-    if (!m_item) return json;
+    if (!m_item) return m_data;
     json["itemType"] = QStringLiteral("table");
     // 尺寸与网格
     json["rows"] = m_item->rowCount();
@@ -24,18 +46,9 @@ QJsonObject TableElement::getData() const
 
 void TableElement::setData(const QJsonObject& data)
 {
-    if (!m_item) m_item = new TableItem(2,2,50,30);
-    int rows = data.value("rows").toInt(2);
-    int cols = data.value("cols").toInt(2);
-    m_item->setGrid(rows, cols);
-    if (data.contains("colWidths") && data.value("colWidths").isArray()) {
-        QVector<qreal> cw; for (auto v : data.value("colWidths").toArray()) cw.append(v.toDouble());
-        if (cw.size() == cols) m_item->setColumnWidths(cw);
-    }
-    if (data.contains("rowHeights") && data.value("rowHeights").isArray()) {
-        QVector<qreal> rh; for (auto v : data.value("rowHeights").toArray()) rh.append(v.toDouble());
-        if (rh.size() == rows) m_item->setRowHeights(rh);
-    }
+    m_data = data;
+    m_data["itemType"] = QStringLiteral("table");
+    if (m_item) applyTableData(m_item, data);
 }
 
 void TableElement::setPos(const QPointF& pos)
@@ -51,6 +64,14 @@ QPointF TableElement::getPos() const
 void TableElement::addToScene(QGraphicsScene* scene)
 {
     if (!scene) return;
-    if (!m_item) m_item = new TableItem(3,3,50,30);
-    scene->addItem(m_item);
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* TableElement::ensureItem()
+{
+    if (!m_item) {
+        m_item = new TableItem(3,3,50,30);
+        if (!m_data.isEmpty()) applyTableData(m_item, m_data);
+    }
+    return m_item;
 }
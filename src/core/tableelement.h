@@ -16,15 +16,18 @@ public:
     ~TableElement() override = default;
 
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     QString getType() const override { return QStringLiteral("table"); }
     QJsonObject getData() const override;
     void setData(const QJsonObject& data) override;
     void setPos(const QPointF& pos) override;
     QPointF getPos() const override;
     void addToScene(QGraphicsScene* scene) override;
+    QGraphicsItem* ensureItem() override;
 
 private:
     TableItem* m_item = nullptr; // TableItem 不是 QObject，不适合 QPointer
+    QJsonObject m_data;          // 图形项创建前的网格数据
 };
 
 #endif // TABLEELEMENT_H
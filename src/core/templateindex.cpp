@@ -0,0 +1,260 @@
+#include "templateindex.h"
+
+#include "labeldocumentfile.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtCore/QBuffer>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtGui/QImage>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QUuid>
+#include <QtCore/QVariant>
+
+#include <utility>
+
+namespace {
+
+// 结构变化时递增，旧索引整体重建
+constexpr int kSchemaVersion = 1;
+// 与模板中心列表的图标尺寸一致
+constexpr int kThumbnailExtent = 150;
+
+const char kDatabaseFileName[] = "template-index.sqlite";
+
+QString directoryKey(const QString &directory)
+{
+    return QDir::cleanPath(QFileInfo(directory).absoluteFilePath());
+}
+
+QByteArray encodePng(const QImage &image)
+{
+    if (image.isNull()) {
+        return QByteArray();
+    }
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes;
+}
+
+} // namespace
+
+TemplateIndex::TemplateIndex(const QString &templatesDirectory)
+    : m_connectionName(QStringLiteral("SimpleLabelTemplateIndex_%1")
+                           .arg(QUuid::createUuid().toString(QUuid::Id128)))
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE"))) {
+        return;
+    }
+
+    // 安装目录通常只读，此时放到应用数据目录
+    QStringList candidates;
+    if (QFileInfo(templatesDirectory).isWritable()) {
+        candidates << QDir(templatesDirectory).filePath(kDatabaseFileName);
+    }
+    const QString dataDirectory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!dataDirectory.isEmpty() && QDir().mkpath(dataDirectory)) {
+        candidates << QDir(dataDirectory).filePath(kDatabaseFileName);
+    }
+    for (const QString &candidate : std::as_const(candidates)) {
+        if (openDatabase(candidate)) {
+            m_open = true;
+            break;
+        }
+    }
+}
+
+TemplateIndex::~TemplateIndex()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+        if (db.isValid()) {
+            db.close();
+        }
+    }
+    if (QSqlDatabase::contains(m_connectionName)) {
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
+
+bool TemplateIndex::openDatabase(const QString &filePath)
+{
+    {
+        QSqlDatabase db = QSqlDatabase::contains(m_connectionName)
+                              ? QSqlDatabase::database(m_connectionName, false)
+                              : QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connectionName);
+        db.setDatabaseName(filePath);
+        if (db.open() && ensureSchema()) {
+            return true;
+        }
+        db.close();
+    }
+    return false;
+}
+
+bool TemplateIndex::ensureSchema()
+{
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    QSqlQuery query(db);
+    if (!query.exec(QStringLiteral("PRAGMA user_version")) || !query.next()) {
+        return false;
+    }
+    if (query.value(0).toInt() == kSchemaVersion) {
+        return true;
+    }
+
+    const QStringList statements = {
+        QStringLiteral("DROP TABLE IF EXISTS templates"),
+        QStringLiteral("CREATE TABLE templates ("
+                       " path TEXT PRIMARY KEY,"
+                       " directory TEXT NOT NULL,"
+                       " name TEXT NOT NULL,"
+                       " width REAL,"
+                       " height REAL,"
+                       " tags TEXT,"
+                       " mtime INTEGER,"
+                       " size INTEGER,"
+                       " thumbnail BLOB)"),
+        QStringLiteral("CREATE INDEX templates_directory ON templates(directory)"),
+        QStringLiteral("PRAGMA user_version = %1").arg(kSchemaVersion),
+    };
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TemplateIndex::Entry TemplateIndex::readEntry(const QString &filePath) const
+{
+    const QFileInfo info(filePath);
+    Entry entry;
+    entry.path = info.absoluteFilePath();
+    entry.name = info.baseName();
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+
+    // 标签：所在分类与用到的元素类型，供搜索使用
+    entry.tags << info.dir().dirName();
+    LabelDocumentFile::Header header;
+    if (LabelDocumentFile::readHeader(filePath, &header)) {
+        entry.labelSizeMM = header.labelSizeMM;
+        for (const LabelDocumentFile::ElementSummary &element : std::as_const(header.elements)) {
+            if (!element.type.isEmpty() && !entry.tags.contains(element.type)) {
+                entry.tags << element.type;
+            }
+        }
+        if (!header.thumbnail.isNull()) {
+            entry.thumbnail = encodePng(header.thumbnail.scaled(kThumbnailExtent, kThumbnailExtent,
+                                                                Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        }
+    }
+    return entry;
+}
+
+QVector<TemplateIndex::Entry> TemplateIndex::refresh(const QString &directory)
+{
+    const QFileInfoList files = QDir(directory).entryInfoList({ QStringLiteral("*.lbl") }, QDir::Files, QDir::Name);
+
+    QVector<Entry> entries;
+    entries.reserve(files.size());
+    if (!m_open) {
+        for (const QFileInfo &info : files) {
+            entries.append(readEntry(info.absoluteFilePath()));
+        }
+        return entries;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    const QString key = directoryKey(directory);
+
+    struct Known {
+        Entry entry;
+        qint64 size = 0;
+    };
+    QHash<QString, Known> known;
+    {
+        QSqlQuery query(db);
+        query.prepare(QStringLiteral("SELECT path, name, width, height, tags, mtime, size, thumbnail"
+                                     " FROM templates WHERE directory = ?"));
+        query.addBindValue(key);
+        if (query.exec()) {
+            while (query.next()) {
+                Known row;
+                row.entry.path = query.value(0).toString();
+                row.entry.name = query.value(1).toString();
+                row.entry.labelSizeMM = QSizeF(query.value(2).toDouble(), query.value(3).toDouble());
+                row.entry.tags = query.value(4).toString().split(QLatin1Char(','), Qt::SkipEmptyParts);
+                row.entry.modified = query.value(5).toLongLong();
+                row.size = query.value(6).toLongLong();
+                row.entry.thumbnail = query.value(7).toByteArray();
+                known.insert(row.entry.path, row);
+            }
+        }
+    }
+
+    db.transaction();
+    QSqlQuery upsert(db);
+    upsert.prepare(QStringLiteral("INSERT OR REPLACE INTO templates"
+                                  " (path, directory, name, width, height, tags, mtime, size, thumbnail)"
+                                  " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    for (const QFileInfo &info : files) {
+        const QString path = info.absoluteFilePath();
+        const auto it = known.find(path);
+        if (it != known.end()
+            && it->entry.modified == info.lastModified().toMSecsSinceEpoch()
+            && it->size == info.size()) {
+            entries.append(it->entry);
+            known.erase(it);
+            continue;
+        }
+        if (it != known.end()) {
+            known.erase(it);
+        }
+
+        // 新增或已修改：重新读取文档头
+        const Entry entry = readEntry(path);
+        upsert.bindValue(0, entry.path);
+        upsert.bindValue(1, key);
+        upsert.bindValue(2, entry.name);
+        upsert.bindValue(3, entry.labelSizeMM.width());
+        upsert.bindValue(4, entry.labelSizeMM.height());
+        upsert.bindValue(5, entry.tags.join(QLatin1Char(',')));
+        upsert.bindValue(6, entry.modified);
+        upsert.bindValue(7, info.size());
+        upsert.bindValue(8, entry.thumbnail);
+        upsert.exec();
+        entries.append(entry);
+    }
+
+    // 剩下的记录对应的文件已删除
+    if (!known.isEmpty()) {
+        QSqlQuery remove(db);
+        remove.prepare(QStringLiteral("DELETE FROM templates WHERE path = ?"));
+        for (auto it = known.constBegin(); it != known.constEnd(); ++it) {
+            remove.bindValue(0, it.key());
+            remove.exec();
+        }
+    }
+    db.commit();
+
+    return entries;
+}
+
+void TemplateIndex::storeThumbnail(const QString &path, qint64 modified, const QByteArray &thumbnail)
+{
+    if (!m_open || thumbnail.isEmpty()) {
+        return;
+    }
+    QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+    query.prepare(QStringLiteral("UPDATE templates SET thumbnail = ? WHERE path = ? AND mtime = ?"));
+    query.bindValue(0, thumbnail);
+    query.bindValue(1, path);
+    query.bindValue(2, modified);
+    query.exec();
+}
@@ -0,0 +1,54 @@
+#ifndef TEMPLATEINDEX_H
+#define TEMPLATEINDEX_H
+
+#include <QByteArray>
+#include <QSizeF>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 模板库索引
+ *
+ * 模板目录下的 SQLite 数据库（目录不可写时放在应用数据目录）按文件路径保存
+ * 名称、标签尺寸、标签（分类与元素类型）、修改时间、文件大小与缩略图（PNG）。
+ * refresh() 只重新读取修改时间或大小变化了的文件，删除已不存在的记录，
+ * 浏览分类时不再逐个解析 .lbl。缩略图取自二进制文档头；没有时（旧版 JSON 文档）
+ * 条目的缩略图为空，由调用方在后台渲染后用 storeThumbnail() 写回。
+ * 未启用 SQLite 驱动或数据库无法打开时退化为每次直接读取，结果相同。
+ */
+class TemplateIndex
+{
+public:
+    struct Entry {
+        QString path;
+        QString name;
+        QSizeF labelSizeMM;
+        QStringList tags;
+        qint64 modified = 0;        // 修改时间（毫秒）
+        QByteArray thumbnail;       // PNG，可能为空
+    };
+
+    explicit TemplateIndex(const QString &templatesDirectory);
+    ~TemplateIndex();
+
+    TemplateIndex(const TemplateIndex &) = delete;
+    TemplateIndex &operator=(const TemplateIndex &) = delete;
+
+    bool isPersistent() const { return m_open; }
+
+    // 同步 directory 下的 *.lbl 并按名称返回
+    QVector<Entry> refresh(const QString &directory);
+    // 保存渲染好的缩略图；文件在此期间又被修改（modified 不符）时忽略
+    void storeThumbnail(const QString &path, qint64 modified, const QByteArray &thumbnail);
+
+private:
+    bool openDatabase(const QString &filePath);
+    bool ensureSchema();
+    Entry readEntry(const QString &filePath) const;
+
+    QString m_connectionName;
+    bool m_open = false;
+};
+
+#endif // TEMPLATEINDEX_H
@@ -42,6 +42,12 @@ QGraphicsItem* TextElement::getItem() const {
     return m_item;
 }
 
+void TextElement::paintContent(QPainter* painter) const {
+    if (m_item) {
+        m_item->paintContent(painter);
+    }
+}
+
 QString TextElement::getType() const {
     return "text";
 }
@@ -241,13 +247,16 @@ void TextElement::setAutoResize(bool autoResize) {
 void TextElement::addToScene(QGraphicsScene* scene) {
     if (!scene) return;
 
+    scene->addItem(ensureItem());
+}
+
+QGraphicsItem* TextElement::ensureItem() {
     // 如果图形项还不存在，创建一个新的
     if (!m_item) {
         m_item = new TextItem(m_text);
         syncToItem();
     }
-
-    scene->addItem(m_item);
+    return m_item;
 }
 
 bool TextElement::applyDataSourceRecord(int index)
@@ -28,6 +28,7 @@ public:
 
     // 继承自LabelElement的虚函数
     QGraphicsItem* getItem() const override;
+    void paintContent(QPainter* painter) const override;
     QString getType() const override;
     QJsonObject getData() const override;
     void setData(const QJsonObject& data) override;
@@ -75,6 +76,7 @@ public:
     bool getAutoResize() const;
     void setAutoResize(bool autoResize);    // 将元素添加到场景
     void addToScene(QGraphicsScene* scene) override;
+    QGraphicsItem* ensureItem() override;
 
     bool applyDataSourceRecord(int index);
     void restoreOriginalData();
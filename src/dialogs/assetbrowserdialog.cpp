@@ -22,6 +22,29 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QSet>
+#include <QCryptographicHash>
+#include <QPixmapCache>
+#include <QSaveFile>
+
+#include <functional>
+
+namespace {
+
+// 缩略图画布边长；生成时按两倍尺寸解码再平滑缩小
+constexpr int kThumbSize = 128;
+
+// 内置素材在进程内只绘制一次
+QPixmap cachedPixmap(const QString& key, const std::function<QPixmap()>& generate)
+{
+    QPixmap pm;
+    if (!QPixmapCache::find(key, &pm)) {
+        pm = generate();
+        QPixmapCache::insert(key, pm);
+    }
+    return pm;
+}
+
+} // namespace
 
 static QPixmap withDevicePixelRatio(const QPixmap& src)
 {
@@ -39,12 +62,26 @@ AssetBrowserDialog::AssetBrowserDialog(QWidget* parent)
     // 外部素材目录：应用程序目录下的 assets 子目录
     m_assetsDir = QCoreApplication::applicationDirPath() + "/assets";
     QDir().mkpath(m_assetsDir);
-    // 仅使用外部素材，移除内置素材
+    // 缩略图缓存：再次打开时直接读取 128px 的 PNG，不再解码原图
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheRoot.isEmpty()) {
+        m_thumbnailCacheDir = QDir(cacheRoot).filePath("asset-thumbnails");
+        QDir().mkpath(m_thumbnailCacheDir);
+    }
+    // 仅使用外部素材，移除内置素材；扫描在后台进行，对话框立即显示
     populateExternalAssets();
     updateCategories();
     refreshList();
 }
 
+AssetBrowserDialog::~AssetBrowserDialog()
+{
+    // 让尚未开始的任务直接返回，并等待进行中的任务结束（它们会回调本对象）
+    ++m_scanGeneration;
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
 void AssetBrowserDialog::buildUi()
 {
     m_categoryCombo = new QComboBox(this);
@@ -74,6 +111,7 @@ void AssetBrowserDialog::buildUi()
         QDesktopServices::openUrl(QUrl::fromLocalFile(m_assetsDir));
     });
     connect(m_refreshButton, &QPushButton::clicked, this, [this]{
+        m_pool.clear();
         populateExternalAssets();
         updateCategories();
         refreshList();
@@ -203,25 +241,31 @@ QPixmap AssetBrowserDialog::genPersonSilhouette()
 }
 
 QPixmap AssetBrowserDialog::makeThumb(const QPixmap& src)
+{
+    return withDevicePixelRatio(QPixmap::fromImage(makeThumbImage(src.toImage())));
+}
+
+QImage AssetBrowserDialog::makeThumbImage(const QImage& src)
 {
     // 统一输出固定128x128画布：保持比例缩放并居中，避免不同宽高导致视觉跳动
-    const int TW = 128, TH = 128;
-    QPixmap canvas(TW, TH);
+    // 只使用 QImage，可在工作线程中调用
+    const int TW = kThumbSize, TH = kThumbSize;
+    QImage canvas(TW, TH, QImage::Format_ARGB32_Premultiplied);
     canvas.fill(Qt::transparent);
     if (src.isNull()) return canvas;
-    QPixmap scaled = src.scaled(TW, TH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    const QImage scaled = src.scaled(TW, TH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     QPainter p(&canvas);
     p.setRenderHint(QPainter::Antialiasing, true);
     const int x = (TW - scaled.width()) / 2;
     const int y = (TH - scaled.height()) / 2;
-    p.drawPixmap(x, y, scaled);
+    p.drawImage(x, y, scaled);
     p.end();
-    return withDevicePixelRatio(canvas);
+    return canvas;
 }
 
 void AssetBrowserDialog::populateBuiltinAssets()
 {
-    // 保留旧实现，但不再默认调用
+    // 保留旧实现，但不再默认调用；生成的图标按键缓存在 QPixmapCache 中
     m_all.clear();
     // 警示语
     {
@@ -231,7 +275,7 @@ void AssetBrowserDialog::populateBuiltinAssets()
             it.id = QStringLiteral("warn_%1").arg(w);
             it.name = w;
             it.category = QStringLiteral("警示语");
-            it.full = genWarningIcon(w);
+            it.full = cachedPixmap(QStringLiteral("asset_builtin_warn_%1").arg(w), [w]{ return genWarningIcon(w); });
             it.thumbnail = makeThumb(it.full);
             m_all.push_back(std::move(it));
         }
@@ -242,7 +286,7 @@ void AssetBrowserDialog::populateBuiltinAssets()
         it.id = QStringLiteral("energy_label");
         it.name = QStringLiteral("能效标签");
         it.category = QStringLiteral("能效");
-        it.full = genEnergyLabel();
+        it.full = cachedPixmap(QStringLiteral("asset_builtin_energy"), []{ return genEnergyLabel(); });
         it.thumbnail = makeThumb(it.full);
         m_all.push_back(std::move(it));
     }
@@ -252,7 +296,7 @@ void AssetBrowserDialog::populateBuiltinAssets()
         it.id = QStringLiteral("gb_mark");
         it.name = QStringLiteral("GB 标识");
         it.category = QStringLiteral("国标");
-        it.full = genGbMark();
+        it.full = cachedPixmap(QStringLiteral("asset_builtin_gb"), []{ return genGbMark(); });
         it.thumbnail = makeThumb(it.full);
         m_all.push_back(std::move(it));
     }
@@ -262,7 +306,7 @@ void AssetBrowserDialog::populateBuiltinAssets()
         it.id = QStringLiteral("person");
         it.name = QStringLiteral("人物");
         it.category = QStringLiteral("人物");
-        it.full = genPersonSilhouette();
+        it.full = cachedPixmap(QStringLiteral("asset_builtin_person"), []{ return genPersonSilhouette(); });
         it.thumbnail = makeThumb(it.full);
         m_all.push_back(std::move(it));
     }
@@ -279,41 +323,137 @@ void AssetBrowserDialog::populateExternalAssets()
 {
     // 以外部素材为唯一来源：先清空列表
     m_all.clear();
-    // 扫描 m_assetsDir 目录：一级子目录为分类；根目录下文件归类为“自定义”
-    QDir base(m_assetsDir);
-    if (!base.exists()) return;
+    m_listItems.clear();
+    const int generation = ++m_scanGeneration;
+
+    // 扫描 m_assetsDir 目录：一级子目录为分类；根目录下文件归类为“自定义”。
+    // 枚举在工作线程完成后一次性交给列表，缩略图随后按列表顺序并行生成、逐个填入
+    const QString assetsDir = m_assetsDir;
+    const QString cacheDir = m_thumbnailCacheDir;
+    const QString customCategory = tr("自定义");
+    m_pool.start([this, generation, assetsDir, cacheDir, customCategory]() {
+        QDir base(assetsDir);
+        if (!base.exists()) return;
+
+        QVector<ScannedFile> files;
+        auto addFile = [&files](const QFileInfo& fi, const QString& category){
+            if (!isImageFile(fi.fileName())) return;
+            ScannedFile file;
+            file.path = fi.absoluteFilePath();
+            file.category = category;
+            file.modified = fi.lastModified();
+            file.size = fi.size();
+            files.push_back(file);
+        };
 
-    auto loadFile = [this](const QString& path, const QString& category){
-        if (!isImageFile(path)) return;
-        QImageReader reader(path);
-        reader.setAutoTransform(true);
-        QImage img = reader.read();
-        if (img.isNull()) return;
-        QPixmap pm = QPixmap::fromImage(img);
+        // 根目录文件
+        const QFileInfoList rootFiles = base.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+        for (const QFileInfo& fi : rootFiles) {
+            addFile(fi, customCategory);
+        }
+
+        // 子目录作为分类
+        const QFileInfoList subdirs = base.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo& di : subdirs) {
+            const QString cat = di.fileName();
+            QDir d(di.absoluteFilePath());
+            const QFileInfoList entries = d.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+            for (const QFileInfo& fi : entries) {
+                addFile(fi, cat);
+            }
+        }
+
+        if (generation != m_scanGeneration) return;
+        QMetaObject::invokeMethod(this, [this, generation, files]() {
+            onAssetsListed(generation, files);
+        }, Qt::QueuedConnection);
+
+        for (int i = 0; i < files.size(); ++i) {
+            const ScannedFile file = files[i];
+            m_pool.start([this, generation, i, file, cacheDir]() {
+                if (generation != m_scanGeneration) return;
+                const QImage thumbnail = loadThumbnail(file, cacheDir);
+                QMetaObject::invokeMethod(this, [this, generation, i, thumbnail]() {
+                    onThumbnailReady(generation, i, thumbnail);
+                }, Qt::QueuedConnection);
+            });
+        }
+    });
+}
+
+QImage AssetBrowserDialog::loadThumbnail(const ScannedFile& file, const QString& cacheDir)
+{
+    // 缓存键：路径 + 修改时间 + 大小，文件被替换后自然失效
+    QString cachePath;
+    if (!cacheDir.isEmpty()) {
+        const QByteArray key = (file.path + QLatin1Char('\n')
+                                + QString::number(file.modified.toMSecsSinceEpoch()) + QLatin1Char('\n')
+                                + QString::number(file.size)).toUtf8();
+        cachePath = QDir(cacheDir).filePath(
+            QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) + ".png");
+        QImage cached;
+        if (cached.load(cachePath, "PNG")) {
+            return cached;
+        }
+    }
+
+    // 按两倍缩略图尺寸解码（JPEG 在解码阶段缩小），再平滑缩小到画布
+    QImageReader reader(file.path);
+    reader.setAutoTransform(true);
+    const QSize sourceSize = reader.size();
+    if (sourceSize.isValid()
+        && (sourceSize.width() > 2 * kThumbSize || sourceSize.height() > 2 * kThumbSize)) {
+        reader.setScaledSize(sourceSize.scaled(2 * kThumbSize, 2 * kThumbSize, Qt::KeepAspectRatio));
+    }
+    const QImage img = reader.read();
+    if (img.isNull()) return QImage();
+
+    const QImage thumbnail = makeThumbImage(img);
+    if (!cachePath.isEmpty()) {
+        QSaveFile out(cachePath);
+        if (out.open(QIODevice::WriteOnly) && thumbnail.save(&out, "PNG")) {
+            out.commit();
+        }
+    }
+    return thumbnail;
+}
+
+void AssetBrowserDialog::onAssetsListed(int generation, const QVector<ScannedFile>& files)
+{
+    if (generation != m_scanGeneration) return;
+
+    m_all.clear();
+    m_all.reserve(files.size());
+    for (const ScannedFile& file : files) {
         AssetItem it;
-        it.id = path; // 使用绝对路径作为唯一ID
-        it.name = QFileInfo(path).completeBaseName();
-        it.category = category;
-        it.full = withDevicePixelRatio(pm);
-        it.thumbnail = makeThumb(it.full);
+        it.id = file.path; // 使用绝对路径作为唯一ID
+        it.name = QFileInfo(file.path).completeBaseName();
+        it.category = file.category;
+        it.path = file.path;
         m_all.push_back(std::move(it));
-    };
-
-    // 根目录文件
-    const QFileInfoList rootFiles = base.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-    for (const QFileInfo& fi : rootFiles) {
-        loadFile(fi.absoluteFilePath(), tr("自定义"));
     }
+    updateCategories();
+    refreshList();
+}
 
-    // 子目录作为分类
-    const QFileInfoList subdirs = base.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo& di : subdirs) {
-        const QString cat = di.fileName();
-        QDir d(di.absoluteFilePath());
-        const QFileInfoList files = d.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-        for (const QFileInfo& fi : files) {
-            loadFile(fi.absoluteFilePath(), cat);
+void AssetBrowserDialog::onThumbnailReady(int generation, int index, const QImage& thumbnail)
+{
+    if (generation != m_scanGeneration || index < 0 || index >= m_all.size()) return;
+
+    AssetItem& it = m_all[index];
+    QListWidgetItem* item = m_listItems.value(index);
+    if (thumbnail.isNull()) {
+        // 无法解码的文件不列出
+        it.id.clear();
+        if (item) {
+            m_listItems.remove(index);
+            delete item;
         }
+        return;
+    }
+    it.thumbnail = withDevicePixelRatio(QPixmap::fromImage(thumbnail));
+    if (item) {
+        item->setIcon(QIcon(it.thumbnail));
     }
 }
 
@@ -344,14 +484,18 @@ void AssetBrowserDialog::updateCategories()
 void AssetBrowserDialog::refreshList()
 {
     m_list->clear();
+    m_listItems.clear();
     m_currentIndex = -1;
     for (int i=0;i<m_all.size();++i) {
         const auto& it = m_all[i];
+        if (it.id.isEmpty()) continue; // 无法解码的外部素材
         if (!m_currentCategory.isEmpty() && it.category != m_currentCategory) continue;
         if (!m_filter.isEmpty() && !it.name.contains(m_filter, Qt::CaseInsensitive)) continue;
+        // 缩略图尚未生成时先以空图标占位，生成后原地替换
         auto* item = new QListWidgetItem(QIcon(it.thumbnail), it.name, m_list);
         item->setData(Qt::UserRole, i);
         m_list->addItem(item);
+        m_listItems.insert(i, item);
     }
 }
 
@@ -362,8 +506,15 @@ bool AssetBrowserDialog::hasSelection() const
 
 AssetItem AssetBrowserDialog::selected() const
 {
-    if (hasSelection()) return m_all[m_currentIndex];
-    return AssetItem{};
+    if (!hasSelection()) return AssetItem{};
+    AssetItem it = m_all[m_currentIndex];
+    // 外部素材的原图只在选中时解码
+    if (it.full.isNull() && !it.path.isEmpty()) {
+        QImageReader reader(it.path);
+        reader.setAutoTransform(true);
+        it.full = withDevicePixelRatio(QPixmap::fromImage(reader.read()));
+    }
+    return it;
 }
 
 void AssetBrowserDialog::onCategoryChanged(int index)
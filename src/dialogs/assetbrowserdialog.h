@@ -2,9 +2,15 @@
 #define ASSETBROWSERDIALOG_H
 
 #include <QDialog>
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
 #include <QPixmap>
+#include <QThreadPool>
 #include <QVector>
 #include <QString>
+
+#include <atomic>
 class QDir;
 
 class QListWidget;
@@ -19,13 +25,15 @@ struct AssetItem {
     QString name;
     QString category; // 国标/警示语/能效/人物
     QPixmap thumbnail; // 预览缩略图（约128x128）
-    QPixmap full;      // 全尺寸（建议512x512以内）
+    QPixmap full;      // 全尺寸（外部素材只在 selected() 时解码）
+    QString path;      // 外部素材文件路径，内置素材为空
 };
 
 class AssetBrowserDialog : public QDialog {
     Q_OBJECT
 public:
     explicit AssetBrowserDialog(QWidget* parent = nullptr);
+    ~AssetBrowserDialog() override;
 
     // 选择结果
     bool hasSelection() const;
@@ -40,21 +48,37 @@ private slots:
 private:
     void buildUi();
     void populateBuiltinAssets(); // 不再默认调用，仅保留以备将来需要
+    // 在后台枚举素材目录并生成缩略图，结果逐步加入列表
     void populateExternalAssets();
     void updateCategories();
     void refreshList();
 
+    // 后台扫描的结果（GUI 线程）
+    struct ScannedFile {
+        QString path;
+        QString category;
+        QDateTime modified;
+        qint64 size = 0;
+    };
+    void onAssetsListed(int generation, const QVector<ScannedFile>& files);
+    void onThumbnailReady(int generation, int index, const QImage& thumbnail);
+
+    // 工作线程：读取或生成一个外部素材的缩略图
+    static QImage loadThumbnail(const ScannedFile& file, const QString& cacheDir);
+
     // 生成内置素材
     static QPixmap genWarningIcon(const QString& text);
     static QPixmap genEnergyLabel();
     static QPixmap genGbMark();
     static QPixmap genPersonSilhouette();
     static QPixmap makeThumb(const QPixmap& src);
+    static QImage makeThumbImage(const QImage& src);
 
     QVector<AssetItem> m_all;
     QString m_currentCategory; // 空=全部
     QString m_filter;
     QString m_assetsDir;       // 外部素材根目录（应用目录下 assets）
+    QString m_thumbnailCacheDir; // 缩略图磁盘缓存（按路径 + 修改时间）
 
     QComboBox* m_categoryCombo{};
     QLineEdit* m_searchEdit{};
@@ -65,6 +89,10 @@ private:
     QPushButton* m_refreshButton{};
 
     int m_currentIndex{-1};
+
+    QHash<int, QListWidgetItem*> m_listItems; // m_all 下标 -> 当前列表项
+    QThreadPool m_pool;
+    std::atomic<int> m_scanGeneration{0};     // 刷新或关闭后递增，旧任务提前结束
 };
 
 #endif // ASSETBROWSERDIALOG_H
@@ -18,29 +18,19 @@ LayoutPreviewWidget::LayoutPreviewWidget(QWidget *parent) : QWidget(parent)
     setMinimumSize(180,240);
 }
 
-void LayoutPreviewWidget::setGrid(int rows, int cols)
-{
-    m_rows = rows; m_cols = cols; update();
-}
-
 void LayoutPreviewWidget::setPageSize(const QSizeF &mm, bool landscape)
 {
     m_pageMM = mm; m_landscape = landscape; update();
 }
 
-void LayoutPreviewWidget::setLabelSizeMM(const QSizeF &mm)
-{
-    m_labelMM = mm; update();
-}
-
 void LayoutPreviewWidget::setMarginsMM(const QMarginsF &mm)
 {
     m_marginsMM = mm; update();
 }
 
-void LayoutPreviewWidget::setSpacingMM(double hSpacing, double vSpacing)
+void LayoutPreviewWidget::setImposition(const ImpositionLayout &layout)
 {
-    m_hSpacingMM = hSpacing; m_vSpacingMM = vSpacing; update();
+    m_imposition = layout; update();
 }
 
 void LayoutPreviewWidget::paintEvent(QPaintEvent *event)
@@ -80,29 +70,20 @@ void LayoutPreviewWidget::paintEvent(QPaintEvent *event)
         innerRect = pageRect;
     }
 
-    // 如果没有标签尺寸或行列，则不画网格
-    if (m_rows<=0 || m_cols<=0 || m_labelMM.width()<=0.0 || m_labelMM.height()<=0.0) return;
-
-    // 以真实标签尺寸和间距绘制“块”
-    const qreal tileW = m_labelMM.width() * sx;
-    const qreal tileH = m_labelMM.height() * sy;
-    const qreal gapX = qMax<qreal>(0.0, m_hSpacingMM * sx);
-    const qreal gapY = qMax<qreal>(0.0, m_vSpacingMM * sy);
-
-    // 计算总占用，尽量在innerRect中居上左对齐展示
-    const qreal totalW = m_cols*tileW + (m_cols-1)*gapX;
-    const qreal totalH = m_rows*tileH + (m_rows-1)*gapY;
-    QRectF tilesRect(innerRect.topLeft(), QSizeF(qMin(innerRect.width(), totalW), qMin(innerRect.height(), totalH)));
-
-    p.setPen(QPen(QColor(180,180,180),0));
-    for (int r=0; r<m_rows; ++r) {
-        for (int c=0; c<m_cols; ++c) {
-            const qreal x = tilesRect.left() + c*(tileW+gapX);
-            const qreal y = tilesRect.top() + r*(tileH+gapY);
-            QRectF rect(x,y,tileW,tileH);
-            if (!innerRect.contains(rect)) continue;
-            p.drawRect(rect);
+    // 按排版引擎给出的单元格绘制（旋转放置的标签以浅色填充区分）
+    if (m_imposition.isEmpty()) return;
+
+    for (const ImpositionCell &cell : m_imposition.cells) {
+        const QRectF rect(pageRect.left() + cell.rectMM.x()*sx,
+                          pageRect.top() + cell.rectMM.y()*sy,
+                          cell.rectMM.width()*sx,
+                          cell.rectMM.height()*sy);
+        if (!innerRect.adjusted(-0.5,-0.5,0.5,0.5).contains(rect)) continue;
+        if (cell.rotated) {
+            p.fillRect(rect, QColor(64,128,255,30));
         }
+        p.setPen(QPen(QColor(180,180,180),0));
+        p.drawRect(rect);
     }
 }
 
@@ -121,6 +102,8 @@ void LayoutExportDialog::buildUi()
     m_horizontalRadio = new QRadioButton(tr("横向排序"),this);
     m_verticalRadio = new QRadioButton(tr("竖向排序"),this);
     m_horizontalRadio->setChecked(true);
+    m_autoFitCheck = new QCheckBox(tr("自动排版（允许旋转 90° 混排）"),this);
+    m_summaryLabel = new QLabel(this);
 
     m_rowSlider = new QSlider(Qt::Horizontal,this);
     m_rowSlider->setRange(1,20); m_rowSlider->setValue(5);
@@ -161,6 +144,12 @@ void LayoutExportDialog::buildUi()
     connect(m_pageSizeCombo,qOverload<int>(&QComboBox::currentIndexChanged),this,&LayoutExportDialog::recalcGrid);
     connect(m_landscapeCheck,&QCheckBox::toggled,this,&LayoutExportDialog::recalcGrid);
     connect(m_horizontalRadio,&QRadioButton::toggled,this,&LayoutExportDialog::updatePreview);
+    connect(m_autoFitCheck,&QCheckBox::toggled,this,[this](bool checked){
+        // 自动排版时行列由排版引擎决定
+        m_rowSlider->setEnabled(!checked); m_rowSpin->setEnabled(!checked);
+        m_colSlider->setEnabled(!checked); m_colSpin->setEnabled(!checked);
+        updatePreview();
+    });
     // 边距/间距联动
     auto connectMM = [this](QDoubleSpinBox* s){ connect(s, qOverload<double>(&QDoubleSpinBox::valueChanged), this, &LayoutExportDialog::recalcGrid); };
     connectMM(m_marginLeft); connectMM(m_marginRight); connectMM(m_marginTop); connectMM(m_marginBottom);
@@ -179,6 +168,9 @@ void LayoutExportDialog::buildUi()
     gridCfg->addWidget(m_colSlider,1,1);
     gridCfg->addWidget(m_colSpin,1,2);
 
+    gridCfg->addWidget(m_autoFitCheck,2,0,1,3);
+    gridCfg->addWidget(m_summaryLabel,3,0,1,3);
+
     QGroupBox *gridGroup = new QGroupBox(tr("网格配置"),this);
     gridGroup->setLayout(gridCfg);
 
@@ -280,15 +272,48 @@ double LayoutExportDialog::hSpacingMM() const { return m_hSpacing ? m_hSpacing->
 double LayoutExportDialog::vSpacingMM() const { return m_vSpacing ? m_vSpacing->value() : 0.0; }
 int LayoutExportDialog::startRow() const { return m_startRowSpin ? m_startRowSpin->value() : 1; }
 int LayoutExportDialog::startColumn() const { return m_startColSpin ? m_startColSpin->value() : 1; }
+bool LayoutExportDialog::autoFit() const { return m_autoFitCheck && m_autoFitCheck->isChecked(); }
+
+ImpositionSettings LayoutExportDialog::impositionSettings() const
+{
+    ImpositionSettings settings;
+    settings.pageSizeMM = orientedPageSizeMM();
+    settings.marginsMM = marginsMM();
+    settings.hSpacingMM = hSpacingMM();
+    settings.vSpacingMM = vSpacingMM();
+    settings.labelSizeMM = m_labelMM;
+    settings.horizontalOrder = horizontalOrder();
+    settings.allowRotation = autoFit();
+    return settings;
+}
+
+ImpositionLayout LayoutExportDialog::imposition() const
+{
+    const ImpositionSettings settings = impositionSettings();
+    return autoFit() ? ImpositionEngine::bestFit(settings)
+                     : ImpositionEngine::grid(settings, rows(), columns());
+}
 
 void LayoutExportDialog::updatePreview()
 {
     QSizeF mm = selectedPageSize();
     m_preview->setPageSize(mm, landscape());
-    m_preview->setLabelSizeMM(m_labelMM);
     m_preview->setMarginsMM(marginsMM());
-    m_preview->setSpacingMM(hSpacingMM(), vSpacingMM());
-    m_preview->setGrid(rows(), columns());
+
+    if (m_labelMM.width() <= 0.0 || m_labelMM.height() <= 0.0) {
+        m_preview->setImposition(ImpositionLayout());
+        if (m_summaryLabel) m_summaryLabel->clear();
+        return;
+    }
+
+    const ImpositionLayout layout = imposition();
+    m_preview->setImposition(layout);
+    if (m_summaryLabel) {
+        m_summaryLabel->setText(tr("每页 %1 个（旋转 %2 个），纸张利用率 %3%")
+                                .arg(layout.cellsPerPage())
+                                .arg(layout.rotatedCellCount())
+                                .arg(layout.utilisation() * 100.0, 0, 'f', 1));
+    }
 }
 
 void LayoutExportDialog::syncRowSlider(int value){ m_rowSpin->setValue(value); updatePreview(); }
@@ -311,18 +336,9 @@ void LayoutExportDialog::recalcGrid()
     }
 
     // 考虑页边距与间距的最大行列数
-    const QMarginsF m = marginsMM();
-    const double innerW = qMax(0.0, pageMM.width() - (m.left() + m.right()));
-    const double innerH = qMax(0.0, pageMM.height() - (m.top() + m.bottom()));
-    const double gapX = qMax(0.0, hSpacingMM());
-    const double gapY = qMax(0.0, vSpacingMM());
-    // N*W + (N-1)*gap <= inner -> N <= floor((inner + gap)/(W + gap))
-    int maxCols = (m_labelMM.width() > 0.0)
-        ? static_cast<int>(std::floor((innerW + gapX) / (m_labelMM.width() + gapX))) : 0;
-    int maxRows = (m_labelMM.height() > 0.0)
-        ? static_cast<int>(std::floor((innerH + gapY) / (m_labelMM.height() + gapY))) : 0;
-    maxCols = std::max(1, maxCols);
-    maxRows = std::max(1, maxRows);
+    const QSize capacity = ImpositionEngine::gridCapacity(impositionSettings());
+    const int maxCols = std::max(1, capacity.width());
+    const int maxRows = std::max(1, capacity.height());
 
     // 若当前用户设定超过最大值，自动截断；若为初始状态使用最大值填充
     if (m_colSpin->value() > maxCols) {
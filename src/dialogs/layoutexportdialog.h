@@ -4,6 +4,8 @@
 #include <QDialog>
 #include <QSizeF>
 
+#include "../printing/imposition.h"
+
 class QComboBox;
 class QRadioButton;
 class QSpinBox;
@@ -32,6 +34,10 @@ public:
     // 起始偏移（第一页从指定行列开始） 1-based；超出范围时内部自动钳制
     int startRow() const; // 1-based
     int startColumn() const; // 1-based
+    // 自动排版：允许 0°/90° 混排以获得单页最多标签
+    bool autoFit() const;
+    ImpositionSettings impositionSettings() const;
+    ImpositionLayout imposition() const;
 
 private slots:
     void updatePreview();
@@ -64,6 +70,8 @@ private:
     QDoubleSpinBox *m_vSpacing{};
     QSpinBox *m_startRowSpin{};
     QSpinBox *m_startColSpin{};
+    QCheckBox *m_autoFitCheck{};
+    QLabel *m_summaryLabel{};
     LayoutPreviewWidget *m_preview{};
     QPushButton *m_exportButton{};
     QPushButton *m_cancelButton{};
@@ -76,22 +84,16 @@ class LayoutPreviewWidget : public QWidget
     Q_OBJECT
 public:
     explicit LayoutPreviewWidget(QWidget *parent = nullptr);
-    void setGrid(int rows, int cols);
     void setPageSize(const QSizeF &mm, bool landscape);
-    void setLabelSizeMM(const QSizeF &mm);
     void setMarginsMM(const QMarginsF &mm);
-    void setSpacingMM(double hSpacing, double vSpacing);
+    void setImposition(const ImpositionLayout &layout);
 protected:
     void paintEvent(QPaintEvent *event) override;
 private:
-    int m_rows{0};
-    int m_cols{0};
     QSizeF m_pageMM{210.0,297.0};
     bool m_landscape{false};
-    QSizeF m_labelMM{0.0,0.0};
     QMarginsF m_marginsMM{0.0,0.0,0.0,0.0};
-    double m_hSpacingMM{0.0};
-    double m_vSpacingMM{0.0};
+    ImpositionLayout m_imposition;
 };
 
 #endif // LAYOUTEXPORTDIALOG_H
@@ -4,11 +4,18 @@
 #include "../graphics/labelscene.h"
 #include "../printing/batchprintmanager.h"
 #include "../printing/printengine.h"
+#include "../printing/imposition.h"
+#include "../printing/elementmodelrenderer.h"
+#include "../printing/symbolprefetcher.h"
 #include "../core/labelelement.h"
 #include "../core/datasource.h"
 #include "../core/textelement.h"
 #include "../core/barcodeelement.h"
 #include "../core/qrcodeelement.h"
+#include "../core/imageelement.h"
+#include "../core/imagestore.h"
+#include "../graphics/recordimageprovider.h"
+#include "../graphics/textitem.h"
 
 #include <QPrinter>
 #include <QPrintDialog>
@@ -25,20 +32,28 @@
 #include <QGraphicsItem>
 #include <QGraphicsPixmapItem>
 #include <QGraphicsView>
+#include <QItemSelectionModel>
+#include <QListView>
 #include <QScrollBar>
 #include <QSignalBlocker>
 #include <QTimer>
 #include <QImage>
 #include <QPainter>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTransform>
 #include <QtCore/qscopeguard.h>
 #include <QLatin1Char>
 #include <QVector>
 #include <QtGlobal>
 #include <QtMath>
 #include "layoutexportdialog.h"
+#include "recordthumbnailmodel.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <utility>
 
 namespace {
@@ -50,12 +65,15 @@ enum class ExportMode {
 };
 
 constexpr int kExportModeRole = Qt::UserRole;
+// 预览缓存按像素字节计算的容量上限
+constexpr int kPreviewCacheBudgetBytes = 128 * 1024 * 1024;
 
 struct PreviewBinding
 {
     TextElement *text = nullptr;
     BarcodeElement *barcode = nullptr;
     QRCodeElement *qrcode = nullptr;
+    ImageElement *image = nullptr;
 
     bool apply(int recordIndex) const
     {
@@ -68,6 +86,9 @@ struct PreviewBinding
         if (qrcode) {
             return qrcode->applyDataSourceRecord(recordIndex);
         }
+        if (image) {
+            return image->applyDataSourceRecord(recordIndex);
+        }
         return true;
     }
 
@@ -79,6 +100,8 @@ struct PreviewBinding
             barcode->restoreOriginalData();
         } else if (qrcode) {
             qrcode->restoreOriginalData();
+        } else if (image) {
+            image->restoreOriginalData();
         }
     }
 };
@@ -157,8 +180,9 @@ bool applyPreviewRecord(const QList<labelelement*> &elements,
         binding.text = dynamic_cast<TextElement*>(element);
         binding.barcode = dynamic_cast<BarcodeElement*>(element);
         binding.qrcode = dynamic_cast<QRCodeElement*>(element);
+        binding.image = dynamic_cast<ImageElement*>(element);
 
-        if (!binding.text && !binding.barcode && !binding.qrcode) {
+        if (!binding.text && !binding.barcode && !binding.qrcode && !binding.image) {
             if (errorMessage) {
                 *errorMessage = PrintCenterDialog::tr("元素类型 %1 暂不支持数据源预览")
                                          .arg(element->getType());
@@ -197,15 +221,36 @@ PrintCenterDialog::PrintCenterDialog(LabelScene* scene, PrintEngine* engine, QWi
     , m_previewPixmapItem(nullptr)
     , m_zoomFactor(1.0)
     , m_previewDevicePixelRatio(1.0)
+    , m_previewCache(kPreviewCacheBudgetBytes)
+    , m_designRevision(0)
+    , m_recordRevision(0)
     , m_previewUpdateScheduled(false)
+    , m_previewWorkTimer(new QTimer(this))
+    , m_previewRefinePending(false)
+    , m_thumbnailModel(new RecordThumbnailModel(this))
     , m_suppressSceneInvalidation(false)
     , m_currentBatchIndex(0)
     , m_totalBatchCount(0)
     , m_batchWindowStart(0)
     , m_previewBaseSize(1024, 768)
 {
+    // 记录图像文件可能在两次打开之间被替换或补齐，重新解析、解码
+    RecordImageProvider::instance().clear();
+
     ui->setupUi(this);
 
+    m_previewWorkTimer->setSingleShot(true);
+    m_previewWorkTimer->setInterval(0);
+    connect(m_previewWorkTimer, &QTimer::timeout, this, &PrintCenterDialog::processPreviewWork);
+
+    m_thumbnailModel->setRenderer([this](int recordIndex, const QSize &pixelSize) {
+        return thumbnailTask(recordIndex, pixelSize);
+    });
+    if (ui->thumbnailStrip) {
+        ui->thumbnailStrip->setModel(m_thumbnailModel);
+        updateThumbnailGeometry();
+    }
+
     if (ui->comboExportMode && ui->comboExportMode->count() >= 3) {
         ui->comboExportMode->setItemData(0, static_cast<int>(ExportMode::Combined), kExportModeRole);
         ui->comboExportMode->setItemData(1, static_cast<int>(ExportMode::Separate), kExportModeRole);
@@ -213,12 +258,22 @@ PrintCenterDialog::PrintCenterDialog(LabelScene* scene, PrintEngine* engine, QWi
     }
 
     if (m_scene) {
-        connect(m_scene, &QGraphicsScene::changed, this, [this](const QList<QRectF>&) {
+        connect(m_scene, &QGraphicsScene::changed, this, [this](const QList<QRectF>& region) {
             if (m_suppressSceneInvalidation) {
                 return;
             }
-            invalidatePreviewCache();
+            // 只重新序列化变化区域内的元素；选中、悬停等不影响输出的变化不触发重绘。
+            // 修订号变化后旧条目自然失效，撤销回原状态时仍可命中
+            markElementsModified(region);
+            const quint64 previousRecordRevision = m_recordRevision;
+            if (!refreshTemplateRevision()) {
+                return;
+            }
+            cancelPreviewWork();
             rebuildRenderModel();
+            if (m_recordRevision != previousRecordRevision) {
+                m_thumbnailModel->invalidate();
+            }
             if (!m_previewUpdateScheduled) {
                 m_previewUpdateScheduled = true;
                 QTimer::singleShot(0, this, [this]() {
@@ -257,8 +312,11 @@ void PrintCenterDialog::setElements(const QList<labelelement*>& elements)
 {
     invalidatePreviewCache();
     m_elements = elements;
+    m_elementDigests.clear();
+    refreshTemplateRevision();
     m_currentBatchIndex = 0;
     rebuildRenderModel();
+    m_thumbnailModel->invalidate();
     if (m_batchManager) {
         const QList<labelelement*> target = m_renderElements.isEmpty() ? m_elements : m_renderElements;
         m_batchManager->setElements(target);
@@ -294,6 +352,8 @@ void PrintCenterDialog::setBaseContext(const PrintContext& context)
     }
     m_zoomFactor = 1.0;
     updateSizeLabel();
+    updateThumbnailGeometry();
+    m_thumbnailModel->invalidate();
     updatePreview();
 }
 
@@ -318,6 +378,15 @@ void PrintCenterDialog::setupConnections()
         });
     }
     
+    if (ui->thumbnailStrip && ui->thumbnailStrip->selectionModel()) {
+        connect(ui->thumbnailStrip->selectionModel(), &QItemSelectionModel::currentChanged, this,
+                [this](const QModelIndex &current) {
+                    if (current.isValid() && current.row() != m_currentBatchIndex) {
+                        onBatchSelected(current.row());
+                    }
+                });
+    }
+    
     // 页面导航
     connect(ui->pageInput, &QLineEdit::returnPressed, this, &PrintCenterDialog::onPageInputChanged);
     
@@ -362,40 +431,68 @@ void PrintCenterDialog::updatePreview()
         return;
     }
 
-    m_previewScene->clear();
-    m_previewPixmapItem = nullptr;
-    m_previewDevicePixelRatio = 1.0;
+    // 新的预览请求使尚未完成的精绘与预取全部失效
+    cancelPreviewWork();
 
     QGraphicsScene *renderScene = m_renderScene ? m_renderScene.get() : m_scene;
     const QList<labelelement*> &renderElements = m_renderElements.isEmpty() ? m_elements : m_renderElements;
 
     if (!renderScene || !m_printEngine || renderElements.isEmpty()) {
-        m_currentPreview = QPixmap();
-        m_previewScene->addText(tr("暂无可预览内容"));
-        m_previewScene->setSceneRect(m_previewScene->itemsBoundingRect());
-        applyZoom();
+        showPreviewMessage(tr("暂无可预览内容"));
         updatePreviewStatus(false);
         return;
     }
 
-    QPrinter dummyPrinter(QPrinter::HighResolution);
-    if (m_baseContext.pageLayout.isValid()) {
-        dummyPrinter.setPageLayout(m_baseContext.pageLayout);
-    } else {
-        dummyPrinter.setPageOrientation(QPageLayout::Portrait);
-        dummyPrinter.setPageSize(QPageSize::A4);
+    const int recordIndex = currentPreviewRecord();
+    const PreviewRequest request = makePreviewRequest(recordIndex, previewRenderScale());
+    if (const CachedPreview *cached = m_previewCache.object(previewCacheKey(request.renderSize, recordIndex))) {
+        showPreview(*cached);
+        updatePreviewStatus(false);
+        queuePreviewPrefetch(recordIndex);
+        return;
     }
-    dummyPrinter.setResolution(300);
 
-    PrintContext context = m_baseContext;
-    context.printer = &dummyPrinter;
-    context.pageLayout = dummyPrinter.pageLayout();
-    context.contentMargins = m_baseContext.contentMargins.isNull()
-                                 ? context.pageLayout.margins(QPageLayout::Millimeter)
-                                 : m_baseContext.contentMargins;
-    context.sourceScene = renderScene;
+    // 先同步绘制一张低分辨率草图，完整质量的绘制放到事件循环的后续轮次，
+    // 期间的翻页/缩放会直接取消尚未开始的精绘
+    constexpr qreal kDraftScale = 0.5;
+    CachedPreview draft;
+    QString errorMsg;
+    if (!renderPreviewImage(makePreviewRequest(recordIndex, kDraftScale), &draft, &errorMsg)) {
+        showPreviewMessage(errorMsg.isEmpty() ? tr("无法生成预览") : errorMsg);
+        updatePreviewStatus(false);
+        return;
+    }
+
+    showPreview(draft);
+    if (ui->labelPreviewStatus) {
+        ui->labelPreviewStatus->setText(tr("正在优化预览…"));
+    }
+    m_previewRefinePending = true;
+    m_previewWorkTimer->start();
+}
+
+int PrintCenterDialog::currentPreviewRecord() const
+{
+    return (m_batchManager && m_totalBatchCount > 0)
+               ? qBound(0, m_currentBatchIndex, m_totalBatchCount - 1)
+               : -1;
+}
+
+qreal PrintCenterDialog::previewRenderScale() const
+{
+    constexpr qreal kMinQualityScale = 1.75;
+    constexpr qreal kMaxQualityScale = 4.0;
+    return std::clamp(m_zoomFactor, kMinQualityScale, kMaxQualityScale);
+}
+
+PrintCenterDialog::PreviewRequest PrintCenterDialog::makePreviewRequest(int recordIndex, qreal renderScale) const
+{
+    PreviewRequest request;
+    request.recordIndex = recordIndex;
 
     const QSize baseSize = previewImageSize();
+    request.logicalSize = baseSize;
+
     const qreal designWidthPx = m_baseContext.labelSizePixels.width() > 0.0
                                     ? m_baseContext.labelSizePixels.width()
                                     : baseSize.width();
@@ -403,54 +500,9 @@ void PrintCenterDialog::updatePreview()
                                      ? m_baseContext.labelSizePixels.height()
                                      : baseSize.height();
 
-    constexpr qreal kMinQualityScale = 1.75;
-    constexpr qreal kMaxQualityScale = 4.0;
-    qreal renderScale = std::max(m_zoomFactor, kMinQualityScale);
-    renderScale = std::min(renderScale, kMaxQualityScale);
-
     const int renderWidth = qMax(1, static_cast<int>(std::ceil(designWidthPx * renderScale)));
     const int renderHeight = qMax(1, static_cast<int>(std::ceil(designHeightPx * renderScale)));
-    const QSize renderSize(renderWidth, renderHeight);
-
-    const int recordIndex = (m_batchManager && m_totalBatchCount > 0)
-                                ? qBound(0, m_currentBatchIndex, m_totalBatchCount - 1)
-                                : -1;
-
-    const QString cacheKey = previewCacheKey(renderSize, recordIndex);
-    if (const auto cachedIt = m_previewCache.constFind(cacheKey); cachedIt != m_previewCache.constEnd()) {
-        const CachedPreview &cached = cachedIt.value();
-        m_previewCacheOrder.removeAll(cacheKey);
-        m_previewCacheOrder.append(cacheKey);
-        m_currentPreview = cached.pixmap;
-        m_previewPixmapItem = m_previewScene->addPixmap(m_currentPreview);
-        const QSize logical = !cached.logicalSize.isEmpty() ? cached.logicalSize : baseSize;
-        m_previewScene->setSceneRect(QRectF(QPointF(0.0, 0.0), QSizeF(logical)));
-        m_previewDevicePixelRatio = cached.devicePixelRatio > 0.0
-                                        ? cached.devicePixelRatio
-                                        : m_currentPreview.devicePixelRatio();
-        applyZoom();
-        updatePreviewStatus(false);
-        return;
-    }
-
-    updatePreviewStatus(true);
-
-    QVector<PreviewBinding> previewBindings;
-    auto restoreGuard = qScopeGuard([&previewBindings]() {
-        restorePreviewBindings(previewBindings);
-    });
-
-    if (recordIndex >= 0) {
-        QString dataError;
-        if (!applyPreviewRecord(renderElements, recordIndex, &previewBindings, &dataError)) {
-            m_currentPreview = QPixmap();
-            m_previewScene->addText(dataError.isEmpty() ? tr("无法生成预览") : dataError);
-            m_previewScene->setSceneRect(m_previewScene->itemsBoundingRect());
-            applyZoom();
-            updatePreviewStatus(false);
-            return;
-        }
-    }
+    request.renderSize = QSize(renderWidth, renderHeight);
 
     const qreal widthRatio = (baseSize.width() > 0)
                                  ? static_cast<qreal>(renderWidth) / baseSize.width()
@@ -458,7 +510,7 @@ void PrintCenterDialog::updatePreview()
     const qreal heightRatio = (baseSize.height() > 0)
                                   ? static_cast<qreal>(renderHeight) / baseSize.height()
                                   : renderScale;
-    const qreal devicePixelRatio = std::max(widthRatio, heightRatio);
+    request.devicePixelRatio = std::max(widthRatio, heightRatio);
 
     auto clampDpi = [](qreal value) {
         return std::clamp(value, 90.0, 600.0);
@@ -474,43 +526,172 @@ void PrintCenterDialog::updatePreview()
     }
 
     if (dpiX <= 0.0 && dpiY <= 0.0) {
-        const qreal fallbackDpi = clampDpi(150.0 * devicePixelRatio);
+        const qreal fallbackDpi = clampDpi(150.0 * request.devicePixelRatio);
         dpiX = dpiY = fallbackDpi;
     } else if (dpiX <= 0.0) {
         dpiX = dpiY;
     } else if (dpiY <= 0.0) {
         dpiY = dpiX;
     }
+    request.dpiX = dpiX;
+    request.dpiY = dpiY;
 
-    QString errorMsg;
-    QImage previewImage = m_printEngine->renderPreview(renderElements, context, renderSize, &errorMsg, dpiX, dpiY);
+    return request;
+}
+
+bool PrintCenterDialog::renderPreviewImage(const PreviewRequest &request, CachedPreview *preview, QString *errorMessage)
+{
+    QGraphicsScene *renderScene = m_renderScene ? m_renderScene.get() : m_scene;
+    const QList<labelelement*> &renderElements = m_renderElements.isEmpty() ? m_elements : m_renderElements;
+    if (!preview || !renderScene || !m_printEngine || renderElements.isEmpty()) {
+        if (errorMessage) {
+            *errorMessage = tr("暂无可预览内容");
+        }
+        return false;
+    }
+
+    QPrinter dummyPrinter(QPrinter::HighResolution);
+    if (m_baseContext.pageLayout.isValid()) {
+        dummyPrinter.setPageLayout(m_baseContext.pageLayout);
+    } else {
+        dummyPrinter.setPageOrientation(QPageLayout::Portrait);
+        dummyPrinter.setPageSize(QPageSize::A4);
+    }
+    dummyPrinter.setResolution(300);
+
+    PrintContext context = m_baseContext;
+    context.printer = &dummyPrinter;
+    context.pageLayout = dummyPrinter.pageLayout();
+    context.contentMargins = m_baseContext.contentMargins.isNull()
+                                 ? context.pageLayout.margins(QPageLayout::Millimeter)
+                                 : m_baseContext.contentMargins;
+    context.sourceScene = renderScene;
+
+    QVector<PreviewBinding> previewBindings;
+    auto restoreGuard = qScopeGuard([&previewBindings]() {
+        restorePreviewBindings(previewBindings);
+    });
+
+    if (request.recordIndex >= 0) {
+        if (!applyPreviewRecord(renderElements, request.recordIndex, &previewBindings, errorMessage)) {
+            return false;
+        }
+    }
+
+    QImage previewImage = m_printEngine->renderPreview(renderElements, context, request.renderSize,
+                                                       errorMessage, request.dpiX, request.dpiY);
     if (previewImage.isNull()) {
-        m_currentPreview = QPixmap();
-        m_previewScene->addText(errorMsg.isEmpty() ? tr("无法生成预览") : errorMsg);
-        m_previewScene->setSceneRect(m_previewScene->itemsBoundingRect());
-        applyZoom();
-        updatePreviewStatus(false);
-        updatePreviewControlsEnabled(true);
-        return;
+        return false;
     }
 
-    previewImage.setDevicePixelRatio(devicePixelRatio);
-    m_currentPreview = QPixmap::fromImage(previewImage);
+    previewImage.setDevicePixelRatio(request.devicePixelRatio);
+    preview->pixmap = QPixmap::fromImage(previewImage);
+    preview->logicalSize = request.logicalSize;
+    preview->devicePixelRatio = request.devicePixelRatio;
+    return true;
+}
+
+void PrintCenterDialog::showPreview(const CachedPreview &preview)
+{
+    m_previewScene->clear();
+    m_currentPreview = preview.pixmap;
     m_previewPixmapItem = m_previewScene->addPixmap(m_currentPreview);
-    m_previewScene->setSceneRect(QRectF(QPointF(0.0, 0.0), QSizeF(baseSize)));
-    m_previewDevicePixelRatio = devicePixelRatio;
-
-    CachedPreview cached;
-    cached.pixmap = m_currentPreview;
-    cached.logicalSize = baseSize;
-    cached.devicePixelRatio = devicePixelRatio;
-    m_previewCache.insert(cacheKey, cached);
-    m_previewCacheOrder.removeAll(cacheKey);
-    m_previewCacheOrder.append(cacheKey);
-    prunePreviewCache();
+    const QSize logical = !preview.logicalSize.isEmpty() ? preview.logicalSize : previewImageSize();
+    m_previewScene->setSceneRect(QRectF(QPointF(0.0, 0.0), QSizeF(logical)));
+    m_previewDevicePixelRatio = preview.devicePixelRatio > 0.0
+                                    ? preview.devicePixelRatio
+                                    : m_currentPreview.devicePixelRatio();
+    applyZoom();
+}
 
+void PrintCenterDialog::showPreviewMessage(const QString &message)
+{
+    m_previewScene->clear();
+    m_previewPixmapItem = nullptr;
+    m_previewDevicePixelRatio = 1.0;
+    m_currentPreview = QPixmap();
+    m_previewScene->addText(message);
+    m_previewScene->setSceneRect(m_previewScene->itemsBoundingRect());
     applyZoom();
-    updatePreviewStatus(false);
+}
+
+void PrintCenterDialog::storePreview(const PreviewCacheKey &cacheKey, const CachedPreview &preview)
+{
+    // 按像素字节计费，超出预算时 QCache 自动淘汰最久未使用的条目
+    const qint64 bytes = static_cast<qint64>(preview.pixmap.width()) * preview.pixmap.height()
+                         * qMax(1, preview.pixmap.depth() / 8);
+    const int cost = static_cast<int>(qBound<qint64>(1, bytes, kPreviewCacheBudgetBytes));
+    m_previewCache.insert(cacheKey, new CachedPreview(preview), cost);
+}
+
+void PrintCenterDialog::cancelPreviewWork()
+{
+    m_previewRefinePending = false;
+    m_previewPrefetchQueue.clear();
+    if (m_previewWorkTimer) {
+        m_previewWorkTimer->stop();
+    }
+}
+
+void PrintCenterDialog::queuePreviewPrefetch(int recordIndex)
+{
+    m_previewPrefetchQueue.clear();
+    if (recordIndex < 0 || m_totalBatchCount <= 1) {
+        return;
+    }
+
+    // 预取相邻记录：N+1、N-1、N+2、N-2
+    for (int distance = 1; distance <= 2; ++distance) {
+        for (int candidate : { recordIndex + distance, recordIndex - distance }) {
+            if (candidate >= 0 && candidate < m_totalBatchCount) {
+                m_previewPrefetchQueue.append(candidate);
+            }
+        }
+    }
+
+    if (!m_previewPrefetchQueue.isEmpty()) {
+        m_previewWorkTimer->start();
+    }
+}
+
+void PrintCenterDialog::processPreviewWork()
+{
+    // 每轮事件循环只处理一个任务，用户操作可在任务之间插入并取消后续任务
+    if (m_previewRefinePending) {
+        m_previewRefinePending = false;
+
+        const int recordIndex = currentPreviewRecord();
+        const PreviewRequest request = makePreviewRequest(recordIndex, previewRenderScale());
+        CachedPreview preview;
+        QString errorMsg;
+        if (renderPreviewImage(request, &preview, &errorMsg)) {
+            storePreview(previewCacheKey(request.renderSize, recordIndex), preview);
+            showPreview(preview);
+            queuePreviewPrefetch(recordIndex);
+        } else {
+            showPreviewMessage(errorMsg.isEmpty() ? tr("无法生成预览") : errorMsg);
+        }
+        updatePreviewStatus(false);
+        return;
+    }
+
+    if (m_previewPrefetchQueue.isEmpty()) {
+        return;
+    }
+
+    const int recordIndex = m_previewPrefetchQueue.takeFirst();
+    const PreviewRequest request = makePreviewRequest(recordIndex, previewRenderScale());
+    const PreviewCacheKey cacheKey = previewCacheKey(request.renderSize, recordIndex);
+    if (!m_previewCache.contains(cacheKey)) {
+        CachedPreview preview;
+        if (renderPreviewImage(request, &preview, nullptr)) {
+            storePreview(cacheKey, preview);
+        }
+    }
+
+    if (!m_previewPrefetchQueue.isEmpty()) {
+        m_previewWorkTimer->start();
+    }
 }
 
 void PrintCenterDialog::updateSizeLabel()
@@ -596,6 +777,8 @@ void PrintCenterDialog::updateBatchButtons()
     if (ui->btnNextBatch) {
         ui->btnNextBatch->setEnabled(m_currentBatchIndex < m_totalBatchCount - 1);
     }
+
+    syncThumbnailSelection();
 }
 
 void PrintCenterDialog::ensureBatchWindowVisible()
@@ -616,40 +799,261 @@ void PrintCenterDialog::ensureBatchWindowVisible()
     m_batchWindowStart = qBound(0, m_batchWindowStart, maxStart);
 }
 
+QRectF PrintCenterDialog::designSourceRect(QGraphicsScene *renderScene, const QList<labelelement*> &elements) const
+{
+    // 优先使用标签像素尺寸以保持与非排版导出一致的物理比例；
+    // 若未提供，则退回到场景矩形或元素联合边界。
+    if (m_baseContext.labelSizePixels.width() > 0.0 && m_baseContext.labelSizePixels.height() > 0.0) {
+        return QRectF(0, 0,
+                      m_baseContext.labelSizePixels.width(),
+                      m_baseContext.labelSizePixels.height());
+    }
+
+    QRectF designRect;
+    bool first = true;
+    for (labelelement *el : elements) {
+        if (!el) continue;
+        if (QGraphicsItem *it = el->getItem()) {
+            const QRectF r = it->sceneBoundingRect();
+            if (first) { designRect = r; first = false; }
+            else { designRect = designRect.united(r); }
+        }
+    }
+    if (designRect.isEmpty() && renderScene) {
+        designRect = renderScene->sceneRect();
+    }
+    if (designRect.width() <= 0 || designRect.height() <= 0) {
+        designRect = QRectF(0,0,100,100);
+    }
+    return designRect;
+}
+
+void PrintCenterDialog::updateThumbnailGeometry()
+{
+    if (!ui->thumbnailStrip) {
+        return;
+    }
+
+    constexpr int kThumbnailHeight = 64;
+    qreal aspect = 1.5;
+    if (m_baseContext.labelSizeMM.width() > 0.0 && m_baseContext.labelSizeMM.height() > 0.0) {
+        aspect = m_baseContext.labelSizeMM.width() / m_baseContext.labelSizeMM.height();
+    }
+    const int thumbnailWidth = qBound(40, qRound(kThumbnailHeight * aspect), 160);
+    const QSize thumbnailSize(thumbnailWidth, kThumbnailHeight);
+
+    m_thumbnailModel->setThumbnailSize(thumbnailSize, ui->thumbnailStrip->devicePixelRatioF());
+    ui->thumbnailStrip->setIconSize(thumbnailSize);
+    ui->thumbnailStrip->setGridSize(QSize(thumbnailWidth + 12, kThumbnailHeight + 30));
+}
+
+struct PrintCenterDialog::ThumbnailSnapshot
+{
+    struct Element {
+        QString type;
+        QJsonObject data;
+        std::shared_ptr<DataSource> source;
+        bool sourceEnabled = false;
+        QPointF pos;
+        QTransform transform;
+        QPointF transformOrigin;
+        qreal z = 0.0;
+    };
+    QVector<Element> elements;
+};
+
+std::function<QImage()> PrintCenterDialog::thumbnailTask(int recordIndex, const QSize &pixelSize) const
+{
+    if (!m_thumbnailSnapshot || m_thumbnailSnapshot->elements.isEmpty() || pixelSize.isEmpty()) {
+        return {};
+    }
+
+    // 池线程创建文本项时不能访问屏幕，先在本线程取得逻辑 DPI
+    TextItem::screenLogicalDpi();
+    const std::shared_ptr<const ThumbnailSnapshot> snapshot = m_thumbnailSnapshot;
+    const QRectF sourceRect = designSourceRect(m_renderScene.get(), m_renderElements);
+    return [snapshot, recordIndex, pixelSize, sourceRect]() {
+        // 元素与图形项只在本线程中创建、绘制和释放，不加入场景；
+        // 数据源只读，可与 GUI 线程共享
+        std::vector<std::unique_ptr<labelelement>> owned;
+        QList<labelelement*> elements;
+        for (const ThumbnailSnapshot::Element &entry : snapshot->elements) {
+            auto element = labelelement::createFromType(entry.type);
+            if (!element) {
+                continue;
+            }
+            element->setData(entry.data);
+            if (entry.source) {
+                element->setDataSource(entry.source);
+                element->setDataSourceEnabled(entry.sourceEnabled);
+            }
+            QGraphicsItem *item = element->ensureItem();
+            if (!item) {
+                continue;
+            }
+            element->setPos(entry.pos);
+            item->setTransform(entry.transform);
+            item->setTransformOriginPoint(entry.transformOrigin);
+            item->setZValue(entry.z);
+            elements.append(element.get());
+            owned.push_back(std::move(element));
+        }
+
+        QImage image;
+        QVector<PreviewBinding> bindings;
+        if (applyPreviewRecord(elements, recordIndex, &bindings, nullptr)) {
+            image = QImage(pixelSize, QImage::Format_RGB32);
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::Antialiasing, true);
+            painter.setRenderHint(QPainter::TextAntialiasing, true);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+            ElementModelRenderer::paintElements(painter, elements, QRectF(QPointF(0.0, 0.0), QSizeF(pixelSize)),
+                                                sourceRect, Qt::KeepAspectRatio);
+            painter.end();
+        }
+
+        // 元素不拥有图形项
+        for (const auto &element : owned) {
+            delete element->getItem();
+        }
+        return image;
+    };
+}
+
+void PrintCenterDialog::syncThumbnailSelection()
+{
+    if (!ui->thumbnailStrip || !ui->thumbnailStrip->isVisible() || m_thumbnailModel->recordCount() <= 0) {
+        return;
+    }
+
+    const QModelIndex index = m_thumbnailModel->index(qBound(0, m_currentBatchIndex, m_thumbnailModel->recordCount() - 1));
+    if (ui->thumbnailStrip->currentIndex() != index) {
+        ui->thumbnailStrip->setCurrentIndex(index);
+    }
+    ui->thumbnailStrip->scrollTo(index);
+}
+
 void PrintCenterDialog::invalidatePreviewCache()
 {
+    cancelPreviewWork();
     m_previewCache.clear();
     m_previewDevicePixelRatio = 1.0;
-    m_previewCacheOrder.clear();
 }
 
-QString PrintCenterDialog::previewCacheKey(const QSize& renderSize, int recordIndex) const
+PrintCenterDialog::PreviewCacheKey PrintCenterDialog::previewCacheKey(const QSize& renderSize, int recordIndex) const
 {
-    return QStringLiteral("%1_%2x%3")
-    .arg(recordIndex)
-        .arg(renderSize.width())
-        .arg(renderSize.height());
+    PreviewCacheKey key;
+    key.recordIndex = recordIndex;
+    key.renderSize = renderSize;
+    // 记录预览中绑定元素的内容来自数据源，只依赖记录修订号
+    key.revision = recordIndex >= 0 ? m_recordRevision : m_designRevision;
+    return key;
 }
 
-void PrintCenterDialog::prunePreviewCache()
+void PrintCenterDialog::markElementsModified(const QList<QRectF>& region)
 {
-    constexpr int kMaxEntries = 12;
-    while (m_previewCacheOrder.size() > kMaxEntries) {
-        const QString oldestKey = m_previewCacheOrder.takeFirst();
-        m_previewCache.remove(oldestKey);
+    if (region.isEmpty() || m_elementDigests.isEmpty()) {
+        return;
     }
+    for (labelelement *element : std::as_const(m_elements)) {
+        const QGraphicsItem *item = element ? element->getItem() : nullptr;
+        if (!item) {
+            continue;
+        }
+        // 水平、垂直线条的包围矩形可能没有面积，稍作扩展
+        const QRectF itemRect = item->sceneBoundingRect().adjusted(-1.0, -1.0, 1.0, 1.0);
+        for (const QRectF &rect : region) {
+            if (rect.intersects(itemRect)) {
+                m_elementDigests.remove(element);
+                break;
+            }
+        }
+    }
+}
+
+bool PrintCenterDialog::refreshTemplateRevision()
+{
+    QCryptographicHash designHash(QCryptographicHash::Sha1);
+    QCryptographicHash recordHash(QCryptographicHash::Sha1);
+
+    for (labelelement *element : std::as_const(m_elements)) {
+        if (!element) {
+            continue;
+        }
+
+        auto digest = m_elementDigests.find(element);
+        if (digest == m_elementDigests.end()) {
+            // 经文档图像表序列化：图像只写 "imageRef"（内容哈希），不做 Base64 编码
+            ImageStore images;
+            element->setImageStore(&images);
+            QJsonObject json = element->toJson();
+            element->setImageStore(nullptr);
+
+            ElementDigest computed;
+            computed.design = QCryptographicHash::hash(QJsonDocument(json).toJson(QJsonDocument::Compact),
+                                                       QCryptographicHash::Sha1);
+            if (element->isDataSourceEnabled()) {
+                // 绑定元素的设计期内容在记录预览中会被替换，不参与记录修订号
+                json.remove(QStringLiteral("text"));
+                json.remove(QStringLiteral("data"));
+                json.remove(QStringLiteral("imageRef"));
+            }
+            computed.record = QCryptographicHash::hash(QJsonDocument(json).toJson(QJsonDocument::Compact),
+                                                       QCryptographicHash::Sha1);
+            digest = m_elementDigests.insert(element, computed);
+        }
+        designHash.addData(digest->design);
+        recordHash.addData(digest->record);
+
+        if (element->isDataSourceEnabled()) {
+            // 数据源实例与记录数变化需要参与记录修订号
+            const std::shared_ptr<DataSource> source = element->dataSource();
+            const qint64 sourceState[] = { static_cast<qint64>(reinterpret_cast<quintptr>(source.get())),
+                                           source ? source->count() : 0 };
+            recordHash.addData(QByteArray::fromRawData(reinterpret_cast<const char *>(sourceState),
+                                                       sizeof(sourceState)));
+        }
+
+        if (const QGraphicsItem *item = element->getItem()) {
+            const QTransform transform = item->transform();
+            const qreal geometry[] = { transform.m11(), transform.m12(), transform.m13(),
+                                       transform.m21(), transform.m22(), transform.m23(),
+                                       transform.m31(), transform.m32(), transform.m33(),
+                                       item->zValue() };
+            const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(geometry),
+                                                             sizeof(geometry));
+            designHash.addData(bytes);
+            recordHash.addData(bytes);
+        }
+    }
+
+    auto toRevision = [](const QByteArray &digest) {
+        quint64 value = 0;
+        std::memcpy(&value, digest.constData(), sizeof(value));
+        return value;
+    };
+
+    const quint64 designRevision = toRevision(designHash.result());
+    const quint64 recordRevision = toRevision(recordHash.result());
+    const bool changed = designRevision != m_designRevision || recordRevision != m_recordRevision;
+    m_designRevision = designRevision;
+    m_recordRevision = recordRevision;
+    return changed;
 }
 
 void PrintCenterDialog::rebuildRenderModel()
 {
     m_renderElements.clear();
     m_renderElementStorage.clear();
+    m_thumbnailSnapshot.reset();
 
     if (m_elements.isEmpty()) {
         m_renderScene.reset();
         return;
     }
 
+    // 克隆场景只负责持有克隆元素的图形项，输出时按元素模型直接绘制，不会被 render
     auto newScene = std::make_unique<QGraphicsScene>();
     newScene->setItemIndexMethod(QGraphicsScene::NoIndex);
     if (m_scene) {
@@ -657,6 +1061,7 @@ void PrintCenterDialog::rebuildRenderModel()
         newScene->setBackgroundBrush(m_scene->backgroundBrush());
     }
 
+    auto snapshot = std::make_shared<ThumbnailSnapshot>();
     for (labelelement *source : m_elements) {
         if (!source) {
             continue;
@@ -667,7 +1072,10 @@ void PrintCenterDialog::rebuildRenderModel()
             continue;
         }
 
-        clone->setData(source->getData());
+        ThumbnailSnapshot::Element entry;
+        entry.type = source->getType();
+        entry.data = source->getData();
+        clone->setData(entry.data);
 
         if (auto ds = source->dataSource()) {
             clone->setDataSource(ds);
@@ -679,20 +1087,28 @@ void PrintCenterDialog::rebuildRenderModel()
 
         clone->addToScene(newScene.get());
         clone->setPos(source->getPos());
+        entry.source = clone->dataSource();
+        entry.sourceEnabled = clone->isDataSourceEnabled();
+        entry.pos = source->getPos();
 
         if (QGraphicsItem *sourceItem = source->getItem()) {
+            entry.transform = sourceItem->transform();
+            entry.transformOrigin = sourceItem->transformOriginPoint();
+            entry.z = sourceItem->zValue();
             if (QGraphicsItem *cloneItem = clone->getItem()) {
-                cloneItem->setTransform(sourceItem->transform());
-                cloneItem->setTransformOriginPoint(sourceItem->transformOriginPoint());
-                cloneItem->setZValue(sourceItem->zValue());
+                cloneItem->setTransform(entry.transform);
+                cloneItem->setTransformOriginPoint(entry.transformOrigin);
+                cloneItem->setZValue(entry.z);
             }
         }
 
+        snapshot->elements.append(entry);
         m_renderElements.append(clone.get());
         m_renderElementStorage.emplace_back(std::move(clone));
     }
 
     m_renderScene = std::move(newScene);
+    m_thumbnailSnapshot = std::move(snapshot);
 
     if (m_batchManager) {
         const QList<labelelement*> target = m_renderElements.isEmpty() ? m_elements : m_renderElements;
@@ -725,6 +1141,10 @@ void PrintCenterDialog::refreshBatchControls()
     const bool hasBatch = m_batchManager && m_totalBatchCount > 0;
     showBatchNavigator(hasBatch);
     showPageNavigator(hasBatch);
+    m_thumbnailModel->setRecordCount(hasBatch ? m_totalBatchCount : 0);
+    if (ui->thumbnailStrip) {
+        ui->thumbnailStrip->setVisible(hasBatch);
+    }
     ui->rangeWidget->setVisible(hasBatch);
 
     if (ui->pageInput) {
@@ -1069,8 +1489,14 @@ void PrintCenterDialog::onExportModeChanged(int index)
 
 void PrintCenterDialog::onLayoutExport()
 {
+    runLayoutJob(false);
+}
+
+void PrintCenterDialog::runLayoutJob(bool toPrinter)
+{
+    const QString title = toPrinter ? tr("排版打印") : tr("排版导出");
     if (!m_scene || m_elements.isEmpty()) {
-        QMessageBox::warning(this, tr("排版导出"), tr("缺少可导出的内容"));
+        QMessageBox::warning(this, title, tr("缺少可导出的内容"));
         return;
     }
 
@@ -1084,33 +1510,43 @@ void PrintCenterDialog::onLayoutExport()
         return;
     }
 
+    // 排版由排版引擎统一计算（固定网格或 0°/90° 混排最优方案）
+    const ImpositionLayout layout = dlg.imposition();
+    if (layout.isEmpty()) {
+        QMessageBox::warning(this, title, tr("无法根据当前纸张与标签尺寸计算排版"));
+        return;
+    }
+
     // 根据当前文件类型提供合适的保存筛选
     QString fileType = ui->comboFileType ? ui->comboFileType->currentText() : QStringLiteral("PDF");
-    QString filter;
-    QString defaultExt;
-    if (fileType == QStringLiteral("PNG")) {
-        filter = tr("PNG图片 (*.png)");
-        defaultExt = QStringLiteral(".png");
-    } else if (fileType == QStringLiteral("JPEG")) {
-        filter = tr("JPEG图片 (*.jpg *.jpeg)");
-        defaultExt = QStringLiteral(".jpg");
-    } else {
-        filter = tr("PDF 文件 (*.pdf)");
-        defaultExt = QStringLiteral(".pdf");
-        fileType = QStringLiteral("PDF");
-    }
+    QString fileName;
+    if (!toPrinter) {
+        QString filter;
+        QString defaultExt;
+        if (fileType == QStringLiteral("PNG")) {
+            filter = tr("PNG图片 (*.png)");
+            defaultExt = QStringLiteral(".png");
+        } else if (fileType == QStringLiteral("JPEG")) {
+            filter = tr("JPEG图片 (*.jpg *.jpeg)");
+            defaultExt = QStringLiteral(".jpg");
+        } else {
+            filter = tr("PDF 文件 (*.pdf)");
+            defaultExt = QStringLiteral(".pdf");
+            fileType = QStringLiteral("PDF");
+        }
 
-    QString suggested = QStringLiteral("layout%1").arg(defaultExt);
-    const QString fileName = QFileDialog::getSaveFileName(this, tr("保存排版文件"), suggested, filter);
-    if (fileName.isEmpty()) {
-        return;
+        QString suggested = QStringLiteral("layout%1").arg(defaultExt);
+        fileName = QFileDialog::getSaveFileName(this, tr("保存排版文件"), suggested, filter);
+        if (fileName.isEmpty()) {
+            return;
+        }
     }
 
     // 选择渲染场景与元素（优先使用克隆的渲染场景）
     QGraphicsScene *renderScene = m_renderScene ? m_renderScene.get() : m_scene;
     const QList<labelelement*> &exportElements = m_renderElements.isEmpty() ? m_elements : m_renderElements;
     if (!renderScene || exportElements.isEmpty()) {
-        QMessageBox::warning(this, tr("排版导出"), tr("缺少可导出的内容"));
+        QMessageBox::warning(this, title, tr("缺少可导出的内容"));
         return;
     }
 
@@ -1121,7 +1557,7 @@ void PrintCenterDialog::onLayoutExport()
         QString err;
         const int recordCount = resolveRecordCount(exportElements, &err);
         if (!err.isEmpty()) {
-            QMessageBox::warning(this, tr("排版导出"), err);
+            QMessageBox::warning(this, title, err);
             return;
         }
 
@@ -1137,98 +1573,8 @@ void PrintCenterDialog::onLayoutExport()
         }
     }
 
-    // 计算设计区域（用于 scene->render 源矩形）：
-    // 优先使用标签像素尺寸以保持与非排版导出一致的物理比例；
-    // 若未提供，则退回到场景矩形或元素联合边界。
-    QRectF designRect;
-    if (m_baseContext.labelSizePixels.width() > 0.0 && m_baseContext.labelSizePixels.height() > 0.0) {
-        designRect = QRectF(0, 0,
-                            m_baseContext.labelSizePixels.width(),
-                            m_baseContext.labelSizePixels.height());
-    } else {
-        bool first = true;
-        for (labelelement *el : exportElements) {
-            if (!el) continue;
-            if (QGraphicsItem *it = el->getItem()) {
-                const QRectF r = it->sceneBoundingRect();
-                if (first) { designRect = r; first = false; }
-                else { designRect = designRect.united(r); }
-            }
-        }
-        if (designRect.isEmpty()) {
-            designRect = renderScene->sceneRect();
-        }
-        if (designRect.width() <= 0 || designRect.height() <= 0) {
-            designRect = QRectF(0,0,100,100);
-        }
-    }
+    const QRectF designRect = designSourceRect(renderScene, exportElements);
 
-    // 页面与尺寸参数（物理毫米）
-    const QSizeF pageMM = dlg.pageSizeMM();
-    const bool landscape = dlg.landscape();
-
-    const bool horizontalOrder = dlg.horizontalOrder();
-    const QMarginsF marginsMM = dlg.marginsMM();
-    const double hSpacingMM = dlg.hSpacingMM();
-    const double vSpacingMM = dlg.vSpacingMM();
-
-    // 使用毫米域计算最大可容纳行列，避免像素取整导致少一列/行
-    QSizeF orientedPageMM = dlg.pageSizeMM();
-    if (dlg.landscape()) {
-        orientedPageMM = QSizeF(orientedPageMM.height(), orientedPageMM.width());
-    }
-    const double innerWmm = std::max(0.0, orientedPageMM.width() - (marginsMM.left() + marginsMM.right()));
-    const double innerHmm = std::max(0.0, orientedPageMM.height() - (marginsMM.top() + marginsMM.bottom()));
-    const double labelWmm = std::max(0.0, m_baseContext.labelSizeMM.width());
-    const double labelHmm = std::max(0.0, m_baseContext.labelSizeMM.height());
-    const int maxCols_mm = (labelWmm > 0.0)
-        ? std::max(1, static_cast<int>(std::floor((innerWmm + hSpacingMM) / (labelWmm + hSpacingMM))))
-        : 1;
-    const int maxRows_mm = (labelHmm > 0.0)
-        ? std::max(1, static_cast<int>(std::floor((innerHmm + vSpacingMM) / (labelHmm + vSpacingMM))))
-        : 1;
-
-    // 公用：毫米转像素
-    auto mmToDevice = [](double mm, double dpi){ return (dpi / 25.4) * mm; };
-
-    // 计算导出 DPI（图像导出使用固定/推算的 DPI；PDF 依赖打印机 DPI）
-    qreal dpiX = 300.0;
-    qreal dpiY = 300.0;
-    if (fileType == QStringLiteral("PDF")) {
-        // 使用打印机的逻辑 DPI
-        // will be assigned later after printer created
-    }
-    // 目标行列：以毫米域的最大容量为上限，避免像素取整带来的-1误差
-    const int targetCols = qBound(1, dlg.columns(), maxCols_mm);
-    const int targetRows = qBound(1, dlg.rows(), maxRows_mm);
-    const int cellsPerPage = targetRows * targetCols;
-
-    auto indexToRowCol = [targetRows, targetCols, horizontalOrder](int index)->QPair<int,int>{
-        if (horizontalOrder) {
-            const int r = index / targetCols;
-            const int c = index % targetCols;
-            return {r,c};
-        } else {
-            const int c = index / targetRows;
-            const int r = index % targetRows;
-            return {r,c};
-        }
-    };
-
-    // 导出过程中隐藏选择框（若直接使用原场景）
-    QGraphicsItem *selFrame = nullptr;
-    bool selFrameVisible = false;
-    if (renderScene == m_scene) {
-        if (auto labelScene = qobject_cast<LabelScene*>(m_scene)) {
-            selFrame = labelScene->selectionFrame();
-            if (selFrame) {
-                selFrameVisible = selFrame->isVisible();
-                selFrame->setVisible(false);
-            }
-        }
-    }
-
-    int printed = 0;
     const bool hasBatch = (exportEndIndex >= exportStartIndex);
     int totalCount = hasBatch ? (exportEndIndex - exportStartIndex + 1) : 1;
     if (!hasBatch) { // 无数据源时，按导出份数 N 排布 N 份
@@ -1236,204 +1582,109 @@ void PrintCenterDialog::onLayoutExport()
         totalCount = copies;
     }
 
-    // 起始偏移（仅第一页生效）
-    int startRow0 = qBound(0, dlg.startRow() - 1, targetRows - 1);   // 0-based
-    int startCol0 = qBound(0, dlg.startColumn() - 1, targetCols - 1); // 0-based
-    const int linearStartIndex = horizontalOrder
-        ? (startRow0 * targetCols + startCol0)
-        : (startCol0 * targetRows + startRow0);
-    const int firstPageCapacityAfterOffset = std::max(0, cellsPerPage - linearStartIndex);
+    // 起始偏移（仅第一页生效，按主网格行列定位）
+    ImpositionRenderer renderer(layout);
+    const int startRow0 = qBound(0, dlg.startRow() - 1, std::max(0, layout.rows - 1));
+    const int startCol0 = qBound(0, dlg.startColumn() - 1, std::max(0, layout.columns - 1));
+    renderer.setStartIndex(layout.startIndexFor(startRow0, startCol0));
 
-    if (fileType == QStringLiteral("PDF")) {
-        // PDF：沿用原有打印机路径
-        QPrinter printer(QPrinter::HighResolution);
-        printer.setOutputFormat(QPrinter::PdfFormat);
-        printer.setOutputFileName(fileName);
-        const QPageSize pageSize(QSize(int(pageMM.width()), int(pageMM.height())), QPageSize::Millimeter);
-        const QPageLayout pageLayout(pageSize, landscape ? QPageLayout::Landscape : QPageLayout::Portrait, QMarginsF());
-        printer.setPageLayout(pageLayout);
-
-        // 设备像素参数
-        const QRectF pageRectPx = printer.paperRect(QPrinter::DevicePixel);
-        dpiX = printer.logicalDpiX();
-        dpiY = printer.logicalDpiY();
-        const qreal labelPxW = std::max<qreal>(1.0, mmToDevice(m_baseContext.labelSizeMM.width(), dpiX));
-        const qreal labelPxH = std::max<qreal>(1.0, mmToDevice(m_baseContext.labelSizeMM.height(), dpiY));
-        const qreal leftPx = std::max<qreal>(0.0, mmToDevice(marginsMM.left(), dpiX));
-        const qreal topPx = std::max<qreal>(0.0, mmToDevice(marginsMM.top(), dpiY));
-        const qreal hGapPx = std::max<qreal>(0.0, mmToDevice(hSpacingMM, dpiX));
-        const qreal vGapPx = std::max<qreal>(0.0, mmToDevice(vSpacingMM, dpiY));
-
-        QPainter painter(&printer);
-        painter.setRenderHint(QPainter::Antialiasing,true);
-        painter.setRenderHint(QPainter::TextAntialiasing,true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform,true);
-
-        int prevPageNumber = 0;
-        for (int i = 0; i < totalCount; ++i) {
-            int pageNumber = 0;
-            int cellIndexInPage = 0;
-            if (i < firstPageCapacityAfterOffset) {
-                pageNumber = 0;
-                cellIndexInPage = linearStartIndex + i;
-            } else {
-                const int remaining = i - firstPageCapacityAfterOffset;
-                pageNumber = 1 + remaining / cellsPerPage;
-                cellIndexInPage = remaining % cellsPerPage;
-            }
-            if (i > 0 && pageNumber != prevPageNumber) {
-                printer.newPage();
-            }
-            prevPageNumber = pageNumber;
+    // 后续记录的条码/二维码提前编码；绘制设备在输出开始后才确定，首次绘制时创建
+    std::unique_ptr<SymbolPrefetcher> prefetcher;
 
+    const ImpositionRenderer::CellPainter paintCell =
+        [&](QPainter &painter, const QRectF &target, int sequenceIndex, QString *errorMessage) {
             QVector<PreviewBinding> bindings;
             auto restoreGuard = qScopeGuard([&bindings]() { restorePreviewBindings(bindings); });
             if (hasBatch) {
-                const int recordIndex = exportStartIndex + i;
+                if (!prefetcher) {
+                    prefetcher = std::make_unique<SymbolPrefetcher>(exportElements, painter.device());
+                }
+                prefetcher->advance(exportStartIndex + sequenceIndex, exportEndIndex);
+
                 QString dataError;
-                if (!applyPreviewRecord(exportElements, recordIndex, &bindings, &dataError)) {
-                    QMessageBox::warning(this, tr("排版导出"), dataError.isEmpty() ? tr("无法应用数据源记录") : dataError);
-                    break;
+                if (!applyPreviewRecord(exportElements, exportStartIndex + sequenceIndex, &bindings, &dataError)) {
+                    if (errorMessage) {
+                        *errorMessage = dataError.isEmpty() ? tr("无法应用数据源记录") : dataError;
+                    }
+                    return false;
                 }
             }
+            // 直接按元素模型绘制，不会带出编辑器的选择框与手柄
+            ElementModelRenderer::paintElements(painter, exportElements, target, designRect);
+            return true;
+        };
 
-            const auto rc = indexToRowCol(cellIndexInPage);
-            const int r = rc.first;
-            const int c = rc.second;
-            painter.save();
-            const qreal x = pageRectPx.left() + leftPx + c * (labelPxW + hGapPx);
-            const qreal y = pageRectPx.top() + topPx + r * (labelPxH + vGapPx);
-            painter.translate(x, y);
-            const QRectF targetCell(0, 0, labelPxW, labelPxH);
-            renderScene->render(&painter, targetCell, designRect, Qt::IgnoreAspectRatio);
-            painter.restore();
-            ++printed;
-        }
-
-        painter.end();
-
-        if (selFrame) selFrame->setVisible(selFrameVisible);
-        QMessageBox::information(this, tr("完成"), tr("已导出 %1 份到 PDF:\n%2")
-                                 .arg(printed)
-                                 .arg(QDir::toNativeSeparators(fileName)));
-        return;
-    }
-
-    // 图像导出：PNG/JPEG
-    // 计算整页像素尺寸（考虑横竖方向）
-    const QSizeF orientedMM = landscape ? QSizeF(pageMM.height(), pageMM.width()) : pageMM;
-    const int pageWidthPx = std::max(1, static_cast<int>(std::ceil(mmToDevice(orientedMM.width(), dpiX))));
-    const int pageHeightPx = std::max(1, static_cast<int>(std::ceil(mmToDevice(orientedMM.height(), dpiY))));
-    const qreal labelPxW = std::max<qreal>(1.0, mmToDevice(m_baseContext.labelSizeMM.width(), dpiX));
-    const qreal labelPxH = std::max<qreal>(1.0, mmToDevice(m_baseContext.labelSizeMM.height(), dpiY));
-    const qreal leftPx = std::max<qreal>(0.0, mmToDevice(marginsMM.left(), dpiX));
-    const qreal topPx = std::max<qreal>(0.0, mmToDevice(marginsMM.top(), dpiY));
-    const qreal hGapPx = std::max<qreal>(0.0, mmToDevice(hSpacingMM, dpiX));
-    const qreal vGapPx = std::max<qreal>(0.0, mmToDevice(vSpacingMM, dpiY));
-
-    const QFileInfo baseInfo(fileName);
-    const QDir targetDir = baseInfo.dir();
-    const QString baseName = baseInfo.completeBaseName();
-    const QString suffix = baseInfo.completeSuffix().isEmpty() ? (fileType == QLatin1String("JPEG") ? QStringLiteral("jpg") : QStringLiteral("png")) : baseInfo.completeSuffix();
-
-    int prevPageNumber = -1;
-    int pageCounter = -1;
-    std::unique_ptr<QImage> pageImage;
-    std::unique_ptr<QPainter> painter;
-
-    auto startNewPage = [&](int pageNumber){
-        pageImage = std::make_unique<QImage>(pageWidthPx, pageHeightPx,
-                                             fileType == QStringLiteral("JPEG") ? QImage::Format_RGB32 : QImage::Format_ARGB32_Premultiplied);
-        if (fileType == QStringLiteral("JPEG")) {
-            pageImage->fill(Qt::white);
-        } else {
-            pageImage->fill(Qt::white);
-        }
-        painter = std::make_unique<QPainter>(pageImage.get());
-        painter->setRenderHint(QPainter::Antialiasing, true);
-        painter->setRenderHint(QPainter::TextAntialiasing, true);
-        painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
-        prevPageNumber = pageNumber;
-        pageCounter = pageNumber;
-    };
+    // 页面参数（物理毫米，排版坐标已包含页边距，因此按整页绘制）
+    const QSizeF pageMM = dlg.pageSizeMM();
+    const QPageSize pageSize(pageMM, QPageSize::Millimeter);
+    const QPageLayout pageLayout(pageSize, dlg.landscape() ? QPageLayout::Landscape : QPageLayout::Portrait, QMarginsF());
 
-    auto flushPage = [&](){
-        if (!pageImage) return true;
-        const QString outPath = targetDir.filePath(QStringLiteral("%1_%2.%3")
-                                                   .arg(baseName)
-                                                   .arg(QString::number(pageCounter + 1).rightJustified(3, QLatin1Char('0')))
-                                                   .arg(suffix));
-        bool ok = pageImage->save(outPath);
-        if (!ok) {
-            QMessageBox::warning(this, tr("导出失败"), tr("无法写入文件 %1").arg(QDir::toNativeSeparators(outPath)));
-        }
-        return ok;
-    };
+    ImpositionResult result;
+    QString errorMsg;
+    QString successMessage;
 
-    for (int i = 0; i < totalCount; ++i) {
-        int pageNumber = 0;
-        int cellIndexInPage = 0;
-        if (i < firstPageCapacityAfterOffset) {
-            pageNumber = 0;
-            cellIndexInPage = linearStartIndex + i;
+    if (toPrinter || fileType == QStringLiteral("PDF")) {
+        QPrinter printer(QPrinter::HighResolution);
+        printer.setPageLayout(pageLayout);
+        printer.setFullPage(true);
+        if (toPrinter) {
+            printer.setOutputFormat(QPrinter::NativeFormat);
+            QPrintDialog printDialog(&printer, this);
+            printDialog.setWindowTitle(tr("打印"));
+            if (printDialog.exec() != QDialog::Accepted) {
+                return;
+            }
         } else {
-            const int remaining = i - firstPageCapacityAfterOffset;
-            pageNumber = 1 + remaining / cellsPerPage;
-            cellIndexInPage = remaining % cellsPerPage;
+            printer.setOutputFormat(QPrinter::PdfFormat);
+            printer.setOutputFileName(fileName);
         }
 
-        if (prevPageNumber != pageNumber) {
-            if (pageImage && painter) {
-                painter->end();
-                if (!flushPage()) {
-                    if (selFrame) selFrame->setVisible(selFrameVisible);
-                    return;
-                }
-            }
-            startNewPage(pageNumber);
+        if (!renderer.renderToPrinter(&printer, totalCount, paintCell, &result, &errorMsg)) {
+            QMessageBox::warning(this, title, errorMsg.isEmpty() ? tr("排版输出失败") : errorMsg);
+            return;
         }
 
-        QVector<PreviewBinding> bindings;
-        auto restoreGuard = qScopeGuard([&bindings]() { restorePreviewBindings(bindings); });
-        if (hasBatch) {
-            const int recordIndex = exportStartIndex + i;
-            QString dataError;
-            if (!applyPreviewRecord(exportElements, recordIndex, &bindings, &dataError)) {
-                QMessageBox::warning(this, tr("排版导出"), dataError.isEmpty() ? tr("无法应用数据源记录") : dataError);
-                break;
-            }
+        successMessage = toPrinter
+            ? tr("打印任务已提交（%1 份）").arg(result.labels)
+            : tr("已导出 %1 份到 PDF:\n%2").arg(result.labels).arg(QDir::toNativeSeparators(fileName));
+    } else {
+        // 图像导出：PNG/JPEG，按 300 DPI 逐页输出
+        constexpr qreal kImageDpi = 300.0;
+        const QFileInfo baseInfo(fileName);
+        const QString suffix = baseInfo.completeSuffix().isEmpty()
+            ? (fileType == QLatin1String("JPEG") ? QStringLiteral("jpg") : QStringLiteral("png"))
+            : baseInfo.completeSuffix();
+
+        if (!renderer.renderToImages(baseInfo.dir().absolutePath(), baseInfo.completeBaseName(), suffix,
+                                     fileType == QStringLiteral("JPEG"), kImageDpi, kImageDpi,
+                                     totalCount, paintCell, &result, &errorMsg)) {
+            QMessageBox::warning(this, tr("导出失败"), errorMsg.isEmpty() ? tr("排版输出失败") : errorMsg);
+            return;
         }
 
-        const auto rc = indexToRowCol(cellIndexInPage);
-        const int r = rc.first;
-        const int c = rc.second;
-        painter->save();
-        const qreal x = leftPx + c * (labelPxW + hGapPx);
-        const qreal y = topPx + r * (labelPxH + vGapPx);
-        painter->translate(x, y);
-        const QRectF targetCell(0, 0, labelPxW, labelPxH);
-        renderScene->render(painter.get(), targetCell, designRect, Qt::IgnoreAspectRatio);
-        painter->restore();
-        ++printed;
-    }
-
-    if (painter) painter->end();
-    if (!flushPage()) {
-        if (selFrame) selFrame->setVisible(selFrameVisible);
-        return;
+        successMessage = tr("已导出 %1 份到 %2 图像，保存于:\n%3")
+                             .arg(result.labels)
+                             .arg(fileType)
+                             .arg(QDir::toNativeSeparators(baseInfo.dir().absolutePath()));
     }
 
-    if (selFrame) selFrame->setVisible(selFrameVisible);
-
-    QMessageBox::information(this, tr("完成"), tr("已导出 %1 份到 %2 图像，保存于:\n%3")
-                             .arg(printed)
-                             .arg(fileType)
-                             .arg(QDir::toNativeSeparators(baseInfo.dir().absolutePath())));
+    successMessage += QStringLiteral("\n")
+                      + tr("共 %1 页，每页 %2 个，纸张利用率 %3%")
+                            .arg(result.pages)
+                            .arg(result.cellsPerPage)
+                            .arg(result.utilisation * 100.0, 0, 'f', 1);
+    QMessageBox::information(this, tr("完成"), successMessage);
 }
 
 void PrintCenterDialog::onPrintDirect()
 {
     if (!m_scene || !m_printEngine || m_elements.isEmpty()) return;
+
+    // 自动排版模式下按排版结果整页打印
+    if (currentExportMode(ui->comboExportMode) == ExportMode::AutoLayout) {
+        runLayoutJob(true);
+        return;
+    }
     
     QPrinter printer(QPrinter::HighResolution);
     printer.setOutputFormat(QPrinter::NativeFormat);
@@ -1499,12 +1750,28 @@ void PrintCenterDialog::onPrintDirect()
         const int maxIndex = m_totalBatchCount - 1;
         const int firstIndex = qBound(0, start - 1, maxIndex);
         const int lastIndex = qBound(firstIndex, end - 1, maxIndex);
+        m_batchManager->setVerificationInterval(ui->spinVerifyInterval->value());
         bool ok = m_batchManager->execute(context, firstIndex, lastIndex, &errorMsg);
         if (!ok) {
             QMessageBox::warning(this, "打印失败", errorMsg);
             return;
         }
         updatePreview();
+
+        const SymbolVerifier::Summary summary = m_batchManager->verificationSummary();
+        if (summary.verified > 0 || summary.skipped > 0) {
+            const QString report = tr("打印任务已提交\n\n条码回读校验：%1 条通过，%2 条失败，%3 条因积压跳过\n解码速度：%4 条/秒")
+                                       .arg(summary.passed)
+                                       .arg(summary.failed)
+                                       .arg(summary.skipped)
+                                       .arg(summary.recordsPerSecond, 0, 'f', 1);
+            if (summary.failed > 0) {
+                QMessageBox::warning(this, tr("完成"), report);
+            } else {
+                QMessageBox::information(this, tr("完成"), report);
+            }
+            return;
+        }
     } else {
         // 单页打印
     int copies = ui->spinCopies->value();
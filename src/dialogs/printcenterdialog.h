@@ -4,9 +4,15 @@
 #include <QDialog>
 #include <QPixmap>
 #include <QSize>
+#include <QCache>
+#include <QByteArray>
 #include <QHash>
+#include <QImage>
+#include <QList>
+#include <QRectF>
 #include <QString>
-#include <QStringList>
+#include <QtGlobal>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -22,6 +28,8 @@ class PrintEngine;
 class labelelement;
 class QGraphicsScene;
 class QGraphicsPixmapItem;
+class QTimer;
+class RecordThumbnailModel;
 
 class PrintCenterDialog : public QDialog
 {
@@ -71,6 +79,43 @@ private:
         qreal devicePixelRatio = 1.0;
     };
 
+    // 预览缓存键：记录、渲染像素尺寸与模板修订号
+    struct PreviewCacheKey {
+        int recordIndex = -1;
+        QSize renderSize;
+        quint64 revision = 0;
+
+        friend bool operator==(const PreviewCacheKey& lhs, const PreviewCacheKey& rhs)
+        {
+            return lhs.recordIndex == rhs.recordIndex
+                && lhs.renderSize == rhs.renderSize
+                && lhs.revision == rhs.revision;
+        }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        friend size_t qHash(const PreviewCacheKey& key, size_t seed = 0)
+#else
+        friend uint qHash(const PreviewCacheKey& key, uint seed = 0)
+#endif
+        {
+            const qint64 fields[] = { key.recordIndex,
+                                      key.renderSize.width(),
+                                      key.renderSize.height(),
+                                      static_cast<qint64>(key.revision) };
+            return qHashBits(fields, sizeof(fields), seed);
+        }
+    };
+
+    // 一次预览绘制的参数：记录、目标像素尺寸与对应 DPI
+    struct PreviewRequest {
+        int recordIndex = -1;
+        QSize renderSize;
+        QSize logicalSize;
+        qreal devicePixelRatio = 1.0;
+        qreal dpiX = 0.0;
+        qreal dpiY = 0.0;
+    };
+
     void setupConnections();
     void updatePreview();
     void updateSizeLabel();
@@ -87,9 +132,32 @@ private:
     void applyZoom();
     void ensureBatchWindowVisible();
     void invalidatePreviewCache();
-    QString previewCacheKey(const QSize& renderSize, int recordIndex) const;
-    void prunePreviewCache();
+    PreviewCacheKey previewCacheKey(const QSize& renderSize, int recordIndex) const;
+    // 重新计算模板修订号，返回是否有影响预览的变化；
+    // 只重新序列化被标记为已修改的元素
+    bool refreshTemplateRevision();
+    // 场景变化区域内的元素标记为已修改
+    void markElementsModified(const QList<QRectF>& region);
+    int currentPreviewRecord() const;
+    qreal previewRenderScale() const;
+    PreviewRequest makePreviewRequest(int recordIndex, qreal renderScale) const;
+    bool renderPreviewImage(const PreviewRequest& request, CachedPreview *preview, QString *errorMessage);
+    void showPreview(const CachedPreview& preview);
+    void showPreviewMessage(const QString& message);
+    void storePreview(const PreviewCacheKey& cacheKey, const CachedPreview& preview);
+    // 渐进式预览：先显示草图，再在后续事件循环中精绘并预取相邻记录
+    void cancelPreviewWork();
+    void queuePreviewPrefetch(int recordIndex);
+    void processPreviewWork();
     void rebuildRenderModel();
+    // 设计区域（scene->render 的源矩形）
+    QRectF designSourceRect(QGraphicsScene* renderScene, const QList<labelelement*>& elements) const;
+    // 批量缩略图条：按标签比例设置缩略图尺寸；单条记录由线程池按元素快照绘制
+    void updateThumbnailGeometry();
+    std::function<QImage()> thumbnailTask(int recordIndex, const QSize& pixelSize) const;
+    void syncThumbnailSelection();
+    // 自动排版输出：toPrinter 为 true 时直接打印，否则按文件类型导出
+    void runLayoutJob(bool toPrinter);
 
     Ui::PrintCenterDialog *ui;
     LabelScene* m_scene;
@@ -100,14 +168,28 @@ private:
     std::vector<std::unique_ptr<labelelement>> m_renderElementStorage;
     QList<labelelement*> m_renderElements;
     std::unique_ptr<QGraphicsScene> m_renderScene;
+    // 渲染元素的不可变快照（数据、数据源与变换），缩略图任务在池线程中据此重建元素
+    struct ThumbnailSnapshot;
+    std::shared_ptr<const ThumbnailSnapshot> m_thumbnailSnapshot;
     QPixmap m_currentPreview;
     QGraphicsScene* m_previewScene;
     QGraphicsPixmapItem* m_previewPixmapItem;
     qreal m_zoomFactor;
     qreal m_previewDevicePixelRatio;
-    QHash<QString, CachedPreview> m_previewCache;
-    QStringList m_previewCacheOrder;
+    QCache<PreviewCacheKey, CachedPreview> m_previewCache;
+    quint64 m_designRevision;
+    quint64 m_recordRevision;
+    // 各元素内容摘要（设计期 / 记录预览）；缺项表示元素已修改，需重新序列化
+    struct ElementDigest {
+        QByteArray design;
+        QByteArray record;
+    };
+    QHash<const labelelement*, ElementDigest> m_elementDigests;
     bool m_previewUpdateScheduled;
+    QTimer* m_previewWorkTimer;
+    bool m_previewRefinePending;
+    QList<int> m_previewPrefetchQueue;
+    RecordThumbnailModel* m_thumbnailModel;
     bool m_suppressSceneInvalidation;
     int m_currentBatchIndex;
     int m_totalBatchCount;
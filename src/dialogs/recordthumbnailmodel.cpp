@@ -0,0 +1,228 @@
+#include "recordthumbnailmodel.h"
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// 缩略图缓存容量（字节）；RGB16 下 96×64 的缩略图约 12 KB
+constexpr int kThumbnailCacheBudgetBytes = 64 * 1024 * 1024;
+// 待生成队列上限，快速滚动时丢弃早已滚出视野的请求
+constexpr int kMaxPendingRequests = 96;
+// 每轮事件循环用于创建绘制任务的时间预算，保证滚动流畅
+constexpr qint64 kFrameBudgetMs = 8;
+
+QSize pixelSizeFor(const QSize &logicalSize, qreal devicePixelRatio)
+{
+    return QSize(std::max(1, qRound(logicalSize.width() * devicePixelRatio)),
+                 std::max(1, qRound(logicalSize.height() * devicePixelRatio)));
+}
+
+} // namespace
+
+RecordThumbnailModel::RecordThumbnailModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_cache(kThumbnailCacheBudgetBytes)
+    , m_pendingTimer(new QTimer(this))
+{
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+
+    m_pendingTimer->setSingleShot(true);
+    m_pendingTimer->setInterval(0);
+    connect(m_pendingTimer, &QTimer::timeout, this, &RecordThumbnailModel::processPending);
+
+    rebuildPlaceholder();
+}
+
+RecordThumbnailModel::~RecordThumbnailModel()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void RecordThumbnailModel::setRenderer(Renderer renderer)
+{
+    m_renderer = std::move(renderer);
+    invalidate();
+}
+
+void RecordThumbnailModel::setRecordCount(int count)
+{
+    count = std::max(0, count);
+    if (count == m_recordCount) {
+        return;
+    }
+
+    beginResetModel();
+    m_recordCount = count;
+    ++m_generation;
+    m_cache.clear();
+    m_pending.clear();
+    m_pendingRows.clear();
+    m_inFlight.clear();
+    m_pool.clear();
+    endResetModel();
+}
+
+void RecordThumbnailModel::setThumbnailSize(const QSize &size, qreal devicePixelRatio)
+{
+    const QSize boundedSize = size.expandedTo(QSize(16, 16));
+    const qreal boundedRatio = std::max<qreal>(1.0, devicePixelRatio);
+    if (boundedSize == m_thumbnailSize && qFuzzyCompare(boundedRatio, m_devicePixelRatio)) {
+        return;
+    }
+
+    m_thumbnailSize = boundedSize;
+    m_devicePixelRatio = boundedRatio;
+    rebuildPlaceholder();
+    invalidate();
+}
+
+void RecordThumbnailModel::invalidate()
+{
+    ++m_generation;
+    m_cache.clear();
+    m_pending.clear();
+    m_pendingRows.clear();
+    m_inFlight.clear();
+    m_pool.clear();
+
+    if (m_recordCount > 0) {
+        emit dataChanged(index(0), index(m_recordCount - 1), { Qt::DecorationRole });
+    }
+}
+
+int RecordThumbnailModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_recordCount;
+}
+
+QVariant RecordThumbnailModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_recordCount) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString::number(row + 1);
+    case Qt::ToolTipRole:
+        return tr("第 %1 条记录").arg(row + 1);
+    case Qt::TextAlignmentRole:
+        return static_cast<int>(Qt::AlignHCenter | Qt::AlignTop);
+    case Qt::DecorationRole:
+        if (const QImage *thumbnail = m_cache.object(row)) {
+            return *thumbnail;
+        }
+        requestThumbnail(row);
+        return m_placeholder;
+    default:
+        return QVariant();
+    }
+}
+
+void RecordThumbnailModel::requestThumbnail(int row) const
+{
+    if (!m_renderer || m_inFlight.contains(row)) {
+        return;
+    }
+
+    if (m_pendingRows.contains(row)) {
+        m_pending.removeOne(row);
+    } else {
+        m_pendingRows.insert(row);
+    }
+    m_pending.append(row);
+
+    while (m_pending.size() > kMaxPendingRequests) {
+        m_pendingRows.remove(m_pending.takeFirst());
+    }
+
+    if (!m_pendingTimer->isActive()) {
+        m_pendingTimer->start();
+    }
+}
+
+void RecordThumbnailModel::processPending()
+{
+    if (!m_renderer) {
+        return;
+    }
+
+    const QSize targetSize = pixelSizeFor(m_thumbnailSize, m_devicePixelRatio);
+    const qreal devicePixelRatio = m_devicePixelRatio;
+    const int generation = m_generation;
+    // 只提交少量任务，滚动后新的可见行不必排在大量已提交任务之后
+    const int capacity = m_pool.maxThreadCount() * 2;
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    while (!m_pending.isEmpty() && m_inFlight.size() < capacity && frameTimer.elapsed() < kFrameBudgetMs) {
+        const int row = m_pending.takeLast();
+        m_pendingRows.remove(row);
+        if (row >= m_recordCount || m_cache.contains(row) || m_inFlight.contains(row)) {
+            continue;
+        }
+
+        RenderTask task = m_renderer(row, targetSize);
+        if (!task) {
+            // 失败的记录以占位图缓存，避免每次重绘都重新尝试
+            m_cache.insert(row, new QImage(m_placeholder), 1);
+            continue;
+        }
+
+        m_inFlight.insert(row);
+        m_pool.start([this, generation, row, task = std::move(task), devicePixelRatio]() {
+            QImage thumbnail = task();
+            if (!thumbnail.isNull()) {
+                thumbnail = thumbnail.convertToFormat(QImage::Format_RGB16);
+                thumbnail.setDevicePixelRatio(devicePixelRatio);
+            }
+            QMetaObject::invokeMethod(this, [this, generation, row, thumbnail]() {
+                storeThumbnail(generation, row, thumbnail);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    // 任务完成后由 storeThumbnail 继续处理余下的请求
+    if (!m_pending.isEmpty() && m_inFlight.size() < capacity) {
+        m_pendingTimer->start();
+    }
+}
+
+void RecordThumbnailModel::storeThumbnail(int generation, int row, const QImage &image)
+{
+    if (generation != m_generation || row >= m_recordCount) {
+        return;
+    }
+
+    m_inFlight.remove(row);
+    if (image.isNull()) {
+        m_cache.insert(row, new QImage(m_placeholder), 1);
+    } else {
+        const int cost = static_cast<int>(std::clamp<qint64>(image.sizeInBytes(), 1, kThumbnailCacheBudgetBytes));
+        m_cache.insert(row, new QImage(image), cost);
+    }
+
+    const QModelIndex modelIndex = index(row);
+    emit dataChanged(modelIndex, modelIndex, { Qt::DecorationRole });
+
+    if (!m_pending.isEmpty() && !m_pendingTimer->isActive()) {
+        m_pendingTimer->start();
+    }
+}
+
+void RecordThumbnailModel::rebuildPlaceholder()
+{
+    m_placeholder = QImage(pixelSizeFor(m_thumbnailSize, m_devicePixelRatio), QImage::Format_RGB16);
+    m_placeholder.fill(QColor(236, 236, 236));
+    m_placeholder.setDevicePixelRatio(m_devicePixelRatio);
+}
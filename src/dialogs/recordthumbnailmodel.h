@@ -0,0 +1,68 @@
+#ifndef RECORDTHUMBNAILMODEL_H
+#define RECORDTHUMBNAILMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QSet>
+#include <QSize>
+#include <QThreadPool>
+
+#include <functional>
+
+class QTimer;
+
+// 批量记录缩略图模型：配合 QListView 使用，只有视图实际请求的行才会生成缩略图。
+// GUI 线程只生成绘制任务，记录的绘制与压缩为 RGB16 都在线程池中完成，
+// 结果按字节数计入缩略图缓存。
+class RecordThumbnailModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    // 在线程池中执行的绘制任务，返回目标尺寸的不透明图像；失败时返回空图像。
+    // 任务只能访问创建时捕获的数据，不能访问 GUI 线程的对象
+    using RenderTask = std::function<QImage()>;
+    // 在 GUI 线程为指定记录创建绘制任务；返回空任务表示无法绘制
+    using Renderer = std::function<RenderTask(int recordIndex, const QSize &pixelSize)>;
+
+    explicit RecordThumbnailModel(QObject *parent = nullptr);
+    ~RecordThumbnailModel() override;
+
+    void setRenderer(Renderer renderer);
+    void setRecordCount(int count);
+    int recordCount() const { return m_recordCount; }
+
+    // 缩略图逻辑尺寸与设备像素比
+    void setThumbnailSize(const QSize &size, qreal devicePixelRatio = 1.0);
+    QSize thumbnailSize() const { return m_thumbnailSize; }
+
+    // 丢弃已有缩略图（模板变化后调用），记录数不变
+    void invalidate();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    void requestThumbnail(int row) const;
+    void processPending();
+    void storeThumbnail(int generation, int row, const QImage &image);
+    void rebuildPlaceholder();
+
+    Renderer m_renderer;
+    int m_recordCount = 0;
+    QSize m_thumbnailSize{96, 64};
+    qreal m_devicePixelRatio = 1.0;
+    QImage m_placeholder;
+
+    QCache<int, QImage> m_cache;
+    // 视图绘制时登记的待生成行，后登记的（当前可见的）优先处理
+    mutable QList<int> m_pending;
+    mutable QSet<int> m_pendingRows;
+    QSet<int> m_inFlight;
+    QTimer *m_pendingTimer = nullptr;
+    QThreadPool m_pool;
+    int m_generation = 0;
+};
+
+#endif // RECORDTHUMBNAILMODEL_H
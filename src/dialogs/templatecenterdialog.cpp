@@ -9,7 +9,6 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QCoreApplication>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QFile>
 #include <QPixmap>
@@ -18,13 +17,20 @@
 #include <QFileDialog>
 #include <QDesktopServices>
 #include <QUrl>
-#include <QGraphicsScene>
-#include <QGraphicsPathItem>
-#include <QPainterPath>
+#include <QBuffer>
 #include <QJsonArray>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QThread>
+#include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "../core/labelelement.h"
+#include "../core/imagestore.h"
+#include "../core/labeldocumentfile.h"
+#include "../printing/elementmodelrenderer.h"
+#include "../graphics/textitem.h"
 
 TemplateCenterDialog::TemplateCenterDialog(QWidget *parent)
     : QDialog(parent)
@@ -59,6 +65,10 @@ TemplateCenterDialog::TemplateCenterDialog(QWidget *parent)
     for (const QString &category : categories) {
     QDir().mkpath(QDir(m_templatesBasePath).filePath(category));
     }
+
+    m_templateIndex = std::make_unique<TemplateIndex>(m_templatesBasePath);
+    // 界面线程也在工作，留出一个核心
+    m_thumbnailPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
     
     setupUI();
     loadTemplates(); //预留扩展点，后续可以预扫描各分类目录，预热缩略图缓存，异步加载历史/精选数据等
@@ -68,6 +78,14 @@ TemplateCenterDialog::TemplateCenterDialog(QWidget *parent)
     onCategoryChanged(0);
 }
 
+TemplateCenterDialog::~TemplateCenterDialog()
+{
+    // 让尚未开始的任务直接返回，并等待进行中的任务结束（它们会回调本对象）
+    ++m_thumbnailGeneration;
+    m_thumbnailPool.clear();
+    m_thumbnailPool.waitForDone();
+}
+
 void TemplateCenterDialog::setupUI()
 {
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
@@ -207,6 +225,8 @@ void TemplateCenterDialog::setupUI()
     connect(m_deleteButton, &QPushButton::clicked, this, &TemplateCenterDialog::onDeleteTemplates);
     connect(m_templateList, &QListWidget::itemSelectionChanged,
         this, &TemplateCenterDialog::updateMyTemplateControlsState);
+    connect(m_templateList->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &TemplateCenterDialog::prioritizeVisibleThumbnails);
 }
 
 void TemplateCenterDialog::onCategoryChanged(int row)
@@ -375,12 +395,7 @@ void TemplateCenterDialog::loadMyTemplates()
     m_templateSelected = false;
     m_templateList->clearSelection();
     
-    QDir dir(m_myTemplatesPath);
-    QStringList filters;
-    filters << "*.lbl";
-    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files);
-    
-    if (fileList.isEmpty()) {
+    if (!populateTemplateList(m_myTemplatesPath)) {
         QListWidgetItem *emptyItem = new QListWidgetItem(tr("暂无自定义模板"));
         emptyItem->setFlags(Qt::NoItemFlags);
         QFont font = emptyItem->font();
@@ -388,37 +403,6 @@ void TemplateCenterDialog::loadMyTemplates()
         emptyItem->setFont(font);
         emptyItem->setForeground(Qt::gray);
         m_templateList->addItem(emptyItem);
-        updateMyTemplateControlsState();
-        return;
-    }
-    
-    for (const QFileInfo &fileInfo : fileList) {
-        QString filePath = fileInfo.absoluteFilePath();
-        QString fileName = fileInfo.baseName();
-        
-    // 读取模板文件获取尺寸信息
-        QFile file(filePath);
-        QString sizeInfo;
-        if (file.open(QFile::ReadOnly)) {
-            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-            QJsonObject obj = doc.object();
-            QJsonObject labelInfo = obj["labelInfo"].toObject();
-            double width = labelInfo["width"].toDouble();
-            double height = labelInfo["height"].toDouble();
-            sizeInfo = QString("%1 x %2 mm").arg(width).arg(height);
-            file.close();
-        }
-        
-    // 生成真实缩略图
-    QPixmap thumbnail = getTemplateThumbnail(filePath, fileName, sizeInfo);
-        
-    QListWidgetItem *item = new QListWidgetItem(QIcon(thumbnail), 
-                                                     fileName + "\n" + sizeInfo);
-        item->setData(Qt::UserRole, filePath);
-        item->setToolTip(filePath);
-        
-        m_templateList->addItem(item);
-        m_allTemplateItems.append(item);
     }
 
     updateMyTemplateControlsState();
@@ -518,9 +502,7 @@ void TemplateCenterDialog::onDeleteTemplates()
 
     QStringList failed;
     for (const QString &path : targets) {
-        if (QFile::remove(path)) {
-            m_thumbnailCache.remove(path);
-        } else {
+        if (!QFile::remove(path)) {
             failed.append(QFileInfo(path).fileName());
         }
     }
@@ -539,12 +521,7 @@ void TemplateCenterDialog::loadCategoryTemplates(const QString &category)
     m_allTemplateItems.clear();
     
     QString categoryPath = QDir(m_templatesBasePath).filePath(category);
-    QDir dir(categoryPath);
-    QStringList filters;
-    filters << "*.lbl";
-    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files);
-    
-    if (fileList.isEmpty()) {
+    if (!populateTemplateList(categoryPath)) {
         // 显示该分类暂无模板
         QString categoryName;
         if (category == "featured") categoryName = tr("精选");
@@ -566,61 +543,140 @@ void TemplateCenterDialog::loadCategoryTemplates(const QString &category)
         emptyItem->setFont(font);
         emptyItem->setForeground(Qt::gray);
         m_templateList->addItem(emptyItem);
-        return;
     }
-    
-    // 加载该分类下的所有模板文件
-    for (const QFileInfo &fileInfo : fileList) {
-        QString filePath = fileInfo.absoluteFilePath();
-        QString fileName = fileInfo.baseName();
-        
-        // 读取模板文件获取尺寸信息
-        QFile file(filePath);
-        QString sizeInfo;
-        if (file.open(QFile::ReadOnly)) {
-            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-            QJsonObject obj = doc.object();
-            QJsonObject labelInfo = obj["labelInfo"].toObject();
-            double width = labelInfo["width"].toDouble();
-            double height = labelInfo["height"].toDouble();
-            sizeInfo = QString("%1 x %2 mm").arg(width).arg(height);
-            file.close();
-        }
-        
-        // 生成真实缩略图
-        QPixmap thumbnail = getTemplateThumbnail(filePath, fileName, sizeInfo);
-        
-        QListWidgetItem *item = new QListWidgetItem(QIcon(thumbnail), 
-                                                     fileName + "\n" + sizeInfo);
-        item->setData(Qt::UserRole, filePath);
-        item->setToolTip(filePath);
-        
+
+    updateMyTemplateControlsState();
+}
+
+bool TemplateCenterDialog::populateTemplateList(const QString &directory)
+{
+    // 列表已清空，上一批尚未完成的缩略图作废
+    ++m_thumbnailGeneration;
+    m_thumbnailPool.clear();
+    m_pendingThumbnails.clear();
+    m_thumbnailItems.clear();
+    m_thumbnailsInFlight = 0;
+
+    // 只重新读取新增或修改过的文件，其余取自索引
+    const QVector<TemplateIndex::Entry> entries = m_templateIndex->refresh(directory);
+
+    for (const TemplateIndex::Entry &entry : entries) {
+        const QString sizeInfo = entry.labelSizeMM.isEmpty()
+                                     ? QString()
+                                     : QString("%1 x %2 mm").arg(entry.labelSizeMM.width()).arg(entry.labelSizeMM.height());
+
+        QListWidgetItem *item = new QListWidgetItem(QIcon(getTemplateThumbnail(entry, sizeInfo)),
+                                                     entry.name + "\n" + sizeInfo);
+        item->setData(Qt::UserRole, entry.path);
+        item->setData(Qt::UserRole + 1, entry.tags.join(QLatin1Char(' ')));
+        item->setToolTip(entry.path);
+
         m_templateList->addItem(item);
         m_allTemplateItems.append(item);
+
+        // 索引中没有缩略图（旧版 JSON 模板）：先显示占位图，后台渲染
+        if (entry.thumbnail.isEmpty()) {
+            m_pendingThumbnails.append({ entry.path, entry.modified, item });
+            m_thumbnailItems.insert(entry.path, item);
+        }
     }
 
-    updateMyTemplateControlsState();
+    prioritizeVisibleThumbnails();
+    return !entries.isEmpty();
+}
+
+void TemplateCenterDialog::prioritizeVisibleThumbnails()
+{
+    if (m_pendingThumbnails.isEmpty()) {
+        return;
+    }
+
+    // 可见项移到队首，保持各自原有顺序
+    const QRect viewport = m_templateList->viewport()->rect();
+    QList<PendingThumbnail> visible;
+    QList<PendingThumbnail> rest;
+    for (const PendingThumbnail &pending : std::as_const(m_pendingThumbnails)) {
+        const bool isVisible = !pending.item->isHidden()
+                               && m_templateList->visualItemRect(pending.item).intersects(viewport);
+        (isVisible ? visible : rest).append(pending);
+    }
+    m_pendingThumbnails = visible + rest;
+    dispatchThumbnails();
+}
+
+void TemplateCenterDialog::dispatchThumbnails()
+{
+    // 只提交少量任务，滚动后新的可见项不必排在大量已提交任务之后
+    const int capacity = m_thumbnailPool.maxThreadCount() * 2;
+    const int generation = m_thumbnailGeneration;
+    // 池线程创建文本项时不能访问屏幕，先在本线程取得逻辑 DPI
+    TextItem::screenLogicalDpi();
+    while (m_thumbnailsInFlight < capacity && !m_pendingThumbnails.isEmpty()) {
+        const PendingThumbnail pending = m_pendingThumbnails.takeFirst();
+        ++m_thumbnailsInFlight;
+
+        const QString path = pending.path;
+        const qint64 modified = pending.modified;
+        m_thumbnailPool.start([this, generation, path, modified]() {
+            if (generation != m_thumbnailGeneration) {
+                return;
+            }
+            const QImage image = renderTemplateThumbnail(path);
+            QByteArray png;
+            if (!image.isNull()) {
+                QBuffer buffer(&png);
+                buffer.open(QIODevice::WriteOnly);
+                image.save(&buffer, "PNG");
+            }
+            QMetaObject::invokeMethod(this, [this, generation, path, modified, image, png]() {
+                onThumbnailRendered(generation, path, modified, image, png);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void TemplateCenterDialog::onThumbnailRendered(int generation,
+                                               const QString &filePath,
+                                               qint64 modified,
+                                               const QImage &image,
+                                               const QByteArray &png)
+{
+    if (generation != m_thumbnailGeneration) {
+        return;
+    }
+    --m_thumbnailsInFlight;
+
+    // 渲染失败的保留占位图
+    QListWidgetItem *item = m_thumbnailItems.take(filePath);
+    if (item && !image.isNull()) {
+        const QPixmap pixmap = QPixmap::fromImage(image);
+        m_thumbnailCache.insert(filePath + QLatin1Char('@') + QString::number(modified), pixmap);
+        item->setIcon(QIcon(pixmap));
+        m_templateIndex->storeThumbnail(filePath, modified, png);
+    }
+    dispatchThumbnails();
 }
 
 // 生成模板缩略图入口，带缓存与占位符回退
-QPixmap TemplateCenterDialog::getTemplateThumbnail(const QString &filePath,
-                                                  const QString &displayName,
+QPixmap TemplateCenterDialog::getTemplateThumbnail(const TemplateIndex::Entry &entry,
                                                   const QString &sizeInfo) const
 {
-    // 使用缓存
-    auto it = m_thumbnailCache.constFind(filePath);
+    // 使用缓存；文件修改后键随之变化
+    const QString cacheKey = entry.path + QLatin1Char('@') + QString::number(entry.modified);
+    auto it = m_thumbnailCache.constFind(cacheKey);
     if (it != m_thumbnailCache.constEnd()) {
         return it.value();
     }
 
-    // 尝试渲染真实缩略图
-    QPixmap pix = renderTemplateThumbnailFromFile(filePath);
-    if (!pix.isNull()) {
-        m_thumbnailCache.insert(filePath, pix);
+    // 索引中的缩略图
+    QPixmap pix;
+    if (!entry.thumbnail.isEmpty() && pix.loadFromData(entry.thumbnail, "PNG")) {
+        m_thumbnailCache.insert(cacheKey, pix);
         return pix;
     }
 
-    // 失败则生成占位图
+    // 没有缩略图则生成占位图
+    const QString displayName = entry.name;
     QPixmap placeholder(150, 150);
     placeholder.fill(QColor(245, 248, 250));
     QPainter p(&placeholder);
@@ -636,20 +692,16 @@ QPixmap TemplateCenterDialog::getTemplateThumbnail(const QString &filePath,
     p.setFont(ft);
     p.drawText(QRect(15, 95, 120, 40), Qt::AlignCenter, sizeInfo);
     p.end();
-    m_thumbnailCache.insert(filePath, placeholder);
+    m_thumbnailCache.insert(cacheKey, placeholder);
     return placeholder;
 }
 
-// 使用离屏 QGraphicsScene 根据 .lbl 文件真实渲染缩略图
-QPixmap TemplateCenterDialog::renderTemplateThumbnailFromFile(const QString &filePath,
-                                                              const QSize &targetSize) const
+// 由元素模型绘制缩略图：标签区域按比例居中，白底
+QImage TemplateCenterDialog::renderTemplateThumbnail(const QString &filePath, const QSize &targetSize)
 {
-    QFile file(filePath);
-    if (!file.open(QFile::ReadOnly)) return QPixmap();
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    file.close();
-    if (doc.isNull() || !doc.isObject()) return QPixmap();
-    QJsonObject root = doc.object();
+    QJsonObject root;
+    ImageStore images;
+    if (!LabelDocumentFile::read(filePath, &root, &images)) return QImage();
 
     // 读取尺寸（mm）并转换为像素（沿用主程序缩放常量）
     const double MM_TO_PIXELS = 7.559056; // 与 MainWindow 保持一致，保证元素坐标对应
@@ -659,42 +711,44 @@ QPixmap TemplateCenterDialog::renderTemplateThumbnailFromFile(const QString &fil
     double wpx = qMax(10.0, wmm * MM_TO_PIXELS);
     double hpx = qMax(10.0, hmm * MM_TO_PIXELS);
 
-    // 创建场景及背景
-    auto scene = std::make_unique<QGraphicsScene>();
-    QPainterPath path; path.addRect(QRectF(0, 0, wpx, hpx));
-    auto *bg = scene->addPath(path, QPen(Qt::NoPen), QBrush(Qt::white));
-    bg->setZValue(-1000);
-
-    // 加载元素
+    // 在线程池中运行：元素与图形项只在本线程中创建、绘制和释放，不加入场景，
+    // 不访问界面线程的对象（文本项度量用的屏幕 DPI 由调度方在 GUI 线程预先取得）。文本经 TextLayoutCache 按本线程排版（字形串中的
+    // QRawFont 不能跨线程使用），池线程空闲退出时其排版缓存随之释放
+    std::vector<std::unique_ptr<labelelement>> owned;
+    QList<labelelement*> elements;
     QJsonArray items = root.value("items").toArray();
     for (const auto &it : items) {
         QJsonObject obj = it.toObject();
-        auto element = labelelement::createFromJson(obj);
+        auto element = labelelement::createFromJson(obj, &images);
         if (element) {
-            element->addToScene(scene.get());
-            QPointF pos(obj.value("x").toDouble(), obj.value("y").toDouble());
-            element->setPos(pos);
+            element->ensureItem();
+            element->setPos(QPointF(obj.value("x").toDouble(), obj.value("y").toDouble()));
+            elements.append(element.get());
+            owned.push_back(std::move(element));
         }
     }
 
-    // 计算源区域（含少量边距）
-    QRectF itemsRect = scene->itemsBoundingRect();
-    if (!itemsRect.isValid() || itemsRect.isNull()) itemsRect = QRectF(0, 0, wpx, hpx);
-    qreal margin = 10.0; // px
-    QRectF source = itemsRect.adjusted(-margin, -margin, margin, margin);
+    const QRectF source(0, 0, wpx, hpx);
+    QSizeF fitted = source.size();
+    fitted.scale(QSizeF(targetSize), Qt::KeepAspectRatio);
+    const QRectF target(QPointF((targetSize.width() - fitted.width()) / 2.0,
+                                (targetSize.height() - fitted.height()) / 2.0),
+                        fitted);
 
-    // 目标图像
-    QPixmap pix(targetSize);
-    pix.fill(Qt::transparent);
-    QPainter painter(&pix);
+    QImage image(targetSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setRenderHint(QPainter::TextAntialiasing);
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
-
-    // 将场景内容渲染到目标区域
-    scene->render(&painter, QRectF(QPointF(0, 0), QSizeF(targetSize)), source);
+    painter.fillRect(target, Qt::white);
+    ElementModelRenderer::paintElements(painter, elements, target, source);
     painter.end();
-    return pix;
+
+    for (const auto &element : owned) {
+        delete element->getItem();
+    }
+    return image;
 }
 
 void TemplateCenterDialog::filterTemplates(const QString &searchText)
@@ -709,10 +763,13 @@ void TemplateCenterDialog::filterTemplates(const QString &searchText)
         for (int i = 0; i < m_templateList->count(); ++i) {
             QListWidgetItem *item = m_templateList->item(i);
             QString itemText = item->text();
-            bool matches = itemText.contains(searchText, Qt::CaseInsensitive);
+            // 名称、尺寸与标签（分类、元素类型）均可匹配
+            bool matches = itemText.contains(searchText, Qt::CaseInsensitive)
+                           || item->data(Qt::UserRole + 1).toString().contains(searchText, Qt::CaseInsensitive);
             item->setHidden(!matches);
         }
     }
+    prioritizeVisibleThumbnails();
 
     updateMyTemplateControlsState();
 }
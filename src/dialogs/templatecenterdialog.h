@@ -11,6 +11,10 @@
 #include <QPushButton>
 #include <QHash>
 #include <QPixmap>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include "../core/templateindex.h"
 
 class TemplateCenterDialog : public QDialog
 {
@@ -18,7 +22,7 @@ class TemplateCenterDialog : public QDialog
 
 public:
     explicit TemplateCenterDialog(QWidget *parent = nullptr);
-    ~TemplateCenterDialog() override = default;
+    ~TemplateCenterDialog() override;
 
     // 获取用户选择的信息
     bool isTemplateSelected() const { return m_templateSelected; }
@@ -37,19 +41,29 @@ private slots:
     void onOpenTemplatesFolder();
     void onDeleteTemplates();
     void updateMyTemplateControlsState();
+    // 列表滚动后，可见项的缩略图优先渲染
+    void prioritizeVisibleThumbnails();
 
 private:
     void setupUI();
     void loadTemplates();
     void loadMyTemplates();
     void loadCategoryTemplates(const QString &category);
+    // 按索引填充模板列表；目录中没有模板时返回 false
+    bool populateTemplateList(const QString &directory);
     void filterTemplates(const QString &searchText);
     QString ensureUniqueFilePath(const QString &dir, const QString &fileName) const;
-    QPixmap getTemplateThumbnail(const QString &filePath,
-                                 const QString &displayName,
+    QPixmap getTemplateThumbnail(const TemplateIndex::Entry &entry,
                                  const QString &sizeInfo) const;
-    QPixmap renderTemplateThumbnailFromFile(const QString &filePath,
-                                            const QSize &targetSize = QSize(150, 150)) const;
+    // 由元素模型直接绘制到 QImage（不创建场景与控件），可在工作线程调用
+    static QImage renderTemplateThumbnail(const QString &filePath,
+                                          const QSize &targetSize = QSize(150, 150));
+    void dispatchThumbnails();
+    void onThumbnailRendered(int generation,
+                             const QString &filePath,
+                             qint64 modified,
+                             const QImage &image,
+                             const QByteArray &png);
 
     // UI组件
     QLineEdit *m_searchEdit;
@@ -87,8 +101,23 @@ private:
     // 当前选中的分类
     QString m_currentCategory;
 
-    // 缩略图缓存（filePath -> pixmap）
+    // 模板库索引（尺寸、标签与缩略图，跨会话保存）
+    std::unique_ptr<TemplateIndex> m_templateIndex;
+
+    // 缩略图缓存（filePath + 修改时间 -> pixmap）
     mutable QHash<QString, QPixmap> m_thumbnailCache;
+
+    // 后台缩略图渲染：列表先显示占位图，渲染完成后替换图标
+    struct PendingThumbnail {
+        QString path;
+        qint64 modified = 0;
+        QListWidgetItem *item = nullptr;
+    };
+    QList<PendingThumbnail> m_pendingThumbnails;
+    QHash<QString, QListWidgetItem*> m_thumbnailItems;
+    int m_thumbnailsInFlight = 0;
+    std::atomic<int> m_thumbnailGeneration{0};
+    QThreadPool m_thumbnailPool;
 };
 
 #endif // TEMPLATECENTERDIALOG_H
@@ -55,7 +55,9 @@ QRectF AbstractShapeItem::boundingRect() const
 void AbstractShapeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     // 调用子类的具体绘制逻辑
-    paintShape(painter, option, widget);
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+    paintShape(painter);
 
     // 如果选中，绘制选择框和调整手柄
     if (isSelected()) {
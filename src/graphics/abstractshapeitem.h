@@ -42,6 +42,9 @@ public:
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制形状内容（不含选择框、手柄与对齐线），供输出渲染使用
+    void paintContent(QPainter *painter) const { paintShape(painter); }
+
     // 形状属性
     void setPen(const QPen &pen);
     QPen pen() const { return m_pen; }
@@ -86,7 +89,7 @@ protected:
     void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
 
     // 纯虚函数，由子类实现具体的绘制逻辑
-    virtual void paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) = 0;
+    virtual void paintShape(QPainter *painter) const = 0;
     
     // 虚函数，子类可以重写以提供特定的调整手柄行为
     virtual HandleType getHandleAt(const QPointF &pos) const;
@@ -33,77 +33,87 @@ void AlignableItem::checkAlignment()
         return;
     }
 
-    // 获取场景中的所有图形项
-    QList<QGraphicsItem*> items = item->scene()->items();
     m_showAlignmentLine = false;
     m_showHorizontalLine = false;
     m_showVerticalLine = false;
 
+    if (!m_hasSnapTargets) {
+        buildSnapTargets();
+    }
+
     // 获取当前图形项在场景中的矩形
     QRectF currentRect = getSceneRect(item);
 
-    // 首先检查与标签背景的对齐
-    QGraphicsItem* labelBackground = nullptr;
-    for (QGraphicsItem* otherItem : items) {
-        if (!otherItem || shouldIgnoreForAlignment(otherItem)) {
-            continue;
-        }
-        if (otherItem->data(0).toString() == "selectionFrame") {
-            continue;
-        }
-        if (otherItem->data(0).toString() == "labelBackground") {
-            labelBackground = otherItem;
-            break;
-        }
-    }
-
     // 目标：单次拖动中可同时对齐两个轴
     bool horizontalAligned = false;
     bool verticalAligned = false;
 
     // 如果找到标签背景，先尝试与标签的两个轴逐一对齐（对齐后更新 currentRect）
-    if (labelBackground) {
-        QRectF labelRect = getSceneRect(labelBackground);
-
-        horizontalAligned = checkLabelHorizontalAlignment(currentRect, labelRect);
+    if (m_hasLabelRect) {
+        horizontalAligned = checkLabelHorizontalAlignment(currentRect, m_labelRect);
         if (horizontalAligned) {
             currentRect = getSceneRect(item);
         }
 
-        verticalAligned = checkLabelVerticalAlignment(currentRect, labelRect);
+        verticalAligned = checkLabelVerticalAlignment(currentRect, m_labelRect);
         if (verticalAligned) {
             currentRect = getSceneRect(item);
         }
     }
 
-    // 然后检查与其他图形项的对齐
+    // 然后检查与其他图形项的对齐：每个轴取场景顺序中第一个可吸附的图形项。
+    // 与逐项检查时相同，两轴落在同一项上时先补齐垂直轴（X），再补齐水平轴（Y）
+    const int xTarget = verticalAligned ? -1 : m_snapIndex.firstXCandidate(currentRect, ALIGNMENT_THRESHOLD);
+    const int yTarget = horizontalAligned ? -1 : m_snapIndex.firstYCandidate(currentRect, ALIGNMENT_THRESHOLD);
+    if (xTarget >= 0 && (yTarget < 0 || xTarget <= yTarget)) {
+        checkVerticalAlignment(currentRect, m_snapIndex.rect(xTarget));
+        currentRect = getSceneRect(item);
+        if (yTarget >= 0) {
+            checkHorizontalAlignment(currentRect, m_snapIndex.rect(yTarget));
+        }
+    } else if (yTarget >= 0) {
+        checkHorizontalAlignment(currentRect, m_snapIndex.rect(yTarget));
+        currentRect = getSceneRect(item);
+        if (xTarget >= 0) {
+            checkVerticalAlignment(currentRect, m_snapIndex.rect(xTarget));
+        }
+    }
+}
+
+void AlignableItem::buildSnapTargets()
+{
+    QGraphicsItem* item = asGraphicsItem();
+    const QList<QGraphicsItem*> items = item->scene()->items();
+
+    QVector<QRectF> rects;
+    rects.reserve(items.size());
+    m_hasLabelRect = false;
     for (QGraphicsItem* otherItem : items) {
-        if (otherItem == item) continue; // 忽略自身
-        if (!otherItem) continue;
+        if (!otherItem || otherItem == item) continue;
         if (shouldIgnoreForAlignment(otherItem)) continue;
-        if (otherItem->data(0).toString() == "selectionFrame") continue;
 
-        // 跳过标签背景（已经检查过了）
-        if (otherItem->data(0).toString() == "labelBackground") {
+        const QString tag = otherItem->data(0).toString();
+        if (tag == "selectionFrame") continue;
+        // 标签背景单独处理，取第一个
+        if (tag == "labelBackground") {
+            if (!m_hasLabelRect) {
+                m_labelRect = getSceneRect(otherItem);
+                m_hasLabelRect = true;
+            }
             continue;
         }
+        rects.append(getSceneRect(otherItem));
+    }
 
-        QRectF otherRect = getSceneRect(otherItem);
-
-        // 先补齐未完成的垂直轴（X 对齐：中心/左右边/跨边）
-        if (!verticalAligned && checkVerticalAlignment(currentRect, otherRect)) {
-            verticalAligned = true;
-            currentRect = getSceneRect(item);
-            if (horizontalAligned) break; // 两轴都完成则退出
-        }
+    m_snapIndex.build(rects);
+    m_hasSnapTargets = true;
+}
 
-        // 再补齐未完成的水平轴（Y 对齐：中心/上下边/跨边）
-        if (!horizontalAligned && checkHorizontalAlignment(currentRect, otherRect)) {
-            horizontalAligned = true;
-            currentRect = getSceneRect(item);
-            if (verticalAligned) break; // 两轴都完成则退出
-        }
-    }
+void AlignableItem::releaseSnapTargets()
+{
+    m_hasSnapTargets = false;
+    m_hasLabelRect = false;
+    m_snapIndex.clear();
 }
 
 bool AlignableItem::checkHorizontalAlignment(const QRectF& currentRect, const QRectF& otherRect)
@@ -363,6 +373,7 @@ void AlignableItem::handleMouseReleaseForAlignment()
     m_showAlignmentLine = false;
     m_showHorizontalLine = false;
     m_showVerticalLine = false;
+    releaseSnapTargets();
 }
 
 void AlignableItem::paintAlignmentLines(QPainter *painter)
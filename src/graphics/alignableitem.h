@@ -6,6 +6,8 @@
 #include <QPainter>
 #include <QPointF>
 #include <QPen>
+#include "alignmentsnapindex.h"
+#include "labelitemtypes.h"
 
 /**
  * @brief 可对齐图形项的混入接口
@@ -121,6 +123,10 @@ private:
      */
     QRectF getSceneRect(QGraphicsItem* item) const;
 
+    // 拖动中第一次移动时收集吸附目标（标签背景与其余图形项），松开鼠标时释放
+    void buildSnapTargets();
+    void releaseSnapTargets();
+
 private:
     bool m_showAlignmentLine;     // 是否显示对齐线
     QPointF m_alignmentP1;        // 对齐线起点
@@ -138,6 +144,12 @@ private:
     // 如需进一步配置，可将其改为静态可变成员并提供 setter。
     static constexpr qreal ALIGNMENT_THRESHOLD = 5.0;  // 原为 10.0
 
+    // 本次拖动的吸附目标；拖动期间其余图形项不动，只建立一次
+    bool m_hasSnapTargets = false;
+    bool m_hasLabelRect = false;
+    QRectF m_labelRect;
+    AlignmentSnapIndex m_snapIndex;
+
     // 锁定状态
     bool m_locked = false;
     
@@ -0,0 +1,77 @@
+#include "alignmentsnapindex.h"
+
+#include <QtMath>
+
+#include <algorithm>
+
+void AlignmentSnapIndex::build(const QVector<QRectF> &rects)
+{
+    clear();
+    m_rects = rects;
+
+    const size_t count = static_cast<size_t>(rects.size());
+    for (Axis *axis : { &m_x, &m_y }) {
+        axis->start.reserve(count);
+        axis->center.reserve(count);
+        axis->end.reserve(count);
+    }
+    for (int i = 0; i < rects.size(); ++i) {
+        const QRectF &r = rects.at(i);
+        // 与逐项检查时使用的取值方式一致，避免浮点差异改变结果
+        m_x.start.emplace_back(r.left(), i);
+        m_x.center.emplace_back(r.center().x(), i);
+        m_x.end.emplace_back(r.right(), i);
+        m_y.start.emplace_back(r.top(), i);
+        m_y.center.emplace_back(r.center().y(), i);
+        m_y.end.emplace_back(r.bottom(), i);
+    }
+    for (Axis *axis : { &m_x, &m_y }) {
+        std::sort(axis->start.begin(), axis->start.end());
+        std::sort(axis->center.begin(), axis->center.end());
+        std::sort(axis->end.begin(), axis->end.end());
+    }
+}
+
+void AlignmentSnapIndex::clear()
+{
+    m_rects.clear();
+    for (Axis *axis : { &m_x, &m_y }) {
+        axis->start.clear();
+        axis->center.clear();
+        axis->end.clear();
+    }
+}
+
+int AlignmentSnapIndex::firstXCandidate(const QRectF &current, qreal threshold) const
+{
+    return firstCandidate(m_x, current.left(), current.center().x(), current.right(), threshold);
+}
+
+int AlignmentSnapIndex::firstYCandidate(const QRectF &current, qreal threshold) const
+{
+    return firstCandidate(m_y, current.top(), current.center().y(), current.bottom(), threshold);
+}
+
+int AlignmentSnapIndex::firstCandidate(const Axis &axis, qreal start, qreal center, qreal end, qreal threshold)
+{
+    int best = -1;
+    collect(axis.center, center, threshold, &best);   // 中线
+    collect(axis.start, start, threshold, &best);     // 起边对起边
+    collect(axis.end, end, threshold, &best);         // 终边对终边
+    collect(axis.end, start, threshold, &best);       // 起边对终边
+    collect(axis.start, end, threshold, &best);       // 终边对起边
+    return best;
+}
+
+void AlignmentSnapIndex::collect(const EdgeList &edges, qreal value, qreal threshold, int *best)
+{
+    auto it = std::lower_bound(edges.begin(), edges.end(), value - threshold,
+                               [](const std::pair<qreal, int> &edge, qreal key) {
+                                   return edge.first < key;
+                               });
+    for (; it != edges.end() && it->first <= value + threshold; ++it) {
+        if (qAbs(value - it->first) < threshold && (*best < 0 || it->second < *best)) {
+            *best = it->second;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ALIGNMENTSNAPINDEX_H
+#define ALIGNMENTSNAPINDEX_H
+
+#include <QRectF>
+#include <QVector>
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 对齐吸附目标的边线索引
+ *
+ * 拖动开始时对其余图形项的场景矩形建立一次索引：X、Y 方向各有按坐标排序的
+ * 起边、中线、终边数组。拖动中每次移动只需在各数组中二分查找阈值范围，
+ * 不再遍历整个场景。矩形按加入顺序编号，查询返回满足条件的最小编号，
+ * 与按 scene()->items() 顺序逐项检查时选中的对象相同。
+ */
+class AlignmentSnapIndex
+{
+public:
+    // rects 按检查优先级排列
+    void build(const QVector<QRectF> &rects);
+    void clear();
+    bool isEmpty() const { return m_rects.isEmpty(); }
+
+    // X 方向（中线、左右边、左对右、右对左）距离小于 threshold 的第一个矩形，没有时返回 -1
+    int firstXCandidate(const QRectF &current, qreal threshold) const;
+    // Y 方向（中线、上下边、上对下、下对上）
+    int firstYCandidate(const QRectF &current, qreal threshold) const;
+
+    const QRectF &rect(int index) const { return m_rects.at(index); }
+
+private:
+    using EdgeList = std::vector<std::pair<qreal, int>>;   // 坐标 -> 矩形编号，按坐标排序
+
+    struct Axis {
+        EdgeList start;     // 左边 / 上边
+        EdgeList center;
+        EdgeList end;       // 右边 / 下边
+    };
+
+    static int firstCandidate(const Axis &axis, qreal start, qreal center, qreal end, qreal threshold);
+    // 坐标与 value 相差小于 threshold 的项中最小的编号更新到 best
+    static void collect(const EdgeList &edges, qreal value, qreal threshold, int *best);
+
+    QVector<QRectF> m_rects;
+    Axis m_x;
+    Axis m_y;
+};
+
+#endif // ALIGNMENTSNAPINDEX_H
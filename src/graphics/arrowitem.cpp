@@ -56,10 +56,10 @@ void ArrowItem::setHeadAngle(qreal degrees)
 	}
 }
 
-void ArrowItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void ArrowItem::paintContent(QPainter *painter) const
 {
-	// 先调用基类绘制主线和手柄
-	LineItem::paint(painter, option, widget);
+	// 先调用基类绘制主线
+	LineItem::paintContent(painter);
 
 	// 再绘制箭头
 	QPointF s = startPoint();
@@ -11,6 +11,9 @@ public:
 	explicit ArrowItem(const QPointF &startPoint, const QPointF &endPoint, QGraphicsItem *parent = nullptr);
 	virtual ~ArrowItem() = default;
 
+	enum { Type = LabelItemType::Arrow };
+	int type() const override { return Type; }
+
 	// 箭头尺寸参数
 	void setHeadLength(qreal len);
 	qreal headLength() const { return m_headLength; }
@@ -28,8 +31,9 @@ public:
 
 	void copyItem(ArrowItem *item);
 
+	void paintContent(QPainter *painter) const override;
+
 protected:
-	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 	void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
 
 private:
@@ -8,6 +8,7 @@
 #include "lineitem.h"
 #include "rectangleitem.h"
 #include "circleitem.h"
+#include "symbolblitter.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QPainter>
 #include <QDebug>
@@ -76,62 +77,74 @@ bool isLinearFormat(ZXing::BarcodeFormat format) {
     }
 }
 
-void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+QFont BarcodeItem::humanReadableFontFor(int deviceDpiX, int deviceDpiY) const
 {
-    Q_UNUSED(widget);
-
     // 使用原始字体，但对打印设备进行大幅缩小
     QFont adjustedFont = m_humanReadableTextFont;
     
-    // 检查设备类型
-    QPaintDevice* device = painter->device();
-    if (device) {
-        // 获取设备的逻辑DPI
-        int deviceDpiX = device->logicalDpiX();
-        int deviceDpiY = device->logicalDpiY();
-        
-        // 标准屏幕DPI通常是96
-        const int standardDpi = 96;
-        
-        // 如果是高DPI设备（通常是打印机），大幅缩小字体
-        if (deviceDpiX > standardDpi * 1.5 || deviceDpiY > standardDpi * 1.5) {
-            // 使用更小的字体并设置为像素大小，更精确控制
-            adjustedFont.setPixelSize(10); // 从8像素调整到10像素，稍微大一点
-        }
+    // 标准屏幕DPI通常是96
+    const int standardDpi = 96;
+    
+    // 如果是高DPI设备（通常是打印机），大幅缩小字体
+    if (deviceDpiX > standardDpi * 1.5 || deviceDpiY > standardDpi * 1.5) {
+        // 使用更小的字体并设置为像素大小，更精确控制
+        adjustedFont.setPixelSize(10); // 从8像素调整到10像素，稍微大一点
     }
+    return adjustedFont;
+}
 
+qreal BarcodeItem::symbolBodyHeight(const QFont &font, const QString &data) const
+{
     // 计算文本高度，如果显示人类可读文本
     qreal textHeight = 0;
     qreal textSpacing = 2; // 进一步减小间距
-    QFontMetrics fm(adjustedFont);
-    if (m_showHumanReadableText && !m_data.isEmpty()) {
+    QFontMetrics fm(font);
+    if (m_showHumanReadableText && !data.isEmpty()) {
         // 为文本预留更多空间，确保不被裁剪
         textHeight = fm.height() + textSpacing + 3; // 额外增加3像素缓冲
     }
+    return m_size.height() - textHeight;
+}
+
+SymbolMatrixKey BarcodeItem::symbolMatrixKey(const QString &data, int deviceDpiX, int deviceDpiY) const
+{
+    // 使用条形码主体区域的尺寸来生成位矩阵
+    SymbolMatrixKey key;
+    if (data.isEmpty()) {
+        return key;
+    }
+    key.encoder = SymbolMatrixKey::Encoder::ZXing;
+    key.data = data;
+    key.format = static_cast<int>(m_format);
+    key.width = static_cast<int>(m_size.width());
+    key.height = static_cast<int>(symbolBodyHeight(humanReadableFontFor(deviceDpiX, deviceDpiY), data));
+    return key;
+}
+
+void BarcodeItem::paintContent(QPainter *painter) const
+{
+    // 获取设备的逻辑DPI
+    const QPaintDevice *device = painter->device();
+    const int deviceDpiX = device ? device->logicalDpiX() : 0;
+    const int deviceDpiY = device ? device->logicalDpiY() : 0;
+    const QFont adjustedFont = humanReadableFontFor(deviceDpiX, deviceDpiY);
 
     // 计算条形码主体的实际绘制区域（为文本预留空间）
-    qreal barcodeHeight = m_size.height() - textHeight;
+    qreal barcodeHeight = symbolBodyHeight(adjustedFont, m_data);
     QRectF barcodeRect(0, 0, m_size.width(), barcodeHeight);
 
     // 绘制背景
     painter->fillRect(QRectF(0, 0, m_size.width(), m_size.height()), m_backgroundColor);
 
-    if (!m_data.isEmpty()) {
-        try {
-            ZXing::MultiFormatWriter writer(m_format);
-            std::string utf8Data = ZXing::TextUtfEncoding::ToUtf8(m_data.toStdWString());
-
-            ZXing::BitMatrix bitMatrix;
-
-            // 使用条形码主体区域的尺寸来生成位矩阵
-            bitMatrix = writer.encode(utf8Data,
-                                       static_cast<int>(barcodeRect.width()),
-                                       static_cast<int>(barcodeRect.height())
-                                       );
-            // --- End Alternative ---
-
+    QString displayText;
 
+    if (!m_data.isEmpty()) {
+        // 结果按（数据、码制、尺寸）缓存，悬停、滚动、缩放与预览重绘不再重新编码
+        const std::shared_ptr<const SymbolMatrix> symbol =
+            m_symbolMatrix.matrix(symbolMatrixKey(m_data, deviceDpiX, deviceDpiY));
 
+        if (symbol && symbol->error.isEmpty()) {
+            const ZXing::BitMatrix &bitMatrix = symbol->bits;
             const int matrixWidth = bitMatrix.width();
             const int matrixHeight = bitMatrix.height();
 
@@ -177,17 +190,16 @@ void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
                     qreal offsetX = (barcodeRect.width() - drawWidth) / 2;
                     qreal offsetY = (barcodeRect.height() - drawHeight) / 2;
 
-                    for (int x = 0; x < matrixWidth; ++x) {
-                        if (bitMatrix.get(x, 0)) { // For 1D, typically check the first row
-                            painter->drawRect(QRectF(
-                                offsetX + x * actualScaleX, 
-                                offsetY, 
-                                actualScaleX, 
-                                drawHeight
-                            ));
-                        }
+                    // 一维码只看第一行：每根条一个矩形，整高绘制；光栅目标直接写扫描线
+                    const QRectF symbolRect(offsetX, offsetY, drawWidth, drawHeight);
+                    if (!SymbolBlitter::blit(painter, symbol->firstRowRuns, matrixWidth, 1,
+                                             symbolRect, m_foregroundColor)) {
+                        painter->drawPath(SymbolMatrix::modulePath(symbol->firstRowRuns,
+                                                                   QPointF(offsetX, offsetY),
+                                                                   actualScaleX,
+                                                                   drawHeight));
                     }
-                    m_displayText = m_data;
+                    displayText = m_data;
                 } else { // Potentially a 2D barcode (e.g. QR_CODE, DATA_MATRIX, AZTEC, PDF_417 if passed to this item)
                     // 使用条形码主体区域来绘制2D条形码
                     qreal scaleX = barcodeRect.width() / matrixWidth;
@@ -221,37 +233,33 @@ void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
                     qreal offsetX = (barcodeRect.width() - drawWidth) / 2;
                     qreal offsetY = (barcodeRect.height() - drawHeight) / 2;
 
-                    for (int y = 0; y < matrixHeight; ++y) {
-                        for (int x = 0; x < matrixWidth; ++x) {
-                            if (bitMatrix.get(x, y)) {
-                                painter->drawRect(QRectF(
-                                    offsetX + x * actualScaleX, 
-                                    offsetY + y * actualScaleY, 
-                                    actualScaleX, 
-                                    actualScaleY
-                                ));
-                            }
-                        }
+                    const QRectF symbolRect(offsetX, offsetY, drawWidth, drawHeight);
+                    if (!SymbolBlitter::blit(painter, symbol->runs, matrixWidth, matrixHeight,
+                                             symbolRect, m_foregroundColor)) {
+                        painter->drawPath(SymbolMatrix::modulePath(symbol->runs,
+                                                                   QPointF(offsetX, offsetY),
+                                                                   actualScaleX,
+                                                                   actualScaleY));
                     }
-                    m_displayText = m_data;
+                    displayText = m_data;
                 }
             } else {
                  qDebug() << "BarcodeItem: Generated BitMatrix is empty for data:" << m_data << "format:" << static_cast<int>(m_format);
-                 m_displayText.clear();
+                 displayText.clear();
             }
 
-        } catch (const std::exception &e) {
-            qDebug() << "BarcodeItem: Error generating barcode for data [" << m_data << "]: " << e.what();
+        } else if (symbol) {
+            qDebug() << "BarcodeItem: Error generating barcode for data [" << m_data << "]: " << symbol->error;
             painter->setPen(Qt::red);
-            painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()), Qt::AlignCenter | Qt::TextWordWrap, QString("Error: %1").arg(e.what()));
-            m_displayText.clear();
+            painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()), Qt::AlignCenter | Qt::TextWordWrap, QString("Error: %1").arg(symbol->error));
+            displayText.clear();
         }
     } else {
-        m_displayText.clear();
+        displayText.clear();
     }
 
     // 绘制人类可读文本（在条形码主体下方，但在总体尺寸内）
-    if (m_showHumanReadableText && !m_displayText.isEmpty()) {
+    if (m_showHumanReadableText && !displayText.isEmpty()) {
         painter->setPen(m_foregroundColor);
         painter->setFont(adjustedFont); // 使用调整后的字体
         
@@ -267,8 +275,15 @@ void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
             textRect.setHeight(m_size.height() - textRect.top());
         }
         
-        painter->drawText(textRect, Qt::AlignCenter | Qt::AlignTop, m_displayText);
+        painter->drawText(textRect, Qt::AlignCenter | Qt::AlignTop, displayText);
     }
+}
+
+void BarcodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    paintContent(painter);
 
     if (option->state & QStyle::State_Selected) {
         // 绘制选择框
@@ -315,6 +330,7 @@ void BarcodeItem::setData(const QString &data)
 {
     if (m_data != data) {
         m_data = data;
+        m_symbolMatrix.invalidate();
         prepareGeometryChange();
         update();
     }
@@ -324,6 +340,7 @@ void BarcodeItem::setFormat(ZXing::BarcodeFormat format)
 {
     if (m_format != format) {
         m_format = format;
+        m_symbolMatrix.invalidate();
         prepareGeometryChange(); // Format change might affect BitMatrix dimensions
         update();
     }
@@ -338,6 +355,7 @@ void BarcodeItem::setSize(const QSizeF &size)
     if (m_size != newSize) {
         prepareGeometryChange();
         m_size = newSize;
+        m_symbolMatrix.invalidate();
         update();
     }
 }
@@ -23,6 +23,7 @@
 #include "BarcodeFormat.h"
 #include "TextUtfEncoding.h" // For UTF-8 conversion
 #include "alignableitem.h"
+#include "symbolmatrixcache.h"
 // #include "ZXing/ImageView.h" // Removed as not used
 // #include "ZXing/Image.h"     // Removed as not used
 
@@ -47,10 +48,19 @@ public:
                          QGraphicsItem *parent = nullptr);
     ~BarcodeItem() override = default;
 
+    enum { Type = LabelItemType::Barcode };
+    int type() const override { return Type; }
+
     // Override QGraphicsItem pure virtual functions
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制条码内容（不含选择框与手柄），供输出渲染使用
+    void paintContent(QPainter *painter) const;
+
+    // 以 data 绘制到给定逻辑 DPI 的设备时的编码参数（DPI 为 0 表示未知设备），批量任务据此提前编码
+    SymbolMatrixKey symbolMatrixKey(const QString &data, int deviceDpiX, int deviceDpiY) const;
+
     // Setters and Getters
     void setData(const QString &data);
     QString data() const { return m_data; }
@@ -107,6 +117,10 @@ private:
     void updateSizeFromHandle(HandleType handle, const QPointF &delta);
     void setCursorForHandle(HandleType handle);
 
+    // 人类可读文本字体（高 DPI 设备上缩小）与扣除文本区后的条码主体高度
+    QFont humanReadableFontFor(int deviceDpiX, int deviceDpiY) const;
+    qreal symbolBodyHeight(const QFont &font, const QString &data) const;
+
     QString m_data;
     ZXing::BarcodeFormat m_format;
     QSizeF m_size;
@@ -121,7 +135,9 @@ private:
 
     bool m_showHumanReadableText;
     QFont m_humanReadableTextFont;
-    QString m_displayText;
+
+    // 最近一次编码得到的模块矩阵（数据、码制或尺寸变化时失效）
+    SymbolMatrixSlot m_symbolMatrix;
 
     // QImage generateBarcodeImage() const; // This helper was not fully implemented and paint() does direct rendering
 };
@@ -64,11 +64,8 @@ void CircleItem::setIsCircle(bool isCircle)
     }
 }
 
-void CircleItem::paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void CircleItem::paintShape(QPainter *painter) const
 {
-    Q_UNUSED(option)
-    Q_UNUSED(widget)
-
     QRectF rect(0, 0, m_size.width(), m_size.height());
 
     // 设置画笔和画刷
@@ -10,6 +10,9 @@ public:
     explicit CircleItem(const QSizeF &size, QGraphicsItem *parent = nullptr);
     virtual ~CircleItem() = default;
 
+    enum { Type = LabelItemType::Circle };
+    int type() const override { return Type; }
+
     // 圆形特有属性
     bool isCircle() const { return m_isCircle; }
     void setIsCircle(bool isCircle);
@@ -28,7 +31,7 @@ public:
 
 protected:
     // 实现抽象方法
-    void paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    void paintShape(QPainter *painter) const override;
 
     // 重写调整大小方法以支持圆形约束
     void updateSizeFromHandle(HandleType handle, const QPointF &delta) override;
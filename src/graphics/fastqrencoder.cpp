@@ -0,0 +1,848 @@
+#include "fastqrencoder.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+// 算法与 qrcodegen（Project Nayuki）逐步对应：分段方式、版本选择、纠错等级提升、
+// 交织、之字形布置与掩码罚分规则都相同，保证输出的模块矩阵完全一致。
+
+namespace {
+
+constexpr int kMinVersion = 1;
+constexpr int kMaxVersion = 40;
+constexpr int kMaxSize = kMaxVersion * 4 + 17;
+constexpr int kWords = (kMaxSize + 63) / 64;
+constexpr int kMaxCodewords = 3706;     // 版本 40 的全部码字数
+constexpr int kMaxEccLength = 30;
+constexpr int kMaskPeriod = 12;         // 8 种掩码在行、列方向的公共周期
+
+constexpr int kPenaltyN1 = 3;
+constexpr int kPenaltyN2 = 3;
+constexpr int kPenaltyN3 = 40;
+constexpr int kPenaltyN4 = 10;
+
+constexpr qint8 kEccCodewordsPerBlock[4][41] = {
+    {-1,  7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28, 28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26, 26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28},
+    {-1, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30, 28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28, 30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+};
+
+constexpr qint8 kNumErrorCorrectionBlocks[4][41] = {
+    {-1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 4,  4,  4,  4,  4,  6,  6,  6,  6,  7,  8,  8,  9,  9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25},
+    {-1, 1, 1, 1, 2, 2, 4, 4, 4, 5, 5,  5,  8,  9,  9, 10, 10, 11, 13, 14, 16, 17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49},
+    {-1, 1, 1, 2, 2, 4, 4, 6, 6, 8, 8,  8, 10, 12, 16, 12, 17, 16, 18, 21, 20, 23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68},
+    {-1, 1, 1, 2, 4, 4, 4, 5, 6, 8, 8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25, 25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81},
+};
+
+// 纠错等级序号到格式信息中两位编码的映射（L=01、M=00、Q=11、H=10）
+constexpr int kFormatBits[4] = { 1, 0, 3, 2 };
+
+enum class Mode { None, Numeric, Alphanumeric, Byte };
+
+// 一行（或一列）模块，第 i 位对应坐标 i
+struct Line {
+    quint64 w[kWords];
+};
+
+inline bool testBit(const Line &line, int i)
+{
+    return (line.w[i >> 6] >> (i & 63)) & 1u;
+}
+
+inline void assignBit(Line &line, int i, bool value)
+{
+    const quint64 bit = quint64(1) << (i & 63);
+    if (value) {
+        line.w[i >> 6] |= bit;
+    } else {
+        line.w[i >> 6] &= ~bit;
+    }
+}
+
+// 结果第 i 位 = 输入第 i + 1 位
+inline Line shiftDown(const Line &line)
+{
+    Line result;
+    for (int i = 0; i < kWords; ++i) {
+        result.w[i] = line.w[i] >> 1;
+        if (i + 1 < kWords) {
+            result.w[i] |= line.w[i + 1] << 63;
+        }
+    }
+    return result;
+}
+
+// 低 count 位为 1
+Line lowBits(int count)
+{
+    Line result{};
+    for (int i = 0; i < kWords; ++i) {
+        const int bits = std::clamp(count - i * 64, 0, 64);
+        result.w[i] = bits == 64 ? ~quint64(0) : ((quint64(1) << bits) - 1);
+    }
+    return result;
+}
+
+bool maskInverts(int mask, int x, int y)
+{
+    switch (mask) {
+    case 0: return (x + y) % 2 == 0;
+    case 1: return y % 2 == 0;
+    case 2: return x % 3 == 0;
+    case 3: return (x + y) % 3 == 0;
+    case 4: return (x / 3 + y / 2) % 2 == 0;
+    case 5: return x * y % 2 + x * y % 3 == 0;
+    case 6: return (x * y % 2 + x * y % 3) % 2 == 0;
+    default: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+    }
+}
+
+// 掩码图案按周期展开成整行：rows[m][y % 12] 的第 x 位、columns[m][x % 12] 的第 y 位
+struct MaskTables {
+    Line rows[8][kMaskPeriod];
+    Line columns[8][kMaskPeriod];
+};
+
+const MaskTables &maskTables()
+{
+    static const MaskTables tables = [] {
+        MaskTables t{};
+        for (int mask = 0; mask < 8; ++mask) {
+            for (int phase = 0; phase < kMaskPeriod; ++phase) {
+                for (int i = 0; i < kMaxSize; ++i) {
+                    assignBit(t.rows[mask][phase], i, maskInverts(mask, i, phase));
+                    assignBit(t.columns[mask][phase], i, maskInverts(mask, phase, i));
+                }
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// GF(2^8)（本原多项式 0x11D）的对数表与各纠错长度的生成多项式
+struct ReedSolomonTables {
+    quint8 exp[512];
+    int log[256];
+    quint8 divisors[kMaxEccLength + 1][kMaxEccLength];
+};
+
+quint8 gfMultiply(const ReedSolomonTables &t, quint8 a, quint8 b)
+{
+    return (a == 0 || b == 0) ? 0 : t.exp[t.log[a] + t.log[b]];
+}
+
+const ReedSolomonTables &reedSolomonTables()
+{
+    static const ReedSolomonTables tables = [] {
+        ReedSolomonTables t{};
+        int value = 1;
+        for (int i = 0; i < 255; ++i) {
+            t.exp[i] = static_cast<quint8>(value);
+            t.log[value] = i;
+            value <<= 1;
+            if (value & 0x100) {
+                value ^= 0x11D;
+            }
+        }
+        for (int i = 255; i < 512; ++i) {
+            t.exp[i] = t.exp[i - 255];
+        }
+
+        for (int degree = 1; degree <= kMaxEccLength; ++degree) {
+            quint8 *divisor = t.divisors[degree];
+            std::fill_n(divisor, degree, 0);
+            divisor[degree - 1] = 1;
+            quint8 root = 1;
+            for (int i = 0; i < degree; ++i) {
+                for (int j = 0; j < degree; ++j) {
+                    divisor[j] = gfMultiply(t, divisor[j], root);
+                    if (j + 1 < degree) {
+                        divisor[j] ^= divisor[j + 1];
+                    }
+                }
+                root = gfMultiply(t, root, 0x02);
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+int numRawDataModules(int version)
+{
+    int result = (16 * version + 128) * version + 64;
+    if (version >= 2) {
+        const int numAlign = version / 7 + 2;
+        result -= (25 * numAlign - 10) * numAlign - 55;
+        if (version >= 7) {
+            result -= 36;
+        }
+    }
+    return result;
+}
+
+int numDataCodewords(int version, int ecl)
+{
+    return numRawDataModules(version) / 8
+         - kEccCodewordsPerBlock[ecl][version] * kNumErrorCorrectionBlocks[ecl][version];
+}
+
+int alphanumericValue(char16_t c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    switch (c) {
+    case ' ': return 36;
+    case '$': return 37;
+    case '%': return 38;
+    case '*': return 39;
+    case '+': return 40;
+    case '-': return 41;
+    case '.': return 42;
+    case '/': return 43;
+    case ':': return 44;
+    default: return -1;
+    }
+}
+
+// 与 QString::toUtf8() 相同的转换规则：孤立代理项写成 '?'
+template <typename Sink>
+void forEachUtf8Byte(QStringView text, Sink sink)
+{
+    const qsizetype length = text.size();
+    for (qsizetype i = 0; i < length; ++i) {
+        const char16_t c = text[i].unicode();
+        if (c < 0x80) {
+            sink(static_cast<quint8>(c));
+        } else if (c < 0x800) {
+            sink(static_cast<quint8>(0xC0 | (c >> 6)));
+            sink(static_cast<quint8>(0x80 | (c & 0x3F)));
+        } else if (QChar::isHighSurrogate(c) && i + 1 < length && QChar::isLowSurrogate(text[i + 1].unicode())) {
+            const char32_t u = QChar::surrogateToUcs4(c, text[++i].unicode());
+            sink(static_cast<quint8>(0xF0 | (u >> 18)));
+            sink(static_cast<quint8>(0x80 | ((u >> 12) & 0x3F)));
+            sink(static_cast<quint8>(0x80 | ((u >> 6) & 0x3F)));
+            sink(static_cast<quint8>(0x80 | (u & 0x3F)));
+        } else if (QChar::isSurrogate(c)) {
+            sink(static_cast<quint8>('?'));
+        } else {
+            sink(static_cast<quint8>(0xE0 | (c >> 12)));
+            sink(static_cast<quint8>(0x80 | ((c >> 6) & 0x3F)));
+            sink(static_cast<quint8>(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+struct Segment {
+    Mode mode = Mode::None;
+    int numChars = 0;   // 数字/字母数字为字符数，字节模式为 UTF-8 字节数
+
+    int modeBits() const
+    {
+        return mode == Mode::Numeric ? 0x1 : mode == Mode::Alphanumeric ? 0x2 : 0x4;
+    }
+
+    int charCountBits(int version) const
+    {
+        const int range = (version + 7) / 17;
+        static constexpr int kNumeric[3] = { 10, 12, 14 };
+        static constexpr int kAlphanumeric[3] = { 9, 11, 13 };
+        static constexpr int kByte[3] = { 8, 16, 16 };
+        return mode == Mode::Numeric ? kNumeric[range]
+             : mode == Mode::Alphanumeric ? kAlphanumeric[range]
+             : kByte[range];
+    }
+
+    int dataBits() const
+    {
+        switch (mode) {
+        case Mode::Numeric: return numChars / 3 * 10 + (numChars % 3 != 0 ? numChars % 3 * 3 + 1 : 0);
+        case Mode::Alphanumeric: return numChars / 2 * 11 + numChars % 2 * 6;
+        case Mode::Byte: return numChars * 8;
+        default: return 0;
+        }
+    }
+
+    // 字符数超出计数字段时返回 -1
+    int totalBits(int version) const
+    {
+        if (mode == Mode::None) {
+            return 0;
+        }
+        const int ccBits = charCountBits(version);
+        if (numChars >= (1 << ccBits)) {
+            return -1;
+        }
+        return 4 + ccBits + dataBits();
+    }
+};
+
+Segment classify(QStringView text)
+{
+    Segment segment;
+    if (text.isEmpty()) {
+        return segment;
+    }
+    bool numeric = true;
+    bool alphanumeric = true;
+    for (const QChar ch : text) {
+        const char16_t c = ch.unicode();
+        numeric = numeric && c >= '0' && c <= '9';
+        alphanumeric = alphanumeric && alphanumericValue(c) >= 0;
+        if (!alphanumeric) {
+            break;
+        }
+    }
+    if (numeric || alphanumeric) {
+        segment.mode = numeric ? Mode::Numeric : Mode::Alphanumeric;
+        segment.numChars = static_cast<int>(text.size());
+    } else {
+        segment.mode = Mode::Byte;
+        qsizetype bytes = 0;
+        forEachUtf8Byte(text, [&bytes](quint8) { ++bytes; });
+        segment.numChars = static_cast<int>(std::min<qsizetype>(bytes, INT_MAX / 8));
+    }
+    return segment;
+}
+
+// 按线程复用的工作区：基础模块（未加掩码）与功能区标记按行、列各存一份，
+// 功能区标记在符号边长之外也置 1，掩码异或不会越界
+struct Workspace {
+    int size = 0;
+    Line rows[kMaxSize];
+    Line columns[kMaxSize];
+    Line functionRows[kMaxSize];
+    Line functionColumns[kMaxSize];
+    Line maskedRows[kMaxSize];
+    Line maskedColumns[kMaxSize];
+    quint8 data[kMaxCodewords];
+    quint8 codewords[kMaxCodewords];
+    quint8 ecc[kMaxCodewords];
+
+    void reset(int symbolSize)
+    {
+        size = symbolSize;
+        Line outside = lowBits(size);
+        for (int i = 0; i < kWords; ++i) {
+            outside.w[i] = ~outside.w[i];
+        }
+        for (int i = 0; i < size; ++i) {
+            rows[i] = Line{};
+            columns[i] = Line{};
+            functionRows[i] = outside;
+            functionColumns[i] = outside;
+        }
+    }
+
+    void setFunction(int x, int y, bool dark)
+    {
+        assignBit(rows[y], x, dark);
+        assignBit(columns[x], y, dark);
+        assignBit(functionRows[y], x, true);
+        assignBit(functionColumns[x], y, true);
+    }
+
+    bool isFunction(int x, int y) const { return testBit(functionRows[y], x); }
+
+    void setModule(int x, int y)
+    {
+        assignBit(rows[y], x, true);
+        assignBit(columns[x], y, true);
+    }
+
+    void setMasked(int x, int y, bool dark)
+    {
+        assignBit(maskedRows[y], x, dark);
+        assignBit(maskedColumns[x], y, dark);
+    }
+};
+
+class BitWriter
+{
+public:
+    explicit BitWriter(quint8 *buffer) : m_buffer(buffer) {}
+
+    void append(quint32 value, int length)
+    {
+        for (int i = length - 1; i >= 0; --i) {
+            if ((value >> i) & 1u) {
+                m_buffer[m_position >> 3] |= static_cast<quint8>(0x80 >> (m_position & 7));
+            }
+            ++m_position;
+        }
+    }
+
+    int size() const { return m_position; }
+
+private:
+    quint8 *m_buffer;
+    int m_position = 0;
+};
+
+void writeSegment(BitWriter *writer, const Segment &segment, QStringView text, int version)
+{
+    if (segment.mode == Mode::None) {
+        return;
+    }
+    writer->append(static_cast<quint32>(segment.modeBits()), 4);
+    writer->append(static_cast<quint32>(segment.numChars), segment.charCountBits(version));
+
+    const qsizetype length = text.size();
+    if (segment.mode == Mode::Numeric) {
+        for (qsizetype i = 0; i < length; i += 3) {
+            const int count = static_cast<int>(std::min<qsizetype>(3, length - i));
+            quint32 value = 0;
+            for (int j = 0; j < count; ++j) {
+                value = value * 10 + (text[i + j].unicode() - '0');
+            }
+            writer->append(value, count * 3 + 1);
+        }
+    } else if (segment.mode == Mode::Alphanumeric) {
+        qsizetype i = 0;
+        for (; i + 2 <= length; i += 2) {
+            writer->append(static_cast<quint32>(alphanumericValue(text[i].unicode()) * 45
+                                                + alphanumericValue(text[i + 1].unicode())), 11);
+        }
+        if (i < length) {
+            writer->append(static_cast<quint32>(alphanumericValue(text[i].unicode())), 6);
+        }
+    } else {
+        forEachUtf8Byte(text, [writer](quint8 byte) { writer->append(byte, 8); });
+    }
+}
+
+void drawFunctionPatterns(Workspace *ws, int version)
+{
+    const int size = ws->size;
+    for (int i = 0; i < size; ++i) {
+        ws->setFunction(6, i, i % 2 == 0);
+        ws->setFunction(i, 6, i % 2 == 0);
+    }
+
+    const int finders[3][2] = { { 3, 3 }, { size - 4, 3 }, { 3, size - 4 } };
+    for (const auto &center : finders) {
+        for (int dy = -4; dy <= 4; ++dy) {
+            for (int dx = -4; dx <= 4; ++dx) {
+                const int dist = std::max(std::abs(dx), std::abs(dy));
+                const int x = center[0] + dx;
+                const int y = center[1] + dy;
+                if (0 <= x && x < size && 0 <= y && y < size) {
+                    ws->setFunction(x, y, dist != 2 && dist != 4);
+                }
+            }
+        }
+    }
+
+    if (version > 1) {
+        int positions[7];
+        const int numAlign = version / 7 + 2;
+        const int step = (version * 8 + numAlign * 3 + 5) / (numAlign * 4 - 4) * 2;
+        positions[0] = 6;
+        for (int i = numAlign - 1, pos = size - 7; i >= 1; --i, pos -= step) {
+            positions[i] = pos;
+        }
+        for (int i = 0; i < numAlign; ++i) {
+            for (int j = 0; j < numAlign; ++j) {
+                if ((i == 0 && j == 0) || (i == 0 && j == numAlign - 1) || (i == numAlign - 1 && j == 0)) {
+                    continue;
+                }
+                for (int dy = -2; dy <= 2; ++dy) {
+                    for (int dx = -2; dx <= 2; ++dx) {
+                        ws->setFunction(positions[i] + dx, positions[j] + dy,
+                                        std::max(std::abs(dx), std::abs(dy)) != 1);
+                    }
+                }
+            }
+        }
+    }
+
+    // 格式信息区只做功能区标记，实际内容随掩码写入
+    for (int i = 0; i <= 8; ++i) {
+        if (i != 6) {
+            ws->setFunction(8, i, false);
+            ws->setFunction(i, 8, false);
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        ws->setFunction(size - 1 - i, 8, false);
+    }
+    for (int i = 8; i < 15; ++i) {
+        ws->setFunction(8, size - 15 + i, false);
+    }
+    ws->setFunction(8, size - 8, true);
+
+    if (version >= 7) {
+        int rem = version;
+        for (int i = 0; i < 12; ++i) {
+            rem = (rem << 1) ^ ((rem >> 11) * 0x1F25);
+        }
+        const long bits = static_cast<long>(version) << 12 | rem;
+        for (int i = 0; i < 18; ++i) {
+            const bool bit = (bits >> i) & 1;
+            const int a = size - 11 + i % 3;
+            const int b = i / 3;
+            ws->setFunction(a, b, bit);
+            ws->setFunction(b, a, bit);
+        }
+    }
+}
+
+// 分块计算纠错码并交织，结果写入 ws->codewords，返回码字总数
+int addEccAndInterleave(Workspace *ws, int version, int ecl)
+{
+    const ReedSolomonTables &rs = reedSolomonTables();
+    const int numBlocks = kNumErrorCorrectionBlocks[ecl][version];
+    const int eccLength = kEccCodewordsPerBlock[ecl][version];
+    const int rawCodewords = numRawDataModules(version) / 8;
+    const int numShortBlocks = numBlocks - rawCodewords % numBlocks;
+    const int shortDataLength = rawCodewords / numBlocks - eccLength;
+    const quint8 *divisor = rs.divisors[eccLength];
+
+    for (int block = 0, offset = 0; block < numBlocks; ++block) {
+        const int dataLength = shortDataLength + (block < numShortBlocks ? 0 : 1);
+        quint8 *remainder = ws->ecc + block * eccLength;
+        std::fill_n(remainder, eccLength, 0);
+        for (int i = 0; i < dataLength; ++i) {
+            const quint8 factor = ws->data[offset + i] ^ remainder[0];
+            std::memmove(remainder, remainder + 1, static_cast<size_t>(eccLength - 1));
+            remainder[eccLength - 1] = 0;
+            if (factor != 0) {
+                const int logFactor = rs.log[factor];
+                for (int j = 0; j < eccLength; ++j) {
+                    if (divisor[j] != 0) {
+                        remainder[j] ^= rs.exp[rs.log[divisor[j]] + logFactor];
+                    }
+                }
+            }
+        }
+        offset += dataLength;
+    }
+
+    int count = 0;
+    for (int i = 0; i <= shortDataLength; ++i) {
+        for (int block = 0; block < numBlocks; ++block) {
+            if (i < shortDataLength || block >= numShortBlocks) {
+                const int blockOffset = block * shortDataLength + std::max(0, block - numShortBlocks);
+                ws->codewords[count++] = ws->data[blockOffset + i];
+            }
+        }
+    }
+    for (int i = 0; i < eccLength; ++i) {
+        for (int block = 0; block < numBlocks; ++block) {
+            ws->codewords[count++] = ws->ecc[block * eccLength + i];
+        }
+    }
+    return count;
+}
+
+void drawCodewords(Workspace *ws, int count)
+{
+    const int size = ws->size;
+    const int totalBits = count * 8;
+    int bit = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) {
+            right = 5;
+        }
+        const bool upward = ((right + 1) & 2) == 0;
+        for (int vert = 0; vert < size; ++vert) {
+            const int y = upward ? size - 1 - vert : vert;
+            for (int j = 0; j < 2; ++j) {
+                const int x = right - j;
+                if (bit < totalBits && !ws->isFunction(x, y)) {
+                    if ((ws->codewords[bit >> 3] >> (7 - (bit & 7))) & 1) {
+                        ws->setModule(x, y);
+                    }
+                    ++bit;
+                }
+            }
+        }
+    }
+}
+
+// 在基础模块上叠加掩码并写入对应的格式信息，结果在 maskedRows / maskedColumns
+void applyMask(Workspace *ws, int mask, int ecl)
+{
+    const MaskTables &tables = maskTables();
+    const int size = ws->size;
+    for (int i = 0; i < size; ++i) {
+        const Line &rowPattern = tables.rows[mask][i % kMaskPeriod];
+        const Line &columnPattern = tables.columns[mask][i % kMaskPeriod];
+        for (int k = 0; k < kWords; ++k) {
+            ws->maskedRows[i].w[k] = ws->rows[i].w[k] ^ (rowPattern.w[k] & ~ws->functionRows[i].w[k]);
+            ws->maskedColumns[i].w[k] = ws->columns[i].w[k] ^ (columnPattern.w[k] & ~ws->functionColumns[i].w[k]);
+        }
+    }
+
+    const int data = kFormatBits[ecl] << 3 | mask;
+    int rem = data;
+    for (int i = 0; i < 10; ++i) {
+        rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    }
+    const int bits = (data << 10 | rem) ^ 0x5412;
+    auto bitAt = [bits](int i) { return ((bits >> i) & 1) != 0; };
+
+    for (int i = 0; i <= 5; ++i) {
+        ws->setMasked(8, i, bitAt(i));
+    }
+    ws->setMasked(8, 7, bitAt(6));
+    ws->setMasked(8, 8, bitAt(7));
+    ws->setMasked(7, 8, bitAt(8));
+    for (int i = 9; i < 15; ++i) {
+        ws->setMasked(14 - i, 8, bitAt(i));
+    }
+    for (int i = 0; i < 8; ++i) {
+        ws->setMasked(size - 1 - i, 8, bitAt(i));
+    }
+    for (int i = 8; i < 15; ++i) {
+        ws->setMasked(8, size - 15 + i, bitAt(i));
+    }
+    ws->setMasked(8, size - 8, true);
+}
+
+// 一行/一列的同色连续段与类定位图案罚分。连续段边界由相邻位异或后按字逐个取出，
+// 类定位图案的判定沿用 qrcodegen 的游程历史（两端各补一段与边长等宽的浅色静区）
+class LineScorer
+{
+public:
+    explicit LineScorer(int size) : m_size(size), m_transitions(lowBits(size - 1)) {}
+
+    long score(const Line &line) const
+    {
+        Line edges = shiftDown(line);
+        for (int k = 0; k < kWords; ++k) {
+            edges.w[k] = (edges.w[k] ^ line.w[k]) & m_transitions.w[k];
+        }
+
+        State state;
+        int start = 0;
+        for (int k = 0; k < kWords; ++k) {
+            quint64 word = edges.w[k];
+            while (word != 0) {
+                const int end = k * 64 + static_cast<int>(qCountTrailingZeroBits(word));
+                pushRun(&state, testBit(line, start), end - start + 1);
+                start = end + 1;
+                word &= word - 1;
+            }
+        }
+        pushRun(&state, testBit(line, start), m_size - start);
+
+        // 收尾：结束最后一段并补上右侧静区
+        state.result += runPenalty(state.runLength);
+        int runLength = state.runLength;
+        if (state.runColor) {
+            addHistory(&state, runLength);
+            runLength = 0;
+        }
+        addHistory(&state, runLength + m_size);
+        state.result += countPatterns(state) * kPenaltyN3;
+        return state.result;
+    }
+
+private:
+    struct State {
+        long result = 0;
+        bool runColor = false;
+        int runLength = 0;
+        int history[7] = {};
+    };
+
+    static long runPenalty(int length)
+    {
+        return length >= 5 ? kPenaltyN1 + (length - 5) : 0;
+    }
+
+    void addHistory(State *state, int length) const
+    {
+        if (state->history[0] == 0) {
+            length += m_size;
+        }
+        std::memmove(state->history + 1, state->history, sizeof(int) * 6);
+        state->history[0] = length;
+    }
+
+    static int countPatterns(const State &state)
+    {
+        const int *h = state.history;
+        const int n = h[1];
+        const bool core = n > 0 && h[2] == n && h[3] == n * 3 && h[4] == n && h[5] == n;
+        return (core && h[0] >= n * 4 && h[6] >= n ? 1 : 0)
+             + (core && h[6] >= n * 4 && h[0] >= n ? 1 : 0);
+    }
+
+    void pushRun(State *state, bool color, int length) const
+    {
+        // 只有首段浅色会与初始的空段同色
+        if (color == state->runColor) {
+            state->runLength += length;
+            return;
+        }
+        state->result += runPenalty(state->runLength);
+        addHistory(state, state->runLength);
+        if (!state->runColor) {
+            state->result += countPatterns(*state) * kPenaltyN3;
+        }
+        state->runColor = color;
+        state->runLength = length;
+    }
+
+    int m_size;
+    Line m_transitions;
+};
+
+long penaltyScore(const Workspace &ws)
+{
+    const int size = ws.size;
+    const LineScorer scorer(size);
+    long result = 0;
+    for (int i = 0; i < size; ++i) {
+        result += scorer.score(ws.maskedRows[i]);
+        result += scorer.score(ws.maskedColumns[i]);
+    }
+
+    // 2×2 同色块：上下同色且左右同色的位置
+    const Line inner = lowBits(size - 1);
+    long blocks = 0;
+    int dark = 0;
+    for (int y = 0; y < size; ++y) {
+        const Line &top = ws.maskedRows[y];
+        for (int k = 0; k < kWords; ++k) {
+            dark += qPopulationCount(top.w[k]);
+        }
+        if (y + 1 == size) {
+            break;
+        }
+        const Line &bottom = ws.maskedRows[y + 1];
+        Line vertical;
+        for (int k = 0; k < kWords; ++k) {
+            vertical.w[k] = ~(top.w[k] ^ bottom.w[k]);
+        }
+        const Line verticalNext = shiftDown(vertical);
+        const Line topNext = shiftDown(top);
+        for (int k = 0; k < kWords; ++k) {
+            blocks += qPopulationCount(vertical.w[k] & verticalNext.w[k] & ~(top.w[k] ^ topNext.w[k]) & inner.w[k]);
+        }
+    }
+    result += blocks * kPenaltyN2;
+
+    const int total = size * size;
+    const int k = static_cast<int>((std::abs(dark * 20L - total * 10L) + total - 1) / total) - 1;
+    result += k * kPenaltyN4;
+    return result;
+}
+
+} // namespace
+
+bool FastQrEncoder::encode(QStringView text,
+                           const Options &options,
+                           ZXing::BitMatrix *matrix,
+                           QString *errorMessage)
+{
+    if (options.eccLevel < 0 || options.eccLevel > 3
+        || options.version < 0 || options.version > kMaxVersion
+        || options.mask < -1 || options.mask > 7) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Invalid value");
+        }
+        return false;
+    }
+
+    // qrcodegen 以 C 字符串接收 UTF-8 数据，遇到 NUL 即截止
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (text[i].unicode() == 0) {
+            text = text.left(i);
+            break;
+        }
+    }
+
+    const Segment segment = classify(text);
+    const int minVersion = options.version > 0 ? options.version : kMinVersion;
+    const int maxVersion = options.version > 0 ? options.version : kMaxVersion;
+    int ecl = options.eccLevel;
+
+    int version = minVersion;
+    int usedBits = 0;
+    for (;; ++version) {
+        const int capacityBits = numDataCodewords(version, ecl) * 8;
+        usedBits = segment.totalBits(version);
+        if (usedBits != -1 && usedBits <= capacityBits) {
+            break;
+        }
+        if (version >= maxVersion) {
+            if (errorMessage) {
+                *errorMessage = usedBits == -1
+                    ? QStringLiteral("Segment too long")
+                    : QStringLiteral("Data length = %1 bits, Max capacity = %2 bits").arg(usedBits).arg(capacityBits);
+            }
+            return false;
+        }
+    }
+
+    if (options.boostEcl) {
+        for (int newEcl = 1; newEcl <= 3; ++newEcl) {
+            if (usedBits <= numDataCodewords(version, newEcl) * 8) {
+                ecl = newEcl;
+            }
+        }
+    }
+
+    thread_local Workspace workspace;
+    Workspace &ws = workspace;
+
+    // 数据位串：段数据、终止符、补齐到字节，再交替填充 0xEC / 0x11
+    const int dataCodewords = numDataCodewords(version, ecl);
+    std::fill_n(ws.data, dataCodewords, 0);
+    BitWriter writer(ws.data);
+    writeSegment(&writer, segment, text, version);
+    const int capacityBits = dataCodewords * 8;
+    writer.append(0, std::min(4, capacityBits - writer.size()));
+    writer.append(0, (8 - writer.size() % 8) % 8);
+    for (quint8 pad = 0xEC; writer.size() < capacityBits; pad ^= 0xEC ^ 0x11) {
+        writer.append(pad, 8);
+    }
+
+    ws.reset(version * 4 + 17);
+    drawFunctionPatterns(&ws, version);
+    drawCodewords(&ws, addEccAndInterleave(&ws, version, ecl));
+
+    int mask = options.mask;
+    if (mask < 0) {
+        long minPenalty = LONG_MAX;
+        for (int candidate = 0; candidate < 8; ++candidate) {
+            applyMask(&ws, candidate, ecl);
+            const long penalty = penaltyScore(ws);
+            if (penalty < minPenalty) {
+                mask = candidate;
+                minPenalty = penalty;
+            }
+        }
+    }
+    applyMask(&ws, mask, ecl);
+
+    const int size = ws.size;
+    *matrix = ZXing::BitMatrix(size, size);
+    for (int y = 0; y < size; ++y) {
+        for (int k = 0; k < kWords; ++k) {
+            quint64 word = ws.maskedRows[y].w[k];
+            while (word != 0) {
+                const int x = k * 64 + static_cast<int>(qCountTrailingZeroBits(word));
+                if (x < size) {
+                    matrix->set(x, y);
+                }
+                word &= word - 1;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef FASTQRENCODER_H
+#define FASTQRENCODER_H
+
+#include <QString>
+#include <QStringView>
+
+#include "BitMatrix.h"
+
+/**
+ * @brief QR 码编码器（与 qrcodegen::QrCode::encodeText 逐模块一致）
+ *
+ * 分段、纠错、布置与掩码选择都在按线程复用的定长缓冲中完成，每次编码只分配输出矩阵；
+ * 模块按 64 位字存储，掩码评分的连续段、2×2 块与深色比例都按字计算。
+ * 批量载荷长度一致时可固定版本与掩码，跳过版本搜索和 8 个掩码的评分。
+ */
+class FastQrEncoder
+{
+public:
+    struct Options {
+        int eccLevel = 1;       // qrcodegen::QrCode::Ecc 的序号：0 L、1 M、2 Q、3 H
+        int version = 0;        // 1..40 固定版本；0 表示取能容纳数据的最小版本
+        int mask = -1;          // 0..7 固定掩码；-1 表示按罚分自动选择
+        bool boostEcl = true;   // 版本不变时尽量提高纠错等级
+    };
+
+    // 编码成功时写入 matrix（边长 = 版本 × 4 + 17，不含静区）；
+    // 数据超出容量或参数无效时返回 false，errorMessage 与 qrcodegen 的异常文本一致
+    static bool encode(QStringView text,
+                       const Options &options,
+                       ZXing::BitMatrix *matrix,
+                       QString *errorMessage);
+};
+
+#endif // FASTQRENCODER_H
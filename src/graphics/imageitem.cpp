@@ -19,6 +19,9 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QtMath>
+#include <QTransform>
+
+#include <cmath>
 
 // 静态成员变量初始化
 bool ImageItem::s_hasCopiedItem = false;
@@ -48,7 +51,6 @@ ImageItem::ImageItem(const QString &imagePath, QGraphicsItem *parent)
 
 ImageItem::ImageItem(const QPixmap &pixmap, QGraphicsItem *parent)
     : QGraphicsItem(parent)
-    , m_pixmap(pixmap)
     , m_size(pixmap.size())
     , m_keepAspectRatio(true)
     , m_opacity(1.0)
@@ -61,9 +63,11 @@ ImageItem::ImageItem(const QPixmap &pixmap, QGraphicsItem *parent)
     setAcceptHoverEvents(true);
 
     // 将 QPixmap 转换为 QByteArray 存储
+    const QImage image = pixmap.toImage();
     QBuffer buffer(&m_originalImageData);
     buffer.open(QIODevice::WriteOnly);
-    m_pixmap.save(&buffer, "PNG");
+    image.save(&buffer, "PNG");
+    m_image = ImageMipChain::fromImage(image, m_originalImageData);
 }
 
 ImageItem::ImageItem(const QByteArray &imageData, QGraphicsItem *parent)
@@ -96,32 +100,68 @@ QRectF ImageItem::boundingRect() const
                   m_size.height() + 2 * padding);
 }
 
-void ImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void ImageItem::paintContent(QPainter *painter) const
 {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
+    const QRectF targetRect(0, 0, m_size.width(), m_size.height());
+    const QTransform transform = painter->deviceTransform();
+    const qreal deviceScaleX = std::hypot(transform.m11(), transform.m12());
+    const qreal deviceScaleY = std::hypot(transform.m21(), transform.m22());
+
+    if (m_hasRecordImage) {
+        // 记录图像尺寸各不相同：保持宽高比时居中放入元素矩形
+        const QSize deviceSize(qCeil(targetRect.width() * deviceScaleX), qCeil(targetRect.height() * deviceScaleY));
+        const QImage image = RecordImageProvider::instance().image(m_recordImagePath, deviceSize);
+        if (image.isNull()) {
+            return;
+        }
+        QRectF drawRect = targetRect;
+        if (m_keepAspectRatio) {
+            QSizeF fitted = QSizeF(image.size()).scaled(targetRect.size(), Qt::KeepAspectRatio);
+            drawRect = QRectF(QPointF(targetRect.center().x() - fitted.width() / 2.0,
+                                      targetRect.center().y() - fitted.height() / 2.0), fitted);
+        }
+        const qreal oldOpacity = painter->opacity();
+        painter->setOpacity(oldOpacity * m_opacity);
+        painter->drawImage(drawRect, image, QRectF(image.rect()));
+        painter->setOpacity(oldOpacity);
+        return;
+    }
 
-    if (m_pixmap.isNull()) {
+    if (!m_image) {
         // 如果没有图像，绘制占位符
         painter->setPen(QPen(Qt::gray, 2, Qt::DashLine));
         painter->setBrush(Qt::NoBrush);
-        QRectF rect(0, 0, m_size.width(), m_size.height());
-        painter->drawRect(rect);
-        
+        painter->drawRect(targetRect);
+
         painter->setPen(Qt::gray);
-        painter->drawText(rect, Qt::AlignCenter, QObject::tr("No Image"));
+        painter->drawText(targetRect, Qt::AlignCenter, QObject::tr("No Image"));
         return;
     }
 
-    // 设置透明度
-    painter->setOpacity(m_opacity);
+    // 设置透明度（叠加在外部透明度之上）
+    const qreal oldOpacity = painter->opacity();
+    painter->setOpacity(oldOpacity * m_opacity);
 
-    // 绘制图像
-    QRectF targetRect(0, 0, m_size.width(), m_size.height());
-    painter->drawPixmap(targetRect, m_pixmap, m_pixmap.rect());
+    // 按设备上的实际像素尺寸取最接近的缩放级别，QPainter 只需再做不到两倍的缩放
+    const QSize deviceSize(qCeil(targetRect.width() * deviceScaleX), qCeil(targetRect.height() * deviceScaleY));
+    const QImage image = m_image->imageFor(deviceSize);
+    painter->drawImage(targetRect, image, QRectF(image.rect()));
 
     // 恢复透明度
-    painter->setOpacity(1.0);
+    painter->setOpacity(oldOpacity);
+}
+
+void ImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    paintContent(painter);
+    if (!m_image) {
+        return;
+    }
+
+    const QRectF targetRect(0, 0, m_size.width(), m_size.height());
 
     // 如果选中，绘制选择框和调整手柄
     if (isSelected()) {
@@ -144,24 +184,25 @@ bool ImageItem::loadImage(const QString &imagePath)
         return false;
     }
 
-    QPixmap pixmap(imagePath);
-    if (pixmap.isNull()) {
+    // 读取原始图像数据
+    QFile file(imagePath);
+    if (!file.open(QIODevice::ReadOnly)) {
         qDebug()<<"isnull";
         return false;
     }
+    const QByteArray imageData = file.readAll();
+    auto image = ImageMipChain::fromEncoded(imageData);
+    if (!image) {
+        return false;
+    }
 
     m_imagePath = imagePath;
-    m_pixmap = pixmap;
-
-    // 读取原始图像数据
-    QFile file(imagePath);
-    if (file.open(QIODevice::ReadOnly)) {
-        m_originalImageData = file.readAll();
-    }
+    m_image = image;
+    m_originalImageData = imageData;
 
     // 如果保持宽高比，调整尺寸
     if (m_keepAspectRatio) {
-        QSizeF originalSize = pixmap.size();
+        QSizeF originalSize = m_image->sourceSize();
         if (originalSize.width() > 0 && originalSize.height() > 0) {
             // 保持原始宽高比，但限制最大尺寸
             qreal maxSize = 300.0;
@@ -185,18 +226,18 @@ bool ImageItem::setImageData(const QByteArray &imageData)
         return false;
     }
 
-    QPixmap pixmap;
-    if (!pixmap.loadFromData(imageData)) {
+    auto image = ImageMipChain::fromEncoded(imageData);
+    if (!image) {
         return false;
     }
 
     m_originalImageData = imageData;
-    m_pixmap = pixmap;
+    m_image = image;
     m_imagePath.clear(); // 清除文件路径，因为这是从数据加载的
 
     // 如果保持宽高比，调整尺寸
     if (m_keepAspectRatio) {
-        QSizeF originalSize = pixmap.size();
+        QSizeF originalSize = m_image->sourceSize();
         if (originalSize.width() > 0 && originalSize.height() > 0) {
             qreal maxSize = 300.0;
             qreal scale = qMin(maxSize / originalSize.width(), maxSize / originalSize.height());
@@ -215,18 +256,43 @@ bool ImageItem::setImageData(const QByteArray &imageData)
 
 void ImageItem::setPixmap(const QPixmap &pixmap)
 {
-    m_pixmap = pixmap;
+    setImage(pixmap.toImage());
+}
+
+void ImageItem::setImage(const QImage &image)
+{
     m_imagePath.clear();
 
-    // 将 QPixmap 转换为 QByteArray
+    // 将图像编码为 QByteArray
+    m_originalImageData.clear();
     QBuffer buffer(&m_originalImageData);
     buffer.open(QIODevice::WriteOnly);
-    m_pixmap.save(&buffer, "PNG");
+    image.save(&buffer, "PNG");
+    m_image = ImageMipChain::fromImage(image, m_originalImageData);
 
     prepareGeometryChange();
     update();
 }
 
+void ImageItem::setRecordImagePath(const QString &filePath)
+{
+    m_recordImagePath = filePath;
+    m_hasRecordImage = true;
+    update();
+}
+
+void ImageItem::clearRecordImage()
+{
+    m_recordImagePath.clear();
+    m_hasRecordImage = false;
+    update();
+}
+
+QImage ImageItem::image() const
+{
+    return m_image ? m_image->sourceImage() : QImage();
+}
+
 QByteArray ImageItem::imageData() const
 {
     return m_originalImageData;
@@ -260,11 +326,11 @@ void ImageItem::setOpacity(qreal opacity)
 
 QSizeF ImageItem::calculateAspectRatioSize(const QSizeF &newSize) const
 {
-    if (m_pixmap.isNull() || newSize.width() <= 0 || newSize.height() <= 0) {
+    if (!m_image || newSize.width() <= 0 || newSize.height() <= 0) {
         return newSize;
     }
 
-    QSizeF originalSize = m_pixmap.size();
+    QSizeF originalSize = m_image->sourceSize();
     if (originalSize.width() <= 0 || originalSize.height() <= 0) {
         return newSize;
     }
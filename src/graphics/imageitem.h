@@ -18,7 +18,11 @@
 #include <QMenu>
 #include <QPixmap>
 #include <QByteArray>
+#include <QImage>
+#include <memory>
 #include "alignableitem.h"
+#include "imagemipchain.h"
+#include "recordimageprovider.h"
 
 class ImageItem : public QGraphicsItem, public AlignableItem
 {
@@ -41,20 +45,42 @@ public:
     explicit ImageItem(const QByteArray &imageData, QGraphicsItem *parent = nullptr);
     ~ImageItem() override = default;
 
+    enum { Type = LabelItemType::Image };
+    int type() const override { return Type; }
+
     // 重写QGraphicsItem的纯虚函数
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制图像内容（不含选择框与手柄），供输出渲染使用
+    void paintContent(QPainter *painter) const;
+
     // 图像相关方法
     bool loadImage(const QString &imagePath);
     bool setImageData(const QByteArray &imageData);
     void setPixmap(const QPixmap &pixmap);
-    QPixmap pixmap() const { return m_pixmap; }
+    void setImage(const QImage &image);
+    // 原分辨率图像（按需解码，供裁剪等编辑操作使用）
+    QImage image() const;
+    QPixmap pixmap() const { return QPixmap::fromImage(image()); }
+    bool hasImage() const { return static_cast<bool>(m_image); }
     
     // 获取图像数据（用于序列化）
     QByteArray imageData() const;
+    // 图像数据的内容哈希（SHA-256），无图像时为空
+    QByteArray imageHash() const { return m_image ? m_image->contentHash() : QByteArray(); }
     QString imagePath() const { return m_imagePath; }
 
+    // 绑定数据源时按记录取图：取值（路径或键名）相对的目录，空为共享素材目录
+    void setRecordImageDirectory(const QString &directory) { m_recordImageDirectory = directory; }
+    QString recordImageDirectory() const { return m_recordImageDirectory; }
+    // 当前记录的图像文件，代替自身图像绘制（由 RecordImageProvider 解码）；
+    // 路径为空表示该记录没有可用图像，不绘制。clearRecordImage() 恢复自身图像
+    void setRecordImagePath(const QString &filePath);
+    void clearRecordImage();
+    QString recordImagePath() const { return m_recordImagePath; }
+    bool hasRecordImage() const { return m_hasRecordImage; }
+
     // 设置和获取图像大小
     void setSize(const QSizeF &size);
     QSizeF size() const { return m_size; }
@@ -108,9 +134,12 @@ private:
     QSizeF calculateAspectRatioSize(const QSizeF &newSize) const;
 
     // 成员变量
-    QPixmap m_pixmap;               // 图像数据
+    std::shared_ptr<const ImageMipChain> m_image; // 多级缩放链，解码结果在共享缓存中
     QByteArray m_originalImageData; // 原始图像数据（用于序列化）
     QString m_imagePath;            // 图像文件路径（如果从文件加载）
+    QString m_recordImageDirectory; // 按记录取图时取值相对的目录
+    QString m_recordImagePath;      // 当前记录的图像文件（批量打印/预览期间）
+    bool m_hasRecordImage = false;  // 正在按记录取图（文件缺失时该记录不绘制图像）
     QSizeF m_size;                  // 显示尺寸
     bool m_keepAspectRatio;         // 是否保持宽高比
     qreal m_opacity;                // 透明度
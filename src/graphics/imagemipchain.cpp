@@ -0,0 +1,197 @@
+#include "imagemipchain.h"
+
+#include <QBuffer>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+
+#include <algorithm>
+
+namespace {
+
+// 缓存容量（KiB）：一张 2400 万像素的原图解码后约 92 MiB
+constexpr int kCacheBudgetKiB = 192 * 1024;
+
+// 以内容哈希而非图形项区分：相同的图像数据（同一标志用在多个元素、多个模板中）共用各级
+using LevelKey = QPair<QByteArray, int>;
+
+struct SharedCache {
+    QMutex mutex;
+    QCache<LevelKey, QImage> levels{kCacheBudgetKiB};
+    // 解码过的内容的原图尺寸；原图被淘汰后再创建缩放链也不必为了尺寸重新解码
+    QHash<QByteArray, QSize> sourceSizes;
+};
+
+SharedCache &sharedCache()
+{
+    static SharedCache cache;
+    return cache;
+}
+
+int costOf(const QImage &image)
+{
+    return std::max(1, static_cast<int>(image.sizeInBytes() / 1024));
+}
+
+// 统一为 QPainter 绘制最快的两种格式
+QImage normalized(const QImage &image)
+{
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    return image.format() == format ? image : image.convertToFormat(format);
+}
+
+QImage decode(const QByteArray &encoded, const QSize &scaledSize)
+{
+    QBuffer buffer;
+    buffer.setData(encoded);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    if (scaledSize.isValid()) {
+        reader.setScaledSize(scaledSize);
+    }
+    return reader.read();
+}
+
+} // namespace
+
+ImageMipChain::ImageMipChain(const QByteArray &encoded, const QByteArray &contentHash, const QSize &sourceSize)
+    : m_encoded(encoded)
+    , m_contentHash(contentHash)
+    , m_sourceSize(sourceSize)
+{
+}
+
+QByteArray ImageMipChain::hashOf(const QByteArray &encoded)
+{
+    return QCryptographicHash::hash(encoded, QCryptographicHash::Sha256);
+}
+
+std::shared_ptr<const ImageMipChain> ImageMipChain::fromEncoded(const QByteArray &encoded)
+{
+    if (encoded.isEmpty()) {
+        return nullptr;
+    }
+    const QByteArray contentHash = hashOf(encoded);
+    {
+        SharedCache &cache = sharedCache();
+        QMutexLocker locker(&cache.mutex);
+        const auto it = cache.sourceSizes.constFind(contentHash);
+        if (it != cache.sourceSizes.constEnd()) {
+            return std::shared_ptr<const ImageMipChain>(new ImageMipChain(encoded, contentHash, it.value()));
+        }
+    }
+    const QImage image = decode(encoded, QSize());
+    if (image.isNull()) {
+        return nullptr;
+    }
+    return create(image, encoded, contentHash);
+}
+
+std::shared_ptr<const ImageMipChain> ImageMipChain::fromImage(const QImage &image, const QByteArray &encoded)
+{
+    if (image.isNull()) {
+        return nullptr;
+    }
+    return create(image, encoded, hashOf(encoded));
+}
+
+std::shared_ptr<const ImageMipChain> ImageMipChain::create(const QImage &image,
+                                                           const QByteArray &encoded,
+                                                           const QByteArray &contentHash)
+{
+    std::shared_ptr<const ImageMipChain> chain(new ImageMipChain(encoded, contentHash, image.size()));
+
+    // 刚解码的原图先放进缓存，首次绘制不必重复解码；之后由预算决定是否保留
+    const QImage source = normalized(image);
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.sourceSizes.insert(contentHash, image.size());
+    cache.levels.insert(LevelKey(contentHash, 0), new QImage(source), costOf(source));
+    return chain;
+}
+
+void ImageMipChain::clearCache()
+{
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.levels.clear();
+}
+
+int ImageMipChain::levelCount() const
+{
+    int count = 1;
+    for (int extent = std::max(m_sourceSize.width(), m_sourceSize.height()); extent > 1; extent = (extent + 1) / 2) {
+        ++count;
+    }
+    return count;
+}
+
+QSize ImageMipChain::levelSize(int level) const
+{
+    const int divisor = 1 << level;
+    return QSize(std::max(1, (m_sourceSize.width() + divisor - 1) / divisor),
+                 std::max(1, (m_sourceSize.height() + divisor - 1) / divisor));
+}
+
+QImage ImageMipChain::imageFor(const QSize &targetSize) const
+{
+    int chosen = 0;
+    const int count = levelCount();
+    for (int i = 1; i < count; ++i) {
+        const QSize size = levelSize(i);
+        if (size.width() < targetSize.width() || size.height() < targetSize.height()) {
+            break;
+        }
+        chosen = i;
+    }
+    return level(chosen);
+}
+
+QImage ImageMipChain::level(int level) const
+{
+    SharedCache &cache = sharedCache();
+
+    // 命中本级直接返回；否则找最近的已缓存的更大一级作为缩小的起点
+    QImage base;
+    int baseLevel = -1;
+    {
+        QMutexLocker locker(&cache.mutex);
+        for (int i = level; i >= 0; --i) {
+            if (const QImage *cached = cache.levels.object(LevelKey(m_contentHash, i))) {
+                base = *cached;
+                baseLevel = i;
+                break;
+            }
+        }
+    }
+    if (baseLevel == level) {
+        return base;
+    }
+
+    // 缩放在锁外进行；两个线程同时生成同一级时只是重复一次工作
+    QImage result;
+    if (baseLevel >= 0) {
+        result = base;
+        for (int i = baseLevel + 1; i <= level; ++i) {
+            result = result.scaled(levelSize(i), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    } else {
+        result = decode(m_encoded, level > 0 ? levelSize(level) : QSize());
+        if (result.size() != levelSize(level) && !result.isNull()) {
+            result = result.scaled(levelSize(level), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+    if (result.isNull()) {
+        return result;
+    }
+    result = normalized(result);
+
+    QMutexLocker locker(&cache.mutex);
+    cache.levels.insert(LevelKey(m_contentHash, level), new QImage(result), costOf(result));
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef IMAGEMIPCHAIN_H
+#define IMAGEMIPCHAIN_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+
+#include <memory>
+
+/**
+ * @brief 图像的多级缩放链
+ *
+ * 第 k 级为原图的 1/2^k（向上取整），绘制时取不小于目标设备尺寸的最小一级，
+ * 再由 QPainter 做最后一次不到两倍的缩放。各级（包括原图解码）都放在进程级、
+ * 按内存预算淘汰的缓存中，以编码数据的 SHA-256 为键，内容相同的图像在整个进程内只解码一次；
+ * 图形项只保留编码数据。被淘汰的级别按需由相邻的更大一级缩小，
+ * 或直接按目标尺寸解码（JPEG 可在解码阶段缩小）。只使用 QImage，可在打印、导出线程中调用。
+ */
+class ImageMipChain
+{
+public:
+    // 解码一次以校验数据并登记原图尺寸；无法解码时返回 nullptr
+    static std::shared_ptr<const ImageMipChain> fromEncoded(const QByteArray &encoded);
+    // 已有解码结果（粘贴、裁剪）：encoded 为其编码数据，image 直接作为第 0 级放入缓存
+    static std::shared_ptr<const ImageMipChain> fromImage(const QImage &image, const QByteArray &encoded);
+
+    // 编码数据的内容哈希（SHA-256，原始 32 字节）
+    static QByteArray hashOf(const QByteArray &encoded);
+
+    ImageMipChain(const ImageMipChain &) = delete;
+    ImageMipChain &operator=(const ImageMipChain &) = delete;
+
+    QSize sourceSize() const { return m_sourceSize; }
+    const QByteArray &encoded() const { return m_encoded; }
+    const QByteArray &contentHash() const { return m_contentHash; }
+
+    // 以 targetSize 设备像素绘制时使用的图像
+    QImage imageFor(const QSize &targetSize) const;
+    // 原图（第 0 级）
+    QImage sourceImage() const { return level(0); }
+
+    // 释放所有缓存的级别（测试内存占用或内存紧张时使用）
+    static void clearCache();
+
+private:
+    ImageMipChain(const QByteArray &encoded, const QByteArray &contentHash, const QSize &sourceSize);
+    static std::shared_ptr<const ImageMipChain> create(const QImage &image,
+                                                       const QByteArray &encoded,
+                                                       const QByteArray &contentHash);
+
+    int levelCount() const;
+    QSize levelSize(int level) const;
+    QImage level(int level) const;
+
+    QByteArray m_encoded;
+    QByteArray m_contentHash;
+    QSize m_sourceSize;
+};
+
+#endif // IMAGEMIPCHAIN_H
@@ -0,0 +1,32 @@
+#ifndef LABELITEMTYPES_H
+#define LABELITEMTYPES_H
+
+#include <QGraphicsItem>
+
+/**
+ * @brief 标签图形项的类型标识
+ *
+ * 各图形项类定义 enum { Type = ... } 并由 type() 返回，按 item->type() 即可区分
+ * 图形项，不必逐个 dynamic_cast。ArrowItem 虽继承 LineItem，也有自己的标识。
+ * 新增图形项在末尾追加，已有的值不要改动。
+ */
+namespace LabelItemType {
+
+enum : int {
+    Text = QGraphicsItem::UserType + 1,
+    Barcode,
+    QRCode,
+    Image,
+    Line,
+    Arrow,
+    Rectangle,
+    Circle,
+    Star,
+    Polygon,
+    Table,
+    SelectionFrame
+};
+
+} // namespace LabelItemType
+
+#endif // LABELITEMTYPES_H
@@ -238,7 +238,17 @@ void LabelScene::clearScene()
         delete m_selectionFrame;
         m_selectionFrame = nullptr;
     }
-    clear();
+    // 标签背景由主窗口持有并随场景保留，不随内容一起删除
+    QList<QGraphicsItem*> topLevelItems;
+    for (QGraphicsItem *item : items()) {
+        if (!item->parentItem() && item->data(0).toString() != "labelBackground") {
+            topLevelItems.append(item);
+        }
+    }
+    for (QGraphicsItem *item : topLevelItems) {
+        removeItem(item);
+        delete item;
+    }
     // 清理拖动/记录状态，防止残留引用
     m_itemStartPositions.clear();
     m_itemStartRects.clear();
@@ -261,6 +271,23 @@ void LabelScene::addLabelItem(QGraphicsItem *item)
     emit sceneModified();
 }
 
+void LabelScene::addLabelItems(const QList<QGraphicsItem*> &items)
+{
+    if (items.isEmpty()) return;
+
+    // 逐项插入 BSP 索引的代价随元素数增长，全部加入后一次性重建更快
+    const ItemIndexMethod indexMethod = itemIndexMethod();
+    setItemIndexMethod(NoIndex);
+    for (QGraphicsItem *item : items) {
+        if (item) {
+            addItem(item);
+            emit itemAdded(item);
+        }
+    }
+    setItemIndexMethod(indexMethod);
+    emit sceneModified();
+}
+
 // 删除选中项
 void LabelScene::removeSelectedItems()
 {
@@ -79,6 +79,8 @@ public:
     public slots:
         // 图形项操作
         void addLabelItem(QGraphicsItem *item);
+    // 批量加入（打开文档）：期间暂停场景索引，结束后重建一次，只发出一次 sceneModified
+    void addLabelItems(const QList<QGraphicsItem*> &items);
     void removeSelectedItems();
     void bringToFront(QGraphicsItem *item);
     void sendToBack(QGraphicsItem *item);
@@ -0,0 +1,500 @@
+#include "linearsymbolencoder.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace {
+
+// ---- 码表 ----
+
+// Code128 符号字符 0..106，每个 6 个元素宽度，以条开始；终止符另加 2 模块宽的终止条
+constexpr std::array<std::array<quint8, 6>, 107> kCode128Patterns = {{
+    {2, 1, 2, 2, 2, 2}, {2, 2, 2, 1, 2, 2}, {2, 2, 2, 2, 2, 1}, {1, 2, 1, 2, 2, 3}, {1, 2, 1, 3, 2, 2}, // 0
+    {1, 3, 1, 2, 2, 2}, {1, 2, 2, 2, 1, 3}, {1, 2, 2, 3, 1, 2}, {1, 3, 2, 2, 1, 2}, {2, 2, 1, 2, 1, 3}, // 5
+    {2, 2, 1, 3, 1, 2}, {2, 3, 1, 2, 1, 2}, {1, 1, 2, 2, 3, 2}, {1, 2, 2, 1, 3, 2}, {1, 2, 2, 2, 3, 1}, // 10
+    {1, 1, 3, 2, 2, 2}, {1, 2, 3, 1, 2, 2}, {1, 2, 3, 2, 2, 1}, {2, 2, 3, 2, 1, 1}, {2, 2, 1, 1, 3, 2}, // 15
+    {2, 2, 1, 2, 3, 1}, {2, 1, 3, 2, 1, 2}, {2, 2, 3, 1, 1, 2}, {3, 1, 2, 1, 3, 1}, {3, 1, 1, 2, 2, 2}, // 20
+    {3, 2, 1, 1, 2, 2}, {3, 2, 1, 2, 2, 1}, {3, 1, 2, 2, 1, 2}, {3, 2, 2, 1, 1, 2}, {3, 2, 2, 2, 1, 1}, // 25
+    {2, 1, 2, 1, 2, 3}, {2, 1, 2, 3, 2, 1}, {2, 3, 2, 1, 2, 1}, {1, 1, 1, 3, 2, 3}, {1, 3, 1, 1, 2, 3}, // 30
+    {1, 3, 1, 3, 2, 1}, {1, 1, 2, 3, 1, 3}, {1, 3, 2, 1, 1, 3}, {1, 3, 2, 3, 1, 1}, {2, 1, 1, 3, 1, 3}, // 35
+    {2, 3, 1, 1, 1, 3}, {2, 3, 1, 3, 1, 1}, {1, 1, 2, 1, 3, 3}, {1, 1, 2, 3, 3, 1}, {1, 3, 2, 1, 3, 1}, // 40
+    {1, 1, 3, 1, 2, 3}, {1, 1, 3, 3, 2, 1}, {1, 3, 3, 1, 2, 1}, {3, 1, 3, 1, 2, 1}, {2, 1, 1, 3, 3, 1}, // 45
+    {2, 3, 1, 1, 3, 1}, {2, 1, 3, 1, 1, 3}, {2, 1, 3, 3, 1, 1}, {2, 1, 3, 1, 3, 1}, {3, 1, 1, 1, 2, 3}, // 50
+    {3, 1, 1, 3, 2, 1}, {3, 3, 1, 1, 2, 1}, {3, 1, 2, 1, 1, 3}, {3, 1, 2, 3, 1, 1}, {3, 3, 2, 1, 1, 1}, // 55
+    {3, 1, 4, 1, 1, 1}, {2, 2, 1, 4, 1, 1}, {4, 3, 1, 1, 1, 1}, {1, 1, 1, 2, 2, 4}, {1, 1, 1, 4, 2, 2}, // 60
+    {1, 2, 1, 1, 2, 4}, {1, 2, 1, 4, 2, 1}, {1, 4, 1, 1, 2, 2}, {1, 4, 1, 2, 2, 1}, {1, 1, 2, 2, 1, 4}, // 65
+    {1, 1, 2, 4, 1, 2}, {1, 2, 2, 1, 1, 4}, {1, 2, 2, 4, 1, 1}, {1, 4, 2, 1, 1, 2}, {1, 4, 2, 2, 1, 1}, // 70
+    {2, 4, 1, 2, 1, 1}, {2, 2, 1, 1, 1, 4}, {4, 1, 3, 1, 1, 1}, {2, 4, 1, 1, 1, 2}, {1, 3, 4, 1, 1, 1}, // 75
+    {1, 1, 1, 2, 4, 2}, {1, 2, 1, 1, 4, 2}, {1, 2, 1, 2, 4, 1}, {1, 1, 4, 2, 1, 2}, {1, 2, 4, 1, 1, 2}, // 80
+    {1, 2, 4, 2, 1, 1}, {4, 1, 1, 2, 1, 2}, {4, 2, 1, 1, 1, 2}, {4, 2, 1, 2, 1, 1}, {2, 1, 2, 1, 4, 1}, // 85
+    {2, 1, 4, 1, 2, 1}, {4, 1, 2, 1, 2, 1}, {1, 1, 1, 1, 4, 3}, {1, 1, 1, 3, 4, 1}, {1, 3, 1, 1, 4, 1}, // 90
+    {1, 1, 4, 1, 1, 3}, {1, 1, 4, 3, 1, 1}, {4, 1, 1, 1, 1, 3}, {4, 1, 1, 3, 1, 1}, {1, 1, 3, 1, 4, 1}, // 95
+    {1, 1, 4, 1, 3, 1}, {3, 1, 1, 1, 4, 1}, {4, 1, 1, 1, 3, 1}, {2, 1, 1, 4, 1, 2}, {2, 1, 1, 2, 1, 4}, // 100
+    {2, 1, 1, 2, 3, 2}, {2, 3, 3, 1, 1, 1}, // 105
+}};
+
+constexpr int kCode128ShiftValue = 98;
+constexpr int kCode128Fnc1Value = 102;
+constexpr int kCode128StartValue = 103;   // + 子集（A=0, B=1, C=2）
+constexpr int kCode128StopValue = 106;
+constexpr int kCode128MaxLength = 80;     // 与 ZXing 相同的长度上限
+constexpr int kCode128DefaultMargin = 10;
+
+// 私有区字符代表功能字符，与 ZXing 的输入约定一致
+constexpr char16_t kEscapeFnc1 = 0x00f1;
+constexpr char16_t kEscapeFnc4 = 0x00f4;
+
+// EAN/UPC 左侧奇校验（L）与偶校验（G）数字图案，均以空开始
+constexpr std::array<std::array<quint8, 4>, 20> kLAndGPatterns = {{
+    {3, 2, 1, 1}, {2, 2, 2, 1}, {2, 1, 2, 2}, {1, 4, 1, 1}, {1, 1, 3, 2}, // L 0-4
+    {1, 2, 3, 1}, {1, 1, 1, 4}, {1, 3, 1, 2}, {1, 2, 1, 3}, {3, 1, 1, 2}, // L 5-9
+    {1, 1, 2, 3}, {1, 2, 2, 2}, {2, 2, 1, 2}, {1, 1, 4, 1}, {2, 3, 1, 1}, // G 0-4
+    {1, 3, 2, 1}, {4, 1, 1, 1}, {2, 1, 3, 1}, {3, 1, 2, 1}, {2, 1, 1, 3}, // G 5-9
+}};
+
+// EAN-13 首位数字决定左侧 6 位的 L/G 组合（1 为 G）
+constexpr std::array<quint8, 10> kEan13FirstDigitParities = {
+    0x00, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A
+};
+
+// UPC-E 数制（0/1）与校验位决定 6 位数字的 L/G 组合（1 为 G）
+constexpr std::array<quint8, 20> kUpceParities = {
+    0x38, 0x34, 0x32, 0x31, 0x2C, 0x26, 0x23, 0x2A, 0x29, 0x25,
+    0x07, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A
+};
+
+constexpr int kUpcEanDefaultMargin = 9;
+
+// ---- 模块序列 ----
+
+// 追加交替的条/空元素；startBar 指定第一个元素是否为条
+template <size_t N>
+void appendPattern(std::vector<quint8> *modules, const std::array<quint8, N> &pattern, bool startBar)
+{
+    quint8 bar = startBar ? 1 : 0;
+    for (quint8 width : pattern) {
+        modules->insert(modules->end(), width, bar);
+        bar ^= 1;
+    }
+}
+
+void appendGuard(std::vector<quint8> *modules, int count, bool startBar)
+{
+    quint8 bar = startBar ? 1 : 0;
+    for (int i = 0; i < count; ++i) {
+        modules->push_back(bar);
+        bar ^= 1;
+    }
+}
+
+// ---- Code128 ----
+
+enum Code128Set {
+    SetA = 0,
+    SetB = 1,
+    SetC = 2,
+    SetCount = 3
+};
+
+bool isDigit(char16_t c)
+{
+    return c >= u'0' && c <= u'9';
+}
+
+bool isFunction(char16_t c)
+{
+    return c >= kEscapeFnc1 && c <= kEscapeFnc4;
+}
+
+// 在子集 set 中从 data[i] 开始编码一个符号字符所消耗的输入字符数，不能编码时返回 0
+int code128Consumes(int set, QStringView data, int i)
+{
+    const char16_t c = data.at(i).unicode();
+    switch (set) {
+    case SetA:
+        return (c < 96 || isFunction(c)) ? 1 : 0;
+    case SetB:
+        return ((c >= 32 && c < 128) || isFunction(c)) ? 1 : 0;
+    default:
+        if (c == kEscapeFnc1) {
+            return 1;
+        }
+        return (isDigit(c) && i + 1 < data.size() && isDigit(data.at(i + 1).unicode())) ? 2 : 0;
+    }
+}
+
+int code128Value(int set, QStringView data, int i)
+{
+    const char16_t c = data.at(i).unicode();
+    if (isFunction(c)) {
+        switch (c - kEscapeFnc1) {
+        case 0: return kCode128Fnc1Value;
+        case 1: return 97;
+        case 2: return 96;
+        default: return set == SetA ? 101 : 100;   // FNC4 在 A/B 子集中的码值不同
+        }
+    }
+    switch (set) {
+    case SetA:
+        return c < 32 ? c + 64 : c - 32;
+    case SetB:
+        return c - 32;
+    default:
+        return (c - u'0') * 10 + (data.at(i + 1).unicode() - u'0');
+    }
+}
+
+// 切换到目标子集的码值：Code A = 101，Code B = 100，Code C = 99
+int code128SwitchValue(int target)
+{
+    return 101 - target;
+}
+
+enum class Code128Step : quint8 {
+    Encode,     // 在当前子集中编码
+    SwitchA,    // 切换子集后编码
+    SwitchB,
+    SwitchC,
+    Shift       // A/B 之间临时转换一个字符
+};
+
+// 动态规划求最少符号字符数：cost[i][s] 为从第 i 个字符起、当前子集为 s 时剩余部分的最少字符数
+bool encodeCode128(QStringView data, std::vector<quint8> *modules, QString *errorMessage)
+{
+    const int length = data.size();
+    if (length < 1 || length > kCode128MaxLength) {
+        *errorMessage = QStringLiteral("Contents length should be between 1 and 80 characters");
+        return false;
+    }
+    for (int i = 0; i < length; ++i) {
+        const char16_t c = data.at(i).unicode();
+        if (c > 127 && !isFunction(c)) {
+            *errorMessage = QStringLiteral("Bad character in input: ") + data.mid(i, 1).toString();
+            return false;
+        }
+    }
+
+    constexpr int kUnreachable = std::numeric_limits<int>::max() / 4;
+    std::array<std::array<int, SetCount>, kCode128MaxLength + 1> cost;
+    std::array<std::array<Code128Step, SetCount>, kCode128MaxLength> step;
+    cost[length].fill(0);
+
+    for (int i = length - 1; i >= 0; --i) {
+        for (int set = 0; set < SetCount; ++set) {
+            int best = kUnreachable;
+            Code128Step bestStep = Code128Step::Encode;
+
+            if (const int used = code128Consumes(set, data, i)) {
+                best = 1 + cost[i + used][set];
+            }
+            for (int target = 0; target < SetCount; ++target) {
+                if (target == set) {
+                    continue;
+                }
+                const int used = code128Consumes(target, data, i);
+                if (used && 2 + cost[i + used][target] < best) {
+                    best = 2 + cost[i + used][target];
+                    bestStep = static_cast<Code128Step>(static_cast<int>(Code128Step::SwitchA) + target);
+                }
+            }
+            if (set != SetC && code128Consumes(1 - set, data, i) && 2 + cost[i + 1][set] < best) {
+                best = 2 + cost[i + 1][set];
+                bestStep = Code128Step::Shift;
+            }
+
+            cost[i][set] = best;
+            step[i][set] = bestStep;
+        }
+    }
+
+    int set = SetB;
+    for (int candidate = 0; candidate < SetCount; ++candidate) {
+        if (code128Consumes(candidate, data, 0) && cost[0][candidate] < cost[0][set]) {
+            set = candidate;
+        }
+    }
+    if (cost[0][set] >= kUnreachable) {
+        *errorMessage = QStringLiteral("Bad character in input");
+        return false;
+    }
+
+    QVarLengthArray<int, 2 * kCode128MaxLength + 4> values;
+    values.append(kCode128StartValue + set);
+    for (int i = 0; i < length;) {
+        const Code128Step next = step[i][set];
+        if (next == Code128Step::Shift) {
+            values.append(kCode128ShiftValue);
+            values.append(code128Value(1 - set, data, i));
+            ++i;
+            continue;
+        }
+        if (next != Code128Step::Encode) {
+            set = static_cast<int>(next) - static_cast<int>(Code128Step::SwitchA);
+            values.append(code128SwitchValue(set));
+        }
+        values.append(code128Value(set, data, i));
+        i += code128Consumes(set, data, i);
+    }
+
+    int checksum = values.at(0);
+    for (int i = 1; i < values.size(); ++i) {
+        checksum += values.at(i) * i;
+    }
+    values.append(checksum % 103);
+    values.append(kCode128StopValue);
+
+    modules->reserve(values.size() * 11 + 2);
+    for (int value : values) {
+        appendPattern(modules, kCode128Patterns[value], true);
+    }
+    modules->insert(modules->end(), 2, 1);   // 终止条
+    return true;
+}
+
+// ---- EAN / UPC ----
+
+// GTIN 校验位：自右向左奇数位 ×3
+int gtinCheckDigit(const int *digits, int count)
+{
+    int sum = 0;
+    for (int i = count - 1; i >= 0; i -= 2) {
+        sum += digits[i];
+    }
+    sum *= 3;
+    for (int i = count - 2; i >= 0; i -= 2) {
+        sum += digits[i];
+    }
+    return (10 - (sum % 10)) % 10;
+}
+
+// 读取 N 或 N-1 位数字；N-1 位时补上校验位，N 位时核对校验位
+template <int N>
+bool readGtinDigits(QStringView data, std::array<int, N> *digits, QString *errorMessage)
+{
+    const int length = data.size();
+    if (length != N && length != N - 1) {
+        *errorMessage = QStringLiteral("Invalid input string length");
+        return false;
+    }
+    for (int i = 0; i < length; ++i) {
+        const char16_t c = data.at(i).unicode();
+        if (!isDigit(c)) {
+            *errorMessage = QStringLiteral("Contents must contain only digits: 0-9");
+            return false;
+        }
+        (*digits)[i] = c - u'0';
+    }
+    const int check = gtinCheckDigit(digits->data(), N - 1);
+    if (length == N - 1) {
+        (*digits)[N - 1] = check;
+    } else if ((*digits)[N - 1] != check) {
+        *errorMessage = QStringLiteral("Checksum error");
+        return false;
+    }
+    return true;
+}
+
+bool encodeEan13Digits(const std::array<int, 13> &digits, std::vector<quint8> *modules)
+{
+    const int parities = kEan13FirstDigitParities[digits[0]];
+    modules->reserve(95);
+    appendGuard(modules, 3, true);
+    for (int i = 1; i <= 6; ++i) {
+        const int digit = digits[i] + (((parities >> (6 - i)) & 1) ? 10 : 0);
+        appendPattern(modules, kLAndGPatterns[digit], false);
+    }
+    appendGuard(modules, 5, false);
+    for (int i = 7; i <= 12; ++i) {
+        appendPattern(modules, kLAndGPatterns[digits[i]], true);
+    }
+    appendGuard(modules, 3, true);
+    return true;
+}
+
+bool encodeEan13(QStringView data, std::vector<quint8> *modules, QString *errorMessage)
+{
+    std::array<int, 13> digits{};
+    return readGtinDigits<13>(data, &digits, errorMessage) && encodeEan13Digits(digits, modules);
+}
+
+// UPC-A 即首位为 0 的 EAN-13
+bool encodeUpcA(QStringView data, std::vector<quint8> *modules, QString *errorMessage)
+{
+    if (data.size() != 11 && data.size() != 12) {
+        *errorMessage = QStringLiteral("Requested contents should be 11 or 12 digits long");
+        return false;
+    }
+    std::array<int, 13> digits{};
+    std::array<int, 12> upc{};
+    if (!readGtinDigits<12>(data, &upc, errorMessage)) {
+        return false;
+    }
+    std::copy(upc.begin(), upc.end(), digits.begin() + 1);
+    return encodeEan13Digits(digits, modules);
+}
+
+bool encodeEan8(QStringView data, std::vector<quint8> *modules, QString *errorMessage)
+{
+    std::array<int, 8> digits{};
+    if (!readGtinDigits<8>(data, &digits, errorMessage)) {
+        return false;
+    }
+    modules->reserve(67);
+    appendGuard(modules, 3, true);
+    for (int i = 0; i <= 3; ++i) {
+        appendPattern(modules, kLAndGPatterns[digits[i]], false);
+    }
+    appendGuard(modules, 5, false);
+    for (int i = 4; i <= 7; ++i) {
+        appendPattern(modules, kLAndGPatterns[digits[i]], true);
+    }
+    appendGuard(modules, 3, true);
+    return true;
+}
+
+// UPC-E 的校验位按展开后的 11 位 UPC-A 计算
+bool encodeUpcE(QStringView data, std::vector<quint8> *modules, QString *errorMessage)
+{
+    const int length = data.size();
+    if (length != 8 && length != 7) {
+        *errorMessage = QStringLiteral("Invalid input string length");
+        return false;
+    }
+    std::array<int, 8> digits{};
+    for (int i = 0; i < length; ++i) {
+        const char16_t c = data.at(i).unicode();
+        if (!isDigit(c)) {
+            *errorMessage = QStringLiteral("Contents must contain only digits: 0-9");
+            return false;
+        }
+        digits[i] = c - u'0';
+    }
+
+    std::array<int, 11> upcA{};
+    const int last = digits[6];
+    switch (last) {
+    case 0:
+    case 1:
+    case 2:
+        upcA = {digits[0], digits[1], digits[2], last, 0, 0, 0, 0, digits[3], digits[4], digits[5]};
+        break;
+    case 3:
+        upcA = {digits[0], digits[1], digits[2], digits[3], 0, 0, 0, 0, 0, digits[4], digits[5]};
+        break;
+    case 4:
+        upcA = {digits[0], digits[1], digits[2], digits[3], digits[4], 0, 0, 0, 0, 0, digits[5]};
+        break;
+    default:
+        upcA = {digits[0], digits[1], digits[2], digits[3], digits[4], digits[5], 0, 0, 0, 0, last};
+        break;
+    }
+    const int check = gtinCheckDigit(upcA.data(), 11);
+    if (length == 7) {
+        digits[7] = check;
+    } else if (digits[7] != check) {
+        *errorMessage = QStringLiteral("Checksum error");
+        return false;
+    }
+    if (digits[0] != 0 && digits[0] != 1) {
+        *errorMessage = QStringLiteral("Number system must be 0 or 1");
+        return false;
+    }
+
+    const int parities = kUpceParities[digits[0] * 10 + digits[7]];
+    modules->reserve(51);
+    appendGuard(modules, 3, true);
+    for (int i = 1; i <= 6; ++i) {
+        const int digit = digits[i] + (((parities >> (6 - i)) & 1) ? 10 : 0);
+        appendPattern(modules, kLAndGPatterns[digit], false);
+    }
+    appendGuard(modules, 6, false);
+    return true;
+}
+
+} // namespace
+
+bool LinearSymbolEncoder::supports(ZXing::BarcodeFormat format)
+{
+    switch (format) {
+    case ZXing::BarcodeFormat::Code128:
+    case ZXing::BarcodeFormat::EAN8:
+    case ZXing::BarcodeFormat::EAN13:
+    case ZXing::BarcodeFormat::UPCA:
+    case ZXing::BarcodeFormat::UPCE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool LinearSymbolEncoder::encodeModules(ZXing::BarcodeFormat format,
+                                        QStringView data,
+                                        std::vector<quint8> *modules,
+                                        int *defaultMargin,
+                                        QString *errorMessage)
+{
+    modules->clear();
+    QString error;
+    bool ok = false;
+    switch (format) {
+    case ZXing::BarcodeFormat::Code128:
+        *defaultMargin = kCode128DefaultMargin;
+        ok = encodeCode128(data, modules, &error);
+        break;
+    case ZXing::BarcodeFormat::EAN8:
+        *defaultMargin = kUpcEanDefaultMargin;
+        ok = encodeEan8(data, modules, &error);
+        break;
+    case ZXing::BarcodeFormat::EAN13:
+        *defaultMargin = kUpcEanDefaultMargin;
+        ok = encodeEan13(data, modules, &error);
+        break;
+    case ZXing::BarcodeFormat::UPCA:
+        *defaultMargin = kUpcEanDefaultMargin;
+        ok = encodeUpcA(data, modules, &error);
+        break;
+    case ZXing::BarcodeFormat::UPCE:
+        *defaultMargin = kUpcEanDefaultMargin;
+        ok = encodeUpcE(data, modules, &error);
+        break;
+    default:
+        error = QStringLiteral("Unsupported format");
+        break;
+    }
+    if (!ok) {
+        modules->clear();
+        if (errorMessage) {
+            *errorMessage = error;
+        }
+    }
+    return ok;
+}
+
+ZXing::BitMatrix LinearSymbolEncoder::render(const std::vector<quint8> &modules, int width, int margin)
+{
+    const int inputWidth = static_cast<int>(modules.size());
+    const int fullWidth = inputWidth + std::max(0, margin);
+    const int outputWidth = std::max(width, fullWidth);
+    if (fullWidth <= 0) {
+        return ZXing::BitMatrix();
+    }
+    const int multiple = outputWidth / fullWidth;
+    const int leftPadding = (outputWidth - inputWidth * multiple) / 2;
+
+    ZXing::BitMatrix result(outputWidth, 1);
+    for (int x = 0; x < inputWidth;) {
+        if (!modules[x]) {
+            ++x;
+            continue;
+        }
+        const int start = x;
+        while (x < inputWidth && modules[x]) {
+            ++x;
+        }
+        result.setRegion(leftPadding + start * multiple, 0, (x - start) * multiple, 1);
+    }
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef LINEARSYMBOLENCODER_H
+#define LINEARSYMBOLENCODER_H
+
+#include <QString>
+#include <QStringView>
+
+#include "BarcodeFormat.h"
+#include "BitMatrix.h"
+
+#include <vector>
+
+/**
+ * @brief 常用一维码的专用编码器（Code128、EAN-8、EAN-13、UPC-A、UPC-E）
+ *
+ * 直接从 UTF-16 数据查表生成模块序列，不经过 ZXing 的通用分派、UTF-8/宽字符转换与整幅矩阵分配。
+ * 输出的单行矩阵与 ZXing 一维写入器的放大、留白规则一致；Code128 按最少符号字符数选择 A/B/C 子集。
+ */
+class LinearSymbolEncoder
+{
+public:
+    static bool supports(ZXing::BarcodeFormat format);
+
+    // 把 data 编码为模块序列（非 0 为条），写入 modules 并复用其容量；
+    // defaultMargin 返回该码制默认的两侧静区总宽（模块数）。失败时返回 false 并写入 errorMessage。
+    static bool encodeModules(ZXing::BarcodeFormat format,
+                              QStringView data,
+                              std::vector<quint8> *modules,
+                              int *defaultMargin,
+                              QString *errorMessage);
+
+    // 按 ZXing 一维写入器的规则把模块序列按整数倍放大到 width 宽，居中生成单行矩阵
+    static ZXing::BitMatrix render(const std::vector<quint8> &modules, int width, int margin);
+};
+
+#endif // LINEARSYMBOLENCODER_H
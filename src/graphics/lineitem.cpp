@@ -66,15 +66,20 @@ QRectF LineItem::boundingRect() const
     return rect.adjusted(-extra, -extra, extra, extra);
 }
 
-void LineItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void LineItem::paintContent(QPainter *painter) const
 {
-    Q_UNUSED(option)
-    Q_UNUSED(widget)
-
     // 绘制线条
     painter->setPen(m_pen);
 
     painter->drawLine(m_startPoint, m_endPoint);
+}
+
+void LineItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    paintContent(painter);
 
     // 如果选中，绘制调整手柄
     if (isSelected()) {
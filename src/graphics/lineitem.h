@@ -28,11 +28,17 @@ public:
     explicit LineItem(const QPointF &startPoint, const QPointF &endPoint, QGraphicsItem *parent = nullptr);
     virtual ~LineItem() = default;
 
+    enum { Type = LabelItemType::Line };
+    int type() const override { return Type; }
+
     // 重写QGraphicsItem的纯虚函数
     QRectF boundingRect() const override;
     QPainterPath shape() const override;  // 精确命中测试：细描边 + 手柄
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制线条内容（不含手柄与对齐线），供输出渲染使用
+    virtual void paintContent(QPainter *painter) const;
+
     // 线条属性
     void setPen(const QPen &pen);
     QPen pen() const { return m_pen; }
@@ -57,11 +57,8 @@ void PolygonItem::updateLastPoint(const QPointF &p)
 	}
 }
 
-void PolygonItem::paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void PolygonItem::paintShape(QPainter *painter) const
 {
-	Q_UNUSED(option)
-	Q_UNUSED(widget)
-
 	painter->setPen(m_borderEnabled ? m_pen : Qt::NoPen);
 	painter->setBrush(m_fillEnabled ? m_brush : Qt::NoBrush);
 
@@ -73,6 +70,11 @@ void PolygonItem::paintShape(QPainter *painter, const QStyleOptionGraphicsItem *
 			painter->drawPolyline(poly);
 		}
 	}
+}
+
+void PolygonItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	AbstractShapeItem::paint(painter, option, widget);
 
 	// 顶点编辑可视化：选中且启用时绘制锚点
 	if (isSelected() && m_vertexEditing && !m_points.isEmpty()) {
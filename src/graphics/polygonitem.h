@@ -12,6 +12,9 @@ public:
 	explicit PolygonItem(const QSizeF &size, QGraphicsItem *parent = nullptr);
 	virtual ~PolygonItem() = default;
 
+	enum { Type = LabelItemType::Polygon };
+	int type() const override { return Type; }
+
 	// 设置/获取点集（局部坐标）
 	void setPoints(const QVector<QPointF>& pts);
 	QVector<QPointF> points() const { return m_points; }
@@ -44,7 +47,8 @@ public:
 
 
 protected:
-	void paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+	void paintShape(QPainter *painter) const override;
+	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 	void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
 	void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
 	void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
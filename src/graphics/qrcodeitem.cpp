@@ -7,6 +7,7 @@
 #include "lineitem.h"
 #include "rectangleitem.h"
 #include "circleitem.h"
+#include "symbolblitter.h"
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QPainter>
@@ -19,6 +20,8 @@ QString QRCodeItem::s_copiedCodeType = "QR";
 QSizeF QRCodeItem::s_copiedSize = QSizeF(200, 200);
 QColor QRCodeItem::s_copiedForegroundColor = Qt::black;
 QColor QRCodeItem::s_copiedBackgroundColor = Qt::white;
+int QRCodeItem::s_copiedQrVersion = 0;
+int QRCodeItem::s_copiedQrMask = -1;
 
 QRCodeItem::QRCodeItem(const QString &text, QGraphicsItem *parent)
     : QGraphicsItem(parent)
@@ -48,236 +51,170 @@ QRectF QRCodeItem::boundingRect() const
                   m_size.height() + 2 * padding);
 }
 
-void QRCodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+SymbolMatrixKey QRCodeItem::symbolMatrixKey(const QString &data) const
 {
-    Q_UNUSED(widget);
+    SymbolMatrixKey key;
+    if (data.isEmpty()) {
+        return key;
+    }
+
+    key.data = data;
+    if (m_codeType == "QR") {
+        // 使用原有的QR码生成方式
+        key.encoder = SymbolMatrixKey::Encoder::QrCodeGen;
+        key.eccLevel = static_cast<int>(qrcodegen::QrCode::Ecc::MEDIUM);
+        key.qrVersion = m_qrVersion;
+        key.qrMask = m_qrMask;
+    } else {
+        // 使用ZXing库生成其他类型的二维码，统一使用最小边距
+        key.encoder = SymbolMatrixKey::Encoder::ZXing;
+        key.margin = 1;
+        if (m_codeType == "PDF417") {
+            key.format = static_cast<int>(ZXing::BarcodeFormat::PDF417);
+            key.eccLevel = 2; // 中等错误纠正级别
+
+            // PDF417让库自动决定最佳列数和行数
+            // 我们只提供一个参考尺寸，让ZXing优化
+            const int referenceSize = qMax(50, qMin(300, static_cast<int>(qMax(m_size.width(), m_size.height()))));
+            key.width = referenceSize;
+            key.height = referenceSize / 3;
+        } else {
+            if (m_codeType == "DataMatrix") {
+                key.format = static_cast<int>(ZXing::BarcodeFormat::DataMatrix);
+            } else if (m_codeType == "Aztec") {
+                key.format = static_cast<int>(ZXing::BarcodeFormat::Aztec);
+            } else {
+                // 默认使用QR码
+                key.format = static_cast<int>(ZXing::BarcodeFormat::QRCode);
+            }
 
+            // 使用正方形逻辑
+            const int targetSize = qMin(static_cast<int>(m_size.width()), static_cast<int>(m_size.height()));
+            key.width = targetSize;
+            key.height = targetSize;
+        }
+    }
+    return key;
+}
+
+void QRCodeItem::paintContent(QPainter *painter) const
+{
     // 绘制背景
     painter->fillRect(QRectF(0, 0, m_size.width(), m_size.height()), m_backgroundColor);
 
-    if (!m_text.isEmpty()) {
-        if (m_codeType == "QR") {
-            // 使用原有的QR码生成方式
-            const qrcodegen::QrCode qr = qrcodegen::QrCode::encodeText(m_text.toUtf8().constData(), qrcodegen::QrCode::Ecc::MEDIUM);
-            const int qrSize = qr.getSize();
+    if (m_text.isEmpty()) {
+        return;
+    }
 
-            // 计算缩放比例，确保QR码完全适配到边框内
-            qreal scaleX = m_size.width() / qrSize;
-            qreal scaleY = m_size.height() / qrSize;
-            qreal scale = qMin(scaleX, scaleY);
-            
-            // 计算实际绘制尺寸
-            qreal drawSize = qrSize * scale;
-            
-            // 计算居中偏移
-            qreal offsetX = (m_size.width() - drawSize) / 2;
-            qreal offsetY = (m_size.height() - drawSize) / 2;
-
-            // 绘制二维码
-            painter->setPen(Qt::NoPen);
-            painter->setBrush(m_foregroundColor);
-
-            for (int y = 0; y < qrSize; y++) {
-                for (int x = 0; x < qrSize; x++) {
-                    if (qr.getModule(x, y)) {
-                        painter->drawRect(QRectF(offsetX + x * scale, offsetY + y * scale, scale, scale));
-                    }
-                }
-            }
-        } else {
-            // 使用ZXing库生成其他类型的二维码
-            try {
-                ZXing::BarcodeFormat format;
-                
-                if (m_codeType == "PDF417") {
-                    format = ZXing::BarcodeFormat::PDF417;
-                    ZXing::MultiFormatWriter writer(format);
-                    
-                    // PDF417特殊处理：设置适当的参数
-                    writer.setMargin(1);  // 最小边距
-                    writer.setEccLevel(2); // 中等错误纠正级别
-                    
-                    // PDF417让库自动决定最佳列数和行数
-                    // 我们只提供一个参考尺寸，让ZXing优化
-                    int referenceSize = qMax(50, qMin(300, static_cast<int>(qMax(m_size.width(), m_size.height()))));
-                    
-                    std::string utf8Data = m_text.toUtf8().toStdString();
-                    ZXing::BitMatrix bitMatrix = writer.encode(utf8Data, referenceSize, referenceSize / 3);
-                    
-                    const int matrixWidth = bitMatrix.width();
-                    const int matrixHeight = bitMatrix.height();
-                    
-                    if (matrixWidth > 0 && matrixHeight > 0) {
-                        painter->setPen(Qt::NoPen);
-                        painter->setBrush(m_foregroundColor);
-                        
-                        // PDF417特殊缩放逻辑：优先保持条码的宽高比
-                        qreal scaleX = m_size.width() / matrixWidth;
-                        qreal scaleY = m_size.height() / matrixHeight;
-                        
-                        // 对于PDF417，我们允许不同的X和Y缩放，但要确保条码清晰可读
-                        qreal minScale = qMin(scaleX, scaleY);
-                        
-                        // 确保最小模块尺寸至少是1像素
-                        if (minScale < 1.0) {
-                            minScale = 1.0;
-                        }
-                        
-                        // 对于PDF417，我们可以使用稍微不同的X和Y比例
-                        // 但要确保不会造成条码失真
-                        qreal actualScaleX = scaleX;
-                        qreal actualScaleY = scaleY;
-                        
-                        // 如果某一个方向的缩放过小，使用最小缩放
-                        if (actualScaleX < 1.0) actualScaleX = minScale;
-                        if (actualScaleY < 1.0) actualScaleY = minScale;
-                        
-                        // 计算实际绘制尺寸
-                        qreal drawWidth = matrixWidth * actualScaleX;
-                        qreal drawHeight = matrixHeight * actualScaleY;
-                        
-                        // 确保不超出边界
-                        if (drawWidth > m_size.width()) {
-                            actualScaleX = m_size.width() / matrixWidth;
-                            drawWidth = m_size.width();
-                        }
-                        if (drawHeight > m_size.height()) {
-                            actualScaleY = m_size.height() / matrixHeight;
-                            drawHeight = m_size.height();
-                        }
-                        
-                        // 计算居中偏移
-                        qreal offsetX = (m_size.width() - drawWidth) / 2;
-                        qreal offsetY = (m_size.height() - drawHeight) / 2;
-                        
-                        // 绘制PDF417
-                        for (int y = 0; y < matrixHeight; ++y) {
-                            for (int x = 0; x < matrixWidth; ++x) {
-                                if (bitMatrix.get(x, y)) {
-                                    painter->drawRect(QRectF(
-                                        offsetX + x * actualScaleX, 
-                                        offsetY + y * actualScaleY, 
-                                        actualScaleX, 
-                                        actualScaleY
-                                    ));
-                                }
-                            }
-                        }
-                    } else {
-                        painter->setPen(Qt::red);
-                        painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()), 
-                                        Qt::AlignCenter, "PDF417: 数据为空");
-                    }
-                    
-                } else if (m_codeType == "DataMatrix") {
-                    format = ZXing::BarcodeFormat::DataMatrix;
-                    ZXing::MultiFormatWriter writer(format);
-                    writer.setMargin(1);
-                    
-                    // DataMatrix使用正方形逻辑
-                    int targetSize = qMin(static_cast<int>(m_size.width()), static_cast<int>(m_size.height()));
-                    std::string utf8Data = m_text.toUtf8().toStdString();
-                    ZXing::BitMatrix bitMatrix = writer.encode(utf8Data, targetSize, targetSize);
-                    
-                    const int matrixWidth = bitMatrix.width();
-                    const int matrixHeight = bitMatrix.height();
-                    
-                    if (matrixWidth > 0 && matrixHeight > 0) {
-                        painter->setPen(Qt::NoPen);
-                        painter->setBrush(m_foregroundColor);
-                        
-                        qreal scale = qMin(m_size.width() / matrixWidth, m_size.height() / matrixHeight);
-                        if (scale < 1.0) scale = 1.0;
-                        
-                        qreal drawWidth = matrixWidth * scale;
-                        qreal drawHeight = matrixHeight * scale;
-                        qreal offsetX = (m_size.width() - drawWidth) / 2;
-                        qreal offsetY = (m_size.height() - drawHeight) / 2;
-                        
-                        for (int y = 0; y < matrixHeight; ++y) {
-                            for (int x = 0; x < matrixWidth; ++x) {
-                                if (bitMatrix.get(x, y)) {
-                                    painter->drawRect(QRectF(offsetX + x * scale, offsetY + y * scale, scale, scale));
-                                }
-                            }
-                        }
-                    }
-                    
-                } else if (m_codeType == "Aztec") {
-                    format = ZXing::BarcodeFormat::Aztec;
-                    ZXing::MultiFormatWriter writer(format);
-                    writer.setMargin(1);
-                    
-                    // Aztec使用正方形逻辑
-                    int targetSize = qMin(static_cast<int>(m_size.width()), static_cast<int>(m_size.height()));
-                    std::string utf8Data = m_text.toUtf8().toStdString();
-                    ZXing::BitMatrix bitMatrix = writer.encode(utf8Data, targetSize, targetSize);
-                    
-                    const int matrixWidth = bitMatrix.width();
-                    const int matrixHeight = bitMatrix.height();
-                    
-                    if (matrixWidth > 0 && matrixHeight > 0) {
-                        painter->setPen(Qt::NoPen);
-                        painter->setBrush(m_foregroundColor);
-                        
-                        qreal scale = qMin(m_size.width() / matrixWidth, m_size.height() / matrixHeight);
-                        if (scale < 1.0) scale = 1.0;
-                        
-                        qreal drawWidth = matrixWidth * scale;
-                        qreal drawHeight = matrixHeight * scale;
-                        qreal offsetX = (m_size.width() - drawWidth) / 2;
-                        qreal offsetY = (m_size.height() - drawHeight) / 2;
-                        
-                        for (int y = 0; y < matrixHeight; ++y) {
-                            for (int x = 0; x < matrixWidth; ++x) {
-                                if (bitMatrix.get(x, y)) {
-                                    painter->drawRect(QRectF(offsetX + x * scale, offsetY + y * scale, scale, scale));
-                                }
-                            }
-                        }
-                    }
-                    
-                } else {
-                    // 默认使用QR码
-                    format = ZXing::BarcodeFormat::QRCode;
-                    ZXing::MultiFormatWriter writer(format);
-                    writer.setMargin(1);
-                    
-                    int targetSize = qMin(static_cast<int>(m_size.width()), static_cast<int>(m_size.height()));
-                    std::string utf8Data = m_text.toUtf8().toStdString();
-                    ZXing::BitMatrix bitMatrix = writer.encode(utf8Data, targetSize, targetSize);
-                    
-                    const int matrixWidth = bitMatrix.width();
-                    const int matrixHeight = bitMatrix.height();
-                    
-                    if (matrixWidth > 0 && matrixHeight > 0) {
-                        painter->setPen(Qt::NoPen);
-                        painter->setBrush(m_foregroundColor);
-                        
-                        qreal scale = qMin(m_size.width() / matrixWidth, m_size.height() / matrixHeight);
-                        if (scale < 1.0) scale = 1.0;
-                        
-                        qreal drawWidth = matrixWidth * scale;
-                        qreal drawHeight = matrixHeight * scale;
-                        qreal offsetX = (m_size.width() - drawWidth) / 2;
-                        qreal offsetY = (m_size.height() - drawHeight) / 2;
-                        
-                        for (int y = 0; y < matrixHeight; ++y) {
-                            for (int x = 0; x < matrixWidth; ++x) {
-                                if (bitMatrix.get(x, y)) {
-                                    painter->drawRect(QRectF(offsetX + x * scale, offsetY + y * scale, scale, scale));
-                                }
-                            }
-                        }
-                    }
-                }
-            } catch (const std::exception &e) {
-                qDebug() << "QRCodeItem: Error generating code for data [" << m_text << "]: " << e.what();
-                painter->setPen(Qt::red);
-                painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()), Qt::AlignCenter | Qt::TextWordWrap, QString("Error: %1").arg(e.what()));
-            }
+    // 模块矩阵按（数据、码制、纠错等级、尺寸提示）缓存，悬停、滚动、缩放与预览重绘不再重新编码
+    const std::shared_ptr<const SymbolMatrix> symbol = m_symbolMatrix.matrix(symbolMatrixKey(m_text));
+    if (!symbol) {
+        return;
+    }
+    if (!symbol->error.isEmpty()) {
+        qDebug() << "QRCodeItem: Error generating code for data [" << m_text << "]: " << symbol->error;
+        painter->setPen(Qt::red);
+        painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()), Qt::AlignCenter | Qt::TextWordWrap, QString("Error: %1").arg(symbol->error));
+        return;
+    }
+
+    const ZXing::BitMatrix &bitMatrix = symbol->bits;
+    const int matrixWidth = bitMatrix.width();
+    const int matrixHeight = bitMatrix.height();
+    if (matrixWidth <= 0 || matrixHeight <= 0) {
+        if (m_codeType == "PDF417") {
+            painter->setPen(Qt::red);
+            painter->drawText(QRectF(0, 0, m_size.width(), m_size.height()),
+                            Qt::AlignCenter, "PDF417: 数据为空");
+        }
+        return;
+    }
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(m_foregroundColor);
+
+    if (m_codeType == "QR") {
+        // 计算缩放比例，确保QR码完全适配到边框内
+        qreal scaleX = m_size.width() / matrixWidth;
+        qreal scaleY = m_size.height() / matrixHeight;
+        qreal scale = qMin(scaleX, scaleY);
+
+        // 计算居中偏移
+        qreal offsetX = (m_size.width() - matrixWidth * scale) / 2;
+        qreal offsetY = (m_size.height() - matrixHeight * scale) / 2;
+
+        const QRectF symbolRect(offsetX, offsetY, matrixWidth * scale, matrixHeight * scale);
+        if (!SymbolBlitter::blit(painter, symbol->runs, matrixWidth, matrixHeight, symbolRect, m_foregroundColor)) {
+            painter->drawPath(SymbolMatrix::modulePath(symbol->runs, QPointF(offsetX, offsetY), scale, scale));
+        }
+    } else if (m_codeType == "PDF417") {
+        // PDF417特殊缩放逻辑：优先保持条码的宽高比
+        qreal scaleX = m_size.width() / matrixWidth;
+        qreal scaleY = m_size.height() / matrixHeight;
+
+        // 确保最小模块尺寸至少是1像素
+        qreal minScale = qMin(scaleX, scaleY);
+        if (minScale < 1.0) {
+            minScale = 1.0;
+        }
+
+        // 对于PDF417，我们可以使用稍微不同的X和Y比例
+        // 但要确保不会造成条码失真
+        qreal actualScaleX = scaleX;
+        qreal actualScaleY = scaleY;
+
+        // 如果某一个方向的缩放过小，使用最小缩放
+        if (actualScaleX < 1.0) actualScaleX = minScale;
+        if (actualScaleY < 1.0) actualScaleY = minScale;
+
+        // 计算实际绘制尺寸
+        qreal drawWidth = matrixWidth * actualScaleX;
+        qreal drawHeight = matrixHeight * actualScaleY;
+
+        // 确保不超出边界
+        if (drawWidth > m_size.width()) {
+            actualScaleX = m_size.width() / matrixWidth;
+            drawWidth = m_size.width();
+        }
+        if (drawHeight > m_size.height()) {
+            actualScaleY = m_size.height() / matrixHeight;
+            drawHeight = m_size.height();
+        }
+
+        // 计算居中偏移
+        qreal offsetX = (m_size.width() - drawWidth) / 2;
+        qreal offsetY = (m_size.height() - drawHeight) / 2;
+
+        // 绘制PDF417
+        const QRectF symbolRect(offsetX, offsetY, drawWidth, drawHeight);
+        if (!SymbolBlitter::blit(painter, symbol->runs, matrixWidth, matrixHeight, symbolRect, m_foregroundColor)) {
+            painter->drawPath(SymbolMatrix::modulePath(symbol->runs,
+                                                       QPointF(offsetX, offsetY),
+                                                       actualScaleX,
+                                                       actualScaleY));
+        }
+    } else {
+        // DataMatrix / Aztec / ZXing QR：正方形模块，最小 1 像素
+        qreal scale = qMin(m_size.width() / matrixWidth, m_size.height() / matrixHeight);
+        if (scale < 1.0) scale = 1.0;
+
+        qreal drawWidth = matrixWidth * scale;
+        qreal drawHeight = matrixHeight * scale;
+        qreal offsetX = (m_size.width() - drawWidth) / 2;
+        qreal offsetY = (m_size.height() - drawHeight) / 2;
+
+        const QRectF symbolRect(offsetX, offsetY, drawWidth, drawHeight);
+        if (!SymbolBlitter::blit(painter, symbol->runs, matrixWidth, matrixHeight, symbolRect, m_foregroundColor)) {
+            painter->drawPath(SymbolMatrix::modulePath(symbol->runs, QPointF(offsetX, offsetY), scale, scale));
         }
     }
+}
+
+void QRCodeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    paintContent(painter);
 
     // 如果被选中，绘制选择框和调整手柄
     if (option->state & QStyle::State_Selected) {
@@ -326,6 +263,7 @@ void QRCodeItem::setText(const QString &text)
 {
     if (m_text != text) {
         m_text = text;
+        m_symbolMatrix.invalidate();
         update();
     }
 }
@@ -335,6 +273,7 @@ void QRCodeItem::setCodeType(const QString &codeType)
     if (m_codeType != codeType) {
         QString oldCodeType = m_codeType;
         m_codeType = codeType;
+        m_symbolMatrix.invalidate();
         
         // 为不同的二维码类型调整默认尺寸
         if (codeType == "PDF417") {
@@ -358,11 +297,32 @@ void QRCodeItem::setCodeType(const QString &codeType)
     }
 }
 
+void QRCodeItem::setQrVersion(int version)
+{
+    version = qBound(0, version, 40);
+    if (m_qrVersion != version) {
+        m_qrVersion = version;
+        m_symbolMatrix.invalidate();
+        update();
+    }
+}
+
+void QRCodeItem::setQrMask(int mask)
+{
+    mask = qBound(-1, mask, 7);
+    if (m_qrMask != mask) {
+        m_qrMask = mask;
+        m_symbolMatrix.invalidate();
+        update();
+    }
+}
+
 void QRCodeItem::setSize(const QSizeF &size)
 {
     if (m_size != size) {
         prepareGeometryChange();
         m_size = size;
+        m_symbolMatrix.invalidate();
         update();
     }
 }
@@ -476,6 +436,8 @@ void QRCodeItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event)
         s_copiedSize = m_size;
         s_copiedForegroundColor = m_foregroundColor;
         s_copiedBackgroundColor = m_backgroundColor;
+        s_copiedQrVersion = m_qrVersion;
+        s_copiedQrMask = m_qrMask;
         
         // 清除其他类型的复制状态
         BarcodeItem::s_hasCopiedItem = false;
@@ -494,6 +456,8 @@ void QRCodeItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event)
             newQRCode->setSize(s_copiedSize);
             newQRCode->setForegroundColor(s_copiedForegroundColor);
             newQRCode->setBackgroundColor(s_copiedBackgroundColor);
+            newQRCode->setQrVersion(s_copiedQrVersion);
+            newQRCode->setQrMask(s_copiedQrMask);
             
             // 获取右键点击的位置并设置新位置
             QPointF sceneClickPos = event->scenePos(); // 场景坐标
@@ -579,6 +543,8 @@ void QRCodeItem::copyItem(QRCodeItem *item)
     s_copiedSize = m_size;
     s_copiedForegroundColor = m_foregroundColor;
     s_copiedBackgroundColor = m_backgroundColor;
+    s_copiedQrVersion = m_qrVersion;
+    s_copiedQrMask = m_qrMask;
     
     // 清除其他类型的复制状态
     BarcodeItem::s_hasCopiedItem = false;
@@ -22,6 +22,7 @@
 #include "BarcodeFormat.h"
 #include "TextUtfEncoding.h"
 #include "alignableitem.h"
+#include "symbolmatrixcache.h"
 
 class QRCodeItem : public QGraphicsItem, public AlignableItem
 {
@@ -42,10 +43,19 @@ public:
     explicit QRCodeItem(const QString &text = "", QGraphicsItem *parent = nullptr);
     ~QRCodeItem() override = default;
 
+    enum { Type = LabelItemType::QRCode };
+    int type() const override { return Type; }
+
     // 重写QGraphicsItem的纯虚函数
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制码图内容（不含选择框与手柄），供输出渲染使用
+    void paintContent(QPainter *painter) const;
+
+    // 以 data 绘制时的编码参数，批量任务据此提前编码
+    SymbolMatrixKey symbolMatrixKey(const QString &data) const;
+
     // 设置和获取二维码内容
     void setText(const QString &text);
     QString text() const { return m_text; }
@@ -54,6 +64,12 @@ public:
     void setCodeType(const QString &codeType);
     QString codeType() const { return m_codeType; }
 
+    // 仅 QR 码：固定版本（1..40，0 为自动）与掩码（0..7，-1 为自动），用于与既有印品保持一致
+    void setQrVersion(int version);
+    int qrVersion() const { return m_qrVersion; }
+    void setQrMask(int mask);
+    int qrMask() const { return m_qrMask; }
+
     void copyItem(QRCodeItem *item);
 
     // 设置和获取二维码大小
@@ -76,6 +92,8 @@ public:
     static QSizeF s_copiedSize;
     static QColor s_copiedForegroundColor;
     static QColor s_copiedBackgroundColor;
+    static int s_copiedQrVersion;
+    static int s_copiedQrMask;
 
     signals:
     void requestDelete(QGraphicsItem *item);
@@ -95,6 +113,8 @@ protected:
 private:
     QString m_text;
     QString m_codeType;  // 添加代码类型成员变量
+    int m_qrVersion = 0;
+    int m_qrMask = -1;
     QSizeF m_size;
     QColor m_foregroundColor;
     QColor m_backgroundColor;
@@ -103,6 +123,9 @@ private:
     QSizeF m_resizeStartSize;
     QPointF m_resizeStartItemPos;  // 调整开始时的项目位置
     HandleType m_resizeHandle;     // 当前调整手柄类型
+
+    // 最近一次编码得到的模块矩阵（内容、码制或尺寸变化时失效）
+    SymbolMatrixSlot m_symbolMatrix;
     
     // 辅助方法
     HandleType getHandleAt(const QPointF &pos) const;
@@ -0,0 +1,233 @@
+#include "recordimageprovider.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// 缓存容量（KiB）：按打印尺寸解码后单张通常在 1 MiB 以内
+constexpr int kCacheBudgetKiB = 256 * 1024;
+
+// 键名省略扩展名时依次尝试
+const char *const kImageSuffixes[] = { "png", "jpg", "jpeg", "bmp", "gif", "webp", "tif", "tiff" };
+
+int costOf(const QImage &image)
+{
+    return std::max(1, static_cast<int>(image.sizeInBytes() / 1024));
+}
+
+QSize levelSize(const QSize &sourceSize, int level)
+{
+    const int divisor = 1 << level;
+    return QSize(std::max(1, (sourceSize.width() + divisor - 1) / divisor),
+                 std::max(1, (sourceSize.height() + divisor - 1) / divisor));
+}
+
+} // namespace
+
+RecordImageProvider &RecordImageProvider::instance()
+{
+    static RecordImageProvider provider;
+    return provider;
+}
+
+RecordImageProvider::RecordImageProvider()
+    : m_images(kCacheBudgetKiB)
+{
+    // 绘制线程自身也在工作，留出一个核心
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+RecordImageProvider::~RecordImageProvider()
+{
+    cancelPending();
+    m_pool.waitForDone();
+}
+
+QString RecordImageProvider::resolve(const QString &value, const QStringList &directories)
+{
+    const QString trimmed = value.trimmed();
+    if (trimmed.isEmpty()) {
+        return QString();
+    }
+
+    const QString cacheKey = directories.join(QLatin1Char('\n')) + QLatin1Char('\n') + trimmed;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_resolved.constFind(cacheKey);
+        if (it != m_resolved.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QStringList candidates;
+    if (QFileInfo(trimmed).isAbsolute()) {
+        candidates << trimmed;
+    } else {
+        for (const QString &directory : directories) {
+            if (!directory.isEmpty()) {
+                candidates << QDir(directory).filePath(trimmed);
+            }
+        }
+    }
+
+    QString resolved;
+    for (const QString &candidate : std::as_const(candidates)) {
+        if (QFileInfo(candidate).isFile()) {
+            resolved = QFileInfo(candidate).absoluteFilePath();
+            break;
+        }
+        if (!QFileInfo(candidate).suffix().isEmpty()) {
+            continue;
+        }
+        for (const char *suffix : kImageSuffixes) {
+            const QString withSuffix = candidate + QLatin1Char('.') + QLatin1String(suffix);
+            if (QFileInfo(withSuffix).isFile()) {
+                resolved = QFileInfo(withSuffix).absoluteFilePath();
+                break;
+            }
+        }
+        if (!resolved.isEmpty()) {
+            break;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_resolved.insert(cacheKey, resolved);
+    return resolved;
+}
+
+RecordImageProvider::Key RecordImageProvider::keyFor(const QString &filePath,
+                                                     const QSize &targetSize,
+                                                     QSize *scaledSize)
+{
+    QSize sourceSize;
+    bool known = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_sourceSizes.constFind(filePath);
+        if (it != m_sourceSizes.constEnd()) {
+            sourceSize = it.value();
+            known = true;
+        }
+    }
+    if (!known) {
+        // 只读取文件头
+        sourceSize = QImageReader(filePath).size();
+        QMutexLocker locker(&m_mutex);
+        m_sourceSizes.insert(filePath, sourceSize);
+    }
+
+    // 文件头中没有尺寸的格式只能按原图解码
+    int level = 0;
+    if (sourceSize.isValid() && !targetSize.isEmpty()) {
+        for (int extent = std::max(sourceSize.width(), sourceSize.height()); extent > 1; extent = (extent + 1) / 2) {
+            const QSize size = levelSize(sourceSize, level + 1);
+            if (size.width() < targetSize.width() || size.height() < targetSize.height()) {
+                break;
+            }
+            ++level;
+        }
+    }
+    *scaledSize = level > 0 ? levelSize(sourceSize, level) : QSize();
+    return Key(filePath, level);
+}
+
+QImage RecordImageProvider::decodeAndStore(const Key &key, const QSize &scaledSize)
+{
+    QImageReader reader(key.first);
+    if (scaledSize.isValid()) {
+        reader.setScaledSize(scaledSize);
+    }
+    QImage image = reader.read();
+    if (!image.isNull()) {
+        const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32;
+        if (image.format() != format) {
+            image = image.convertToFormat(format);
+        }
+    }
+
+    // 解码失败也缓存（空图像），缺失的文件不会被每条记录重复读取
+    QMutexLocker locker(&m_mutex);
+    m_images.insert(key, new QImage(image), costOf(image));
+    m_inFlight.remove(key);
+    m_decoded.wakeAll();
+    return image;
+}
+
+void RecordImageProvider::prefetch(const QString &filePath, const QSize &targetSize)
+{
+    if (filePath.isEmpty()) {
+        return;
+    }
+    QSize scaledSize;
+    const Key key = keyFor(filePath, targetSize, &scaledSize);
+
+    int generation = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_images.contains(key) || m_inFlight.contains(key)) {
+            return;
+        }
+        m_inFlight.insert(key);
+        generation = m_generation;
+    }
+
+    m_pool.start([this, key, scaledSize, generation]() {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (generation != m_generation) {
+                // 已取消：交还给可能在等待的绘制线程自行解码
+                m_inFlight.remove(key);
+                m_decoded.wakeAll();
+                return;
+            }
+        }
+        decodeAndStore(key, scaledSize);
+    });
+}
+
+QImage RecordImageProvider::image(const QString &filePath, const QSize &targetSize)
+{
+    if (filePath.isEmpty()) {
+        return QImage();
+    }
+    QSize scaledSize;
+    const Key key = keyFor(filePath, targetSize, &scaledSize);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        for (;;) {
+            if (const QImage *cached = m_images.object(key)) {
+                return *cached;
+            }
+            if (!m_inFlight.contains(key)) {
+                break;
+            }
+            m_decoded.wait(&m_mutex);
+        }
+        m_inFlight.insert(key);
+    }
+    return decodeAndStore(key, scaledSize);
+}
+
+void RecordImageProvider::cancelPending()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+}
+
+void RecordImageProvider::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+    m_sourceSizes.clear();
+    m_resolved.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef RECORDIMAGEPROVIDER_H
+#define RECORDIMAGEPROVIDER_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+/**
+ * @brief 按记录取图的图像提供者（产品照片、认证标志等绑定数据源的图像元素）
+ *
+ * 图像按文件路径与缩放级别缓存：第 k 级为原图的 1/2^k，取不小于目标设备尺寸的最小一级，
+ * 用 QImageReader::setScaledSize 直接解码到该尺寸（JPEG 在解码阶段缩小）。
+ * 预取在线程池中进行；同一文件同一级别正在解码时，其他请求等待其结果，
+ * 因此引用同一图像的记录只解码一次。解码结果放在按内存预算淘汰的 LRU 缓存中。
+ * 只使用 QImage，可在打印、导出线程中调用。
+ */
+class RecordImageProvider
+{
+public:
+    static RecordImageProvider &instance();
+
+    RecordImageProvider(const RecordImageProvider &) = delete;
+    RecordImageProvider &operator=(const RecordImageProvider &) = delete;
+
+    // 数据源取值解析为图像文件：绝对路径，或依次相对 directories 中各目录的路径/键名
+    // （键名可省略扩展名）。无法解析时返回空；结果缓存，文件变化后调用 clear()
+    QString resolve(const QString &value, const QStringList &directories);
+
+    // 在后台解码 filePath 以 targetSize 设备像素绘制时使用的级别
+    void prefetch(const QString &filePath, const QSize &targetSize);
+    // 取图像：已缓存时直接返回；正在后台解码时等待；否则在调用线程解码
+    QImage image(const QString &filePath, const QSize &targetSize);
+
+    // 放弃尚未开始的预取
+    void cancelPending();
+    // 清空缓存（文件内容变化后使用）
+    void clear();
+
+private:
+    RecordImageProvider();
+    ~RecordImageProvider();
+
+    using Key = QPair<QString, int>;
+
+    Key keyFor(const QString &filePath, const QSize &targetSize, QSize *scaledSize);
+    QImage decodeAndStore(const Key &key, const QSize &scaledSize);
+
+    QMutex m_mutex;
+    QWaitCondition m_decoded;
+    QCache<Key, QImage> m_images;
+    QSet<Key> m_inFlight;
+    QHash<QString, QSize> m_sourceSizes;    // 文件头中的原图尺寸
+    QHash<QString, QString> m_resolved;     // 取值 + 目录 -> 文件路径
+    int m_generation = 0;                   // cancelPending() 后递增，旧的预取任务不再解码
+    QThreadPool m_pool;
+};
+
+#endif // RECORDIMAGEPROVIDER_H
@@ -41,11 +41,8 @@ void RectangleItem::initializeDefaults()
     m_cornerRadius = 0.0;
 }
 
-void RectangleItem::paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void RectangleItem::paintShape(QPainter *painter) const
 {
-    Q_UNUSED(option)
-    Q_UNUSED(widget)
-
     QRectF rect(0, 0, m_size.width(), m_size.height());
 
     // 设置画笔和画刷
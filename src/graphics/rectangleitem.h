@@ -10,6 +10,9 @@ public:
     explicit RectangleItem(const QSizeF &size, QGraphicsItem *parent = nullptr);
     virtual ~RectangleItem() = default;
 
+    enum { Type = LabelItemType::Rectangle };
+    int type() const override { return Type; }
+
     // 静态成员变量，用于复制粘贴功能
     static bool s_hasCopiedItem;
     static QPen s_copiedPen;
@@ -28,7 +31,7 @@ public:
 
 protected:
     // 实现抽象方法
-    void paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    void paintShape(QPainter *painter) const override;
 
     // 重写右键菜单以提供矩形特定的选项
     void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
@@ -15,6 +15,9 @@ public:
 	explicit SelectionFrame(QGraphicsItem *parent = nullptr);
 	~SelectionFrame() override = default;
 
+	enum { Type = LabelItemType::SelectionFrame };
+	int type() const override { return Type; }
+
 	QRectF boundingRect() const override;
 	QPainterPath shape() const override;
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
@@ -83,11 +83,8 @@ QPolygonF StarItem::buildStarPolygon() const
 	return poly;
 }
 
-void StarItem::paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void StarItem::paintShape(QPainter *painter) const
 {
-	Q_UNUSED(option)
-	Q_UNUSED(widget)
-
 	// 设置画笔和画刷
 	painter->setPen(m_borderEnabled ? m_pen : Qt::NoPen);
 	painter->setBrush(m_fillEnabled ? m_brush : Qt::NoBrush);
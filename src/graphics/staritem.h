@@ -11,6 +11,9 @@ public:
 	explicit StarItem(const QSizeF &size, QGraphicsItem *parent = nullptr);
 	virtual ~StarItem() = default;
 
+	enum { Type = LabelItemType::Star };
+	int type() const override { return Type; }
+
 	// 星形参数
 	void setPointCount(int n);
 	int pointCount() const { return m_points; }
@@ -32,7 +35,7 @@ public:
 	void copyItem(StarItem *item);
 
 protected:
-	void paintShape(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+	void paintShape(QPainter *painter) const override;
 	void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
 
 private:
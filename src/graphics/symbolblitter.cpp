@@ -0,0 +1,194 @@
+#include "symbolblitter.h"
+
+#include <QImage>
+#include <QPaintDevice>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTransform>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// 按像素中心取整：覆盖像素中心的像素才计入
+QRect deviceRect(const QRectF &rect)
+{
+    const int left = qRound(rect.left());
+    const int top = qRound(rect.top());
+    return QRect(QPoint(left, top), QPoint(qRound(rect.right()) - 1, qRound(rect.bottom()) - 1));
+}
+
+void fill32(QImage *image, const QRect &rect, quint32 pixel)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(image->scanLine(y)) + rect.left();
+        std::fill_n(line, rect.width(), pixel);
+    }
+}
+
+// 1 位格式：首尾不足一字节的部分逐位处理，中间整字节直接 memset
+void fillMonoLine(uchar *line, int x0, int x1, bool msbFirst, bool set)
+{
+    auto mask = [msbFirst](int bit) {
+        return static_cast<uchar>(msbFirst ? (0x80 >> bit) : (0x01 << bit));
+    };
+    auto apply = [&](int x) {
+        uchar &byte = line[x >> 3];
+        if (set) {
+            byte |= mask(x & 7);
+        } else {
+            byte &= static_cast<uchar>(~mask(x & 7));
+        }
+    };
+
+    int x = x0;
+    for (; x < x1 && (x & 7) != 0; ++x) {
+        apply(x);
+    }
+    const int wholeBytes = (x1 - x) >> 3;
+    if (wholeBytes > 0) {
+        std::memset(line + (x >> 3), set ? 0xff : 0x00, static_cast<size_t>(wholeBytes));
+        x += wholeBytes << 3;
+    }
+    for (; x < x1; ++x) {
+        apply(x);
+    }
+}
+
+void fillMono(QImage *image, const QRect &rect, bool msbFirst, bool set)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        fillMonoLine(image->scanLine(y), rect.left(), rect.right() + 1, msbFirst, set);
+    }
+}
+
+// 路径只由外接矩形的四个角点以直线连接而成
+bool isRectangular(const QPainterPath &path)
+{
+    const int count = path.elementCount();
+    if (count < 4 || count > 5) {
+        return false;
+    }
+    const QRectF bounds = path.boundingRect();
+    auto same = [](qreal a, qreal b) { return std::abs(a - b) < 1e-6; };
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element element = path.elementAt(i);
+        if (element.isCurveTo()) {
+            return false;
+        }
+        const bool onVertical = same(element.x, bounds.left()) || same(element.x, bounds.right());
+        const bool onHorizontal = same(element.y, bounds.top()) || same(element.y, bounds.bottom());
+        if (!onVertical || !onHorizontal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 颜色表中与前景色灰度最接近的索引
+int nearestMonoIndex(const QImage &image, const QColor &color)
+{
+    const QVector<QRgb> table = image.colorTable();
+    if (table.size() < 2) {
+        return -1;
+    }
+    const int gray = qGray(color.rgb());
+    return std::abs(qGray(table.at(0)) - gray) <= std::abs(qGray(table.at(1)) - gray) ? 0 : 1;
+}
+
+} // namespace
+
+bool SymbolBlitter::blit(QPainter *painter,
+                         const QVector<QRect> &runs,
+                         int columns,
+                         int rows,
+                         const QRectF &targetRect,
+                         const QColor &color)
+{
+    if (!painter || !painter->isActive() || columns <= 0 || rows <= 0 || targetRect.isEmpty()) {
+        return false;
+    }
+
+    QPaintDevice *device = painter->device();
+    if (!device || device->devType() != QInternal::Image) {
+        return false;
+    }
+    QImage *image = static_cast<QImage *>(device);
+    if (!image->isDetached()) {
+        return false;
+    }
+
+    const QImage::Format format = image->format();
+    const bool is32Bit = format == QImage::Format_RGB32
+                         || format == QImage::Format_ARGB32
+                         || format == QImage::Format_ARGB32_Premultiplied;
+    const bool isMono = format == QImage::Format_Mono || format == QImage::Format_MonoLSB;
+    if (!is32Bit && !isMono) {
+        return false;
+    }
+
+    // 半透明、混合模式会改变像素结果，交给 QPainter 处理
+    if (color.alpha() != 255 || painter->opacity() < 1.0
+        || painter->compositionMode() != QPainter::CompositionMode_SourceOver) {
+        return false;
+    }
+
+    const QTransform transform = painter->deviceTransform();
+    if (transform.type() > QTransform::TxScale || transform.m11() <= 0.0 || transform.m22() <= 0.0) {
+        return false;
+    }
+
+    // 模块宽高向下对齐到整数个设备点，符号不超出元素区域，保持符号中心不变。
+    // 模块小于一个点，或取整后符号缩小超过四分之一（预览、缩略图等小尺寸）时
+    // 交给路径绘制，避免符号尺寸明显变化
+    const QRectF symbolRect = transform.mapRect(targetRect);
+    const qreal exactWidth = symbolRect.width() / columns;
+    const qreal exactHeight = symbolRect.height() / rows;
+    const int dotWidth = static_cast<int>(std::floor(exactWidth));
+    const int dotHeight = static_cast<int>(std::floor(exactHeight));
+    if (dotWidth < 1 || dotHeight < 1 || dotWidth < exactWidth * 0.75 || dotHeight < exactHeight * 0.75) {
+        return false;
+    }
+    const int left = qRound(symbolRect.center().x() - dotWidth * columns / 2.0);
+    const int top = qRound(symbolRect.center().y() - dotHeight * rows / 2.0);
+
+    // 只能按矩形裁剪；圆角标签等非矩形裁剪交给路径绘制
+    QRect clip = image->rect();
+    if (painter->hasClipping()) {
+        if (!isRectangular(painter->clipPath())) {
+            return false;
+        }
+        clip &= deviceRect(transform.mapRect(painter->clipBoundingRect()));
+    }
+    if (clip.isEmpty()) {
+        return true;
+    }
+
+    int monoIndex = -1;
+    if (isMono) {
+        monoIndex = nearestMonoIndex(*image, color);
+        if (monoIndex < 0) {
+            return false;
+        }
+    }
+    const quint32 pixel = 0xff000000u | color.rgb();
+
+    for (const QRect &run : runs) {
+        const QRect rect = QRect(left + run.x() * dotWidth,
+                                 top + run.y() * dotHeight,
+                                 run.width() * dotWidth,
+                                 run.height() * dotHeight) & clip;
+        if (rect.isEmpty()) {
+            continue;
+        }
+        if (is32Bit) {
+            fill32(image, rect, pixel);
+        } else {
+            fillMono(image, rect, format == QImage::Format_Mono, monoIndex == 1);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef SYMBOLBLITTER_H
+#define SYMBOLBLITTER_H
+
+#include <QColor>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+
+class QPainter;
+
+/**
+ * @brief 条码/二维码模块的光栅直写
+ *
+ * 目标是 QImage（1 位或 32 位格式）且只有平移、缩放时，把模块宽度对齐到整数个设备点，
+ * 直接按扫描线填充合并后的模块长条，不经过 QPainter 的抗锯齿路径填充。
+ * 条边落在整点上，203/300 dpi 输出不再出现灰边，扫描等级更稳定。
+ */
+class SymbolBlitter
+{
+public:
+    // runs 为模块坐标中的长条，columns × rows 为模块网格，targetRect 为网格在 painter 逻辑坐标中的区域。
+    // 设备、变换、格式或绘制状态不满足直写条件时返回 false，调用方改用路径绘制。
+    static bool blit(QPainter *painter,
+                     const QVector<QRect> &runs,
+                     int columns,
+                     int rows,
+                     const QRectF &targetRect,
+                     const QColor &color);
+};
+
+#endif // SYMBOLBLITTER_H
@@ -0,0 +1,233 @@
+#include "symbolmatrixcache.h"
+#include "fastqrencoder.h"
+#include "linearsymbolencoder.h"
+
+#include "BarcodeFormat.h"
+#include "MultiFormatWriter.h"
+
+#include <QCache>
+#include <QHash>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+// QCache 通过参数相关查找定位 qHash，因此定义在全局命名空间
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+static size_t qHash(const SymbolMatrixKey &key, size_t seed = 0)
+#else
+static uint qHash(const SymbolMatrixKey &key, uint seed = 0)
+#endif
+{
+    const int fields[] = { static_cast<int>(key.encoder),
+                           key.format,
+                           key.eccLevel,
+                           key.margin,
+                           key.width,
+                           key.height,
+                           key.qrVersion,
+                           key.qrMask };
+    return qHashBits(fields, sizeof(fields), seed) ^ ::qHash(key.data, seed);
+}
+
+namespace {
+
+// 缓存容量（字节）；一维码矩阵按绘制宽高生成，单个约数十 KB
+constexpr int kCacheBudgetBytes = 32 * 1024 * 1024;
+
+struct SharedCache {
+    QMutex mutex;
+    QCache<SymbolMatrixKey, std::shared_ptr<const SymbolMatrix>> entries{kCacheBudgetBytes};
+};
+
+SharedCache &sharedCache()
+{
+    static SharedCache cache;
+    return cache;
+}
+
+// 一维码按绘制高度生成的矩阵每一行都相同，只保留一行：
+// 缓存项缩小到原来的几十分之一，批量预编码的窗口也能完整留在缓存中
+void collapseRepeatedRows(SymbolMatrix *symbol)
+{
+    const ZXing::BitMatrix &bits = symbol->bits;
+    const int width = bits.width();
+    const int height = bits.height();
+    if (height <= 1) {
+        return;
+    }
+    for (int y = 1; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (bits.get(x, y) != bits.get(x, 0)) {
+                return;
+            }
+        }
+    }
+
+    ZXing::BitMatrix row(width, 1);
+    for (int x = 0; x < width; ++x) {
+        if (bits.get(x, 0)) {
+            row.set(x, 0);
+        }
+    }
+    symbol->bits = std::move(row);
+}
+
+// 逐行扫描深色模块：同行连续模块合并为长条；与上一行起点、长度都相同的长条向下延伸
+void buildRuns(SymbolMatrix *symbol)
+{
+    const ZXing::BitMatrix &bits = symbol->bits;
+    const int width = bits.width();
+    const int height = bits.height();
+
+    // 键为 (x << 32 | 长度)，值为 runs 中对应长条的下标
+    QHash<quint64, int> openRuns;
+    QHash<quint64, int> nextOpenRuns;
+    for (int y = 0; y < height; ++y) {
+        nextOpenRuns.clear();
+        int x = 0;
+        while (x < width) {
+            if (!bits.get(x, y)) {
+                ++x;
+                continue;
+            }
+            const int start = x;
+            while (x < width && bits.get(x, y)) {
+                ++x;
+            }
+            const int length = x - start;
+            if (y == 0) {
+                symbol->firstRowRuns.append(QRect(start, 0, length, 1));
+            }
+
+            const quint64 runKey = (static_cast<quint64>(start) << 32) | static_cast<quint32>(length);
+            const auto open = openRuns.constFind(runKey);
+            if (open != openRuns.constEnd()) {
+                symbol->runs[open.value()].setHeight(symbol->runs[open.value()].height() + 1);
+                nextOpenRuns.insert(runKey, open.value());
+            } else {
+                nextOpenRuns.insert(runKey, symbol->runs.size());
+                symbol->runs.append(QRect(start, y, length, 1));
+            }
+        }
+        openRuns.swap(nextOpenRuns);
+    }
+}
+
+std::shared_ptr<const SymbolMatrix> encode(const SymbolMatrixKey &key)
+{
+    auto result = std::make_shared<SymbolMatrix>();
+    try {
+        if (key.encoder == SymbolMatrixKey::Encoder::QrCodeGen) {
+            FastQrEncoder::Options options;
+            options.eccLevel = std::clamp(key.eccLevel, 0, 3);
+            options.version = key.qrVersion;
+            options.mask = key.qrMask;
+            if (!FastQrEncoder::encode(key.data, options, &result->bits, &result->error)) {
+                return result;
+            }
+        } else if (key.encoder == SymbolMatrixKey::Encoder::ZXing
+                   && LinearSymbolEncoder::supports(static_cast<ZXing::BarcodeFormat>(key.format))) {
+            // 常用一维码走专用编码器，直接生成单行矩阵；模块缓冲按线程复用
+            thread_local std::vector<quint8> modules;
+            int defaultMargin = 0;
+            if (!LinearSymbolEncoder::encodeModules(static_cast<ZXing::BarcodeFormat>(key.format), key.data,
+                                                    &modules, &defaultMargin, &result->error)) {
+                return result;
+            }
+            result->bits = LinearSymbolEncoder::render(modules, key.width,
+                                                       key.margin >= 0 ? key.margin : defaultMargin);
+        } else if (key.encoder == SymbolMatrixKey::Encoder::ZXing) {
+            ZXing::MultiFormatWriter writer(static_cast<ZXing::BarcodeFormat>(key.format));
+            if (key.margin >= 0) {
+                writer.setMargin(key.margin);
+            }
+            if (key.eccLevel >= 0) {
+                writer.setEccLevel(key.eccLevel);
+            }
+            const std::string utf8Data = key.data.toUtf8().toStdString();
+            result->bits = writer.encode(utf8Data, key.width, key.height);
+            collapseRepeatedRows(result.get());
+        }
+    } catch (const std::exception &e) {
+        result->bits = ZXing::BitMatrix();
+        result->error = QString::fromUtf8(e.what());
+        if (result->error.isEmpty()) {
+            result->error = QStringLiteral("encode failed");
+        }
+        return result;
+    }
+    buildRuns(result.get());
+    return result;
+}
+
+} // namespace
+
+QPainterPath SymbolMatrix::modulePath(const QVector<QRect> &runs,
+                                      const QPointF &offset,
+                                      qreal scaleX,
+                                      qreal scaleY)
+{
+    // 路径在每次绘制时由缓存的长条生成：QPainterPath 内部有惰性计算的可变状态，
+    // 不能在打印线程与界面线程之间共享
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for (const QRect &run : runs) {
+        path.addRect(QRectF(offset.x() + run.x() * scaleX,
+                            offset.y() + run.y() * scaleY,
+                            run.width() * scaleX,
+                            run.height() * scaleY));
+    }
+    return path;
+}
+
+std::shared_ptr<const SymbolMatrix> SymbolMatrixCache::matrix(const SymbolMatrixKey &key)
+{
+    if (key.encoder == SymbolMatrixKey::Encoder::None || key.data.isEmpty()) {
+        return nullptr;
+    }
+
+    SharedCache &cache = sharedCache();
+    {
+        QMutexLocker locker(&cache.mutex);
+        if (const auto *cached = cache.entries.object(key)) {
+            return *cached;
+        }
+    }
+
+    // 编码在锁外进行，避免长数据阻塞其他线程的命中查询
+    std::shared_ptr<const SymbolMatrix> encoded = encode(key);
+    const qint64 bytes = static_cast<qint64>(encoded->bits.width()) * encoded->bits.height()
+                         + static_cast<qint64>(encoded->runs.size() + encoded->firstRowRuns.size()) * sizeof(QRect)
+                         + key.data.size() * 2 + 64;
+    const int cost = static_cast<int>(std::clamp<qint64>(bytes, 1, kCacheBudgetBytes));
+
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.insert(key, new std::shared_ptr<const SymbolMatrix>(encoded), cost);
+    return encoded;
+}
+
+void SymbolMatrixCache::clear()
+{
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.clear();
+}
+
+std::shared_ptr<const SymbolMatrix> SymbolMatrixSlot::matrix(const SymbolMatrixKey &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_matrix || m_key != key) {
+        m_matrix = SymbolMatrixCache::matrix(key);
+        m_key = key;
+    }
+    return m_matrix;
+}
+
+void SymbolMatrixSlot::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_matrix.reset();
+    m_key = SymbolMatrixKey();
+}
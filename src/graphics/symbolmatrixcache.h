@@ -0,0 +1,90 @@
+#ifndef SYMBOLMATRIXCACHE_H
+#define SYMBOLMATRIXCACHE_H
+
+#include <QMutex>
+#include <QPainterPath>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "BitMatrix.h"
+
+#include <memory>
+
+// 条码/二维码编码结果：模块矩阵，或编码失败时的错误信息
+struct SymbolMatrix {
+    ZXing::BitMatrix bits;
+    QString error;
+
+    // 合并后的深色模块（模块坐标），编码时生成一次：同行相邻模块合并为横向长条，
+    // 上下行完全相同的长条再纵向合并，一维码因此直接得到整根竖条
+    QVector<QRect> runs;
+    // 仅第一行的横向长条（高度为 1），一维码按第一行绘制整高竖条时使用
+    QVector<QRect> firstRowRuns;
+
+    bool isValid() const { return error.isEmpty() && bits.width() > 0 && bits.height() > 0; }
+
+    // 把长条按 offset + 模块坐标 × (scaleX, scaleY) 映射为一条路径，一次填充完成绘制，
+    // 相邻模块之间不会出现抗锯齿接缝，PDF 中也只有一个路径对象
+    static QPainterPath modulePath(const QVector<QRect> &runs,
+                                   const QPointF &offset,
+                                   qreal scaleX,
+                                   qreal scaleY);
+};
+
+// 编码参数：数据、码制、纠错等级、静区与尺寸提示共同决定模块矩阵
+struct SymbolMatrixKey {
+    enum class Encoder {
+        None,
+        ZXing,      // ZXing::MultiFormatWriter
+        QrCodeGen   // FastQrEncoder（输出与 qrcodegen::QrCode::encodeText 一致）
+    };
+
+    Encoder encoder = Encoder::None;
+    QString data;
+    int format = 0;         // ZXing::BarcodeFormat
+    int eccLevel = -1;      // -1 表示使用编码器默认值
+    int margin = -1;        // -1 表示使用编码器默认值
+    int width = 0;
+    int height = 0;
+    int qrVersion = 0;      // 仅 QrCodeGen：固定版本 1..40，0 表示自动
+    int qrMask = -1;        // 仅 QrCodeGen：固定掩码 0..7，-1 表示自动
+
+    bool operator==(const SymbolMatrixKey &other) const
+    {
+        return encoder == other.encoder
+            && format == other.format
+            && eccLevel == other.eccLevel
+            && margin == other.margin
+            && width == other.width
+            && height == other.height
+            && qrVersion == other.qrVersion
+            && qrMask == other.qrMask
+            && data == other.data;
+    }
+    bool operator!=(const SymbolMatrixKey &other) const { return !(*this == other); }
+};
+
+// 进程级 LRU：相同载荷（批量重打、复制粘贴的元素）共享一次编码。线程安全。
+class SymbolMatrixCache
+{
+public:
+    static std::shared_ptr<const SymbolMatrix> matrix(const SymbolMatrixKey &key);
+    static void clear();
+};
+
+// 图形项持有的矩阵：记住最近一次的键与结果，重绘时直接复用；
+// 数据、码制或尺寸变化时由图形项的 setter 调用 invalidate()
+class SymbolMatrixSlot
+{
+public:
+    std::shared_ptr<const SymbolMatrix> matrix(const SymbolMatrixKey &key) const;
+    void invalidate();
+
+private:
+    mutable QMutex m_mutex;
+    mutable SymbolMatrixKey m_key;
+    mutable std::shared_ptr<const SymbolMatrix> m_matrix;
+};
+
+#endif // SYMBOLMATRIXCACHE_H
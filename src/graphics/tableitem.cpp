@@ -31,9 +31,8 @@ QRectF TableItem::boundingRect() const
     return QRectF(0,0,w,h);
 }
 
-void TableItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+void TableItem::paintContent(QPainter* painter) const
 {
-    Q_UNUSED(option); Q_UNUSED(widget);
     const QRectF rect = boundingRect();
     painter->fillRect(rect, m_background);
     painter->setPen(m_gridPen);
@@ -54,8 +53,15 @@ void TableItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
         y += m_rowHeights[r];
         painter->drawLine(QPointF(0, y), QPointF(rect.width(), y));
     }
+}
+
+void TableItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option); Q_UNUSED(widget);
+    paintContent(painter);
 
     if (isSelected()) {
+        const QRectF rect = boundingRect();
         painter->setPen(QPen(Qt::blue, 1, Qt::DashLine));
         painter->drawRect(rect.adjusted(0.5,0.5,-0.5,-0.5));
     }
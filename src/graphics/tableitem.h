@@ -7,14 +7,20 @@
 #include <QBrush>
 #include <QMenu>
 #include <QString>
+#include "labelitemtypes.h"
 
 class TableItem : public QGraphicsItem
 {
 public:
     TableItem(int rows = 2, int cols = 2, qreal cellW = 50, qreal cellH = 30, QGraphicsItem* parent = nullptr);
 
+    enum { Type = LabelItemType::Table };
+    int type() const override { return Type; }
+
     QRectF boundingRect() const override;
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+    // 仅绘制表格内容（不含选择框），供输出渲染使用
+    void paintContent(QPainter* painter) const;
 
     int rowCount() const { return m_rows; }
     int columnCount() const { return m_cols; }
@@ -1,4 +1,5 @@
 #include "textitem.h"
+#include "textlayoutcache.h"
 #include <QGraphicsScene>
 #include "labelscene.h"
 #include "../commands/undomanager.h"
@@ -16,6 +17,8 @@
 #include <QTextEdit>
 #include <QTextDocument>
 #include <QScreen>
+#include <QThread>
+#include <atomic>
 
 // 常量定义
 static const qreal HANDLE_SIZE = 8.0;
@@ -100,10 +103,8 @@ QRectF TextItem::boundingRect() const
     return rect;
 }
 
-void TextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void TextItem::paintContent(QPainter *painter) const
 {
-    Q_UNUSED(widget);
-
     // 获取文本框的矩形区域
     QRectF textRect(0, 0, m_size.width(), m_size.height());
 
@@ -119,6 +120,14 @@ void TextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 
     // 绘制文本
     drawText(painter, textRect);
+}
+
+void TextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    paintContent(painter);
 
     // 如果选中且不在编辑状态，绘制调整手柄
     if (isSelected() && !m_isEditing) {
@@ -304,16 +313,25 @@ void TextItem::setEditing(bool editing)
     }
 }
 
+qreal TextItem::screenLogicalDpi()
+{
+    static std::atomic<qreal> s_dpi{96.0};
+    const QCoreApplication *app = QCoreApplication::instance();
+    if (app && QThread::currentThread() == app->thread()) {
+        if (QScreen *screen = QGuiApplication::primaryScreen()) {
+            s_dpi.store(screen->logicalDotsPerInch(), std::memory_order_relaxed);
+        }
+    }
+    return s_dpi.load(std::memory_order_relaxed);
+}
+
 QSizeF TextItem::calculateMinimumSize() const
 {
     if (m_text.isEmpty()) {
         return QSizeF(100, 30); // 默认最小尺寸
     }
 
-    double baseDpi = 96.0;
-    if (QScreen *screen = QApplication::primaryScreen()) {
-        baseDpi = screen->logicalDotsPerInch();
-    }
+    const double baseDpi = screenLogicalDpi();
 
     const double scale = baseDpi > 0.0 ? kSceneDpi / baseDpi : 1.0;
     QFont metricsFont = m_font;
@@ -330,24 +348,24 @@ QSizeF TextItem::calculateMinimumSize() const
     }
     metricsFont.setLetterSpacing(QFont::AbsoluteSpacing, m_letterSpacing * scale);
 
-    QFontMetrics fm(metricsFont);
+    // 度量结果经排版缓存共享，批量记录应用/恢复时相同的值不再重复度量
     if (m_wordWrap) {
         // 如果启用换行，使用当前宽度进行计算
         qreal width = qMax(100.0, m_size.width());
         QRect boundingRect(0, 0, static_cast<int>(width), 0);
-        QRect rect = fm.boundingRect(boundingRect, Qt::TextWordWrap | m_alignment, m_text);
+        QRect rect = TextLayoutCache::boundingRect(metricsFont, boundingRect, Qt::TextWordWrap | m_alignment, m_text);
         // 增加更多的垂直空间，确保文本完全显示
         return QSizeF(width, qMax(30.0, static_cast<qreal>(rect.height()) + 20));
     } else {
         // 单行文本
-        QRect rect = fm.boundingRect(m_text);
+        QRect rect = TextLayoutCache::boundingRect(metricsFont, m_text);
         // 增加更多的水平和垂直空间，确保文本完全显示
         return QSizeF(qMax(100.0, static_cast<qreal>(rect.width()) + 30), 
                      qMax(30.0, static_cast<qreal>(rect.height()) + 20));
     }
 }
 
-void TextItem::drawText(QPainter *painter, const QRectF &rect)
+void TextItem::drawText(QPainter *painter, const QRectF &rect) const
 {
     if (m_text.isEmpty()) {
         return;
@@ -388,15 +406,16 @@ void TextItem::drawText(QPainter *painter, const QRectF &rect)
         flags |= Qt::TextWordWrap;
     }
 
-    painter->drawText(textRect, flags, m_text);
+    // 整形后的字形串按（文本、字体、区域、标志、设备 DPI）缓存，重绘与重复值直接复用
+    TextLayoutCache::drawText(painter, textRect, flags, m_text);
 }
 
-void TextItem::drawBackground(QPainter *painter, const QRectF &rect)
+void TextItem::drawBackground(QPainter *painter, const QRectF &rect) const
 {
     painter->fillRect(rect, m_backgroundColor);
 }
 
-void TextItem::drawBorder(QPainter *painter, const QRectF &rect)
+void TextItem::drawBorder(QPainter *painter, const QRectF &rect) const
 {
     painter->setPen(m_borderPen);
     painter->setBrush(Qt::NoBrush);
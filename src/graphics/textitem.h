@@ -46,10 +46,16 @@ public:
     explicit TextItem(const QString &text = "", QGraphicsItem *parent = nullptr);
     ~TextItem() override = default;
 
+    enum { Type = LabelItemType::Text };
+    int type() const override { return Type; }
+
     // 重写QGraphicsItem的纯虚函数
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
+    // 仅绘制文本内容（不含手柄与对齐线），供输出渲染使用
+    void paintContent(QPainter *painter) const;
+
     // 文本内容相关
     void setText(const QString &text);
     QString text() const { return m_text; }
@@ -103,6 +109,11 @@ public:
     // 计算文本所需的最小尺寸
     QSizeF calculateMinimumSize() const;
 
+    // 度量最小尺寸时使用的屏幕逻辑 DPI。屏幕只能在 GUI 线程访问：在 GUI 线程调用时
+    // 重新读取，其他线程返回 GUI 线程最近一次读到的值。在线程池中创建文本项之前，
+    // 调度方须先在 GUI 线程调用一次
+    static qreal screenLogicalDpi();
+
     // 实现 AlignableItem 接口
     QGraphicsItem* asGraphicsItem() override { return this; }
     const QGraphicsItem* asGraphicsItem() const override { return this; }
@@ -163,9 +174,9 @@ private:
     void setCursorForHandle(HandleType handle);
 
     // 文本绘制相关
-    void drawText(QPainter *painter, const QRectF &rect);
-    void drawBackground(QPainter *painter, const QRectF &rect);
-    void drawBorder(QPainter *painter, const QRectF &rect);
+    void drawText(QPainter *painter, const QRectF &rect) const;
+    void drawBackground(QPainter *painter, const QRectF &rect) const;
+    void drawBorder(QPainter *painter, const QRectF &rect) const;
     
     // 内部调整大小方法（不触发几何变化通知）
     void setSizeInternal(const QSizeF &size);
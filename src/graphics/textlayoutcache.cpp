@@ -0,0 +1,310 @@
+#include "textlayoutcache.h"
+
+#include <QCache>
+#include <QFontMetrics>
+#include <QFontMetricsF>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPaintDevice>
+#include <QPainter>
+#include <QTextLayout>
+#include <QTextLine>
+#include <QTextOption>
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+// 缓存容量按字形数计（度量结果按 1 计），约合数 MB
+constexpr int kMaxCachedGlyphs = 200000;
+// 与 QPainter::drawText 相同：不换行时使用“无限”行宽
+constexpr qreal kUnboundedLineWidth = 0x01000000;
+
+enum class EntryKind {
+    Layout,
+    SingleLineMetrics,
+    RectMetrics
+};
+
+struct CacheKey {
+    EntryKind kind = EntryKind::Layout;
+    QString text;
+    QString fontKey;
+    qreal letterSpacing = 0.0;
+    qreal wordSpacing = 0.0;
+    qreal width = 0.0;
+    qreal height = 0.0;
+    int flags = 0;
+    int dpiX = 0;
+    int dpiY = 0;
+
+    friend bool operator==(const CacheKey &lhs, const CacheKey &rhs)
+    {
+        return lhs.kind == rhs.kind
+            && lhs.flags == rhs.flags
+            && lhs.dpiX == rhs.dpiX
+            && lhs.dpiY == rhs.dpiY
+            && lhs.width == rhs.width
+            && lhs.height == rhs.height
+            && lhs.letterSpacing == rhs.letterSpacing
+            && lhs.wordSpacing == rhs.wordSpacing
+            && lhs.text == rhs.text
+            && lhs.fontKey == rhs.fontKey;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    friend size_t qHash(const CacheKey &key, size_t seed = 0)
+#else
+    friend uint qHash(const CacheKey &key, uint seed = 0)
+#endif
+    {
+        const double fields[] = { static_cast<double>(key.kind),
+                                  key.letterSpacing,
+                                  key.wordSpacing,
+                                  key.width,
+                                  key.height,
+                                  static_cast<double>(key.flags),
+                                  static_cast<double>(key.dpiX),
+                                  static_cast<double>(key.dpiY) };
+        return qHashBits(fields, sizeof(fields), seed) ^ qHash(key.text, seed) ^ qHash(key.fontKey, seed);
+    }
+};
+
+struct CacheEntry {
+    std::shared_ptr<const TextLayoutCache::Layout> layout;
+    QRect rect;
+};
+
+// 度量结果只有 QRect，各线程共享
+struct SharedCache {
+    QMutex mutex;
+    QCache<CacheKey, CacheEntry> entries{kMaxCachedGlyphs};
+};
+
+SharedCache &sharedCache()
+{
+    static SharedCache cache;
+    return cache;
+}
+
+// clear() 递增代数，各线程的排版缓存在下次访问时自行清空
+std::atomic<int> s_layoutGeneration{0};
+
+// 字形串持有的 QRawFont 属于创建它的线程，排版结果按线程缓存，随线程结束释放
+struct ThreadLayoutCache {
+    int generation = 0;
+    QCache<CacheKey, CacheEntry> entries{kMaxCachedGlyphs};
+};
+
+QCache<CacheKey, CacheEntry> &threadLayoutCache()
+{
+    thread_local ThreadLayoutCache cache;
+    const int generation = s_layoutGeneration.load(std::memory_order_acquire);
+    if (cache.generation != generation) {
+        cache.entries.clear();
+        cache.generation = generation;
+    }
+    return cache.entries;
+}
+
+CacheKey makeKey(EntryKind kind, const QString &text, const QFont &font)
+{
+    CacheKey key;
+    key.kind = kind;
+    key.text = text;
+    // QFont::key() 不含字距等排版属性，单独记录
+    key.fontKey = font.key() + QLatin1Char('|') + font.styleName()
+                  + QLatin1Char('|') + QString::number(static_cast<int>(font.capitalization()))
+                  + QLatin1Char('|') + QString::number(static_cast<int>(font.letterSpacingType()))
+                  + QLatin1Char('|') + QString::number(static_cast<int>(font.hintingPreference()));
+    key.letterSpacing = font.letterSpacing();
+    key.wordSpacing = font.wordSpacing();
+    return key;
+}
+
+bool lookup(const CacheKey &key, CacheEntry *entry)
+{
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    if (const CacheEntry *cached = cache.entries.object(key)) {
+        *entry = *cached;
+        return true;
+    }
+    return false;
+}
+
+void store(const CacheKey &key, const CacheEntry &entry, int cost)
+{
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.insert(key, new CacheEntry(entry), std::clamp(cost, 1, kMaxCachedGlyphs));
+}
+
+// 复刻 QPainter::drawText(rect, flags, text) 的排版规则：
+// 行距含 leading，逐行按水平对齐偏移，整块按垂直对齐偏移
+std::shared_ptr<const TextLayoutCache::Layout> buildLayout(const QString &text,
+                                                           const QFont &font,
+                                                           const QSizeF &size,
+                                                           int flags,
+                                                           const QPaintDevice *device)
+{
+    auto result = std::make_shared<TextLayoutCache::Layout>();
+
+    QString laidOutText = text;
+    laidOutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
+
+    QTextLayout textLayout(laidOutText, font, const_cast<QPaintDevice *>(device));
+    QTextOption option;
+    option.setWrapMode((flags & Qt::TextWordWrap) ? QTextOption::WordWrap : QTextOption::ManualWrap);
+    textLayout.setTextOption(option);
+
+    const QFontMetricsF metrics = device ? QFontMetricsF(font, device) : QFontMetricsF(font);
+    const qreal leading = metrics.leading();
+    const qreal lineWidth = (flags & Qt::TextWordWrap) ? std::max<qreal>(0.0, size.width()) : kUnboundedLineWidth;
+
+    qreal height = -leading;
+    qreal blockWidth = 0.0;
+    textLayout.beginLayout();
+    for (QTextLine line = textLayout.createLine(); line.isValid(); line = textLayout.createLine()) {
+        line.setLineWidth(lineWidth);
+        height += leading;
+        line.setPosition(QPointF(0.0, height));
+        height += line.height();
+        blockWidth = std::max(blockWidth, line.naturalTextWidth());
+    }
+    textLayout.endLayout();
+    height = std::max<qreal>(0.0, height);
+
+    qreal yOffset = 0.0;
+    if (flags & Qt::AlignBottom) {
+        yOffset = size.height() - height;
+    } else if (flags & Qt::AlignVCenter) {
+        yOffset = (size.height() - height) / 2.0;
+    }
+
+    qreal blockX = 0.0;
+    if (flags & Qt::AlignRight) {
+        blockX = size.width() - blockWidth;
+    } else if (flags & Qt::AlignHCenter) {
+        blockX = (size.width() - blockWidth) / 2.0;
+    }
+    result->bounds = QRectF(blockX, yOffset, blockWidth, height);
+
+    for (int i = 0; i < textLayout.lineCount(); ++i) {
+        const QTextLine line = textLayout.lineAt(i);
+        const qreal advance = line.horizontalAdvance();
+        qreal xOffset = 0.0;
+        if (flags & Qt::AlignRight) {
+            xOffset = size.width() - advance;
+        } else if (flags & Qt::AlignHCenter) {
+            xOffset = (size.width() - advance) / 2.0;
+        }
+
+        const QPointF offset(xOffset, yOffset);
+        const QList<QGlyphRun> runs = line.glyphRuns();
+        for (QGlyphRun run : runs) {
+            QVector<QPointF> positions = run.positions();
+            for (QPointF &position : positions) {
+                position += offset;
+            }
+            run.setPositions(positions);
+            result->glyphCount += positions.size();
+            result->glyphRuns.append(run);
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+std::shared_ptr<const TextLayoutCache::Layout> TextLayoutCache::layout(const QString &text,
+                                                                       const QFont &font,
+                                                                       const QSizeF &size,
+                                                                       int flags,
+                                                                       const QPaintDevice *device)
+{
+    CacheKey key = makeKey(EntryKind::Layout, text, font);
+    key.width = size.width();
+    key.height = size.height();
+    key.flags = flags;
+    key.dpiX = device ? device->logicalDpiX() : 0;
+    key.dpiY = device ? device->logicalDpiY() : 0;
+
+    QCache<CacheKey, CacheEntry> &cache = threadLayoutCache();
+    if (const CacheEntry *cached = cache.object(key)) {
+        return cached->layout;
+    }
+
+    auto entry = std::make_unique<CacheEntry>();
+    entry->layout = buildLayout(text, font, size, flags, device);
+    std::shared_ptr<const Layout> result = entry->layout;
+    cache.insert(key, entry.release(), std::clamp(result->glyphCount + 1, 1, kMaxCachedGlyphs));
+    return result;
+}
+
+void TextLayoutCache::drawText(QPainter *painter, const QRectF &rect, int flags, const QString &text)
+{
+    if (!painter || text.isEmpty() || !rect.isValid()) {
+        return;
+    }
+
+    const std::shared_ptr<const Layout> cached = layout(text, painter->font(), rect.size(), flags, painter->device());
+
+    // 与 QPainter::drawText 一致：文本块超出区域时才裁剪
+    const bool clip = !(flags & Qt::TextDontClip)
+                      && !QRectF(QPointF(0.0, 0.0), rect.size()).contains(cached->bounds);
+    if (clip) {
+        painter->save();
+        painter->setClipRect(rect, Qt::IntersectClip);
+    }
+
+    for (const QGlyphRun &run : cached->glyphRuns) {
+        painter->drawGlyphRun(rect.topLeft(), run);
+    }
+
+    if (clip) {
+        painter->restore();
+    }
+}
+
+QRect TextLayoutCache::boundingRect(const QFont &font, const QString &text)
+{
+    const CacheKey key = makeKey(EntryKind::SingleLineMetrics, text, font);
+
+    CacheEntry entry;
+    if (lookup(key, &entry)) {
+        return entry.rect;
+    }
+
+    entry.rect = QFontMetrics(font).boundingRect(text);
+    store(key, entry, 1);
+    return entry.rect;
+}
+
+QRect TextLayoutCache::boundingRect(const QFont &font, const QRect &rect, int flags, const QString &text)
+{
+    CacheKey key = makeKey(EntryKind::RectMetrics, text, font);
+    key.width = rect.width();
+    key.height = rect.height();
+    key.flags = flags;
+
+    CacheEntry entry;
+    if (lookup(key, &entry)) {
+        return entry.rect.translated(rect.topLeft());
+    }
+
+    entry.rect = QFontMetrics(font).boundingRect(QRect(QPoint(0, 0), rect.size()), flags, text);
+    store(key, entry, 1);
+    return entry.rect.translated(rect.topLeft());
+}
+
+void TextLayoutCache::clear()
+{
+    s_layoutGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+    SharedCache &cache = sharedCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.clear();
+}
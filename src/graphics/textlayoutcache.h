@@ -0,0 +1,51 @@
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <QFont>
+#include <QGlyphRun>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class QPainter;
+class QPaintDevice;
+
+/**
+ * @brief 文本排版缓存
+ *
+ * 以（文本、字体、字距、排版区域、换行与对齐标志、设备 DPI）为键缓存整形后的字形串，
+ * 同一线程的文本项与批量记录共享。重复的字段值或同一缩放下的重绘不再重新整形。
+ * 绘制结果与 QPainter::drawText(rect, flags, text) 一致。
+ * 字形串中的 QRawFont 属于排版所在的线程，因此排版结果按线程分别缓存，
+ * layout() 返回的结果只能在调用线程中绘制；度量结果（boundingRect）各线程共享。
+ */
+class TextLayoutCache
+{
+public:
+    struct Layout {
+        QVector<QGlyphRun> glyphRuns;   // 字形位置相对排版区域左上角
+        QRectF bounds;                  // 文本块在排版区域中的位置
+        int glyphCount = 0;
+    };
+
+    // 取得当前线程的排版结果（未命中时排版并写入当前线程的缓存）
+    static std::shared_ptr<const Layout> layout(const QString &text,
+                                                const QFont &font,
+                                                const QSizeF &size,
+                                                int flags,
+                                                const QPaintDevice *device);
+
+    // 代替 QPainter::drawText(rect, flags, text)，使用 painter 当前的字体与画笔
+    static void drawText(QPainter *painter, const QRectF &rect, int flags, const QString &text);
+
+    // 带缓存的 QFontMetrics::boundingRect（屏幕 DPI），用于自动调整尺寸
+    static QRect boundingRect(const QFont &font, const QString &text);
+    static QRect boundingRect(const QFont &font, const QRect &rect, int flags, const QString &text);
+
+    static void clear();
+};
+
+#endif // TEXTLAYOUTCACHE_H
@@ -43,6 +43,12 @@
 #include <QJsonObject>
 #include "core/barcodeelement.h"
 #include "core/imageelement.h"
+#include "core/imagestore.h"
+#include "core/labeldocumentfile.h"
+#include "core/documentwriter.h"
+#include "core/documentjournal.h"
+#include "core/documentloader.h"
+#include "core/elementregistry.h"
 #include "core/datasource.h"
 #include "core/qrcodeelement.h"
 #include "core/textelement.h"
@@ -54,7 +60,7 @@
 #include "core/polygonelement.h"
 #include "core/tableelement.h"
 #include "printing/printengine.h"
-#include "printing/defaultprintrenderer.h"
+#include "printing/elementmodelrenderer.h"
 #include "printing/printcontext.h"
 #include "printing/batchprintmanager.h"
 #include "panels/labelpropswidget.h"
@@ -109,8 +115,34 @@ MainWindow::MainWindow(QWidget *parent)
     createToolbars();
     createStatusBar();
     setInitialStyles();
+    registerPropertyPanels();
     connectSignals();
 
+    // 后台保存；未保存的修改定期写入崩溃恢复日志
+    m_documentWriter = new DocumentWriter(this);
+    connect(m_documentWriter, &DocumentWriter::saveFinished,
+            this, &MainWindow::onDocumentSaveFinished);
+    m_journal = std::make_unique<DocumentJournal>(m_documentWriter);
+    // 打开文档时解析、解码与创建元素在后台进行
+    m_documentLoader = new DocumentLoader(this);
+    connect(m_documentLoader, &DocumentLoader::loadFinished,
+            this, &MainWindow::onDocumentLoaded);
+    m_journalTimer = new QTimer(this);
+    m_journalTimer->setInterval(5000);
+    connect(m_journalTimer, &QTimer::timeout, this, &MainWindow::updateRecoveryJournal);
+    // 重绘区域触及的元素可能已修改，下次写日志时重新序列化
+    connect(scene, &QGraphicsScene::changed, this, [this](const QList<QRectF> &region) {
+        for (const QRectF &rect : region) {
+            const QList<QGraphicsItem*> touched
+                = scene->items(rect.adjusted(-1, -1, 1, 1), Qt::IntersectsItemBoundingRect);
+            for (QGraphicsItem *item : touched) {
+                m_journalDirtyItems.insert(item);
+            }
+        }
+    });
+    m_journalTimer->start();
+    QTimer::singleShot(0, this, &MainWindow::recoverFromJournal);
+
     // 读取上次的窗口设置
     //readSettings();
 }
@@ -125,14 +157,7 @@ void MainWindow::insertTable()
     QSizeF labelSize(300, 200); // fallback 默认值
     QRectF bgRect;
     {
-        QGraphicsPathItem *labelItem = nullptr;
-        const QList<QGraphicsItem*> existingItems = scene->items(Qt::AscendingOrder);
-        for (QGraphicsItem *it : existingItems) {
-            if (it && it->data(0).toString() == "labelBackground") {
-                labelItem = qgraphicsitem_cast<QGraphicsPathItem*>(it);
-                break;
-            }
-        }
+        QGraphicsPathItem *labelItem = m_labelBackground;
         if (labelItem) {
             bgRect = labelItem->sceneBoundingRect();
             labelSize = bgRect.size();
@@ -174,6 +199,14 @@ void MainWindow::closeEvent(QCloseEvent *event)
         event->ignore();
         return;
     }
+    // 等待后台保存完成；保存失败时不关闭，错误随后提示
+    if (!m_documentWriter->waitForDone()) {
+        event->ignore();
+        return;
+    }
+    m_documentLoader->cancel();
+    m_journal->discard();
+    m_documentWriter->waitForDone();
     //writeSettings();
     event->accept();
 }
@@ -216,30 +249,12 @@ void MainWindow::newFile()
         // 关键修复：新建开始时清空当前文件路径，避免后续保存覆盖旧文件
         currentFile.clear();
         if (dialog.isTemplateSelected()) {
-            // 用户选择了模板，直接加载模板文件
-            QString templatePath = dialog.selectedTemplatePath();
-            
-            if (loadFile(templatePath)) {
-                // 模板加载后清除当前文件路径，强制另存为
-                m_templateSourcePath = templatePath;
-                currentFile.clear();
-                setWindowTitle(tr("SimpleLabel - 未命名"));
-                isModified = false;
-                if (undoManager) {
-                    undoManager->setClean();
-                }
-            } else {
-                // 加载失败，创建默认标签
-                widthLineEdit->setText(QString::number(100));
-                heightLineEdit->setText(QString::number(75));
-                paperSizeComboBox->setCurrentText(tr("自定义尺寸"));
-                updateLabelSize();
-                setWindowTitle(tr("SimpleLabel - 未命名"));
-                m_templateSourcePath.clear();
-                // 确保清空当前文件路径
-                currentFile.clear();
-            }
+            // 用户选择了模板，在后台加载模板文件，完成后见 onDocumentLoaded
+            loadFile(dialog.selectedTemplatePath(), true);
         } else {
+            // 放弃尚未完成的打开
+            m_documentLoader->cancel();
+            statusBar()->clearMessage();
             // 用户选择创建空白标签
             widthLineEdit->setText(QString::number(dialog.labelWidth()));
             heightLineEdit->setText(QString::number(dialog.labelHeight()));
@@ -262,6 +277,7 @@ void MainWindow::newFile()
         if (undoManager) {
             undoManager->setClean();
         }
+        m_journal->discard();
     }
 }
 
@@ -270,7 +286,7 @@ void MainWindow::openFile()
     if (maybeSave()) {
         QString fileName = QFileDialog::getOpenFileName(this,
             tr("打开标签文件"), "",
-            tr("标签文件 (*.lbl);;所有文件 (*)"));
+            tr("标签文件 (*.lbl *.json);;所有文件 (*)"));
 
         if (!fileName.isEmpty()) {
             loadFile(fileName);
@@ -284,17 +300,21 @@ void MainWindow::clearScene()
         return;
     }
 
+    // 逐项从 BSP 索引中移除较慢，清空期间暂停索引
+    const QGraphicsScene::ItemIndexMethod indexMethod = scene->itemIndexMethod();
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
     QGraphicsItem* selectionFrame = scene->selectionFrame();
     foreach (QGraphicsItem* item, scene->items()) {
         if (!item || item == selectionFrame) {
             continue;
         }
         // 不删除背景
-        if (item->data(0).toString() != "labelBackground") {
+        if (item != m_labelBackground) {
             scene->removeItem(item);
             delete item;
         }
     }
+    scene->setItemIndexMethod(indexMethod);
 
     // 清空撤销栈，避免后续撤销操作访问已删除的对象
     if (undoManager) {
@@ -302,30 +322,75 @@ void MainWindow::clearScene()
     }
 
     m_itemDataSources.clear();
+    m_journalItems.clear();
+    m_journalDirtyItems.clear();
 }
 
-bool MainWindow::loadFile(const QString &fileName)
+void MainWindow::loadFile(const QString &fileName, bool asTemplate)
 {
+    // 同一文件可能仍在后台保存
+    m_documentWriter->waitForDone();
+
+    m_loadingTemplate = asTemplate;
+    statusBar()->showMessage(tr("正在打开 %1…").arg(QFileInfo(fileName).fileName()));
+    m_documentLoader->load(fileName);
+}
+
+void MainWindow::onDocumentLoaded(const QString &fileName,
+                                  std::shared_ptr<DocumentLoader::Document> document,
+                                  const QString &errorMessage)
+{
+    statusBar()->clearMessage();
+    const bool asTemplate = m_loadingTemplate;
+    m_loadingTemplate = false;
     m_templateSourcePath.clear();
 
-    QFile file(fileName);
-    if (!file.open(QFile::ReadOnly | QFile::Text)) {
-    QMessageBox::warning(this, tr("SimpleLabel"),
-                            tr("无法读取文件 %1:\n%2.")
-                            .arg(QDir::toNativeSeparators(fileName),
-                                file.errorString()));
-        return false;
+    if (!document) {
+        if (asTemplate) {
+            // 模板加载失败，创建默认标签
+            widthLineEdit->setText(QString::number(100));
+            heightLineEdit->setText(QString::number(75));
+            paperSizeComboBox->setCurrentText(tr("自定义尺寸"));
+            updateLabelSize();
+            setWindowTitle(tr("SimpleLabel - 未命名"));
+            // 确保清空当前文件路径
+            currentFile.clear();
+        } else {
+            QMessageBox::warning(this, tr("SimpleLabel"),
+                                 tr("无法读取文件 %1:\n%2.")
+                                 .arg(QDir::toNativeSeparators(fileName),
+                                      errorMessage));
+        }
+        return;
     }
 
-    QByteArray fileData = file.readAll();
-    QJsonDocument document = QJsonDocument::fromJson(fileData);
-    QJsonObject rootObject = document.object();
+    loadDocument(*document);
+    m_journal->discard();
 
+    if (asTemplate) {
+        // 模板加载后清除当前文件路径，强制另存为
+        m_templateSourcePath = fileName;
+        currentFile.clear();
+        setWindowTitle(tr("SimpleLabel - 未命名"));
+    } else {
+        currentFile = fileName;
+        setWindowTitle(tr("SimpleLabel - %1").arg(QFileInfo(currentFile).fileName()));
+    }
+    isModified = false;
+
+    // 设置撤销管理器的clean状态
+    if (undoManager) {
+        undoManager->setClean();
+    }
+}
+
+void MainWindow::loadDocument(DocumentLoader::Document &document)
+{
     // 清除当前场景
     clearScene();
 
     // 读取标签尺寸信息
-    QJsonObject labelInfo = rootObject["labelInfo"].toObject();
+    QJsonObject labelInfo = document.root["labelInfo"].toObject();
     double width = labelInfo["width"].toDouble();
     double height = labelInfo["height"].toDouble();
 
@@ -333,46 +398,32 @@ bool MainWindow::loadFile(const QString &fileName)
     heightLineEdit->setText(QString::number(height));
     updateLabelSize();
 
-    // 加载所有元素
-    QJsonArray itemsArray = rootObject["items"].toArray();
-    for (const auto &itemValue : itemsArray) {
-        QJsonObject itemObject = itemValue.toObject();
-
-        // 使用工厂方法从JSON创建元素
-        auto element = labelelement::createFromJson(itemObject);
-        if (element) {
-            // 将元素添加到场景
-            element->addToScene(scene);
-
-            // 从JSON获取位置并设置
-            QPointF pos(itemObject["x"].toDouble(), itemObject["y"].toDouble());
-            element->setPos(pos);
-
-            if (element->hasDataSource()) {
-                if (QGraphicsItem* addedItem = element->getItem()) {
-                    DataSourceBinding binding;
-                    binding.source = element->dataSource();
-                    binding.enabled = element->isDataSourceEnabled();
-                    if (binding.source) {
-                        m_itemDataSources.insert(addedItem, binding);
-                    }
-                }
+    // 元素已在后台创建（图像已解码），这里只创建图形项，不在场景中时设置位置，
+    // 最后一次性加入场景
+    QList<QGraphicsItem*> items;
+    items.reserve(static_cast<int>(document.elements.size()));
+    for (DocumentLoader::Element &entry : document.elements) {
+        labelelement *element = entry.element.get();
+        QGraphicsItem *item = element->ensureItem();
+        if (!item) {
+            continue;
+        }
+        element->setPos(entry.pos);
+        items.append(item);
+
+        if (element->hasDataSource()) {
+            DataSourceBinding binding;
+            binding.source = element->dataSource();
+            binding.enabled = element->isDataSourceEnabled();
+            if (binding.source) {
+                m_itemDataSources.insert(item, binding);
             }
         }
     }
+    scene->addLabelItems(items);
 
     m_originalLabelWidthMM = width;
     m_originalLabelHeightMM = height;
-    currentFile = fileName;
-    setWindowTitle(tr("SimpleLabel - %1").arg(QFileInfo(currentFile).fileName()));
-    isModified = false;
-    
-    // 设置撤销管理器的clean状态
-    if (undoManager) {
-        undoManager->setClean();
-    }
-
-    return true;
 }
 
 bool MainWindow::saveFile()
@@ -399,7 +450,7 @@ bool MainWindow::saveFileAs()
 
     QString fileName = QFileDialog::getSaveFileName(this,
         tr("保存标签文件"), defaultPath,
-        tr("标签文件 (*.lbl);;所有文件 (*)"));
+        tr("标签文件 (*.lbl);;JSON 标签文件 (*.json);;所有文件 (*)"));
 
     if (fileName.isEmpty())
         return false;
@@ -409,22 +460,73 @@ bool MainWindow::saveFileAs()
 
 bool MainWindow::saveFile(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!file.open(QFile::WriteOnly | QFile::Text)) {
-    QMessageBox::warning(this, tr("SimpleLabel"),
-                           tr("无法写入文件 %1:\n%2.")
-                           .arg(QDir::toNativeSeparators(fileName),
-                               file.errorString()));
-        return false;
-    }
-
-    QJsonObject rootObject;
+    QJsonObject rootObject = documentProperties();
 
     // 保存文档基本信息
-    rootObject["version"] = "1.0";
     rootObject["createTime"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     rootObject["lastModified"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
+    // 保存所有图形项
+    QJsonArray itemsArray;
+    ImageStore images;
+    const QList<QGraphicsItem*> orderedItems = scene->items(Qt::AscendingOrder);
+    for (QGraphicsItem *item : orderedItems) {
+        // 背景、选择框等不是元素，serializeItem 返回空对象
+        const QJsonObject itemObject = serializeItem(item, &images);
+        if (!itemObject.isEmpty()) {
+            itemsArray.append(itemObject);
+        }
+    }
+    rootObject["items"] = itemsArray;
+
+    // 相同图像只存一份；保存到模板目录时放入共享素材目录，文档中只留引用
+    LabelDocumentFile::WriteOptions options;
+    options.format = LabelDocumentFile::formatForFileName(fileName);
+    options.useSharedAssets = ImageStore::usesSharedAssets(fileName);
+    options.thumbnail = renderDocumentThumbnail();
+
+    // 序列化与写盘在后台进行，此时的快照即为保存内容；
+    // 写入失败时在 onDocumentSaveFinished 中恢复修改状态
+    m_documentWriter->save(fileName, rootObject, images, options);
+    m_journal->discard();
+
+    currentFile = fileName;
+    m_templateSourcePath.clear();
+    setWindowTitle(tr("SimpleLabel - %1").arg(QFileInfo(currentFile).fileName()));
+    isModified = false;
+    
+    // 设置撤销管理器的clean状态
+    if (undoManager) {
+        undoManager->setClean();
+    }
+
+    return true;
+}
+
+void MainWindow::onDocumentSaveFinished(const QString &fileName, bool ok, const QString &errorMessage)
+{
+    if (ok) {
+        return;
+    }
+
+    // 文档仍未保存：恢复修改状态，恢复日志在下次定时更新时重新写入
+    if (fileName == currentFile) {
+        isModified = true;
+        if (undoManager) {
+            undoManager->undoStack()->resetClean();
+        }
+    }
+    QMessageBox::warning(this, tr("SimpleLabel"),
+                         tr("无法写入文件 %1:\n%2.")
+                         .arg(QDir::toNativeSeparators(fileName),
+                              errorMessage));
+}
+
+QJsonObject MainWindow::documentProperties() const
+{
+    QJsonObject rootObject;
+    rootObject["version"] = "1.1";
+
     // 保存标签尺寸信息
     QJsonObject labelInfo;
     labelInfo["width"] = widthLineEdit->text().toDouble();
@@ -435,105 +537,122 @@ bool MainWindow::saveFile(const QString &fileName)
     QJsonObject sceneProperties;
     sceneProperties["width"] = scene->width();
     sceneProperties["height"] = scene->height();
-    rootObject["sceneProperties"] = sceneProperties;    // 保存所有图形项
-    QJsonArray itemsArray;
-    auto applyBindingToElement = [this](labelelement& element, QGraphicsItem* itemPtr) {
-        auto it = m_itemDataSources.constFind(itemPtr);
-        if (it != m_itemDataSources.constEnd() && it.value().source) {
-            element.setDataSource(it.value().source);
-            element.setDataSourceEnabled(it.value().enabled);
-        }
-    };
+    rootObject["sceneProperties"] = sceneProperties;
+    return rootObject;
+}
+
+QJsonObject MainWindow::serializeItem(QGraphicsItem *item, ImageStore *images) const
+{
+    // 按图形项类型查注册表包装为元素，由元素生成 JSON；背景、选择框等返回空对象
+    auto element = ElementRegistry::instance().wrap(item);
+    if (!element) {
+        return QJsonObject();
+    }
+
+    auto it = m_itemDataSources.constFind(item);
+    if (it != m_itemDataSources.constEnd() && it.value().source) {
+        element->setDataSource(it.value().source);
+        element->setDataSourceEnabled(it.value().enabled);
+    }
+    element->setImageStore(images);
+    return element->toJson();
+}
+
+bool MainWindow::isDocumentModified() const
+{
+    return isModified || (undoManager && !undoManager->isClean());
+}
+
+namespace {
+
+// 日志标识存放在图形项自身的 data() 中，不随地址复用转移到新建的图形项
+constexpr int kJournalIdKey = 1;
+
+} // namespace
+
+void MainWindow::updateRecoveryJournal()
+{
+    if (!scene || !isDocumentModified()) {
+        m_journal->discard();
+        return;
+    }
+
+    // 自上次更新以来没有重绘、撤销位置与文档属性均未变化时跳过本次
+    const QJsonObject document = documentProperties();
+    const int undoIndex = undoManager ? undoManager->undoStack()->index() : -1;
+    const bool snapshot = m_journal->needsSnapshot(currentFile);
+    if (!snapshot && m_journalDirtyItems.isEmpty() && undoIndex == m_journalUndoIndex
+        && document == m_journalDocument) {
+        return;
+    }
+
+    // 只重新序列化被触及的元素，其余沿用上次的 JSON；写快照时全部重新序列化以收齐图像
+    QVector<DocumentJournal::Entry> entries;
+    ImageStore images;
+    QHash<quint64, QJsonObject> journalItems;
     const QList<QGraphicsItem*> orderedItems = scene->items(Qt::AscendingOrder);
-    QGraphicsItem* selectionFrame = scene->selectionFrame();
     for (QGraphicsItem *item : orderedItems) {
-        if (!item || item == selectionFrame) {
+        quint64 id = item->data(kJournalIdKey).toULongLong();
+        const auto cached = m_journalItems.constFind(id);
+        const bool changed = snapshot || cached == m_journalItems.constEnd()
+                             || m_journalDirtyItems.contains(item);
+        const QJsonObject itemObject = changed ? serializeItem(item, &images) : cached.value();
+        if (itemObject.isEmpty()) {
             continue;
         }
-        // 跳过背景标签项
-        if (item->data(0).toString() == "labelBackground") {
-            continue;
+        if (id == 0) {
+            id = m_nextJournalId++;
+            item->setData(kJournalIdKey, id);
         }
+        journalItems.insert(id, itemObject);
+        entries.append({ id, itemObject, changed });
+    }
+    m_journalItems.swap(journalItems);
+    m_journalDirtyItems.clear();
+    m_journalUndoIndex = undoIndex;
+    m_journalDocument = document;
+    m_journal->update(currentFile, document, entries, images);
+}
 
-        // 处理二维码项
-        if (auto qrItem = dynamic_cast<QRCodeItem*>(item)) {
-            QRCodeElement element(qrItem);
-            applyBindingToElement(element, qrItem);
-            // 使用 labelelement 的 toJson 方法获取完整的 JSON 对象
-            itemsArray.append(element.toJson());
-        }        // 处理条形码项
-        else if (auto barcodeItem = dynamic_cast<BarcodeItem*>(item)) {
-            BarcodeElement element(barcodeItem);
-            applyBindingToElement(element, barcodeItem);
-            // 使用 labelelement 的 toJson 方法获取完整的 JSON 对象
-            itemsArray.append(element.toJson());
-        }
-        // 处理文本项
-        else if (auto textItem = dynamic_cast<TextItem*>(item)) {
-            TextElement element(textItem);
-            applyBindingToElement(element, textItem);
-            // 使用 labelelement 的 toJson 方法获取完整的 JSON 对象
-            itemsArray.append(element.toJson());
-        }
-        // 处理图像项
-        else if (auto imageItem = dynamic_cast<ImageItem*>(item)) {
-            ImageElement element(imageItem);
-            // 使用 labelelement 的 toJson 方法获取完整的 JSON 对象
-            itemsArray.append(element.toJson());
-        }
-        else if (auto lineItem = dynamic_cast<LineItem*>(item)) {
-            LineElement element(lineItem);
-            applyBindingToElement(element, lineItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto rectangleItem = dynamic_cast<RectangleItem*>(item)) {
-            RectangleElement element(rectangleItem);
-            applyBindingToElement(element, rectangleItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
-            CircleElement element(circleItem);
-            applyBindingToElement(element, circleItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto starItem = dynamic_cast<StarItem*>(item)) {
-            StarElement element(starItem);
-            applyBindingToElement(element, starItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto arrowItem = dynamic_cast<ArrowItem*>(item)) {
-            ArrowElement element(arrowItem);
-            applyBindingToElement(element, arrowItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
-            PolygonElement element(polyItem);
-            applyBindingToElement(element, polyItem);
-            itemsArray.append(element.toJson());
-        }
-        else if (auto tableItem = dynamic_cast<TableItem*>(item)) {
-            TableElement element(tableItem);
-            itemsArray.append(element.toJson());
+void MainWindow::recoverFromJournal()
+{
+    const QStringList journals = DocumentJournal::pendingJournals();
+    for (const QString &journalPath : journals) {
+        QString documentPath;
+        QJsonObject rootObject;
+        DocumentLoader::Document document;
+        if (!DocumentJournal::recover(journalPath, &documentPath, &rootObject, &document.images)) {
+            DocumentJournal::removeJournal(journalPath);
+            continue;
         }
-        // 后续可以添加其他类型的元素处理
-    }
-    rootObject["items"] = itemsArray;
 
-    // 将JSON对象写入文件
-    QJsonDocument document(rootObject);
-    file.write(document.toJson(QJsonDocument::Indented));
+        const QString name = documentPath.isEmpty() ? tr("未命名")
+                                                    : QDir::toNativeSeparators(documentPath);
+        const QMessageBox::StandardButton ret
+            = QMessageBox::question(this, tr("SimpleLabel"),
+                                    tr("程序上次意外退出，发现未保存的文档：\n%1\n\n是否恢复？").arg(name),
+                                    QMessageBox::Yes | QMessageBox::No);
+        DocumentJournal::removeJournal(journalPath);
+        if (ret != QMessageBox::Yes) {
+            continue;
+        }
 
-    currentFile = fileName;
-    m_templateSourcePath.clear();
-    setWindowTitle(tr("SimpleLabel - %1").arg(QFileInfo(currentFile).fileName()));
-    isModified = false;
-    
-    // 设置撤销管理器的clean状态
-    if (undoManager) {
-        undoManager->setClean();
+        // 恢复的内容尚未保存：保留原路径，标记为已修改，随即写入本会话的日志
+        m_documentLoader->cancel();
+        DocumentLoader::build(rootObject, &document);
+        loadDocument(document);
+        m_templateSourcePath.clear();
+        currentFile = documentPath;
+        setWindowTitle(tr("SimpleLabel - %1").arg(documentPath.isEmpty() ? tr("未命名")
+                                                                       : QFileInfo(documentPath).fileName()));
+        isModified = true;
+        if (undoManager) {
+            undoManager->undoStack()->resetClean();
+        }
+        updateRecoveryJournal();
+        // 一个窗口只恢复一个文档，其余的留到下次启动
+        break;
     }
-
-    return true;
 }
 
 void MainWindow::openPrintCenter()
@@ -577,6 +696,14 @@ void MainWindow::openPrintCenter()
                     statusBar()->showMessage(tr("正在打印第 %1 条记录").arg(index + 1), 1000);
                 }
             });
+            connect(m_batchPrintManager.get(), &BatchPrintManager::recordVerified, this,
+                    [this](int index, bool passed, const QStringList &missing) {
+                if (!passed && statusBar()) {
+                    statusBar()->showMessage(tr("第 %1 条记录的条码回读失败：%2")
+                                                 .arg(index + 1)
+                                                 .arg(missing.join(QStringLiteral(", "))), 5000);
+                }
+            });
         } else {
             m_batchPrintManager->setEngine(m_printEngine.get());
         }
@@ -1327,6 +1454,19 @@ void MainWindow::createDockWindows()
     imageLayout->addRow(keepAspectRatioCheck);
     imageLayout->addRow(tr("透明度:"), imageOpacitySpin);
 
+    // 绑定数据源时，取值为图像文件路径或键名（相对下面的目录，可省略扩展名）
+    recordImageDirEdit = new QLineEdit();
+    recordImageDirEdit->setPlaceholderText(tr("默认使用共享素材目录"));
+    recordImageDirButton = new QPushButton(tr("浏览..."));
+    QHBoxLayout *recordImageDirLayout = new QHBoxLayout();
+    recordImageDirLayout->setContentsMargins(0, 0, 0, 0);
+    recordImageDirLayout->addWidget(recordImageDirEdit, 1);
+    recordImageDirLayout->addWidget(recordImageDirButton);
+    imageLayout->addRow(tr("图片目录:"), recordImageDirLayout);
+
+    imageDatabaseWidget = new DatabasePrintWidget(imageGroup);
+    imageLayout->addRow(imageDatabaseWidget);
+
     // 绘图工具设置组
     drawingGroup = new QGroupBox(tr("绘图设置"));
     QFormLayout *drawingLayout = new QFormLayout(drawingGroup);
@@ -1641,6 +1781,12 @@ void MainWindow::connectSignals()
     connect(textDatabaseWidget, &DatabasePrintWidget::dataSourceEnabledChanged,
         this, &MainWindow::handleTextDataSourceEnabledChanged);
     }
+    if (imageDatabaseWidget) {
+    connect(imageDatabaseWidget, &DatabasePrintWidget::applyRequested,
+        this, &MainWindow::applyImageDataSource);
+    connect(imageDatabaseWidget, &DatabasePrintWidget::dataSourceEnabledChanged,
+        this, &MainWindow::handleImageDataSourceEnabledChanged);
+    }
     
     // 连接文本双击编辑信号
     connect(scene, &LabelScene::textItemDoubleClicked,
@@ -1712,14 +1858,7 @@ void MainWindow::updateLabelSize()
     double labelHeight = height * MM_TO_PIXELS;
 
     // 查找或创建标签背景
-    QGraphicsPathItem *labelItem = nullptr;
-    const QList<QGraphicsItem*> existingItems = scene->items(Qt::AscendingOrder);
-    for (QGraphicsItem *item : existingItems) {
-        if (item && item->data(0).toString() == "labelBackground") {
-            labelItem = qgraphicsitem_cast<QGraphicsPathItem*>(item);
-            break;
-        }
-    }
+    QGraphicsPathItem *labelItem = m_labelBackground;
 
     int cornerPx = 0;
     if (labelCornerRadiusSpin) {
@@ -1744,6 +1883,7 @@ void MainWindow::updateLabelSize()
         labelItem->setZValue(-1000);
         labelItem->setData(0, "labelBackground");
         scene->addItem(labelItem);
+        m_labelBackground = labelItem;
     } else {
         labelItem->setPath(path);
         labelItem->setBrush(Qt::white);
@@ -1835,28 +1975,50 @@ void MainWindow::updateCodeTypeComboBox(bool isQRCode)
     }
 }
 
+void MainWindow::registerPropertyPanels()
+{
+    // 未登记的类型（如表格）显示绘图设置组
+    m_propertyPanels.insert(BarcodeItem::Type, &MainWindow::showBarcodeProperties);
+    m_propertyPanels.insert(QRCodeItem::Type, &MainWindow::showQRCodeProperties);
+    m_propertyPanels.insert(TextItem::Type, &MainWindow::showTextProperties);
+    m_propertyPanels.insert(ImageItem::Type, &MainWindow::showImageProperties);
+}
+
+void MainWindow::showPropertyGroup(QGroupBox *group)
+{
+    // 全局标签组始终显示，其余类型组只显示 group
+    labelSizeGroup->setVisible(true);
+    codeGroup->setVisible(group == codeGroup);
+    textGroup->setVisible(group == textGroup);
+    imageGroup->setVisible(group == imageGroup);
+    drawingGroup->setVisible(group == drawingGroup);
+
+    // 停用不属于 group 的数据源面板
+    const std::pair<QGroupBox*, DatabasePrintWidget*> databaseWidgets[] = {
+        { codeGroup, codeDatabaseWidget },
+        { textGroup, textDatabaseWidget },
+        { imageGroup, imageDatabaseWidget }
+    };
+    for (const auto &entry : databaseWidgets) {
+        DatabasePrintWidget *widget = entry.second;
+        if (!widget) {
+            continue;
+        }
+        widget->setEnabled(entry.first == group);
+        if (entry.first != group) {
+            widget->clearInputs();
+            widget->setDataSourceEnabled(false);
+        }
+    }
+}
+
 void MainWindow::updateSelectedItemProperties()
 {
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
     if (selectedItems.isEmpty()) {
-    // 仅显示全局标签组，隐藏其他类型组
-    labelSizeGroup->setVisible(true);
-    codeGroup->setVisible(false);
-    textGroup->setVisible(false);
-    imageGroup->setVisible(false);
-    drawingGroup->setVisible(false);
+        // 仅显示全局标签组，隐藏其他类型组
+        showPropertyGroup(nullptr);
 
-        if (codeDatabaseWidget) {
-            codeDatabaseWidget->setEnabled(false);
-            codeDatabaseWidget->clearInputs();
-            codeDatabaseWidget->setDataSourceEnabled(false);
-        }
-        if (textDatabaseWidget) {
-            textDatabaseWidget->setEnabled(false);
-            textDatabaseWidget->clearInputs();
-            textDatabaseWidget->setDataSourceEnabled(false);
-        }
-        
         // 恢复码类下拉框为完整列表
         QSignalBlocker blocker(codeTypeComboBox);
         codeTypeComboBox->clear();
@@ -1874,278 +2036,228 @@ void MainWindow::updateSelectedItemProperties()
         return;
     }
 
-    // 获取选中项
+    // 获取选中项，按类型标识查表
     QGraphicsItem* item = selectedItems.first();
+    const PropertyPanelHandler handler =
+        m_propertyPanels.value(item->type(), &MainWindow::showDrawingProperties);
+    (this->*handler)(item);
+}
+
+void MainWindow::showBarcodeProperties(QGraphicsItem *item)
+{
+    BarcodeItem* barcodeItem = static_cast<BarcodeItem*>(item);
 
-    // 处理条形码项
-    BarcodeItem* barcodeItem = dynamic_cast<BarcodeItem*>(item);
-    if (barcodeItem) {
     // 显示码类组，隐藏其它类型组
-    labelSizeGroup->setVisible(true);
-    codeGroup->setVisible(true);
-    textGroup->setVisible(false);
-    imageGroup->setVisible(false);
-    drawingGroup->setVisible(false);
+    showPropertyGroup(codeGroup);
+    if (codeDatabaseWidget) {
+        syncCodeDataSourceWidget(barcodeItem);
+    }
 
-        if (codeDatabaseWidget) {
-            codeDatabaseWidget->setEnabled(true);
-            syncCodeDataSourceWidget(barcodeItem);
-        }
-        if (textDatabaseWidget) {
-            textDatabaseWidget->setEnabled(false);
-            textDatabaseWidget->clearInputs();
-            textDatabaseWidget->setDataSourceEnabled(false);
-        }
+    // 更新码类下拉框为条形码类型
+    updateCodeTypeComboBox(false); // false表示条形码
 
-        // 更新码类下拉框为条形码类型
-        updateCodeTypeComboBox(false); // false表示条形码
-
-        // 阻断信号更新以避免循环触发
-        QSignalBlocker blockType(codeTypeComboBox);
-        QSignalBlocker blockData(codeDataEdit);
-        QSignalBlocker blockWidth(codeWidthSpin);
-        QSignalBlocker blockHeight(codeHeightSpin);
-
-        // 设置条形码类型
-        int typeIndex = 0; // 默认 CODE_128
-        ZXing::BarcodeFormat format = barcodeItem->format();
-        if (format == ZXing::BarcodeFormat::Code128) typeIndex = 0;
-        else if (format == ZXing::BarcodeFormat::EAN13) typeIndex = 1;
-        else if (format == ZXing::BarcodeFormat::UPCA) typeIndex = 2;
-        else if (format == ZXing::BarcodeFormat::Code39) typeIndex = 3;
-        codeTypeComboBox->setCurrentIndex(typeIndex);
-
-        // 设置条形码数据
-        codeDataEdit->setText(barcodeItem->data());
-
-        // 设置条形码尺寸
-        codeWidthSpin->setValue(barcodeItem->size().width());
-        codeHeightSpin->setValue(barcodeItem->size().height());        // 显示显示文本选项（条形码支持）
-        if (showBarcodeTextCheck) {
-            showBarcodeTextCheck->setVisible(true);
-            QSignalBlocker blockShowText(showBarcodeTextCheck);
-            showBarcodeTextCheck->setChecked(barcodeItem->showHumanReadableText());
-        }
-    } 
-    // 处理二维码项
-    else {
-        QRCodeItem* qrCodeItem = dynamic_cast<QRCodeItem*>(item);
-        if (qrCodeItem) {
-            // 显示码类组，隐藏其它类型组
-            labelSizeGroup->setVisible(true);
-            codeGroup->setVisible(true);
-            textGroup->setVisible(false);
-            imageGroup->setVisible(false);
-            drawingGroup->setVisible(false);
-
-            if (codeDatabaseWidget) {
-                codeDatabaseWidget->setEnabled(true);
-                syncCodeDataSourceWidget(qrCodeItem);
-            }
-            if (textDatabaseWidget) {
-                textDatabaseWidget->setEnabled(false);
-                textDatabaseWidget->clearInputs();
-                textDatabaseWidget->setDataSourceEnabled(false);
-            }
+    // 阻断信号更新以避免循环触发
+    QSignalBlocker blockType(codeTypeComboBox);
+    QSignalBlocker blockData(codeDataEdit);
+    QSignalBlocker blockWidth(codeWidthSpin);
+    QSignalBlocker blockHeight(codeHeightSpin);
 
-            // 更新码类下拉框为二维码类型
-            updateCodeTypeComboBox(true); // true表示二维码
-
-            // 阻断信号更新以避免循环触发
-            QSignalBlocker blockType(codeTypeComboBox);
-            QSignalBlocker blockData(codeDataEdit);
-            QSignalBlocker blockWidth(codeWidthSpin);
-            QSignalBlocker blockHeight(codeHeightSpin);
-
-            // 设置二维码类型
-            int typeIndex = 0; // 默认QR Code
-            QString codeType = qrCodeItem->codeType();
-            if (codeType == "QR") typeIndex = 0;
-            else if (codeType == "PDF417") typeIndex = 1;
-            else if (codeType == "DataMatrix") typeIndex = 2;
-            else if (codeType == "Aztec") typeIndex = 3;
-            codeTypeComboBox->setCurrentIndex(typeIndex);
-
-            // 设置二维码数据
-            codeDataEdit->setText(qrCodeItem->text());
-
-            // 设置二维码尺寸
-            codeWidthSpin->setValue(qrCodeItem->boundingRect().width());
-            codeHeightSpin->setValue(qrCodeItem->boundingRect().height());            // 隐藏显示文本选项（二维码不支持）
-            if (showBarcodeTextCheck) {
-                showBarcodeTextCheck->setVisible(false);
-            }        } else {
-            // 处理文本项
-            TextItem* textItem = dynamic_cast<TextItem*>(item);
-            if (textItem) {
-                // 显示文本组
-                labelSizeGroup->setVisible(true);
-                codeGroup->setVisible(false);
-                textGroup->setVisible(true);
-                imageGroup->setVisible(false);
-                drawingGroup->setVisible(false);
-
-                if (textDatabaseWidget) {
-                    textDatabaseWidget->setEnabled(true);
-                    syncTextDataSourceWidget(textItem);
-                }
-                if (codeDatabaseWidget) {
-                    codeDatabaseWidget->setEnabled(false);
-                    codeDatabaseWidget->clearInputs();
-                    codeDatabaseWidget->setDataSourceEnabled(false);
-                }
-                
-                // 阻断信号更新以避免循环触发
-                QSignalBlocker blockContent(textContentEdit);
-                QSignalBlocker blockFont(fontComboBox);
-                QSignalBlocker blockSize(fontSizeSpinBox);
-                QSignalBlocker blockPropertiesFont(propertiesFontComboBox);
-                QSignalBlocker blockPropertiesSize(propertiesFontSizeSpinBox);
-                QSignalBlocker blockAlignment(textAlignmentCombo);
-                QSignalBlocker blockWordWrap(wordWrapCheck);
-                QSignalBlocker blockAutoResize(autoResizeCheck);
-                QSignalBlocker blockBorderEnabled(borderEnabledCheck);
-                QSignalBlocker blockBackgroundEnabled(backgroundEnabledCheck);
-                QSignalBlocker blockBorderWidth(borderWidthSpin);
-                QSignalBlocker blockLetterSpacing(letterSpacingSpin);
-                
-                // 设置文本内容
-                textContentEdit->setText(textItem->text());
-                
-                // 设置字体（同时更新工具栏和属性面板）
-                QFont itemFont = textItem->font();
-                fontComboBox->setCurrentFont(itemFont);
-                fontSizeSpinBox->setValue(itemFont.pointSize());
-                propertiesFontComboBox->setCurrentFont(itemFont);
-                propertiesFontSizeSpinBox->setValue(itemFont.pointSize());
-                // 设置字距
-                if (letterSpacingSpin) {
-                    letterSpacingSpin->setValue(static_cast<int>(std::round(textItem->letterSpacing())));
-                }
-                
-                // 设置对齐方式
-                Qt::Alignment alignment = textItem->alignment();
-                int alignmentIndex = 0;
-                if (alignment & Qt::AlignLeft) alignmentIndex = 0;
-                else if (alignment & Qt::AlignCenter) alignmentIndex = 1;
-                else if (alignment & Qt::AlignRight) alignmentIndex = 2;
-                textAlignmentCombo->setCurrentIndex(alignmentIndex);
-                  // 设置文本选项
-                wordWrapCheck->setChecked(textItem->wordWrap());
-                autoResizeCheck->setChecked(textItem->autoResize());
-                borderEnabledCheck->setChecked(textItem->isBorderEnabled());
-                backgroundEnabledCheck->setChecked(textItem->isBackgroundEnabled());
-                
-                // 设置边框宽度
-                borderWidthSpin->setValue(textItem->borderWidth());
-                
-                // 隐藏显示文本选项（文本项不需要）
-                if (showBarcodeTextCheck) {
-                    showBarcodeTextCheck->setVisible(false);
-                }
-            } else {
-                // 处理图像项
-                ImageItem* imageItem = dynamic_cast<ImageItem*>(item);
-                if (imageItem) {
-                    // 显示图像组
-                    labelSizeGroup->setVisible(true);
-                    codeGroup->setVisible(false);
-                    textGroup->setVisible(false);
-                    imageGroup->setVisible(true);
-                    drawingGroup->setVisible(false);
-
-                    if (codeDatabaseWidget) {
-                        codeDatabaseWidget->setEnabled(false);
-                        codeDatabaseWidget->clearInputs();
-                        codeDatabaseWidget->setDataSourceEnabled(false);
-                    }
-                    if (textDatabaseWidget) {
-                        textDatabaseWidget->setEnabled(false);
-                        textDatabaseWidget->clearInputs();
-                        textDatabaseWidget->setDataSourceEnabled(false);
-                    }
+    // 设置条形码类型
+    int typeIndex = 0; // 默认 CODE_128
+    ZXing::BarcodeFormat format = barcodeItem->format();
+    if (format == ZXing::BarcodeFormat::Code128) typeIndex = 0;
+    else if (format == ZXing::BarcodeFormat::EAN13) typeIndex = 1;
+    else if (format == ZXing::BarcodeFormat::UPCA) typeIndex = 2;
+    else if (format == ZXing::BarcodeFormat::Code39) typeIndex = 3;
+    codeTypeComboBox->setCurrentIndex(typeIndex);
 
-                    // 阻断信号更新以避免循环触发
-                    QSignalBlocker blockWidth(imageWidthSpin);
-                    QSignalBlocker blockHeight(imageHeightSpin);
-                    QSignalBlocker blockAspectRatio(keepAspectRatioCheck);
-                    QSignalBlocker blockOpacity(imageOpacitySpin);
+    // 设置条形码数据
+    codeDataEdit->setText(barcodeItem->data());
 
-                    // 设置图像尺寸
-                    imageWidthSpin->setValue(static_cast<int>(imageItem->size().width()));
-                    imageHeightSpin->setValue(static_cast<int>(imageItem->size().height()));
+    // 设置条形码尺寸
+    codeWidthSpin->setValue(barcodeItem->size().width());
+    codeHeightSpin->setValue(barcodeItem->size().height());
 
-                    // 设置保持宽高比
-                    keepAspectRatioCheck->setChecked(imageItem->keepAspectRatio());
+    // 显示显示文本选项（条形码支持）
+    if (showBarcodeTextCheck) {
+        showBarcodeTextCheck->setVisible(true);
+        QSignalBlocker blockShowText(showBarcodeTextCheck);
+        showBarcodeTextCheck->setChecked(barcodeItem->showHumanReadableText());
+    }
+}
 
-                    // 设置透明度
-                    imageOpacitySpin->setValue(static_cast<int>(imageItem->opacity() * 100));
+void MainWindow::showQRCodeProperties(QGraphicsItem *item)
+{
+    QRCodeItem* qrCodeItem = static_cast<QRCodeItem*>(item);
 
-                    // 隐藏显示文本选项（图像项不需要）
-                    if (showBarcodeTextCheck) {
-                        showBarcodeTextCheck->setVisible(false);
-                    }
-                } else {
-                    // 其他类型（线条/矩形/圆形/星形/箭头/多边形等）显示绘图设置组
-                    labelSizeGroup->setVisible(true);
-                    codeGroup->setVisible(false);
-                    textGroup->setVisible(false);
-                    imageGroup->setVisible(false);
-                    drawingGroup->setVisible(true);
-
-                    if (codeDatabaseWidget) {
-                        codeDatabaseWidget->setEnabled(false);
-                        codeDatabaseWidget->clearInputs();
-                        codeDatabaseWidget->setDataSourceEnabled(false);
-                    }
-                    if (textDatabaseWidget) {
-                        textDatabaseWidget->setEnabled(false);
-                        textDatabaseWidget->clearInputs();
-                        textDatabaseWidget->setDataSourceEnabled(false);
-                    }
-                    // 控件可见性按照类型细化
-                    bool isLine = dynamic_cast<LineItem*>(item) != nullptr;
-                    bool isRect = dynamic_cast<RectangleItem*>(item) != nullptr;
-                    bool isCircle = dynamic_cast<CircleItem*>(item) != nullptr;
-                    bool isStar = dynamic_cast<StarItem*>(item) != nullptr;
-                    bool isArrow = dynamic_cast<ArrowItem*>(item) != nullptr;
-                    bool isPolygon = dynamic_cast<PolygonItem*>(item) != nullptr;
-                    const bool canFill = isRect || isCircle || isStar || isPolygon;
-                    if (fillColorButton) fillColorButton->setVisible(canFill);
-                    if (fillEnabledCheck) fillEnabledCheck->setVisible(canFill);
-                    if (keepCircleCheck) keepCircleCheck->setVisible(isCircle);
-                    if (lineAngleSpin) lineAngleSpin->setVisible(isLine || isArrow);
-                    if (lineDashedCheck) lineDashedCheck->setVisible(isLine || isArrow);
-                    if (cornerRadiusSpin) cornerRadiusSpin->setVisible(isRect);
-                    if (isLine && lineAngleSpin) {
-                        LineItem* lineItem = static_cast<LineItem*>(item);
-                        QSignalBlocker blk(lineAngleSpin);
-                        lineAngleSpin->setValue(lineItem->angleFromVertical());
-                        if (lineDashedCheck) {
-                            QSignalBlocker blk2(lineDashedCheck);
-                            lineDashedCheck->setChecked(lineItem->isDashed());
-                        }
-                    }
-                    if (isArrow && lineAngleSpin) {
-                        ArrowItem* arrowItem = static_cast<ArrowItem*>(item);
-                        QSignalBlocker blk(lineAngleSpin);
-                        lineAngleSpin->setValue(arrowItem->angleFromVertical());
-                        if (lineDashedCheck) {
-                            QSignalBlocker blk2(lineDashedCheck);
-                            lineDashedCheck->setChecked(arrowItem->isDashed());
-                        }
-                    }
-                    if (isRect && cornerRadiusSpin) {
-                        RectangleItem* rectItem = static_cast<RectangleItem*>(item);
-                        QSignalBlocker blk2(cornerRadiusSpin);
-                        // 动态限制最大值为当前尺寸一半
-                        int maxRadius = int(std::round(std::min(rectItem->size().width(), rectItem->size().height()) / 2.0));
-                        cornerRadiusSpin->setMaximum(maxRadius);
-                        cornerRadiusSpin->setValue(int(std::round(rectItem->cornerRadius())));
-                    }
-                }
-            }
-        }
+    // 显示码类组，隐藏其它类型组
+    showPropertyGroup(codeGroup);
+    if (codeDatabaseWidget) {
+        syncCodeDataSourceWidget(qrCodeItem);
+    }
+
+    // 更新码类下拉框为二维码类型
+    updateCodeTypeComboBox(true); // true表示二维码
+
+    // 阻断信号更新以避免循环触发
+    QSignalBlocker blockType(codeTypeComboBox);
+    QSignalBlocker blockData(codeDataEdit);
+    QSignalBlocker blockWidth(codeWidthSpin);
+    QSignalBlocker blockHeight(codeHeightSpin);
+
+    // 设置二维码类型
+    int typeIndex = 0; // 默认QR Code
+    QString codeType = qrCodeItem->codeType();
+    if (codeType == "QR") typeIndex = 0;
+    else if (codeType == "PDF417") typeIndex = 1;
+    else if (codeType == "DataMatrix") typeIndex = 2;
+    else if (codeType == "Aztec") typeIndex = 3;
+    codeTypeComboBox->setCurrentIndex(typeIndex);
+
+    // 设置二维码数据
+    codeDataEdit->setText(qrCodeItem->text());
+
+    // 设置二维码尺寸
+    codeWidthSpin->setValue(qrCodeItem->boundingRect().width());
+    codeHeightSpin->setValue(qrCodeItem->boundingRect().height());
+
+    // 隐藏显示文本选项（二维码不支持）
+    if (showBarcodeTextCheck) {
+        showBarcodeTextCheck->setVisible(false);
+    }
+}
+
+void MainWindow::showTextProperties(QGraphicsItem *item)
+{
+    TextItem* textItem = static_cast<TextItem*>(item);
+
+    // 显示文本组
+    showPropertyGroup(textGroup);
+    if (textDatabaseWidget) {
+        syncTextDataSourceWidget(textItem);
+    }
+
+    // 阻断信号更新以避免循环触发
+    QSignalBlocker blockContent(textContentEdit);
+    QSignalBlocker blockFont(fontComboBox);
+    QSignalBlocker blockSize(fontSizeSpinBox);
+    QSignalBlocker blockPropertiesFont(propertiesFontComboBox);
+    QSignalBlocker blockPropertiesSize(propertiesFontSizeSpinBox);
+    QSignalBlocker blockAlignment(textAlignmentCombo);
+    QSignalBlocker blockWordWrap(wordWrapCheck);
+    QSignalBlocker blockAutoResize(autoResizeCheck);
+    QSignalBlocker blockBorderEnabled(borderEnabledCheck);
+    QSignalBlocker blockBackgroundEnabled(backgroundEnabledCheck);
+    QSignalBlocker blockBorderWidth(borderWidthSpin);
+    QSignalBlocker blockLetterSpacing(letterSpacingSpin);
+
+    // 设置文本内容
+    textContentEdit->setText(textItem->text());
+
+    // 设置字体（同时更新工具栏和属性面板）
+    QFont itemFont = textItem->font();
+    fontComboBox->setCurrentFont(itemFont);
+    fontSizeSpinBox->setValue(itemFont.pointSize());
+    propertiesFontComboBox->setCurrentFont(itemFont);
+    propertiesFontSizeSpinBox->setValue(itemFont.pointSize());
+    // 设置字距
+    if (letterSpacingSpin) {
+        letterSpacingSpin->setValue(static_cast<int>(std::round(textItem->letterSpacing())));
+    }
+
+    // 设置对齐方式
+    Qt::Alignment alignment = textItem->alignment();
+    int alignmentIndex = 0;
+    if (alignment & Qt::AlignLeft) alignmentIndex = 0;
+    else if (alignment & Qt::AlignCenter) alignmentIndex = 1;
+    else if (alignment & Qt::AlignRight) alignmentIndex = 2;
+    textAlignmentCombo->setCurrentIndex(alignmentIndex);
+
+    // 设置文本选项
+    wordWrapCheck->setChecked(textItem->wordWrap());
+    autoResizeCheck->setChecked(textItem->autoResize());
+    borderEnabledCheck->setChecked(textItem->isBorderEnabled());
+    backgroundEnabledCheck->setChecked(textItem->isBackgroundEnabled());
+
+    // 设置边框宽度
+    borderWidthSpin->setValue(textItem->borderWidth());
+
+    // 隐藏显示文本选项（文本项不需要）
+    if (showBarcodeTextCheck) {
+        showBarcodeTextCheck->setVisible(false);
+    }
+}
+
+void MainWindow::showImageProperties(QGraphicsItem *item)
+{
+    ImageItem* imageItem = static_cast<ImageItem*>(item);
+
+    // 显示图像组
+    showPropertyGroup(imageGroup);
+    if (imageDatabaseWidget) {
+        syncImageDataSourceWidget(imageItem);
+    }
+
+    // 阻断信号更新以避免循环触发
+    QSignalBlocker blockWidth(imageWidthSpin);
+    QSignalBlocker blockHeight(imageHeightSpin);
+    QSignalBlocker blockAspectRatio(keepAspectRatioCheck);
+    QSignalBlocker blockOpacity(imageOpacitySpin);
+
+    // 设置图像尺寸
+    imageWidthSpin->setValue(static_cast<int>(imageItem->size().width()));
+    imageHeightSpin->setValue(static_cast<int>(imageItem->size().height()));
+
+    // 设置保持宽高比
+    keepAspectRatioCheck->setChecked(imageItem->keepAspectRatio());
+
+    // 设置透明度
+    imageOpacitySpin->setValue(static_cast<int>(imageItem->opacity() * 100));
+
+    // 按记录取图的目录
+    recordImageDirEdit->setText(QDir::toNativeSeparators(imageItem->recordImageDirectory()));
+
+    // 隐藏显示文本选项（图像项不需要）
+    if (showBarcodeTextCheck) {
+        showBarcodeTextCheck->setVisible(false);
+    }
+}
+
+void MainWindow::showDrawingProperties(QGraphicsItem *item)
+{
+    // 其他类型（线条/矩形/圆形/星形/箭头/多边形等）显示绘图设置组
+    showPropertyGroup(drawingGroup);
+
+    // 控件可见性按照类型细化
+    const int type = item->type();
+    const bool isLine = type == LineItem::Type;
+    const bool isArrow = type == ArrowItem::Type;
+    const bool isRect = type == RectangleItem::Type;
+    const bool isCircle = type == CircleItem::Type;
+    const bool canFill = isRect || isCircle || type == StarItem::Type || type == PolygonItem::Type;
+    if (fillColorButton) fillColorButton->setVisible(canFill);
+    if (fillEnabledCheck) fillEnabledCheck->setVisible(canFill);
+    if (keepCircleCheck) keepCircleCheck->setVisible(isCircle);
+    if (lineAngleSpin) lineAngleSpin->setVisible(isLine || isArrow);
+    if (lineDashedCheck) lineDashedCheck->setVisible(isLine || isArrow);
+    if (cornerRadiusSpin) cornerRadiusSpin->setVisible(isRect);
+    if ((isLine || isArrow) && lineAngleSpin) {
+        // ArrowItem 继承 LineItem，角度与虚线设置相同
+        LineItem* lineItem = static_cast<LineItem*>(item);
+        QSignalBlocker blk(lineAngleSpin);
+        lineAngleSpin->setValue(lineItem->angleFromVertical());
+        if (lineDashedCheck) {
+            QSignalBlocker blk2(lineDashedCheck);
+            lineDashedCheck->setChecked(lineItem->isDashed());
+        }
+    }
+    if (isRect && cornerRadiusSpin) {
+        RectangleItem* rectItem = static_cast<RectangleItem*>(item);
+        QSignalBlocker blk2(cornerRadiusSpin);
+        // 动态限制最大值为当前尺寸一半
+        int maxRadius = int(std::round(std::min(rectItem->size().width(), rectItem->size().height()) / 2.0));
+        cornerRadiusSpin->setMaximum(maxRadius);
+        cornerRadiusSpin->setValue(int(std::round(rectItem->cornerRadius())));
     }
 }
 
@@ -2306,7 +2418,7 @@ void MainWindow::applyCodeDataSource()
     }
 
     QGraphicsItem* item = selected.first();
-    if (!dynamic_cast<BarcodeItem*>(item) && !dynamic_cast<QRCodeItem*>(item)) {
+    if (!qgraphicsitem_cast<BarcodeItem*>(item) && !qgraphicsitem_cast<QRCodeItem*>(item)) {
         QMessageBox::information(this, tr("数据源"), tr("当前选择的不是条码或二维码元素。"));
         return;
     }
@@ -2325,6 +2437,7 @@ void MainWindow::applyCodeDataSource()
     binding.enabled = codeDatabaseWidget->isDataSourceEnabled() && source->isValid();
 
     m_itemDataSources.insert(item, binding);
+    m_journalDirtyItems.insert(item);
     syncCodeDataSourceWidget(item);
 
     if (statusBar()) {
@@ -2346,7 +2459,7 @@ void MainWindow::applyTextDataSource()
     }
 
     QGraphicsItem* item = selected.first();
-    if (!dynamic_cast<TextItem*>(item)) {
+    if (!qgraphicsitem_cast<TextItem*>(item)) {
         QMessageBox::information(this, tr("数据源"), tr("当前选择的不是文本元素。"));
         return;
     }
@@ -2365,6 +2478,7 @@ void MainWindow::applyTextDataSource()
     binding.enabled = textDatabaseWidget->isDataSourceEnabled() && source->isValid();
 
     m_itemDataSources.insert(item, binding);
+    m_journalDirtyItems.insert(item);
     syncTextDataSourceWidget(item);
 
     if (statusBar()) {
@@ -2373,6 +2487,47 @@ void MainWindow::applyTextDataSource()
     isModified = true;
 }
 
+void MainWindow::applyImageDataSource()
+{
+    if (!imageDatabaseWidget || !scene) {
+        return;
+    }
+
+    const QList<QGraphicsItem*> selected = scene->selectedItems();
+    if (selected.isEmpty()) {
+        QMessageBox::information(this, tr("数据源"), tr("请先选择图像元素。"));
+        return;
+    }
+
+    QGraphicsItem* item = selected.first();
+    if (!qgraphicsitem_cast<ImageItem*>(item)) {
+        QMessageBox::information(this, tr("数据源"), tr("当前选择的不是图像元素。"));
+        return;
+    }
+
+    QString errorMessage;
+    auto source = imageDatabaseWidget->createDataSource(&errorMessage);
+    if (!source) {
+        if (!errorMessage.isEmpty()) {
+            QMessageBox::warning(this, tr("数据源无效"), errorMessage);
+        }
+        return;
+    }
+
+    DataSourceBinding binding;
+    binding.source = source;
+    binding.enabled = imageDatabaseWidget->isDataSourceEnabled() && source->isValid();
+
+    m_itemDataSources.insert(item, binding);
+    m_journalDirtyItems.insert(item);
+    syncImageDataSourceWidget(item);
+
+    if (statusBar()) {
+        statusBar()->showMessage(tr("图像数据源已更新"), 2000);
+    }
+    isModified = true;
+}
+
 void MainWindow::handleCodeDataSourceEnabledChanged(bool enabled)
 {
     if (!codeDatabaseWidget || !scene) {
@@ -2385,7 +2540,7 @@ void MainWindow::handleCodeDataSourceEnabledChanged(bool enabled)
     }
 
     QGraphicsItem* item = selected.first();
-    if (!dynamic_cast<BarcodeItem*>(item) && !dynamic_cast<QRCodeItem*>(item)) {
+    if (!qgraphicsitem_cast<BarcodeItem*>(item) && !qgraphicsitem_cast<QRCodeItem*>(item)) {
         return;
     }
 
@@ -2405,6 +2560,7 @@ void MainWindow::handleCodeDataSourceEnabledChanged(bool enabled)
     }
 
     it->enabled = enabled;
+    m_journalDirtyItems.insert(item);
     isModified = true;
 }
 
@@ -2420,7 +2576,7 @@ void MainWindow::handleTextDataSourceEnabledChanged(bool enabled)
     }
 
     QGraphicsItem* item = selected.first();
-    if (!dynamic_cast<TextItem*>(item)) {
+    if (!qgraphicsitem_cast<TextItem*>(item)) {
         return;
     }
 
@@ -2440,6 +2596,43 @@ void MainWindow::handleTextDataSourceEnabledChanged(bool enabled)
     }
 
     it->enabled = enabled;
+    m_journalDirtyItems.insert(item);
+    isModified = true;
+}
+
+void MainWindow::handleImageDataSourceEnabledChanged(bool enabled)
+{
+    if (!imageDatabaseWidget || !scene) {
+        return;
+    }
+
+    const QList<QGraphicsItem*> selected = scene->selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
+
+    QGraphicsItem* item = selected.first();
+    if (!qgraphicsitem_cast<ImageItem*>(item)) {
+        return;
+    }
+
+    auto it = m_itemDataSources.find(item);
+    if (it == m_itemDataSources.end() || !it->source) {
+        if (enabled) {
+            QMessageBox::information(this, tr("数据源"), tr("请先配置数据源并点击“应用到当前元素”。"));
+            imageDatabaseWidget->setDataSourceEnabled(false);
+        }
+        return;
+    }
+
+    if (enabled && !it->source->isValid()) {
+        QMessageBox::warning(this, tr("数据源无效"), tr("当前数据源无效，请重新配置。"));
+        imageDatabaseWidget->setDataSourceEnabled(false);
+        return;
+    }
+
+    it->enabled = enabled;
+    m_journalDirtyItems.insert(item);
     isModified = true;
 }
 
@@ -2482,12 +2675,30 @@ void MainWindow::syncTextDataSourceWidget(QGraphicsItem* item)
     textDatabaseWidget->setDataSourceEnabled(binding.enabled);
 }
 
+void MainWindow::syncImageDataSourceWidget(QGraphicsItem* item)
+{
+    if (!imageDatabaseWidget) {
+        return;
+    }
+
+    if (!item) {
+        imageDatabaseWidget->clearInputs();
+        imageDatabaseWidget->setDataSourceEnabled(false);
+        return;
+    }
+
+    const DataSourceBinding binding = m_itemDataSources.value(item);
+    imageDatabaseWidget->setDataSource(binding.source);
+    imageDatabaseWidget->setDataSourceEnabled(binding.enabled);
+}
+
 void MainWindow::clearDataSourceBinding(QGraphicsItem* item)
 {
     if (!item) {
         return;
     }
     m_itemDataSources.remove(item);
+    m_journalDirtyItems.insert(item);
 }
 
 void MainWindow::initializePrinting()
@@ -2496,10 +2707,37 @@ void MainWindow::initializePrinting()
         return;
     }
 
-    auto renderer = std::make_unique<DefaultPrintRenderer>();
+    auto renderer = std::make_unique<ElementModelRenderer>();
     m_printEngine = std::make_unique<PrintEngine>(std::move(renderer));
 }
 
+QImage MainWindow::renderDocumentThumbnail() const
+{
+    const double widthMM = widthLineEdit->text().toDouble();
+    const double heightMM = heightLineEdit->text().toDouble();
+    if (widthMM <= 0.0 || heightMM <= 0.0) {
+        return QImage();
+    }
+
+    constexpr int kThumbnailExtent = 256;
+    const QSizeF designSize(widthMM * MM_TO_PIXELS, heightMM * MM_TO_PIXELS);
+    const QSize size = designSize.scaled(kThumbnailExtent, kThumbnailExtent, Qt::KeepAspectRatio)
+                           .toSize()
+                           .expandedTo(QSize(1, 1));
+
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    ElementModelRenderer::paintElements(painter, collectElements(false),
+                                        QRectF(QPointF(0.0, 0.0), QSizeF(size)),
+                                        QRectF(QPointF(0.0, 0.0), designSize),
+                                        Qt::KeepAspectRatio);
+    painter.end();
+    return image;
+}
+
 QList<labelelement*> MainWindow::collectElements(bool onlySelected) const
 {
     QList<labelelement*> result;
@@ -2526,10 +2764,7 @@ QList<labelelement*> MainWindow::collectElements(bool onlySelected) const
     m_elementCache.reserve(static_cast<size_t>(items.size()));
 
     for (QGraphicsItem* item : items) {
-        if (!item || item == selectionFrame || item->data(0).toString() == "labelBackground") {
-            continue;
-        }
-
+        // 背景、选择框等不是元素，注册表中查不到
         auto element = wrapItem(item);
         if (!element) {
             continue;
@@ -2601,42 +2836,7 @@ PrintContext MainWindow::buildPrintContext(QPrinter *printer) const
 
 std::unique_ptr<labelelement> MainWindow::wrapItem(QGraphicsItem *item) const
 {
-    if (!item) {
-        return nullptr;
-    }
-
-    if (auto barcode = dynamic_cast<BarcodeItem*>(item)) {
-        return std::make_unique<BarcodeElement>(barcode);
-    }
-    if (auto qr = dynamic_cast<QRCodeItem*>(item)) {
-        return std::make_unique<QRCodeElement>(qr);
-    }
-    if (auto text = dynamic_cast<TextItem*>(item)) {
-        return std::make_unique<TextElement>(text);
-    }
-    if (auto image = dynamic_cast<ImageItem*>(item)) {
-        return std::make_unique<ImageElement>(image);
-    }
-    if (auto line = dynamic_cast<LineItem*>(item)) {
-        return std::make_unique<LineElement>(line);
-    }
-    if (auto rect = dynamic_cast<RectangleItem*>(item)) {
-        return std::make_unique<RectangleElement>(rect);
-    }
-    if (auto circle = dynamic_cast<CircleItem*>(item)) {
-        return std::make_unique<CircleElement>(circle);
-    }
-    if (auto star = dynamic_cast<StarItem*>(item)) {
-        return std::make_unique<StarElement>(star);
-    }
-    if (auto arrow = dynamic_cast<ArrowItem*>(item)) {
-        return std::make_unique<ArrowElement>(arrow);
-    }
-    if (auto poly = dynamic_cast<PolygonItem*>(item)) {
-        return std::make_unique<PolygonElement>(poly);
-    }
-
-    return nullptr;
+    return ElementRegistry::instance().wrap(item);
 }
 
 std::optional<bool> MainWindow::promptSelectionChoice(const QString &title,
@@ -2720,7 +2920,7 @@ BarcodeItem* MainWindow::getSelectedBarcodeItem()
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
     if (selectedItems.isEmpty()) return nullptr;
 
-    return dynamic_cast<BarcodeItem*>(selectedItems.first());
+    return qgraphicsitem_cast<BarcodeItem*>(selectedItems.first());
 }
 
 // 获取选中的二维码项
@@ -2729,7 +2929,7 @@ QRCodeItem* MainWindow::getSelectedQRCodeItem()
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
     if (selectedItems.isEmpty()) return nullptr;
 
-    return dynamic_cast<QRCodeItem*>(selectedItems.first());
+    return qgraphicsitem_cast<QRCodeItem*>(selectedItems.first());
 }
 
 void MainWindow::createRulers()
@@ -2882,7 +3082,7 @@ void MainWindow::handleRubberBandSelection(const QRectF &selectionRect, bool fin
         if (!(item->flags() & QGraphicsItem::ItemIsSelectable)) {
             continue;
         }
-        if (item->data(0).toString() == QStringLiteral("labelBackground")) {
+        if (item == m_labelBackground) {
             continue;
         }
         if (qgraphicsitem_cast<QGraphicsProxyWidget*>(item)) {
@@ -3001,7 +3201,7 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
                     QList<QGraphicsItem*> sel = scene->selectedItems();
                     if (sel.size() == 1) {
                         QGraphicsItem* item = sel.first();
-                        if (item && item->data(0).toString() != "labelBackground" && !qgraphicsitem_cast<QGraphicsProxyWidget*>(item)) {
+                        if (item && item != m_labelBackground && !qgraphicsitem_cast<QGraphicsProxyWidget*>(item)) {
                             // 优先使用 AlignableItem 提供的“内容矩形”的场景坐标，确保与视觉内容边缘一致
                             if (auto alignable = dynamic_cast<AlignableItem*>(item)) {
                                 QRectF rect = alignable->alignmentSceneRect();
@@ -3090,6 +3290,33 @@ void MainWindow::setZoomFactorAtPosition(double factor, const QPointF &scenePos)
     }
 }
 
+namespace {
+
+// 同一时间只保留一种图形项的复制状态
+void clearCopiedItemFlags()
+{
+    QRCodeItem::s_hasCopiedItem = false;
+    BarcodeItem::s_hasCopiedItem = false;
+    TextItem::s_hasCopiedItem = false;
+    ImageItem::s_hasCopiedItem = false;
+    LineItem::s_hasCopiedItem = false;
+    RectangleItem::s_hasCopiedItem = false;
+    CircleItem::s_hasCopiedItem = false;
+    StarItem::s_hasCopiedItem = false;
+    ArrowItem::s_hasCopiedItem = false;
+    PolygonItem::s_hasCopiedItem = false;
+}
+
+template <typename Item>
+void copyItemOfType(QGraphicsItem *item)
+{
+    clearCopiedItemFlags();
+    Item *typedItem = static_cast<Item*>(item);
+    typedItem->copyItem(typedItem);
+}
+
+} // namespace
+
 // 右键菜单槽函数实现
 void MainWindow::copySelectedItem()
 {
@@ -3102,195 +3329,27 @@ void MainWindow::copySelectedItem()
     }
 
     QGraphicsItem* item = selectedItems.first();
-    qDebug() << "Selected item type:" << typeid(*item).name();
-
-    // 复制条形码项
-    BarcodeItem* barcodeItem = dynamic_cast<BarcodeItem*>(item);
-    if (barcodeItem) {
-        qDebug() << "Copying BarcodeItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-
-        barcodeItem->copyItem(barcodeItem);
-        // 更新按钮状态
-        updateContextMenuActions();
+    qDebug() << "Selected item type:" << item->type();
+
+    // 按图形项类型标识分派（箭头有独立的标识，不再按直线复制）
+    switch (item->type()) {
+    case BarcodeItem::Type:   copyItemOfType<BarcodeItem>(item); break;
+    case QRCodeItem::Type:    copyItemOfType<QRCodeItem>(item); break;
+    case TextItem::Type:      copyItemOfType<TextItem>(item); break;
+    case ImageItem::Type:     copyItemOfType<ImageItem>(item); break;
+    case LineItem::Type:      copyItemOfType<LineItem>(item); break;
+    case ArrowItem::Type:     copyItemOfType<ArrowItem>(item); break;
+    case RectangleItem::Type: copyItemOfType<RectangleItem>(item); break;
+    case CircleItem::Type:    copyItemOfType<CircleItem>(item); break;
+    case StarItem::Type:      copyItemOfType<StarItem>(item); break;
+    case PolygonItem::Type:   copyItemOfType<PolygonItem>(item); break;
+    default:
+        qDebug() << "Unknown item type, cannot copy";
         return;
     }
 
-    // 复制二维码项
-    QRCodeItem* qrCodeItem = dynamic_cast<QRCodeItem*>(item);
-    if (qrCodeItem) {
-        qDebug() << "Copying QRCodeItem";
-        // 清除其他类型的复制状态
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-
-        qrCodeItem->copyItem(qrCodeItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制文本项
-    TextItem* textItem = dynamic_cast<TextItem*>(item);
-    if (textItem) {
-        qDebug() << "Copying TextItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-
-        textItem->copyItem(textItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制图像项
-    ImageItem* imageItem = dynamic_cast<ImageItem*>(item);
-    if (imageItem) {
-        qDebug() << "Copying ImageItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-
-        imageItem->copyItem(imageItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制线条项
-    LineItem* lineItem = dynamic_cast<LineItem*>(item);
-    if (lineItem) {
-        qDebug() << "Copying LineItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-        StarItem::s_hasCopiedItem = false;
-        ArrowItem::s_hasCopiedItem = false;
-        PolygonItem::s_hasCopiedItem = false;
-
-        lineItem->copyItem(lineItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制矩形项
-    RectangleItem* rectangleItem = dynamic_cast<RectangleItem*>(item);
-    if (rectangleItem) {
-        qDebug() << "Copying RectangleItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-        StarItem::s_hasCopiedItem = false;
-        ArrowItem::s_hasCopiedItem = false;
-        PolygonItem::s_hasCopiedItem = false;
-
-        rectangleItem->copyItem(rectangleItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制圆形项
-    CircleItem* circleItem = dynamic_cast<CircleItem*>(item);
-    if (circleItem) {
-        qDebug() << "Copying CircleItem";
-        // 清除其他类型的复制状态
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        StarItem::s_hasCopiedItem = false;
-        ArrowItem::s_hasCopiedItem = false;
-        PolygonItem::s_hasCopiedItem = false;
-
-        circleItem->copyItem(circleItem);
-        // 更新按钮状态
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制星形项
-    if (auto starItem = dynamic_cast<StarItem*>(item)) {
-        qDebug() << "Copying StarItem";
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-        ArrowItem::s_hasCopiedItem = false;
-        PolygonItem::s_hasCopiedItem = false;
-        starItem->copyItem(starItem);
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制箭头项
-    if (auto arrowItem = dynamic_cast<ArrowItem*>(item)) {
-        qDebug() << "Copying ArrowItem";
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-        StarItem::s_hasCopiedItem = false;
-        PolygonItem::s_hasCopiedItem = false;
-        arrowItem->copyItem(arrowItem);
-        updateContextMenuActions();
-        return;
-    }
-
-    // 复制多边形项
-    if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
-        qDebug() << "Copying PolygonItem";
-        QRCodeItem::s_hasCopiedItem = false;
-        BarcodeItem::s_hasCopiedItem = false;
-        TextItem::s_hasCopiedItem = false;
-        ImageItem::s_hasCopiedItem = false;
-        LineItem::s_hasCopiedItem = false;
-        RectangleItem::s_hasCopiedItem = false;
-        CircleItem::s_hasCopiedItem = false;
-        StarItem::s_hasCopiedItem = false;
-        ArrowItem::s_hasCopiedItem = false;
-        polyItem->copyItem(polyItem);
-        updateContextMenuActions();
-        return;
-    }
-
-    qDebug() << "Unknown item type, cannot copy";
+    // 更新按钮状态
+    updateContextMenuActions();
 }
 
 void MainWindow::deleteSelectedItem()
@@ -3699,7 +3758,7 @@ TextItem* MainWindow::getSelectedTextItem()
         return nullptr;
     }
     
-    return dynamic_cast<TextItem*>(selectedItems.first());
+    return qgraphicsitem_cast<TextItem*>(selectedItems.first());
 }
 
 void MainWindow::startTextEditing(TextItem* textItem)
@@ -3765,6 +3824,12 @@ void MainWindow::connectImageSignals()
     // 连接透明度调整器的信号
     connect(imageOpacitySpin, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &MainWindow::updateImageOpacity);
+
+    // 连接按记录取图目录的信号
+    connect(recordImageDirEdit, &QLineEdit::editingFinished,
+            this, &MainWindow::updateRecordImageDirectory);
+    connect(recordImageDirButton, &QPushButton::clicked,
+            this, &MainWindow::browseRecordImageDirectory);
 }
 
 void MainWindow::loadImageFile()
@@ -3847,6 +3912,34 @@ void MainWindow::updateImageOpacity(int opacity)
     }
 }
 
+void MainWindow::updateRecordImageDirectory()
+{
+    ImageItem* imageItem = getSelectedImageItem();
+    if (imageItem) {
+        const QString directory = recordImageDirEdit->text().trimmed();
+        if (directory != imageItem->recordImageDirectory()) {
+            imageItem->setRecordImageDirectory(directory);
+            isModified = true;
+        }
+    }
+}
+
+void MainWindow::browseRecordImageDirectory()
+{
+    ImageItem* imageItem = getSelectedImageItem();
+    if (!imageItem) return;
+
+    const QString directory = QFileDialog::getExistingDirectory(
+        this,
+        tr("选择图片目录"),
+        imageItem->recordImageDirectory()
+    );
+    if (!directory.isEmpty()) {
+        recordImageDirEdit->setText(QDir::toNativeSeparators(directory));
+        updateRecordImageDirectory();
+    }
+}
+
 ImageItem* MainWindow::getSelectedImageItem()
 {
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
@@ -3854,7 +3947,7 @@ ImageItem* MainWindow::getSelectedImageItem()
         return nullptr;
     }
 
-    return dynamic_cast<ImageItem*>(selectedItems.first());
+    return qgraphicsitem_cast<ImageItem*>(selectedItems.first());
 }
 
 // ========== 绘图工具相关方法实现 ==========
@@ -3896,23 +3989,23 @@ void MainWindow::updateLineWidth()
             QPen pen = lineItem->pen();
             pen.setWidth(lineWidthSpin->value());
             lineItem->setPen(pen);
-        } else if (auto arrowItem = dynamic_cast<ArrowItem*>(item)) {
+        } else if (auto arrowItem = qgraphicsitem_cast<ArrowItem*>(item)) {
             QPen pen = arrowItem->pen();
             pen.setWidth(lineWidthSpin->value());
             arrowItem->setPen(pen);
-        } else if (auto rectItem = dynamic_cast<RectangleItem*>(item)) {
+        } else if (auto rectItem = qgraphicsitem_cast<RectangleItem*>(item)) {
             QPen pen = rectItem->pen();
             pen.setWidth(lineWidthSpin->value());
             rectItem->setPen(pen);
-        } else if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
+        } else if (auto circleItem = qgraphicsitem_cast<CircleItem*>(item)) {
             QPen pen = circleItem->pen();
             pen.setWidth(lineWidthSpin->value());
             circleItem->setPen(pen);
-        } else if (auto starItem = dynamic_cast<StarItem*>(item)) {
+        } else if (auto starItem = qgraphicsitem_cast<StarItem*>(item)) {
             QPen pen = starItem->pen();
             pen.setWidth(lineWidthSpin->value());
             starItem->setPen(pen);
-        } else if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
+        } else if (auto polyItem = qgraphicsitem_cast<PolygonItem*>(item)) {
             QPen pen = polyItem->pen();
             pen.setWidth(lineWidthSpin->value());
             polyItem->setPen(pen);
@@ -3940,23 +4033,23 @@ void MainWindow::updateLineColor()
                     QPen pen = lineItem->pen();
                     pen.setColor(color);
                     lineItem->setPen(pen);
-                } else if (auto arrowItem = dynamic_cast<ArrowItem*>(item)) {
+                } else if (auto arrowItem = qgraphicsitem_cast<ArrowItem*>(item)) {
                     QPen pen = arrowItem->pen();
                     pen.setColor(color);
                     arrowItem->setPen(pen);
-                } else if (auto rectItem = dynamic_cast<RectangleItem*>(item)) {
+                } else if (auto rectItem = qgraphicsitem_cast<RectangleItem*>(item)) {
                     QPen pen = rectItem->pen();
                     pen.setColor(color);
                     rectItem->setPen(pen);
-                } else if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
+                } else if (auto circleItem = qgraphicsitem_cast<CircleItem*>(item)) {
                     QPen pen = circleItem->pen();
                     pen.setColor(color);
                     circleItem->setPen(pen);
-                } else if (auto starItem = dynamic_cast<StarItem*>(item)) {
+                } else if (auto starItem = qgraphicsitem_cast<StarItem*>(item)) {
                     QPen pen = starItem->pen();
                     pen.setColor(color);
                     starItem->setPen(pen);
-                } else if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
+                } else if (auto polyItem = qgraphicsitem_cast<PolygonItem*>(item)) {
                     QPen pen = polyItem->pen();
                     pen.setColor(color);
                     polyItem->setPen(pen);
@@ -3982,19 +4075,19 @@ void MainWindow::updateFillColor()
             // 更新选中的绘图项的填充颜色
             QList<QGraphicsItem*> selectedItems = scene->selectedItems();
             for (QGraphicsItem* item : selectedItems) {
-                if (auto rectItem = dynamic_cast<RectangleItem*>(item)) {
+                if (auto rectItem = qgraphicsitem_cast<RectangleItem*>(item)) {
                     QBrush brush = rectItem->brush();
                     brush.setColor(color);
                     rectItem->setBrush(brush);
-                } else if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
+                } else if (auto circleItem = qgraphicsitem_cast<CircleItem*>(item)) {
                     QBrush brush = circleItem->brush();
                     brush.setColor(color);
                     circleItem->setBrush(brush);
-                } else if (auto starItem = dynamic_cast<StarItem*>(item)) {
+                } else if (auto starItem = qgraphicsitem_cast<StarItem*>(item)) {
                     QBrush brush = starItem->brush();
                     brush.setColor(color);
                     starItem->setBrush(brush);
-                } else if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
+                } else if (auto polyItem = qgraphicsitem_cast<PolygonItem*>(item)) {
                     QBrush brush = polyItem->brush();
                     brush.setColor(color);
                     polyItem->setBrush(brush);
@@ -4012,13 +4105,13 @@ void MainWindow::updateFillEnabled()
     // 更新选中的绘图项的填充状态
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
     for (QGraphicsItem* item : selectedItems) {
-        if (auto rectItem = dynamic_cast<RectangleItem*>(item)) {
+        if (auto rectItem = qgraphicsitem_cast<RectangleItem*>(item)) {
             rectItem->setFillEnabled(enabled);
-        } else if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
+        } else if (auto circleItem = qgraphicsitem_cast<CircleItem*>(item)) {
             circleItem->setFillEnabled(enabled);
-        } else if (auto starItem = dynamic_cast<StarItem*>(item)) {
+        } else if (auto starItem = qgraphicsitem_cast<StarItem*>(item)) {
             starItem->setFillEnabled(enabled);
-        } else if (auto polyItem = dynamic_cast<PolygonItem*>(item)) {
+        } else if (auto polyItem = qgraphicsitem_cast<PolygonItem*>(item)) {
             polyItem->setFillEnabled(enabled);
         }
     }
@@ -4032,7 +4125,7 @@ void MainWindow::updateKeepCircle()
     // 更新选中的圆形项的保持圆形状态
     QList<QGraphicsItem*> selectedItems = scene->selectedItems();
     for (QGraphicsItem* item : selectedItems) {
-        if (auto circleItem = dynamic_cast<CircleItem*>(item)) {
+        if (auto circleItem = qgraphicsitem_cast<CircleItem*>(item)) {
             circleItem->setIsCircle(keepCircle);
         }
     }
@@ -4085,9 +4178,12 @@ void MainWindow::startPastePreview()
         // 创建预览二维码
         m_previewItem = new QRCodeItem(QRCodeItem::s_copiedText);
         QRCodeItem* previewQR = static_cast<QRCodeItem*>(m_previewItem);
+        previewQR->setCodeType(QRCodeItem::s_copiedCodeType);
         previewQR->setSize(QRCodeItem::s_copiedSize);
         previewQR->setForegroundColor(QRCodeItem::s_copiedForegroundColor);
         previewQR->setBackgroundColor(QRCodeItem::s_copiedBackgroundColor);
+        previewQR->setQrVersion(QRCodeItem::s_copiedQrVersion);
+        previewQR->setQrMask(QRCodeItem::s_copiedQrMask);
     }
     else if (BarcodeItem::s_hasCopiedItem) {
         // 创建预览条形码
@@ -4244,9 +4340,12 @@ void MainWindow::confirmPaste(const QPointF& scenePos)
     // 根据复制的类型创建对应的新项目
     if (QRCodeItem::s_hasCopiedItem) {
         QRCodeItem* newQRCode = new QRCodeItem(QRCodeItem::s_copiedText);
+        newQRCode->setCodeType(QRCodeItem::s_copiedCodeType);
         newQRCode->setSize(QRCodeItem::s_copiedSize);
         newQRCode->setForegroundColor(QRCodeItem::s_copiedForegroundColor);
         newQRCode->setBackgroundColor(QRCodeItem::s_copiedBackgroundColor);
+        newQRCode->setQrVersion(QRCodeItem::s_copiedQrVersion);
+        newQRCode->setQrMask(QRCodeItem::s_copiedQrMask);
         newQRCode->setPos(scenePos);
         newItem = newQRCode;
         description = tr("粘贴二维码");
@@ -4435,15 +4534,8 @@ void MainWindow::alignItemsLeft()
         return;
     }
     
-    // 找到标签背景项来获取标签边界
-    QGraphicsItem* labelBackground = nullptr;
-    for (QGraphicsItem* item : scene->items()) {
-        if (item->data(0).toString() == "labelBackground") {
-            labelBackground = item;
-            break;
-        }
-    }
-    
+    // 标签背景给出标签边界
+    QGraphicsItem* labelBackground = m_labelBackground;
     if (!labelBackground) {
         return;
     }
@@ -4458,7 +4550,7 @@ void MainWindow::alignItemsLeft()
     
     // 移动每个选中的项到左边界
     for (QGraphicsItem* item : selectedItems) {
-        if (item->data(0).toString() != "labelBackground") {  // 不移动标签背景自身
+        if (item != m_labelBackground) {  // 不移动标签背景自身
             QPointF oldPos = item->pos();
             QPointF newPos(labelLeft, oldPos.y());
             
@@ -4488,15 +4580,8 @@ void MainWindow::alignItemsCenter()
         return;
     }
     
-    // 找到标签背景项来获取标签边界
-    QGraphicsItem* labelBackground = nullptr;
-    for (QGraphicsItem* item : scene->items()) {
-        if (item->data(0).toString() == "labelBackground") {
-            labelBackground = item;
-            break;
-        }
-    }
-    
+    // 标签背景给出标签边界
+    QGraphicsItem* labelBackground = m_labelBackground;
     if (!labelBackground) {
         return;
     }
@@ -4512,7 +4597,7 @@ void MainWindow::alignItemsCenter()
     
     // 移动每个选中的项到中心
     for (QGraphicsItem* item : selectedItems) {
-        if (item->data(0).toString() != "labelBackground") {  // 不移动标签背景自身
+        if (item != m_labelBackground) {  // 不移动标签背景自身
             QPointF oldPos = item->pos();
             qreal itemWidth = 0;
             
@@ -4571,15 +4656,8 @@ void MainWindow::alignItemsRight()
         return;
     }
     
-    // 找到标签背景项来获取标签边界
-    QGraphicsItem* labelBackground = nullptr;
-    for (QGraphicsItem* item : scene->items()) {
-        if (item->data(0).toString() == "labelBackground") {
-            labelBackground = item;
-            break;
-        }
-    }
-    
+    // 标签背景给出标签边界
+    QGraphicsItem* labelBackground = m_labelBackground;
     if (!labelBackground) {
         return;
     }
@@ -4595,7 +4673,7 @@ void MainWindow::alignItemsRight()
     
     // 移动每个选中的项到右边界
     for (QGraphicsItem* item : selectedItems) {
-        if (item->data(0).toString() != "labelBackground") {  // 不移动标签背景自身
+        if (item != m_labelBackground) {  // 不移动标签背景自身
             QPointF oldPos = item->pos();
             qreal itemWidth = 0;
             
@@ -4689,14 +4767,9 @@ void MainWindow::normalizeSelectedItems()
     QList<QGraphicsItem*> sel = scene->selectedItems();
     if (sel.isEmpty()) return;
 
-    // 找到标签背景尺寸（场景中 data(0)=="labelBackground" 的 QGraphicsPathItem）
-    QRectF labelRectPx; // 场景坐标
-    for (QGraphicsItem* item : scene->items()) {
-        if (item && item->data(0).toString() == "labelBackground") {
-            labelRectPx = item->sceneBoundingRect();
-            break;
-        }
-    }
+    // 标签背景尺寸（场景坐标）
+    if (!m_labelBackground) return;
+    const QRectF labelRectPx = m_labelBackground->sceneBoundingRect();
     if (labelRectPx.isNull()) return;
 
     // 撤销宏：批量规格化
@@ -4753,25 +4826,25 @@ void MainWindow::normalizeSelectedItems()
 
     for (QGraphicsItem* item : sel) {
         if (!item) continue;
-        if (item->data(0).toString() == "labelBackground") continue;
+        if (item == m_labelBackground) continue;
         // 仅处理顶层选中项（不处理选择框）
         if (item->data(0).toString() == "selectionFrame") continue;
 
         // 使用内容矩形（不含手柄/描边padding）确保定位准确，避免偏移
         QRectF contentSceneRect;
-        if (auto ti = dynamic_cast<TextItem*>(item)) {
+        if (auto ti = qgraphicsitem_cast<TextItem*>(item)) {
             QPointF tl = item->mapToScene(QPointF(0,0));
             QPointF br = item->mapToScene(QPointF(ti->size().width(), ti->size().height()));
             contentSceneRect = QRectF(tl, br).normalized();
-        } else if (auto ii = dynamic_cast<ImageItem*>(item)) {
+        } else if (auto ii = qgraphicsitem_cast<ImageItem*>(item)) {
             QPointF tl = item->mapToScene(QPointF(0,0));
             QPointF br = item->mapToScene(QPointF(ii->size().width(), ii->size().height()));
             contentSceneRect = QRectF(tl, br).normalized();
-        } else if (auto ri = dynamic_cast<RectangleItem*>(item)) {
+        } else if (auto ri = qgraphicsitem_cast<RectangleItem*>(item)) {
             QPointF tl = item->mapToScene(QPointF(0,0));
             QPointF br = item->mapToScene(QPointF(ri->size().width(), ri->size().height()));
             contentSceneRect = QRectF(tl, br).normalized();
-        } else if (auto ci = dynamic_cast<CircleItem*>(item)) {
+        } else if (auto ci = qgraphicsitem_cast<CircleItem*>(item)) {
             QPointF tl = item->mapToScene(QPointF(0,0));
             QPointF br = item->mapToScene(QPointF(ci->size().width(), ci->size().height()));
             contentSceneRect = QRectF(tl, br).normalized();
@@ -4800,25 +4873,25 @@ void MainWindow::normalizeSelectedItems()
             pushMove(item, oldPos);
 
             // 尺寸收缩
-            if (auto textItem = dynamic_cast<TextItem*>(item)) {
+            if (auto textItem = qgraphicsitem_cast<TextItem*>(item)) {
                 QSizeF oldSize = textItem->size();
                 QRectF oldRect(QPointF(0,0), oldSize);
                 QSizeF newSize( qMax<qreal>(10.0, oldSize.width()), qMax<qreal>(10.0, oldSize.height()) );
                 textItem->setSize(newSize);
                 pushResize(item, oldRect, QRectF(QPointF(0,0), newSize));
-            } else if (auto img = dynamic_cast<ImageItem*>(item)) {
+            } else if (auto img = qgraphicsitem_cast<ImageItem*>(item)) {
                 QSizeF oldSize = img->size();
                 QRectF oldRect(QPointF(0,0), oldSize);
                 QSizeF newSize( qMax<qreal>(10.0, oldSize.width()), qMax<qreal>(10.0, oldSize.height()) );
                 img->setSize(newSize);
                 pushResize(item, oldRect, QRectF(QPointF(0,0), newSize));
-            } else if (auto rect = dynamic_cast<RectangleItem*>(item)) {
+            } else if (auto rect = qgraphicsitem_cast<RectangleItem*>(item)) {
                 QSizeF oldSize = rect->size();
                 QRectF oldRect(QPointF(0,0), oldSize);
                 QSizeF newSize( qMax<qreal>(10.0, oldSize.width()), qMax<qreal>(10.0, oldSize.height()) );
                 rect->setSize(newSize);
                 pushResize(item, oldRect, QRectF(QPointF(0,0), newSize));
-            } else if (auto circle = dynamic_cast<CircleItem*>(item)) {
+            } else if (auto circle = qgraphicsitem_cast<CircleItem*>(item)) {
                 QSizeF oldSize = circle->size();
                 QRectF oldRect(QPointF(0,0), oldSize);
                 QSizeF newSize( qMax<qreal>(10.0, oldSize.width()), qMax<qreal>(10.0, oldSize.height()) );
@@ -4842,9 +4915,9 @@ void MainWindow::normalizeSelectedItems()
 
         // 部分在外：需要裁剪或收缩
         // 对于可缩放的类型：调整尺寸与位置，使其局部内容矩形与交集对应
-        if (auto img = dynamic_cast<ImageItem*>(item)) {
+        if (auto img = qgraphicsitem_cast<ImageItem*>(item)) {
             // 图像：按照当前缩放比例计算源像素裁剪区域
-            QPixmap pm = img->pixmap();
+            const QImage pm = img->image();
             if (!pm.isNull()) {
                 // 局部->场景: item->mapToScene(localPoint)
                 QPointF localTopLeft = item->mapFromScene(inter.topLeft());
@@ -4859,12 +4932,12 @@ void MainWindow::normalizeSelectedItems()
                     qreal sh = localCropRect.height() * (pm.height() / oldSize.height());
                     QRect cropPx = QRect(qFloor(sx), qFloor(sy), qCeil(sw), qCeil(sh)).intersected(pm.rect());
                     if (!cropPx.isEmpty()) {
-                        QPixmap cropped = pm.copy(cropPx);
+                        const QImage cropped = pm.copy(cropPx);
                         QRectF oldRect(QPointF(0,0), oldSize);
                         // 暂时关闭等比以精确设置尺寸
                         bool oldKeep = img->keepAspectRatio();
                         img->setKeepAspectRatio(false);
-                        img->setPixmap(cropped);
+                        img->setImage(cropped);
                         img->setSize(cropped.size());
                         img->setKeepAspectRatio(oldKeep);
                         // 将 item 移动，使裁剪后图像与交集左上角对齐
@@ -4876,7 +4949,7 @@ void MainWindow::normalizeSelectedItems()
                     }
                 }
             }
-        } else if (auto textItem = dynamic_cast<TextItem*>(item)) {
+        } else if (auto textItem = qgraphicsitem_cast<TextItem*>(item)) {
             QSizeF oldSize = textItem->size();
             QRectF oldRect(QPointF(0,0), oldSize);
             // 收缩尺寸，不做内容智能裁剪（简单方式）
@@ -4891,7 +4964,7 @@ void MainWindow::normalizeSelectedItems()
             textItem->setSize(newSize);
             pushMove(item, oldPos);
             pushResize(item, oldRect, QRectF(QPointF(0,0), newSize));
-        } else if (auto rect = dynamic_cast<RectangleItem*>(item)) {
+        } else if (auto rect = qgraphicsitem_cast<RectangleItem*>(item)) {
             QSizeF oldSize = rect->size();
             QRectF oldRect(QPointF(0,0), oldSize);
             QPointF localTL = item->mapFromScene(inter.topLeft());
@@ -4905,7 +4978,7 @@ void MainWindow::normalizeSelectedItems()
             rect->setSize(newSize);
             pushMove(item, oldPos);
             pushResize(item, oldRect, QRectF(QPointF(0,0), newSize));
-        } else if (auto circle = dynamic_cast<CircleItem*>(item)) {
+        } else if (auto circle = qgraphicsitem_cast<CircleItem*>(item)) {
             QSizeF oldSize = circle->size();
             QRectF oldRect(QPointF(0,0), oldSize);
             QPointF localTL = item->mapFromScene(inter.topLeft());
@@ -4945,7 +5018,7 @@ void MainWindow::updateCornerRadius(int radius)
     if (!scene) return;
     QList<QGraphicsItem*> sel = scene->selectedItems();
     if (sel.isEmpty()) return;
-    RectangleItem* rect = dynamic_cast<RectangleItem*>(sel.first());
+    RectangleItem* rect = qgraphicsitem_cast<RectangleItem*>(sel.first());
     if (!rect) return;
     double oldR = rect->cornerRadius();
     double newR = radius;
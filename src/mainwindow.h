@@ -27,6 +27,8 @@
 #include <QPointF>
 #include <QRectF>
 #include <QHash>
+#include <QSet>
+#include <QJsonObject>
 #include <memory>
 #include "graphics/labelscene.h"
 #include "graphics/ruler.h"
@@ -37,6 +39,7 @@
 #include "dialogs/templatecenterdialog.h"
 #include "core/qrcodeelement.h"
 #include "core/textelement.h"
+#include "core/documentloader.h"
 #include "commands/undomanager.h"
 #include <QCheckBox>
 #include "panels/databaseprintwidget.h"
@@ -48,6 +51,9 @@ class DataSource;
 class PrintEngine;
 struct PrintContext;
 class BatchPrintManager;
+class DocumentWriter;
+class DocumentJournal;
+class ImageStore;
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -72,6 +78,14 @@ private slots:
 
     bool saveFile();
     bool saveFileAs();
+    void onDocumentSaveFinished(const QString &fileName, bool ok, const QString &errorMessage);
+    void onDocumentLoaded(const QString &fileName,
+                          std::shared_ptr<DocumentLoader::Document> document,
+                          const QString &errorMessage);
+    // 把未保存的修改写入崩溃恢复日志（定时调用）
+    void updateRecoveryJournal();
+    // 启动时检查崩溃遗留的恢复日志
+    void recoverFromJournal();
     void openPrintCenter();  // 统一打印中心
     //void openLayoutExportDialog(); // 排版导出
 
@@ -107,7 +121,15 @@ private:
     // 文件操作相关
     bool maybeSave();
     bool saveFile(const QString &fileName);
-    bool loadFile(const QString &fileName);
+    // 在后台读取文档，完成后由 onDocumentLoaded 重建场景；asTemplate 为 true 时作为新文档的模板
+    void loadFile(const QString &fileName, bool asTemplate = false);
+    // 用后台阶段创建的元素重建场景（界面线程阶段）
+    void loadDocument(DocumentLoader::Document &document);
+    // 文档根对象中除元素、图像与时间之外的部分
+    QJsonObject documentProperties() const;
+    // 单个图形项的 JSON（与 .lbl "items" 中相同）；图像登记到 images
+    QJsonObject serializeItem(QGraphicsItem *item, ImageStore *images) const;
+    bool isDocumentModified() const;
     //void writeSettings();
     //void readSettings();
 
@@ -118,7 +140,17 @@ private:
     void createDockWindows();
     void createStatusBar();
     void setInitialStyles();
-    void connectSignals();    void updateSelectedItemProperties();    // 码类相关（条形码和二维码）
+    void connectSignals();    void updateSelectedItemProperties();
+    // 属性面板：按选中项的类型标识（QGraphicsItem::type()）查表分派
+    using PropertyPanelHandler = void (MainWindow::*)(QGraphicsItem *item);
+    void registerPropertyPanels();
+    void showPropertyGroup(QGroupBox *group);
+    void showBarcodeProperties(QGraphicsItem *item);
+    void showQRCodeProperties(QGraphicsItem *item);
+    void showTextProperties(QGraphicsItem *item);
+    void showImageProperties(QGraphicsItem *item);
+    void showDrawingProperties(QGraphicsItem *item);
+    // 码类相关（条形码和二维码）
     void openAssetBrowser(); // 打开素材浏览对话框
     void updateCodeTypeComboBox(bool isQRCode); // 更新码类下拉框选项
     void connectCodeSignals();
@@ -147,16 +179,21 @@ private:
 
     void applyCodeDataSource();
     void applyTextDataSource();
+    void applyImageDataSource();
     void handleCodeDataSourceEnabledChanged(bool enabled);
     void handleTextDataSourceEnabledChanged(bool enabled);
+    void handleImageDataSourceEnabledChanged(bool enabled);
     void onSceneItemRemoved(QGraphicsItem* item);
 
     void syncCodeDataSourceWidget(QGraphicsItem* item);
     void syncTextDataSourceWidget(QGraphicsItem* item);
+    void syncImageDataSourceWidget(QGraphicsItem* item);
     void clearDataSourceBinding(QGraphicsItem* item);
 
     void initializePrinting();
     QList<labelelement*> collectElements(bool onlySelected = false) const;
+    // 保存到文档头中的缩略图（长边 256 像素）
+    QImage renderDocumentThumbnail() const;
     PrintContext buildPrintContext(QPrinter *printer) const;
     std::unique_ptr<labelelement> wrapItem(QGraphicsItem *item) const;
     std::optional<bool> promptSelectionChoice(const QString &title,
@@ -171,6 +208,8 @@ private:
     void updateImageHeight(int height);
     void updateImageKeepAspectRatio(bool keep);
     void updateImageOpacity(int opacity);
+    void updateRecordImageDirectory();
+    void browseRecordImageDirectory();
     ImageItem* getSelectedImageItem();
 
     // 绘图工具相关方法
@@ -216,6 +255,7 @@ private:
 
     // 图形场景相关
     LabelScene *scene = nullptr;
+    QGraphicsPathItem *m_labelBackground = nullptr;  // 标签背景，随场景存在，清空场景时保留
     QGraphicsView *view = nullptr;
     QWidget* cornerWidget = nullptr;
     bool m_isRubberBandSelecting = false;
@@ -295,6 +335,7 @@ private:
 
     DatabasePrintWidget *codeDatabaseWidget = nullptr;
     DatabasePrintWidget *textDatabaseWidget = nullptr;
+    DatabasePrintWidget *imageDatabaseWidget = nullptr;
 
     // 标签尺寸控件
     QComboBox *paperSizeComboBox = nullptr;
@@ -330,6 +371,8 @@ private:
     QSpinBox *imageHeightSpin = nullptr;
     QCheckBox *keepAspectRatioCheck = nullptr;
     QSpinBox *imageOpacitySpin = nullptr;
+    QLineEdit *recordImageDirEdit = nullptr;       // 按记录取图的目录
+    QPushButton *recordImageDirButton = nullptr;
 
     // 绘图工具设置控件
     QSpinBox *lineWidthSpin = nullptr;
@@ -395,10 +438,23 @@ private:
     };
 
     QHash<QGraphicsItem*, DataSourceBinding> m_itemDataSources;
+    QHash<int, PropertyPanelHandler> m_propertyPanels;   // 图形项类型 -> 属性面板
         std::unique_ptr<PrintEngine> m_printEngine;
     std::unique_ptr<BatchPrintManager> m_batchPrintManager;
 
         mutable std::vector<std::unique_ptr<labelelement>> m_elementCache;
+
+    // 后台保存与崩溃恢复日志
+    DocumentWriter *m_documentWriter = nullptr;
+    DocumentLoader *m_documentLoader = nullptr;
+    bool m_loadingTemplate = false;         // 正在读取的文档作为新文档的模板
+    std::unique_ptr<DocumentJournal> m_journal;
+    QTimer *m_journalTimer = nullptr;
+    quint64 m_nextJournalId = 1;                    // 日志元素标识记在图形项的 data() 中
+    QHash<quint64, QJsonObject> m_journalItems;     // 上次写入日志的元素 JSON，按日志标识索引
+    QSet<QGraphicsItem*> m_journalDirtyItems;       // 此后被重绘区域触及或改绑数据源的元素
+    QJsonObject m_journalDocument;
+    int m_journalUndoIndex = -1;
 signals:
     void zoomFactorChanged(double factor);
 };
@@ -0,0 +1,531 @@
+#include "bandimagewriter.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QSaveFile>
+#include <QtGui/QImage>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <jpeglib.h>
+#include <zlib.h>
+
+// 编码器只处理 8 位 RGB / RGBA 扫描线，逐行输入，输出追加到字节缓冲区；
+// 编码库报错时返回 false
+class BandImageWriter::Encoder
+{
+public:
+    virtual ~Encoder() = default;
+    virtual bool begin(std::vector<uchar> &out) = 0;
+    virtual bool writeRow(const uchar *row, std::vector<uchar> &out) = 0;
+    virtual bool finish(std::vector<uchar> &out) = 0;
+};
+
+namespace {
+
+void appendU32(std::vector<uchar> &out, quint32 value)
+{
+    out.push_back(static_cast<uchar>((value >> 24) & 0xFF));
+    out.push_back(static_cast<uchar>((value >> 16) & 0xFF));
+    out.push_back(static_cast<uchar>((value >> 8) & 0xFF));
+    out.push_back(static_cast<uchar>(value & 0xFF));
+}
+
+void appendPngChunk(std::vector<uchar> &out, const char type[4], const uchar *data, size_t length)
+{
+    appendU32(out, static_cast<quint32>(length));
+    const size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    if (length > 0) {
+        out.insert(out.end(), data, data + length);
+    }
+    const uLong crc = crc32(0L, out.data() + typeOffset, static_cast<uInt>(length + 4));
+    appendU32(out, static_cast<quint32>(crc));
+}
+
+// ---------------------------------------------------------------------------
+// PNG：逐行滤波，IDAT 由 zlib 流式压缩，压缩缓冲区写满即输出一个 IDAT 块
+// ---------------------------------------------------------------------------
+
+class PngEncoder : public BandImageWriter::Encoder
+{
+public:
+    PngEncoder(int width, int height, int channels, quint32 pixelsPerMeterX, quint32 pixelsPerMeterY)
+        : m_width(width)
+        , m_height(height)
+        , m_channels(channels)
+        , m_pixelsPerMeterX(pixelsPerMeterX)
+        , m_pixelsPerMeterY(pixelsPerMeterY)
+        , m_previousRow(static_cast<size_t>(width) * channels, 0)
+        , m_filtered(static_cast<size_t>(width) * channels + 1)
+        , m_candidate(static_cast<size_t>(width) * channels + 1)
+        , m_idat(kIdatChunkSize)
+    {
+    }
+
+    ~PngEncoder() override
+    {
+        if (m_streamReady) {
+            deflateEnd(&m_stream);
+        }
+    }
+
+    bool begin(std::vector<uchar> &out) override
+    {
+        static const uchar kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        out.insert(out.end(), kSignature, kSignature + 8);
+
+        std::vector<uchar> header;
+        appendU32(header, static_cast<quint32>(m_width));
+        appendU32(header, static_cast<quint32>(m_height));
+        header.push_back(8);                       // 位深
+        header.push_back(m_channels == 4 ? 6 : 2); // RGBA / RGB
+        header.push_back(0);                       // deflate
+        header.push_back(0);                       // 自适应滤波
+        header.push_back(0);                       // 非隔行
+        appendPngChunk(out, "IHDR", header.data(), header.size());
+
+        if (m_pixelsPerMeterX > 0 && m_pixelsPerMeterY > 0) {
+            std::vector<uchar> physical;
+            appendU32(physical, m_pixelsPerMeterX);
+            appendU32(physical, m_pixelsPerMeterY);
+            physical.push_back(1); // 单位：米
+            appendPngChunk(out, "pHYs", physical.data(), physical.size());
+        }
+
+        m_stream = z_stream();
+        if (deflateInit(&m_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            return false;
+        }
+        m_streamReady = true;
+        m_stream.next_out = m_idat.data();
+        m_stream.avail_out = static_cast<uInt>(m_idat.size());
+        return true;
+    }
+
+    bool writeRow(const uchar *row, std::vector<uchar> &out) override
+    {
+        filterRow(row);
+        std::memcpy(m_previousRow.data(), row, m_previousRow.size());
+        return compress(m_filtered.data(), m_filtered.size(), Z_NO_FLUSH, out);
+    }
+
+    bool finish(std::vector<uchar> &out) override
+    {
+        if (!compress(nullptr, 0, Z_FINISH, out)) {
+            return false;
+        }
+        const size_t pending = m_idat.size() - m_stream.avail_out;
+        if (pending > 0) {
+            appendPngChunk(out, "IDAT", m_idat.data(), pending);
+        }
+        appendPngChunk(out, "IEND", nullptr, 0);
+        return true;
+    }
+
+private:
+    static constexpr size_t kIdatChunkSize = 64 * 1024;
+
+    static quint64 filterCost(const std::vector<uchar> &filtered)
+    {
+        quint64 cost = 0;
+        for (size_t i = 1; i < filtered.size(); ++i) {
+            cost += static_cast<quint64>(std::abs(static_cast<int>(static_cast<signed char>(filtered[i]))));
+        }
+        return cost;
+    }
+
+    // 在 None / Sub / Up 中选择绝对值和最小的滤波方式
+    void filterRow(const uchar *row)
+    {
+        const size_t length = m_previousRow.size();
+
+        m_filtered[0] = 0;
+        std::memcpy(m_filtered.data() + 1, row, length);
+        quint64 bestCost = filterCost(m_filtered);
+
+        m_candidate[0] = 1;
+        for (size_t i = 0; i < length; ++i) {
+            const uchar left = i >= static_cast<size_t>(m_channels) ? row[i - m_channels] : 0;
+            m_candidate[i + 1] = static_cast<uchar>(row[i] - left);
+        }
+        quint64 cost = filterCost(m_candidate);
+        if (cost < bestCost) {
+            bestCost = cost;
+            m_filtered.swap(m_candidate);
+        }
+
+        m_candidate[0] = 2;
+        for (size_t i = 0; i < length; ++i) {
+            m_candidate[i + 1] = static_cast<uchar>(row[i] - m_previousRow[i]);
+        }
+        cost = filterCost(m_candidate);
+        if (cost < bestCost) {
+            m_filtered.swap(m_candidate);
+        }
+    }
+
+    // Z_NO_FLUSH 时消耗完输入即返回，Z_FINISH 时直到流结束；压缩缓冲区满时写出 IDAT
+    bool compress(const uchar *data, size_t length, int flush, std::vector<uchar> &out)
+    {
+        m_stream.next_in = const_cast<Bytef *>(data);
+        m_stream.avail_in = static_cast<uInt>(length);
+        for (;;) {
+            const int result = deflate(&m_stream, flush);
+            if (result == Z_STREAM_ERROR) {
+                return false;
+            }
+            const bool done = flush == Z_FINISH ? result == Z_STREAM_END
+                                                : (m_stream.avail_in == 0 && m_stream.avail_out > 0);
+            if (m_stream.avail_out == 0) {
+                appendPngChunk(out, "IDAT", m_idat.data(), m_idat.size());
+                m_stream.next_out = m_idat.data();
+                m_stream.avail_out = static_cast<uInt>(m_idat.size());
+            }
+            if (done) {
+                return true;
+            }
+        }
+    }
+
+    int m_width;
+    int m_height;
+    int m_channels;
+    quint32 m_pixelsPerMeterX;
+    quint32 m_pixelsPerMeterY;
+    std::vector<uchar> m_previousRow;
+    std::vector<uchar> m_filtered;
+    std::vector<uchar> m_candidate;
+    std::vector<uchar> m_idat;
+    z_stream m_stream = z_stream();
+    bool m_streamReady = false;
+};
+
+// ---------------------------------------------------------------------------
+// JPEG：libjpeg 逐行写出，YCbCr 4:4:4（条码、小字不做色度下采样）
+// ---------------------------------------------------------------------------
+
+// libjpeg 出错时默认直接退出进程，改为跳回调用处
+struct JpegErrorManager {
+    jpeg_error_mgr pub;
+    std::jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr info)
+{
+    std::longjmp(reinterpret_cast<JpegErrorManager *>(info->err)->jump, 1);
+}
+
+void jpegOutputMessage(j_common_ptr)
+{
+}
+
+// 压缩结果先进入定长缓冲区，写满后追加到调用方的输出缓冲区
+struct JpegDestination {
+    jpeg_destination_mgr pub;
+    std::vector<uchar> *out = nullptr;
+    std::array<JOCTET, 16 * 1024> buffer;
+};
+
+void jpegInitDestination(j_compress_ptr info)
+{
+    auto *destination = reinterpret_cast<JpegDestination *>(info->dest);
+    destination->pub.next_output_byte = destination->buffer.data();
+    destination->pub.free_in_buffer = destination->buffer.size();
+}
+
+boolean jpegEmptyOutputBuffer(j_compress_ptr info)
+{
+    auto *destination = reinterpret_cast<JpegDestination *>(info->dest);
+    destination->out->insert(destination->out->end(), destination->buffer.begin(), destination->buffer.end());
+    destination->pub.next_output_byte = destination->buffer.data();
+    destination->pub.free_in_buffer = destination->buffer.size();
+    return TRUE;
+}
+
+void jpegTermDestination(j_compress_ptr info)
+{
+    auto *destination = reinterpret_cast<JpegDestination *>(info->dest);
+    const size_t used = destination->buffer.size() - destination->pub.free_in_buffer;
+    destination->out->insert(destination->out->end(), destination->buffer.begin(),
+                             destination->buffer.begin() + used);
+}
+
+class JpegEncoder : public BandImageWriter::Encoder
+{
+public:
+    JpegEncoder(int width, int height, int quality, int dotsPerInchX, int dotsPerInchY)
+        : m_width(width)
+        , m_height(height)
+        , m_quality(std::clamp(quality, 1, 100))
+        , m_dotsPerInchX(dotsPerInchX)
+        , m_dotsPerInchY(dotsPerInchY)
+    {
+        m_info.err = jpeg_std_error(&m_error.pub);
+        m_error.pub.error_exit = jpegErrorExit;
+        m_error.pub.output_message = jpegOutputMessage;
+        m_destination.pub.init_destination = jpegInitDestination;
+        m_destination.pub.empty_output_buffer = jpegEmptyOutputBuffer;
+        m_destination.pub.term_destination = jpegTermDestination;
+    }
+
+    ~JpegEncoder() override
+    {
+        if (m_created) {
+            jpeg_destroy_compress(&m_info);
+        }
+    }
+
+    // 调用 libjpeg 的函数不持有需要析构的局部对象，longjmp 跳回时不会跳过析构
+    bool begin(std::vector<uchar> &out) override
+    {
+        m_destination.out = &out;
+        if (setjmp(m_error.jump)) {
+            return false;
+        }
+        jpeg_create_compress(&m_info);
+        m_created = true;
+        m_info.dest = &m_destination.pub;
+        m_info.image_width = static_cast<JDIMENSION>(m_width);
+        m_info.image_height = static_cast<JDIMENSION>(m_height);
+        m_info.input_components = 3;
+        m_info.in_color_space = JCS_RGB;
+        jpeg_set_defaults(&m_info);
+        jpeg_set_quality(&m_info, m_quality, TRUE);
+        for (int i = 0; i < m_info.num_components; ++i) {
+            m_info.comp_info[i].h_samp_factor = 1;
+            m_info.comp_info[i].v_samp_factor = 1;
+        }
+        if (m_dotsPerInchX > 0 && m_dotsPerInchY > 0) {
+            m_info.density_unit = 1; // DPI
+            m_info.X_density = static_cast<UINT16>(std::min(m_dotsPerInchX, 65535));
+            m_info.Y_density = static_cast<UINT16>(std::min(m_dotsPerInchY, 65535));
+        }
+        jpeg_start_compress(&m_info, TRUE);
+        return true;
+    }
+
+    bool writeRow(const uchar *row, std::vector<uchar> &out) override
+    {
+        m_destination.out = &out;
+        if (setjmp(m_error.jump)) {
+            return false;
+        }
+        JSAMPROW rows[1] = { const_cast<JSAMPLE *>(row) };
+        return jpeg_write_scanlines(&m_info, rows, 1) == 1;
+    }
+
+    bool finish(std::vector<uchar> &out) override
+    {
+        m_destination.out = &out;
+        if (setjmp(m_error.jump)) {
+            return false;
+        }
+        jpeg_finish_compress(&m_info);
+        return true;
+    }
+
+private:
+    int m_width;
+    int m_height;
+    int m_quality;
+    int m_dotsPerInchX;
+    int m_dotsPerInchY;
+    jpeg_compress_struct m_info = jpeg_compress_struct();
+    JpegErrorManager m_error = JpegErrorManager();
+    JpegDestination m_destination;
+    bool m_created = false;
+};
+
+std::unique_ptr<BandImageWriter::Encoder> createEncoder(BandImageWriter::Format format,
+                                                       const QSize &size,
+                                                       bool opaque,
+                                                       int quality,
+                                                       qreal dpiX,
+                                                       qreal dpiY)
+{
+    if (format == BandImageWriter::Format::Png) {
+        const quint32 ppmX = dpiX > 0.0 ? static_cast<quint32>(std::lround(dpiX / 0.0254)) : 0;
+        const quint32 ppmY = dpiY > 0.0 ? static_cast<quint32>(std::lround(dpiY / 0.0254)) : 0;
+        return std::make_unique<PngEncoder>(size.width(), size.height(), opaque ? 3 : 4, ppmX, ppmY);
+    }
+    return std::make_unique<JpegEncoder>(size.width(), size.height(), quality,
+                                         static_cast<int>(std::lround(dpiX)),
+                                         static_cast<int>(std::lround(dpiY)));
+}
+
+} // namespace
+
+BandImageWriter::BandImageWriter() = default;
+
+BandImageWriter::~BandImageWriter()
+{
+    cancel();
+}
+
+bool BandImageWriter::formatForSuffix(const QString &suffix, Format *format)
+{
+    // 兼容 "label.png" 之类的复合后缀，只看最后一段
+    const QString lower = suffix.section(QLatin1Char('.'), -1).toLower();
+    Format detected = Format::Png;
+    if (lower == QStringLiteral("png")) {
+        detected = Format::Png;
+    } else if (lower == QStringLiteral("jpg") || lower == QStringLiteral("jpeg")) {
+        detected = Format::Jpeg;
+    } else {
+        return false;
+    }
+    if (format) {
+        *format = detected;
+    }
+    return true;
+}
+
+void BandImageWriter::setQuality(int quality)
+{
+    m_quality = std::clamp(quality, 1, 100);
+}
+
+bool BandImageWriter::open(const QString &filePath,
+                           Format format,
+                           const QSize &size,
+                           bool opaque,
+                           qreal dpiX,
+                           qreal dpiY,
+                           QString *errorMessage)
+{
+    cancel();
+
+    if (size.isEmpty() || (format == Format::Jpeg && (size.width() > 65535 || size.height() > 65535))) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("图像尺寸无效：%1 × %2").arg(size.width()).arg(size.height());
+        }
+        return false;
+    }
+
+    auto file = std::make_unique<QSaveFile>(filePath);
+    if (!file->open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无法写入文件：%1").arg(filePath);
+        }
+        return false;
+    }
+
+    m_format = format;
+    m_size = size;
+    // JPEG 没有透明通道
+    m_opaque = opaque || format == Format::Jpeg;
+    m_filePath = filePath;
+    m_rowsWritten = 0;
+    m_output.clear();
+    m_file = std::move(file);
+
+    m_encoder = createEncoder(format, size, m_opaque, m_quality, dpiX, dpiY);
+    if (!m_encoder->begin(m_output)) {
+        return failEncoding(errorMessage);
+    }
+    return flushOutput(errorMessage);
+}
+
+bool BandImageWriter::writeBand(const QImage &band, QString *errorMessage)
+{
+    if (!m_file || !m_encoder) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("图像文件未打开");
+        }
+        return false;
+    }
+
+    if (band.width() != m_size.width() || band.height() > m_size.height() - m_rowsWritten) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("条带尺寸与图像不一致：%1").arg(m_filePath);
+        }
+        cancel();
+        return false;
+    }
+
+    // 编码器需要非预乘的 8 位 RGB / RGBA 扫描线
+    const QImage rows = band.convertToFormat(m_opaque ? QImage::Format_RGB888 : QImage::Format_RGBA8888);
+    for (int y = 0; y < rows.height(); ++y) {
+        if (!m_encoder->writeRow(rows.constScanLine(y), m_output)) {
+            return failEncoding(errorMessage);
+        }
+    }
+    m_rowsWritten += rows.height();
+    return flushOutput(errorMessage);
+}
+
+bool BandImageWriter::finish(QString *errorMessage)
+{
+    if (!m_file || !m_encoder) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("图像文件未打开");
+        }
+        return false;
+    }
+
+    if (m_rowsWritten != m_size.height()) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("图像数据不完整：%1").arg(m_filePath);
+        }
+        cancel();
+        return false;
+    }
+
+    if (!m_encoder->finish(m_output)) {
+        return failEncoding(errorMessage);
+    }
+    if (!flushOutput(errorMessage)) {
+        return false;
+    }
+
+    const bool committed = m_file->commit();
+    m_file.reset();
+    m_encoder.reset();
+    if (!committed && errorMessage) {
+        *errorMessage = QObject::tr("无法写入文件：%1").arg(m_filePath);
+    }
+    return committed;
+}
+
+void BandImageWriter::cancel()
+{
+    if (m_file) {
+        m_file->cancelWriting();
+    }
+    m_file.reset();
+    m_encoder.reset();
+    m_output.clear();
+}
+
+bool BandImageWriter::failEncoding(QString *errorMessage)
+{
+    if (errorMessage) {
+        *errorMessage = QObject::tr("图像编码失败：%1").arg(m_filePath);
+    }
+    cancel();
+    return false;
+}
+
+bool BandImageWriter::flushOutput(QString *errorMessage)
+{
+    if (m_output.empty()) {
+        return true;
+    }
+
+    const qint64 length = static_cast<qint64>(m_output.size());
+    const bool ok = m_file && m_file->write(reinterpret_cast<const char *>(m_output.data()), length) == length;
+    m_output.clear();
+    if (!ok) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无法写入文件：%1").arg(m_filePath);
+        }
+        cancel();
+    }
+    return ok;
+}
@@ -0,0 +1,75 @@
+#ifndef BANDIMAGEWRITER_H
+#define BANDIMAGEWRITER_H
+
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <memory>
+#include <vector>
+
+class QImage;
+class QSaveFile;
+
+// 按水平条带流式写出 PNG/JPEG：调用方按从上到下的顺序提交条带，
+// 每个条带编码后立即写盘，内存占用与页面尺寸无关。
+// PNG 的 IDAT 由 zlib 流式压缩，JPEG 由 libjpeg 逐行写出。
+class BandImageWriter
+{
+public:
+    enum class Format {
+        Png,
+        Jpeg
+    };
+
+    BandImageWriter();
+    ~BandImageWriter();
+
+    BandImageWriter(const BandImageWriter &) = delete;
+    BandImageWriter &operator=(const BandImageWriter &) = delete;
+
+    // 根据文件后缀识别格式（png / jpg / jpeg）
+    static bool formatForSuffix(const QString &suffix, Format *format);
+
+    // JPEG 质量（1~100），需在 open 之前设置
+    void setQuality(int quality);
+
+    bool open(const QString &filePath,
+              Format format,
+              const QSize &size,
+              bool opaque,
+              qreal dpiX,
+              qreal dpiY,
+              QString *errorMessage);
+
+    // 追加条带：宽度须与图像一致，行数不超过剩余行数
+    bool writeBand(const QImage &band, QString *errorMessage);
+
+    // 写完所有行后提交文件；未写满时返回失败并放弃文件
+    bool finish(QString *errorMessage);
+
+    // 放弃当前文件（不会留下不完整的输出）
+    void cancel();
+
+    bool isOpen() const { return static_cast<bool>(m_file); }
+    int rowsWritten() const { return m_rowsWritten; }
+    QSize size() const { return m_size; }
+
+    class Encoder;
+
+private:
+    bool flushOutput(QString *errorMessage);
+    bool failEncoding(QString *errorMessage);
+
+    std::unique_ptr<QSaveFile> m_file;
+    std::unique_ptr<Encoder> m_encoder;
+    std::vector<uchar> m_output;
+    QString m_filePath;
+    QSize m_size;
+    Format m_format = Format::Png;
+    bool m_opaque = true;
+    int m_quality = 75;
+    int m_rowsWritten = 0;
+};
+
+#endif // BANDIMAGEWRITER_H
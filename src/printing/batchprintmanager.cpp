@@ -3,15 +3,20 @@
 #include "printengine.h"
 #include "printcontext.h"
 #include "printrenderer.h"
+#include "symbolprefetcher.h"
+#include "symbolverifier.h"
 #include "../core/labelelement.h"
 #include "../core/datasource.h"
 #include "../core/textelement.h"
 #include "../core/barcodeelement.h"
 #include "../core/qrcodeelement.h"
+#include "../core/imageelement.h"
 
 #include <QtCore/QVector>
 #include <QtGui/QPainter>
 
+#include <algorithm>
+
 namespace {
 
 struct DataBinding
@@ -21,6 +26,7 @@ struct DataBinding
     TextElement *text = nullptr;
     BarcodeElement *barcode = nullptr;
     QRCodeElement *qrcode = nullptr;
+    ImageElement *image = nullptr;
 
     bool applyRecord(int index) const
     {
@@ -33,6 +39,9 @@ struct DataBinding
         if (qrcode) {
             return qrcode->applyDataSourceRecord(index);
         }
+        if (image) {
+            return image->applyDataSourceRecord(index);
+        }
         return true;
     }
 
@@ -44,6 +53,8 @@ struct DataBinding
             barcode->restoreOriginalData();
         } else if (qrcode) {
             qrcode->restoreOriginalData();
+        } else if (image) {
+            image->restoreOriginalData();
         }
     }
 };
@@ -76,6 +87,21 @@ const QList<labelelement*> &BatchPrintManager::elements() const
     return m_elements;
 }
 
+void BatchPrintManager::setVerificationInterval(int interval)
+{
+    m_verificationInterval = std::max(0, interval);
+}
+
+int BatchPrintManager::verificationInterval() const
+{
+    return m_verificationInterval;
+}
+
+SymbolVerifier::Summary BatchPrintManager::verificationSummary() const
+{
+    return m_verificationSummary;
+}
+
 bool BatchPrintManager::execute(const PrintContext &context, QString *errorMessage)
 {
     return execute(context, 0, -1, errorMessage);
@@ -83,6 +109,8 @@ bool BatchPrintManager::execute(const PrintContext &context, QString *errorMessa
 
 bool BatchPrintManager::execute(const PrintContext &context, int firstRecord, int lastRecord, QString *errorMessage)
 {
+    m_verificationSummary = SymbolVerifier::Summary();
+
     if (!m_engine) {
         if (errorMessage) {
             *errorMessage = tr("批量打印缺少打印引擎实例");
@@ -159,8 +187,9 @@ bool BatchPrintManager::execute(const PrintContext &context, int firstRecord, in
         binding.text = dynamic_cast<TextElement*>(element);
         binding.barcode = dynamic_cast<BarcodeElement*>(element);
         binding.qrcode = dynamic_cast<QRCodeElement*>(element);
+        binding.image = dynamic_cast<ImageElement*>(element);
 
-        if (!binding.text && !binding.barcode && !binding.qrcode) {
+        if (!binding.text && !binding.barcode && !binding.qrcode && !binding.image) {
             if (errorMessage) {
                 *errorMessage = tr("元素类型 %1 不支持数据源应用")
                                     .arg(element->getType());
@@ -220,7 +249,18 @@ bool BatchPrintManager::execute(const PrintContext &context, int firstRecord, in
     bool success = true;
     QString lastError;
 
+    // 后续记录的条码/二维码在线程池中提前编码、记录图像提前解码，与当前记录的绘制重叠
+    SymbolPrefetcher prefetcher(printable, context.printer);
+
+    // 抽检记录的栅格在后台解码回读，结果逐条通过 recordVerified 报告
+    SymbolVerifier verifier(printable, renderer, context, m_verificationInterval);
+    verifier.setResultHandler([this](const SymbolVerifier::RecordResult &result) {
+        emit recordVerified(result.index, result.passed, result.missing);
+    });
+
     for (int index = startIndex; index <= endIndex && success; ++index) {
+        prefetcher.advance(index, endIndex);
+
         for (const DataBinding &binding : bindings) {
             if (!binding.applyRecord(index)) {
                 success = false;
@@ -242,6 +282,7 @@ bool BatchPrintManager::execute(const PrintContext &context, int firstRecord, in
         }
 
         emit recordPrinted(index);
+        verifier.submit(index);
 
         if (index < endIndex) {
             if (!context.printer->newPage()) {
@@ -252,10 +293,15 @@ bool BatchPrintManager::execute(const PrintContext &context, int firstRecord, in
         }
     }
 
+    prefetcher.cancel();
     for (const DataBinding &binding : bindings) {
         binding.restore();
     }
 
+    // 先结束绘制提交打印作业，再等待剩余的校验
+    painter.end();
+    m_verificationSummary = verifier.finish();
+
     if (!success && errorMessage) {
         *errorMessage = lastError.isEmpty()
                              ? tr("批量打印过程中发生未知错误")
@@ -6,6 +6,8 @@
 #include <QtCore/QList>
 #include <memory>
 
+#include "symbolverifier.h"
+
 class QGraphicsItem;
 class labelelement;
 class PrintEngine;
@@ -27,12 +29,22 @@ public:
     bool execute(const PrintContext &context, QString *errorMessage = nullptr);
     bool execute(const PrintContext &context, int firstRecord, int lastRecord, QString *errorMessage);
 
+    // 解码回读校验：每 interval 条记录校验一条，0 表示关闭
+    void setVerificationInterval(int interval);
+    int verificationInterval() const;
+    // 最近一次 execute 的校验汇总
+    SymbolVerifier::Summary verificationSummary() const;
+
 signals:
     void recordPrinted(int index);
+    // 在校验线程中发出；missing 为未读到的载荷
+    void recordVerified(int index, bool passed, const QStringList &missing);
 
 private:
     PrintEngine *m_engine = nullptr;
     QList<labelelement*> m_elements;
+    int m_verificationInterval = 0;
+    SymbolVerifier::Summary m_verificationSummary;
 };
 
 #endif // BATCHPRINTMANAGER_H
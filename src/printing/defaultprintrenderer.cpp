@@ -61,13 +61,6 @@ bool DefaultPrintRenderer::render(QPainter &painter,
                                   const PrintContext &context,
                                   QString *errorMessage)
 {
-    if (!context.sourceScene) {
-        if (errorMessage) {
-            *errorMessage = QObject::tr("打印上下文缺少源场景");
-        }
-        return false;
-    }
-
     const QRectF designRect = resolveDesignRect(elements, context);
     if (designRect.width() <= 0 || designRect.height() <= 0) {
         if (errorMessage) {
@@ -114,8 +107,28 @@ bool DefaultPrintRenderer::render(QPainter &painter,
 
     painter.fillRect(targetRect, Qt::white);
 
-    context.sourceScene->render(&painter, targetRect, designRect, Qt::IgnoreAspectRatio);
+    const bool rendered = renderContent(painter, elements, context, targetRect, designRect, errorMessage);
 
     painter.restore();
+    return rendered;
+}
+
+bool DefaultPrintRenderer::renderContent(QPainter &painter,
+                                         const QList<labelelement*> &elements,
+                                         const PrintContext &context,
+                                         const QRectF &targetRect,
+                                         const QRectF &designRect,
+                                         QString *errorMessage)
+{
+    Q_UNUSED(elements);
+
+    if (!context.sourceScene) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("打印上下文缺少源场景");
+        }
+        return false;
+    }
+
+    context.sourceScene->render(&painter, targetRect, designRect, Qt::IgnoreAspectRatio);
     return true;
 }
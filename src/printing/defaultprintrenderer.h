@@ -3,6 +3,8 @@
 
 #include "printrenderer.h"
 
+class QRectF;
+
 class DefaultPrintRenderer : public PrintRenderer
 {
 public:
@@ -10,6 +12,16 @@ public:
                 const QList<labelelement*> &elements,
                 const PrintContext &context,
                 QString *errorMessage) override;
+
+protected:
+    // 绘制标签内容：painter 已完成页边距平移、毫米缩放、圆角裁剪与白底填充，
+    // designRect 为标签坐标中的源区域，需映射到 targetRect。默认实现交给源场景绘制。
+    virtual bool renderContent(QPainter &painter,
+                               const QList<labelelement*> &elements,
+                               const PrintContext &context,
+                               const QRectF &targetRect,
+                               const QRectF &designRect,
+                               QString *errorMessage);
 };
 
 #endif // DEFAULTPRINTRENDERER_H
@@ -0,0 +1,100 @@
+#include "elementmodelrenderer.h"
+
+#include "printcontext.h"
+#include "../core/labelelement.h"
+
+#include <QtCore/QRectF>
+#include <QtGui/QPainter>
+
+#include <algorithm>
+#include <utility>
+
+ElementModelRenderer::RenderList ElementModelRenderer::buildRenderList(const QList<labelelement*> &elements)
+{
+    QVector<std::pair<qreal, Node>> ordered;
+    ordered.reserve(elements.size());
+    for (labelelement *element : elements) {
+        if (!element || !element->isRenderVisible()) {
+            continue;
+        }
+        const qreal opacity = element->renderOpacity();
+        if (opacity <= 0.0) {
+            continue;
+        }
+
+        Node node;
+        node.element = element;
+        node.transform = element->renderTransform();
+        node.opacity = opacity;
+        ordered.append({element->renderZValue(), node});
+    }
+
+    std::stable_sort(ordered.begin(), ordered.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    RenderList list;
+    list.reserve(ordered.size());
+    for (const auto &entry : std::as_const(ordered)) {
+        list.append(entry.second);
+    }
+    return list;
+}
+
+void ElementModelRenderer::paintRenderList(QPainter &painter, const RenderList &list)
+{
+    const QTransform baseTransform = painter.worldTransform();
+    const qreal baseOpacity = painter.opacity();
+
+    for (const Node &node : list) {
+        painter.save();
+        painter.setWorldTransform(node.transform * baseTransform);
+        painter.setOpacity(baseOpacity * node.opacity);
+        node.element->paintContent(&painter);
+        painter.restore();
+    }
+}
+
+void ElementModelRenderer::paintElements(QPainter &painter,
+                                         const QList<labelelement*> &elements,
+                                         const QRectF &targetRect,
+                                         const QRectF &sourceRect,
+                                         Qt::AspectRatioMode aspectRatioMode)
+{
+    if (targetRect.isEmpty() || sourceRect.isEmpty()) {
+        return;
+    }
+
+    // 与 QGraphicsScene::render 相同的映射规则，替换后输出位置不变
+    qreal xratio = targetRect.width() / sourceRect.width();
+    qreal yratio = targetRect.height() / sourceRect.height();
+    if (aspectRatioMode == Qt::KeepAspectRatio) {
+        xratio = yratio = std::min(xratio, yratio);
+    } else if (aspectRatioMode == Qt::KeepAspectRatioByExpanding) {
+        xratio = yratio = std::max(xratio, yratio);
+    }
+
+    const RenderList list = buildRenderList(elements);
+
+    painter.save();
+    painter.setClipRect(targetRect, Qt::IntersectClip);
+    painter.translate(targetRect.left(), targetRect.top());
+    painter.scale(xratio, yratio);
+    painter.translate(-sourceRect.left(), -sourceRect.top());
+    paintRenderList(painter, list);
+    painter.restore();
+}
+
+bool ElementModelRenderer::renderContent(QPainter &painter,
+                                         const QList<labelelement*> &elements,
+                                         const PrintContext &context,
+                                         const QRectF &targetRect,
+                                         const QRectF &designRect,
+                                         QString *errorMessage)
+{
+    Q_UNUSED(context);
+    Q_UNUSED(errorMessage);
+
+    paintElements(painter, elements, targetRect, designRect, Qt::IgnoreAspectRatio);
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef ELEMENTMODELRENDERER_H
+#define ELEMENTMODELRENDERER_H
+
+#include "defaultprintrenderer.h"
+
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtGui/QTransform>
+
+class QRectF;
+
+// 直接按元素模型输出：按 z 值排好序的元素列表 + 每个元素的变换 + 纯绘制例程。
+// 不经过 QGraphicsScene::render，也就没有场景索引遍历、样式选项和选择框/手柄绘制，
+// 打印时不再需要源场景。
+class ElementModelRenderer : public DefaultPrintRenderer
+{
+public:
+    struct Node {
+        const labelelement *element = nullptr;
+        QTransform transform;
+        qreal opacity = 1.0;
+    };
+    using RenderList = QVector<Node>;
+
+    // 采集绘制列表：跳过隐藏元素，按 z 值稳定排序（同 z 值保持列表顺序）。
+    // 变换读自图形项，须在元素所在线程（通常是 GUI 线程）调用。
+    static RenderList buildRenderList(const QList<labelelement*> &elements);
+
+    // 纯绘制：painter 已映射到标签坐标（像素），不访问场景。元素内容仍读自图形项，
+    // 场景中的元素须在 GUI 线程绘制；未加入场景的元素可在拥有它的线程中绘制
+    static void paintRenderList(QPainter &painter, const RenderList &list);
+
+    // 便捷接口：把标签坐标中的 sourceRect 映射到 targetRect 并绘制元素
+    static void paintElements(QPainter &painter,
+                              const QList<labelelement*> &elements,
+                              const QRectF &targetRect,
+                              const QRectF &sourceRect,
+                              Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio);
+
+protected:
+    bool renderContent(QPainter &painter,
+                       const QList<labelelement*> &elements,
+                       const PrintContext &context,
+                       const QRectF &targetRect,
+                       const QRectF &designRect,
+                       QString *errorMessage) override;
+};
+
+#endif // ELEMENTMODELRENDERER_H
@@ -0,0 +1,617 @@
+#include "imposition.h"
+
+#include "bandimagewriter.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QRect>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtPrintSupport/QPrinter>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace {
+constexpr double kMillimetrePerInch = 25.4;
+constexpr double kFitEpsilon = 1e-6;
+
+double mmToDevice(double mm, double dpi)
+{
+    return (dpi / kMillimetrePerInch) * mm;
+}
+
+QRectF cellRectPx(const ImpositionCell &cell, const QPointF &pageOrigin, qreal dpiX, qreal dpiY)
+{
+    return QRectF(pageOrigin.x() + mmToDevice(cell.rectMM.x(), dpiX),
+                  pageOrigin.y() + mmToDevice(cell.rectMM.y(), dpiY),
+                  std::max<qreal>(1.0, mmToDevice(cell.rectMM.width(), dpiX)),
+                  std::max<qreal>(1.0, mmToDevice(cell.rectMM.height(), dpiY)));
+}
+
+// N*item + (N-1)*gap <= available -> N <= floor((available + gap) / (item + gap))
+int fitCount(double available, double item, double gap)
+{
+    if (item <= 0.0 || available <= 0.0) {
+        return 0;
+    }
+    return std::max(0, static_cast<int>(std::floor((available + gap) / (item + gap) + kFitEpsilon)));
+}
+
+struct InnerArea
+{
+    double left = 0.0;
+    double top = 0.0;
+    double width = 0.0;
+    double height = 0.0;
+    double gapX = 0.0;
+    double gapY = 0.0;
+    double labelW = 0.0;
+    double labelH = 0.0;
+};
+
+InnerArea innerArea(const ImpositionSettings &settings)
+{
+    InnerArea area;
+    area.left = std::max(0.0, settings.marginsMM.left());
+    area.top = std::max(0.0, settings.marginsMM.top());
+    area.width = std::max(0.0, settings.pageSizeMM.width()
+                                   - (settings.marginsMM.left() + settings.marginsMM.right()));
+    area.height = std::max(0.0, settings.pageSizeMM.height()
+                                    - (settings.marginsMM.top() + settings.marginsMM.bottom()));
+    area.gapX = std::max(0.0, settings.hSpacingMM);
+    area.gapY = std::max(0.0, settings.vSpacingMM);
+    area.labelW = std::max(0.0, settings.labelSizeMM.width());
+    area.labelH = std::max(0.0, settings.labelSizeMM.height());
+    return area;
+}
+
+void appendBlock(ImpositionLayout *layout,
+                 const InnerArea &area,
+                 double originX,
+                 double originY,
+                 int rows,
+                 int columns,
+                 bool rotated,
+                 int block,
+                 bool horizontalOrder)
+{
+    if (!layout || rows <= 0 || columns <= 0) {
+        return;
+    }
+
+    const double cellW = rotated ? area.labelH : area.labelW;
+    const double cellH = rotated ? area.labelW : area.labelH;
+    const int count = rows * columns;
+    layout->cells.reserve(layout->cells.size() + count);
+
+    for (int i = 0; i < count; ++i) {
+        const int r = horizontalOrder ? i / columns : i % rows;
+        const int c = horizontalOrder ? i % columns : i / rows;
+
+        ImpositionCell cell;
+        cell.rectMM = QRectF(originX + c * (cellW + area.gapX),
+                             originY + r * (cellH + area.gapY),
+                             cellW,
+                             cellH);
+        cell.rotated = rotated;
+        cell.block = block;
+        cell.row = r;
+        cell.column = c;
+        layout->cells.append(cell);
+    }
+}
+
+ImpositionLayout emptyLayout(const ImpositionSettings &settings)
+{
+    ImpositionLayout layout;
+    layout.pageSizeMM = settings.pageSizeMM;
+    layout.labelSizeMM = settings.labelSizeMM;
+    return layout;
+}
+
+ImpositionLayout uniformLayout(const ImpositionSettings &settings, bool rotated)
+{
+    const InnerArea area = innerArea(settings);
+    const QSize capacity = ImpositionEngine::gridCapacity(settings, rotated);
+
+    ImpositionLayout layout = emptyLayout(settings);
+    layout.rows = capacity.height();
+    layout.columns = capacity.width();
+    appendBlock(&layout, area, area.left, area.top, layout.rows, layout.columns,
+                rotated, 0, settings.horizontalOrder);
+    return layout;
+}
+
+// 主网格占用左侧若干列（stripRight）或上方若干行，剩余区域以相反方向填充
+ImpositionLayout splitLayout(const ImpositionSettings &settings,
+                             bool mainRotated,
+                             bool stripRight,
+                             int mainSpan)
+{
+    const InnerArea area = innerArea(settings);
+    const double mainW = mainRotated ? area.labelH : area.labelW;
+    const double mainH = mainRotated ? area.labelW : area.labelH;
+    const double stripW = mainRotated ? area.labelW : area.labelH;
+    const double stripH = mainRotated ? area.labelH : area.labelW;
+
+    ImpositionLayout layout = emptyLayout(settings);
+
+    if (stripRight) {
+        const int mainRows = fitCount(area.height, mainH, area.gapY);
+        const double used = mainSpan * (mainW + area.gapX);
+        const double remaining = area.width - used;
+        layout.rows = mainRows;
+        layout.columns = mainSpan;
+        appendBlock(&layout, area, area.left, area.top, mainRows, mainSpan,
+                    mainRotated, 0, settings.horizontalOrder);
+        appendBlock(&layout, area, area.left + used, area.top,
+                    fitCount(area.height, stripH, area.gapY),
+                    fitCount(remaining, stripW, area.gapX),
+                    !mainRotated, 1, settings.horizontalOrder);
+    } else {
+        const int mainColumns = fitCount(area.width, mainW, area.gapX);
+        const double used = mainSpan * (mainH + area.gapY);
+        const double remaining = area.height - used;
+        layout.rows = mainSpan;
+        layout.columns = mainColumns;
+        appendBlock(&layout, area, area.left, area.top, mainSpan, mainColumns,
+                    mainRotated, 0, settings.horizontalOrder);
+        appendBlock(&layout, area, area.left, area.top + used,
+                    fitCount(remaining, stripH, area.gapY),
+                    fitCount(area.width, stripW, area.gapX),
+                    !mainRotated, 1, settings.horizontalOrder);
+    }
+
+    return layout;
+}
+}
+
+int ImpositionLayout::rotatedCellCount() const
+{
+    return static_cast<int>(std::count_if(cells.cbegin(), cells.cend(),
+                                          [](const ImpositionCell &cell) { return cell.rotated; }));
+}
+
+double ImpositionLayout::utilisation() const
+{
+    const double pageArea = pageSizeMM.width() * pageSizeMM.height();
+    if (pageArea <= 0.0) {
+        return 0.0;
+    }
+    const double labelArea = labelSizeMM.width() * labelSizeMM.height();
+    return std::clamp(cells.size() * labelArea / pageArea, 0.0, 1.0);
+}
+
+int ImpositionLayout::startIndexFor(int row, int column) const
+{
+    for (int i = 0; i < cells.size(); ++i) {
+        const ImpositionCell &cell = cells.at(i);
+        if (cell.block == 0 && cell.row == row && cell.column == column) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+void ImpositionLayout::locate(int sequenceIndex, int startIndex, int *page, int *cellIndex) const
+{
+    const int perPage = cells.size();
+    int resolvedPage = 0;
+    int resolvedCell = 0;
+
+    if (perPage > 0 && sequenceIndex >= 0) {
+        const int start = qBound(0, startIndex, perPage - 1);
+        const int firstPageCapacity = perPage - start;
+        if (sequenceIndex < firstPageCapacity) {
+            resolvedCell = start + sequenceIndex;
+        } else {
+            const int remaining = sequenceIndex - firstPageCapacity;
+            resolvedPage = 1 + remaining / perPage;
+            resolvedCell = remaining % perPage;
+        }
+    }
+
+    if (page) {
+        *page = resolvedPage;
+    }
+    if (cellIndex) {
+        *cellIndex = resolvedCell;
+    }
+}
+
+int ImpositionLayout::pageCount(int labelCount, int startIndex) const
+{
+    if (labelCount <= 0 || cells.isEmpty()) {
+        return 0;
+    }
+    int lastPage = 0;
+    locate(labelCount - 1, startIndex, &lastPage, nullptr);
+    return lastPage + 1;
+}
+
+QSize ImpositionEngine::gridCapacity(const ImpositionSettings &settings, bool rotated)
+{
+    const InnerArea area = innerArea(settings);
+    const double cellW = rotated ? area.labelH : area.labelW;
+    const double cellH = rotated ? area.labelW : area.labelH;
+    return QSize(fitCount(area.width, cellW, area.gapX),
+                 fitCount(area.height, cellH, area.gapY));
+}
+
+ImpositionLayout ImpositionEngine::grid(const ImpositionSettings &settings, int rows, int columns)
+{
+    const InnerArea area = innerArea(settings);
+    const QSize capacity = gridCapacity(settings, false);
+
+    ImpositionLayout layout = emptyLayout(settings);
+    layout.columns = qBound(1, columns, std::max(1, capacity.width()));
+    layout.rows = qBound(1, rows, std::max(1, capacity.height()));
+    appendBlock(&layout, area, area.left, area.top, layout.rows, layout.columns,
+                false, 0, settings.horizontalOrder);
+    return layout;
+}
+
+ImpositionLayout ImpositionEngine::bestFit(const ImpositionSettings &settings)
+{
+    ImpositionLayout best = uniformLayout(settings, false);
+
+    // 候选按“简单优先”顺序评估，只有严格更多时才替换
+    auto consider = [&best](ImpositionLayout candidate) {
+        if (candidate.cellsPerPage() > best.cellsPerPage()) {
+            best = std::move(candidate);
+        }
+    };
+
+    if (settings.allowRotation) {
+        consider(uniformLayout(settings, true));
+
+        for (bool mainRotated : {false, true}) {
+            const QSize capacity = gridCapacity(settings, mainRotated);
+            for (int span = 1; span < capacity.width(); ++span) {
+                consider(splitLayout(settings, mainRotated, true, span));
+            }
+            for (int span = 1; span < capacity.height(); ++span) {
+                consider(splitLayout(settings, mainRotated, false, span));
+            }
+        }
+    }
+
+    if (best.isEmpty()) {
+        // 标签大于可用区域时仍按单格输出，与旧行为一致
+        return grid(settings, 1, 1);
+    }
+    return best;
+}
+
+ImpositionRenderer::ImpositionRenderer(const ImpositionLayout &layout)
+    : m_layout(layout)
+{
+}
+
+void ImpositionRenderer::setStartIndex(int startIndex)
+{
+    m_startIndex = std::max(0, startIndex);
+}
+
+bool ImpositionRenderer::drawCell(QPainter &painter,
+                                  const ImpositionCell &cell,
+                                  const QPointF &pageOrigin,
+                                  qreal dpiX,
+                                  qreal dpiY,
+                                  int sequenceIndex,
+                                  const CellPainter &paintCell,
+                                  QString *errorMessage) const
+{
+    const QRectF cellPx = cellRectPx(cell, pageOrigin, dpiX, dpiY);
+
+    painter.save();
+    QRectF target;
+    if (cell.rotated) {
+        // 顺时针 90°：标签左上角落在单元格右上角
+        painter.translate(cellPx.right(), cellPx.top());
+        painter.rotate(90.0);
+        target = QRectF(0, 0, cellPx.height(), cellPx.width());
+    } else {
+        painter.translate(cellPx.topLeft());
+        target = QRectF(0, 0, cellPx.width(), cellPx.height());
+    }
+    const bool ok = paintCell(painter, target, sequenceIndex, errorMessage);
+    painter.restore();
+    return ok;
+}
+
+bool ImpositionRenderer::renderToPrinter(QPrinter *printer,
+                                         int labelCount,
+                                         const CellPainter &paintCell,
+                                         ImpositionResult *result,
+                                         QString *errorMessage)
+{
+    if (!printer || !paintCell) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("排版输出缺少打印机或绘制回调");
+        }
+        return false;
+    }
+
+    if (m_layout.isEmpty() || labelCount <= 0) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("排版结果为空，无法输出");
+        }
+        return false;
+    }
+
+    QPainter painter(printer);
+    if (!painter.isActive()) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("无法在打印机上初始化绘制");
+        }
+        return false;
+    }
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::TextAntialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    const QRectF pageRectPx = printer->paperRect(QPrinter::DevicePixel);
+    const qreal dpiX = printer->logicalDpiX();
+    const qreal dpiY = printer->logicalDpiY();
+
+    int previousPage = 0;
+    int printed = 0;
+    for (int i = 0; i < labelCount; ++i) {
+        int page = 0;
+        int cellIndex = 0;
+        m_layout.locate(i, m_startIndex, &page, &cellIndex);
+        if (i > 0 && page != previousPage) {
+            if (!printer->newPage()) {
+                if (errorMessage) {
+                    *errorMessage = QObject::tr("无法创建新的打印页");
+                }
+                painter.end();
+                return false;
+            }
+        }
+        previousPage = page;
+
+        if (!drawCell(painter, m_layout.cells.at(cellIndex), pageRectPx.topLeft(),
+                      dpiX, dpiY, i, paintCell, errorMessage)) {
+            painter.end();
+            return false;
+        }
+        ++printed;
+    }
+
+    painter.end();
+
+    if (result) {
+        result->labels = printed;
+        result->pages = previousPage + 1;
+        result->cellsPerPage = m_layout.cellsPerPage();
+        result->utilisation = m_layout.utilisation();
+        result->files.clear();
+    }
+    return true;
+}
+
+bool ImpositionRenderer::renderToImages(const QString &directory,
+                                        const QString &baseName,
+                                        const QString &suffix,
+                                        bool opaque,
+                                        qreal dpiX,
+                                        qreal dpiY,
+                                        int labelCount,
+                                        const CellPainter &paintCell,
+                                        ImpositionResult *result,
+                                        QString *errorMessage)
+{
+    if (!paintCell || dpiX <= 0.0 || dpiY <= 0.0) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("排版输出参数无效");
+        }
+        return false;
+    }
+
+    if (m_layout.isEmpty() || labelCount <= 0) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("排版结果为空，无法输出");
+        }
+        return false;
+    }
+
+    BandImageWriter::Format imageFormat = BandImageWriter::Format::Png;
+    if (!BandImageWriter::formatForSuffix(suffix, &imageFormat)) {
+        if (errorMessage) {
+            *errorMessage = QObject::tr("不支持的图像格式：%1").arg(suffix);
+        }
+        return false;
+    }
+
+    const int pageWidthPx = std::max(1, static_cast<int>(std::ceil(mmToDevice(m_layout.pageSizeMM.width(), dpiX))));
+    const int pageHeightPx = std::max(1, static_cast<int>(std::ceil(mmToDevice(m_layout.pageSizeMM.height(), dpiY))));
+    const QImage::Format format = opaque ? QImage::Format_RGB32 : QImage::Format_ARGB32_Premultiplied;
+    const QDir targetDir(directory);
+
+    // 页面按水平条带合成，条带交给编码线程流式写入文件；
+    // 同一时刻最多存在 kMaxBandsInFlight 个条带与跨越当前条带的一行图块，
+    // 内存占用与页面高度无关。
+    constexpr int kBandHeight = 256;
+    constexpr int kMaxBandsInFlight = 3;
+    QThreadPool encoderPool;
+    encoderPool.setMaxThreadCount(1); // 单线程保证条带按顺序写入
+    QSemaphore bandsInFlight(kMaxBandsInFlight);
+    QMutex failedMutex;
+    QStringList failedFiles;
+    QString firstFailure;
+    QStringList savedFiles;
+
+    struct PageOutput {
+        BandImageWriter writer;
+        QString path;
+        QString error;
+    };
+
+    auto renderPage = [&](int page, const QVector<QPair<int, int>> &entries) {
+        const QString outPath = targetDir.filePath(QStringLiteral("%1_%2.%3")
+                                                       .arg(baseName)
+                                                       .arg(QString::number(page + 1).rightJustified(3, QLatin1Char('0')))
+                                                       .arg(suffix));
+        auto output = std::make_shared<PageOutput>();
+        output->path = outPath;
+        if (!output->writer.open(outPath, imageFormat, QSize(pageWidthPx, pageHeightPx),
+                                 opaque, dpiX, dpiY, errorMessage)) {
+            return false;
+        }
+        savedFiles.append(outPath);
+
+        // 各单元格先完整绘制到自己的图块（含 1px 抗锯齿余量），再复制到与之相交的条带；
+        // 每个标签只绘制一次，图块在最后一个相交条带写出后释放
+        const QRect pageRectPx(0, 0, pageWidthPx, pageHeightPx);
+        QVector<QRect> tileRects;
+        tileRects.reserve(entries.size());
+        for (const auto &entry : entries) {
+            const QRectF bounds = cellRectPx(m_layout.cells.at(entry.first), QPointF(0.0, 0.0), dpiX, dpiY)
+                                      .adjusted(-1.0, -1.0, 1.0, 1.0);
+            tileRects.append(bounds.toAlignedRect() & pageRectPx);
+        }
+        QVector<QImage> tiles(entries.size());
+        QVector<bool> tileDone(entries.size(), false);
+
+        auto renderTile = [&](int i) {
+            const QRect &tileRect = tileRects.at(i);
+            QImage tile(tileRect.size(), QImage::Format_ARGB32_Premultiplied);
+            tile.fill(Qt::transparent);
+            QPainter painter(&tile);
+            if (!painter.isActive()) {
+                if (errorMessage) {
+                    *errorMessage = QObject::tr("无法创建排版画布");
+                }
+                return false;
+            }
+            painter.setRenderHint(QPainter::Antialiasing, true);
+            painter.setRenderHint(QPainter::TextAntialiasing, true);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+            // 图块原点为整数像素，与直接绘制到页面时的设备像素对齐一致
+            painter.translate(-tileRect.topLeft());
+            if (!drawCell(painter, m_layout.cells.at(entries.at(i).first), QPointF(0.0, 0.0),
+                          dpiX, dpiY, entries.at(i).second, paintCell, errorMessage)) {
+                return false;
+            }
+            painter.end();
+            tiles[i] = tile;
+            return true;
+        };
+
+        for (int bandTop = 0; bandTop < pageHeightPx; bandTop += kBandHeight) {
+            const int bandHeight = std::min(kBandHeight, pageHeightPx - bandTop);
+            QImage band(pageWidthPx, bandHeight, format);
+            band.fill(Qt::white);
+
+            QPainter painter(&band);
+            if (!painter.isActive()) {
+                // 之前的条带可能仍在编码线程中写出，先等其结束再丢弃输出
+                encoderPool.waitForDone();
+                output->writer.cancel();
+                if (errorMessage) {
+                    *errorMessage = QObject::tr("无法创建排版画布");
+                }
+                return false;
+            }
+            painter.translate(0.0, -bandTop);
+
+            // 按原顺序叠加图块，与依次直接绘制到页面的结果一致
+            for (int i = 0; i < entries.size(); ++i) {
+                const QRect &tileRect = tileRects.at(i);
+                if (tileDone.at(i) || tileRect.isEmpty()
+                    || tileRect.bottom() < bandTop || tileRect.top() >= bandTop + bandHeight) {
+                    continue;
+                }
+                if (tiles.at(i).isNull() && !renderTile(i)) {
+                    painter.end();
+                    encoderPool.waitForDone();
+                    output->writer.cancel();
+                    return false;
+                }
+                painter.drawImage(tileRect.topLeft(), tiles.at(i));
+                if (tileRect.bottom() < bandTop + bandHeight) {
+                    tiles[i] = QImage();
+                    tileDone[i] = true;
+                }
+            }
+            painter.end();
+
+            bandsInFlight.acquire();
+            encoderPool.start([output, band, &bandsInFlight]() {
+                if (output->error.isEmpty()) {
+                    output->writer.writeBand(band, &output->error);
+                }
+                bandsInFlight.release();
+            });
+        }
+
+        encoderPool.start([output, &failedMutex, &failedFiles, &firstFailure]() {
+            if (output->error.isEmpty()) {
+                output->writer.finish(&output->error);
+            }
+            if (!output->error.isEmpty()) {
+                QMutexLocker locker(&failedMutex);
+                failedFiles.append(output->path);
+                if (firstFailure.isEmpty()) {
+                    firstFailure = output->error;
+                }
+            }
+        });
+        return true;
+    };
+
+    int printed = 0;
+    int currentPage = -1;
+    QVector<QPair<int, int>> pageEntries; // (单元格, 标签序号)
+    for (int i = 0; i < labelCount; ++i) {
+        int page = 0;
+        int cellIndex = 0;
+        m_layout.locate(i, m_startIndex, &page, &cellIndex);
+
+        if (page != currentPage) {
+            if (!pageEntries.isEmpty() && !renderPage(currentPage, pageEntries)) {
+                encoderPool.waitForDone();
+                return false;
+            }
+            pageEntries.clear();
+            currentPage = page;
+        }
+        pageEntries.append(qMakePair(cellIndex, i));
+        ++printed;
+    }
+
+    if (!pageEntries.isEmpty() && !renderPage(currentPage, pageEntries)) {
+        encoderPool.waitForDone();
+        return false;
+    }
+    encoderPool.waitForDone();
+
+    if (!failedFiles.isEmpty()) {
+        if (errorMessage) {
+            *errorMessage = firstFailure.isEmpty()
+                                ? QObject::tr("无法写入文件 %1").arg(QDir::toNativeSeparators(failedFiles.first()))
+                                : firstFailure;
+        }
+        return false;
+    }
+
+    if (result) {
+        result->labels = printed;
+        result->pages = currentPage + 1;
+        result->cellsPerPage = m_layout.cellsPerPage();
+        result->utilisation = m_layout.utilisation();
+        result->files = savedFiles;
+    }
+    return true;
+}
@@ -0,0 +1,135 @@
+#ifndef IMPOSITION_H
+#define IMPOSITION_H
+
+#include <QtCore/QMarginsF>
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QSize>
+#include <QtCore/QSizeF>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <functional>
+
+class QPainter;
+class QPrinter;
+
+// 排版输入参数（单位：mm，页面尺寸已按横竖方向处理）
+struct ImpositionSettings
+{
+    QSizeF pageSizeMM;
+    QMarginsF marginsMM;
+    double hSpacingMM = 0.0;
+    double vSpacingMM = 0.0;
+    QSizeF labelSizeMM;
+    bool horizontalOrder = true; // true 横向排序, false 纵向排序
+    bool allowRotation = false;  // 允许 90° 旋转放置以容纳更多标签
+};
+
+// 页面上的一个标签位置
+struct ImpositionCell
+{
+    QRectF rectMM;        // 页面坐标（含边距），旋转时为旋转后的外框
+    bool rotated = false; // 标签顺时针旋转 90° 放置
+    int block = 0;        // 0 主网格, 1 填充余量的副网格
+    int row = 0;
+    int column = 0;
+};
+
+// 单页排版结果，所有页面共用
+struct ImpositionLayout
+{
+    QSizeF pageSizeMM;
+    QSizeF labelSizeMM;
+    QVector<ImpositionCell> cells;
+    int rows = 0;    // 主网格行数
+    int columns = 0; // 主网格列数
+
+    bool isEmpty() const { return cells.isEmpty(); }
+    int cellsPerPage() const { return cells.size(); }
+    int rotatedCellCount() const;
+
+    // 纸张利用率：标签总面积 / 页面面积（0~1）
+    double utilisation() const;
+
+    // 主网格中 (row, column) 对应的线性起始序号（0-based），不存在时返回 0
+    int startIndexFor(int row, int column) const;
+
+    // 计算第 sequenceIndex 个标签所在页与单元格（首页从 startIndex 开始）
+    void locate(int sequenceIndex, int startIndex, int *page, int *cellIndex) const;
+    int pageCount(int labelCount, int startIndex) const;
+};
+
+class ImpositionEngine
+{
+public:
+    // 不考虑用户行列限制时可容纳的最大行列（width=列, height=行）
+    static QSize gridCapacity(const ImpositionSettings &settings, bool rotated = false);
+
+    // 固定行列网格（行列会被钳制到可容纳范围，至少 1×1）
+    static ImpositionLayout grid(const ImpositionSettings &settings, int rows, int columns);
+
+    // 在所有候选方案（0°、90°、0°/90° 混排）中选择单页容纳最多标签的方案
+    static ImpositionLayout bestFit(const ImpositionSettings &settings);
+};
+
+struct ImpositionResult
+{
+    int labels = 0;
+    int pages = 0;
+    int cellsPerPage = 0;
+    double utilisation = 0.0;
+    QStringList files;
+};
+
+// 按排版结果逐页输出：打印机（含 PDF）或逐页图像。
+// 单元格内容由调用方绘制，绘制前画笔已平移/旋转到标签坐标系，
+// target 为标签方向下的设备像素矩形。
+class ImpositionRenderer
+{
+public:
+    using CellPainter = std::function<bool(QPainter &painter,
+                                           const QRectF &target,
+                                           int sequenceIndex,
+                                           QString *errorMessage)>;
+
+    explicit ImpositionRenderer(const ImpositionLayout &layout);
+
+    void setStartIndex(int startIndex);
+    int startIndex() const { return m_startIndex; }
+
+    bool renderToPrinter(QPrinter *printer,
+                         int labelCount,
+                         const CellPainter &paintCell,
+                         ImpositionResult *result,
+                         QString *errorMessage);
+
+    // 图像按页输出为 <baseName>_<页码>.<suffix>（png / jpg）。页面按条带绘制，
+    // 条带在编码线程中流式写入文件，与后续条带的绘制并行进行。
+    bool renderToImages(const QString &directory,
+                        const QString &baseName,
+                        const QString &suffix,
+                        bool opaque,
+                        qreal dpiX,
+                        qreal dpiY,
+                        int labelCount,
+                        const CellPainter &paintCell,
+                        ImpositionResult *result,
+                        QString *errorMessage);
+
+private:
+    bool drawCell(QPainter &painter,
+                  const ImpositionCell &cell,
+                  const QPointF &pageOrigin,
+                  qreal dpiX,
+                  qreal dpiY,
+                  int sequenceIndex,
+                  const CellPainter &paintCell,
+                  QString *errorMessage) const;
+
+    ImpositionLayout m_layout;
+    int m_startIndex = 0;
+};
+
+#endif // IMPOSITION_H
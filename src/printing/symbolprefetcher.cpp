@@ -0,0 +1,112 @@
+#include "symbolprefetcher.h"
+
+#include "../core/barcodeelement.h"
+#include "../core/imageelement.h"
+#include "../core/qrcodeelement.h"
+#include "../graphics/recordimageprovider.h"
+#include "../graphics/symbolmatrixcache.h"
+
+#include <QtCore/QThread>
+#include <QtGui/QPaintDevice>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// 标签坐标的分辨率：MainWindow::MM_TO_PIXELS（96/25.4 × 2）对应 192 DPI
+constexpr double kLabelPixelsPerInch = 192.0;
+
+} // namespace
+
+SymbolPrefetcher::SymbolPrefetcher(const QList<labelelement*> &elements,
+                                   const QPaintDevice *device,
+                                   int window)
+    : m_deviceDpiX(device ? device->logicalDpiX() : 0)
+    , m_deviceDpiY(device ? device->logicalDpiY() : 0)
+    , m_window(std::max(1, window))
+{
+    for (labelelement *element : elements) {
+        if (!element || !element->isDataSourceEnabled()) {
+            continue;
+        }
+        if (auto *barcode = dynamic_cast<BarcodeElement*>(element)) {
+            m_barcodes.append(barcode);
+        } else if (auto *qrcode = dynamic_cast<QRCodeElement*>(element)) {
+            m_qrcodes.append(qrcode);
+        } else if (auto *image = dynamic_cast<ImageElement*>(element)) {
+            m_images.append(image);
+        }
+    }
+
+    // 绘制线程自身也在工作，留出一个核心
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+SymbolPrefetcher::~SymbolPrefetcher()
+{
+    cancel();
+}
+
+void SymbolPrefetcher::advance(int recordIndex, int lastRecord)
+{
+    if (isEmpty() || recordIndex < 0) {
+        return;
+    }
+
+    // 向前跳过的记录不再提交；回到已提交的记录（排版条带逐带重绘同一页）时不重复提交
+    if (m_nextRecord < recordIndex) {
+        m_nextRecord = recordIndex;
+    }
+
+    const int windowEnd = std::min(lastRecord, recordIndex + m_window - 1);
+    for (; m_nextRecord <= windowEnd; ++m_nextRecord) {
+        // 目标尺寸只需估计到两倍以内：解码按 1/2^k 分级，与绘制时取到的级别一致
+        for (const ImageElement *image : std::as_const(m_images)) {
+            const QString filePath = image->recordImagePath(m_nextRecord);
+            if (filePath.isEmpty() || m_deviceDpiX <= 0 || m_deviceDpiY <= 0) {
+                continue;
+            }
+            const QSizeF size = image->getSize();
+            const QSize targetSize(static_cast<int>(std::ceil(size.width() * m_deviceDpiX / kLabelPixelsPerInch)),
+                                   static_cast<int>(std::ceil(size.height() * m_deviceDpiY / kLabelPixelsPerInch)));
+            RecordImageProvider::instance().prefetch(filePath, targetSize);
+        }
+
+        QVector<SymbolMatrixKey> keys;
+        keys.reserve(m_barcodes.size() + m_qrcodes.size());
+        for (const BarcodeElement *barcode : std::as_const(m_barcodes)) {
+            SymbolMatrixKey key = barcode->symbolMatrixKeyForRecord(m_nextRecord, m_deviceDpiX, m_deviceDpiY);
+            if (key.encoder != SymbolMatrixKey::Encoder::None) {
+                keys.append(std::move(key));
+            }
+        }
+        for (const QRCodeElement *qrcode : std::as_const(m_qrcodes)) {
+            SymbolMatrixKey key = qrcode->symbolMatrixKeyForRecord(m_nextRecord);
+            if (key.encoder != SymbolMatrixKey::Encoder::None) {
+                keys.append(std::move(key));
+            }
+        }
+        if (keys.isEmpty()) {
+            continue;
+        }
+
+        // 编码只依赖键本身，不再访问元素
+        m_pool.start([keys = std::move(keys)]() {
+            for (const SymbolMatrixKey &key : keys) {
+                SymbolMatrixCache::matrix(key);
+            }
+        });
+    }
+}
+
+void SymbolPrefetcher::cancel()
+{
+    if (!m_images.isEmpty()) {
+        RecordImageProvider::instance().cancelPending();
+    }
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_nextRecord = -1;
+}
@@ -0,0 +1,53 @@
+#ifndef SYMBOLPREFETCHER_H
+#define SYMBOLPREFETCHER_H
+
+#include <QtCore/QList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+class BarcodeElement;
+class ImageElement;
+class QRCodeElement;
+class QPaintDevice;
+class labelelement;
+
+// 批量任务的条码/二维码预编码：绘制第 N 条记录时，后续窗口内记录的符号已在线程池中编码，
+// 结果写入共享的 SymbolMatrixCache，绘制时直接命中。编码与绘制因此重叠进行。
+// 绑定数据源的图像元素同样提前交给 RecordImageProvider 按打印尺寸解码。
+// 编码参数读自图形项，advance() 须在元素所在线程（通常是 GUI 线程）调用。
+class SymbolPrefetcher
+{
+public:
+    static constexpr int kDefaultWindow = 32;
+
+    // elements 中启用了数据源的条码、二维码、图像元素参与预编码；
+    // device 为实际绘制设备（只读取其 DPI），一维码的文本区高度与设备 DPI 有关
+    SymbolPrefetcher(const QList<labelelement*> &elements,
+                     const QPaintDevice *device,
+                     int window = kDefaultWindow);
+    ~SymbolPrefetcher();
+
+    SymbolPrefetcher(const SymbolPrefetcher &) = delete;
+    SymbolPrefetcher &operator=(const SymbolPrefetcher &) = delete;
+
+    bool isEmpty() const { return m_barcodes.isEmpty() && m_qrcodes.isEmpty() && m_images.isEmpty(); }
+
+    // 即将绘制 recordIndex：把 [recordIndex, recordIndex + window) 中
+    // 不超过 lastRecord 且尚未提交的记录交给线程池
+    void advance(int recordIndex, int lastRecord);
+
+    // 放弃尚未开始的编码并等待进行中的编码结束
+    void cancel();
+
+private:
+    QVector<BarcodeElement*> m_barcodes;
+    QVector<QRCodeElement*> m_qrcodes;
+    QVector<ImageElement*> m_images;
+    int m_deviceDpiX = 0;
+    int m_deviceDpiY = 0;
+    int m_window = kDefaultWindow;
+    int m_nextRecord = -1;  // 下一条尚未提交的记录
+    QThreadPool m_pool;
+};
+
+#endif // SYMBOLPREFETCHER_H
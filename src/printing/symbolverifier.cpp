@@ -0,0 +1,266 @@
+#include "symbolverifier.h"
+
+#include "printrenderer.h"
+#include "../core/barcodeelement.h"
+#include "../core/qrcodeelement.h"
+
+#include "ReadBarcode.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QSysInfo>
+#include <QtCore/QThread>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr double kMillimetrePerInch = 25.4;
+
+int formatForCodeType(const QString &codeType)
+{
+    if (codeType == QLatin1String("PDF417")) {
+        return static_cast<int>(ZXing::BarcodeFormat::PDF417);
+    }
+    if (codeType == QLatin1String("DataMatrix")) {
+        return static_cast<int>(ZXing::BarcodeFormat::DataMatrix);
+    }
+    if (codeType == QLatin1String("Aztec")) {
+        return static_cast<int>(ZXing::BarcodeFormat::Aztec);
+    }
+    return static_cast<int>(ZXing::BarcodeFormat::QRCode);
+}
+
+// EAN/UPC 的载荷可以省略校验位，写入器会补上
+bool appendsCheckDigit(int format)
+{
+    switch (static_cast<ZXing::BarcodeFormat>(format)) {
+    case ZXing::BarcodeFormat::EAN8:
+    case ZXing::BarcodeFormat::EAN13:
+    case ZXing::BarcodeFormat::UPCA:
+    case ZXing::BarcodeFormat::UPCE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool matches(const SymbolVerifier::Expected &expected, int format, const QString &text)
+{
+    if (expected.format != format) {
+        return false;
+    }
+    if (text == expected.payload) {
+        return true;
+    }
+    return appendsCheckDigit(format)
+        && text.size() == expected.payload.size() + 1
+        && text.startsWith(expected.payload);
+}
+
+} // namespace
+
+SymbolVerifier::SymbolVerifier(const QList<labelelement*> &elements,
+                               PrintRenderer *renderer,
+                               const PrintContext &context,
+                               int sampleInterval)
+    : m_elements(elements)
+    , m_renderer(renderer)
+    , m_context(context)
+    , m_sampleInterval(sampleInterval)
+{
+    if (m_sampleInterval <= 0 || !m_renderer || !m_context.printer) {
+        return;
+    }
+
+    QVector<Expected> expected;
+    collectExpected(&expected);
+    if (expected.isEmpty()) {
+        return;
+    }
+
+    // 栅格只包含标签本身：去掉页边距，尺寸按打印机 DPI 换算
+    m_dpiX = m_context.printer->logicalDpiX();
+    m_dpiY = m_context.printer->logicalDpiY();
+    m_context.contentMargins = QMarginsF();
+    const QSizeF labelMM = m_context.labelSizeMM;
+    const QSizeF labelPixels = m_context.labelSizePixels;
+    const double width = labelMM.width() > 0.0 ? labelMM.width() * m_dpiX / kMillimetrePerInch : labelPixels.width();
+    const double height = labelMM.height() > 0.0 ? labelMM.height() * m_dpiY / kMillimetrePerInch : labelPixels.height();
+    m_rasterSize = QSize(static_cast<int>(std::ceil(width)), static_cast<int>(std::ceil(height)));
+    if (m_rasterSize.isEmpty() || m_dpiX <= 0 || m_dpiY <= 0) {
+        return;
+    }
+
+    // 打印线程自身也在工作，留出一个核心；积压上限同时限制了栅格占用的内存
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+    m_maxPending = m_pool.maxThreadCount() * 2;
+    m_enabled = true;
+}
+
+SymbolVerifier::~SymbolVerifier()
+{
+    m_pool.waitForDone();
+}
+
+void SymbolVerifier::collectExpected(QVector<Expected> *expected) const
+{
+    for (labelelement *element : m_elements) {
+        if (!element) {
+            continue;
+        }
+        const QGraphicsItem *item = element->getItem();
+        if (item && !item->isVisible()) {
+            continue;
+        }
+
+        Expected entry;
+        if (auto *barcode = dynamic_cast<BarcodeElement*>(element)) {
+            entry.payload = barcode->getBarcodeData();
+            entry.format = static_cast<int>(barcode->getFormat());
+        } else if (auto *qrcode = dynamic_cast<QRCodeElement*>(element)) {
+            const auto *qrItem = static_cast<const QRCodeItem*>(item);
+            entry.payload = qrcode->getText();
+            entry.format = formatForCodeType(qrItem ? qrItem->codeType() : QString());
+        } else {
+            continue;
+        }
+        if (!entry.payload.isEmpty()) {
+            expected->append(entry);
+        }
+    }
+}
+
+void SymbolVerifier::submit(int recordIndex)
+{
+    if (!m_enabled) {
+        return;
+    }
+    if (m_firstRecord < 0) {
+        m_firstRecord = recordIndex;
+        m_timer.start();
+    }
+    if ((recordIndex - m_firstRecord) % m_sampleInterval != 0) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pending >= m_maxPending) {
+            ++m_summary.skipped;
+            return;
+        }
+        ++m_pending;
+    }
+
+    QVector<Expected> expected;
+    collectExpected(&expected);
+
+    // 与送往打印机的绘制走同一渲染器，条码直写、预编码缓存等路径都相同
+    QImage raster(m_rasterSize, QImage::Format_RGB32);
+    raster.setDotsPerMeterX(qRound(m_dpiX / kMillimetrePerInch * 1000.0));
+    raster.setDotsPerMeterY(qRound(m_dpiY / kMillimetrePerInch * 1000.0));
+    raster.fill(Qt::white);
+    QString renderError;
+    bool rendered = false;
+    {
+        QPainter painter(&raster);
+        rendered = painter.isActive() && m_renderer->render(painter, m_elements, m_context, &renderError);
+    }
+
+    if (!rendered) {
+        RecordResult result;
+        result.index = recordIndex;
+        result.missing << (renderError.isEmpty() ? QObject::tr("无法生成校验栅格") : renderError);
+        report(result);
+        return;
+    }
+
+    m_pool.start([this, recordIndex, raster = std::move(raster), expected = std::move(expected)]() {
+        decode(recordIndex, raster, expected);
+    });
+}
+
+void SymbolVerifier::decode(int recordIndex, const QImage &raster, const QVector<Expected> &expected)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ZXing::BarcodeFormats formats;
+    for (const Expected &entry : expected) {
+        formats |= static_cast<ZXing::BarcodeFormat>(entry.format);
+    }
+    ZXing::ReaderOptions options;
+    options.setFormats(formats);
+    options.setTextMode(ZXing::TextMode::Plain);
+    options.setTryRotate(true);
+    options.setTryHarder(true);
+
+    // QImage::Format_RGB32 在内存中按字节依次为 B、G、R、X（小端）
+    const ZXing::ImageFormat pixelFormat = QSysInfo::ByteOrder == QSysInfo::LittleEndian
+                                               ? ZXing::ImageFormat::BGRA
+                                               : ZXing::ImageFormat::ARGB;
+    const ZXing::ImageView view(raster.constBits(), raster.width(), raster.height(),
+                                pixelFormat, static_cast<int>(raster.bytesPerLine()));
+    const ZXing::Barcodes barcodes = ZXing::ReadBarcodes(view, options);
+
+    // 每个载荷须匹配一个不同的读出结果（同一载荷出现多次时也逐个核对）
+    QVector<bool> used(static_cast<int>(barcodes.size()), false);
+    RecordResult result;
+    result.index = recordIndex;
+    for (const Expected &entry : expected) {
+        bool found = false;
+        for (int i = 0; i < used.size() && !found; ++i) {
+            const ZXing::Barcode &barcode = barcodes[static_cast<size_t>(i)];
+            if (used[i] || !barcode.isValid()) {
+                continue;
+            }
+            if (matches(entry, static_cast<int>(barcode.format()), QString::fromStdString(barcode.text()))) {
+                used[i] = true;
+                found = true;
+            }
+        }
+        if (!found) {
+            result.missing << entry.payload;
+        }
+    }
+    result.passed = result.missing.isEmpty();
+    result.decodeMs = timer.elapsed();
+    report(result);
+}
+
+void SymbolVerifier::report(const RecordResult &result)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_pending;
+        ++m_summary.verified;
+        if (result.passed) {
+            ++m_summary.passed;
+        } else {
+            ++m_summary.failed;
+        }
+    }
+    if (m_handler) {
+        m_handler(result);
+    }
+}
+
+SymbolVerifier::Summary SymbolVerifier::finish()
+{
+    m_pool.waitForDone();
+
+    QMutexLocker locker(&m_mutex);
+    Summary summary = m_summary;
+    if (m_timer.isValid()) {
+        summary.elapsedMs = m_timer.elapsed();
+        if (summary.elapsedMs > 0) {
+            summary.recordsPerSecond = summary.verified * 1000.0 / summary.elapsedMs;
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,97 @@
+#ifndef SYMBOLVERIFIER_H
+#define SYMBOLVERIFIER_H
+
+#include "printcontext.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSize>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <functional>
+
+class PrintRenderer;
+class QImage;
+class labelelement;
+
+// 批量打印的解码回读校验：按抽检间隔把记录的最终栅格（打印机 DPI、与送往打印机的绘制相同）
+// 交给线程池，用 ZXing 读出标签上的全部条码/二维码并与元素当前的载荷比对。
+// 栅格须在元素套用该记录后生成，因此 submit() 在打印线程调用；解码在后台进行，
+// 积压超过上限时跳过该记录的校验，不阻塞打印。
+class SymbolVerifier
+{
+public:
+    struct RecordResult {
+        int index = -1;
+        bool passed = false;
+        QStringList missing;    // 未读到的载荷；栅格生成失败时为错误信息
+        qint64 decodeMs = 0;
+    };
+
+    struct Summary {
+        int verified = 0;
+        int passed = 0;
+        int failed = 0;
+        int skipped = 0;        // 解码积压时跳过的抽检记录
+        qint64 elapsedMs = 0;   // 首条提交到最后一条解码完成
+        double recordsPerSecond = 0.0;
+    };
+
+    // 每条校验结果在线程池线程中回调
+    using ResultHandler = std::function<void(const RecordResult &)>;
+
+    // sampleInterval：每 N 条记录校验一条，1 为逐条校验，<= 0 为关闭
+    SymbolVerifier(const QList<labelelement*> &elements,
+                   PrintRenderer *renderer,
+                   const PrintContext &context,
+                   int sampleInterval);
+    ~SymbolVerifier();
+
+    SymbolVerifier(const SymbolVerifier &) = delete;
+    SymbolVerifier &operator=(const SymbolVerifier &) = delete;
+
+    // 未开启、没有条码/二维码或无法确定标签尺寸时不做任何事
+    bool isEnabled() const { return m_enabled; }
+
+    void setResultHandler(ResultHandler handler) { m_handler = std::move(handler); }
+
+    // recordIndex 已套用到元素并送往打印机后调用
+    void submit(int recordIndex);
+
+    // 等待进行中的解码结束并返回汇总
+    Summary finish();
+
+    struct Expected {
+        QString payload;
+        int format = 0;     // ZXing::BarcodeFormat
+    };
+
+private:
+    void collectExpected(QVector<Expected> *expected) const;
+    void decode(int recordIndex, const QImage &raster, const QVector<Expected> &expected);
+    void report(const RecordResult &result);
+
+    QList<labelelement*> m_elements;
+    PrintRenderer *m_renderer = nullptr;
+    PrintContext m_context;
+    QSize m_rasterSize;
+    int m_dpiX = 0;
+    int m_dpiY = 0;
+    int m_sampleInterval = 0;
+    int m_firstRecord = -1;
+    bool m_enabled = false;
+    ResultHandler m_handler;
+
+    QThreadPool m_pool;
+    int m_maxPending = 0;
+    QElapsedTimer m_timer;
+
+    mutable QMutex m_mutex;
+    int m_pending = 0;
+    Summary m_summary;
+};
+
+#endif // SYMBOLVERIFIER_H